@@ -0,0 +1,138 @@
+'use strict'
+
+// Compares the cost of an antialiased frame rendered with a multisampled
+// drawing buffer against rendering at a higher resolution and downsampling
+// on the CPU.
+//
+//   node bench/antialias.js [width] [height] [frames]
+
+const createContext = require('../index')
+
+const WIDTH = (process.argv[2] | 0) || 512
+const HEIGHT = (process.argv[3] | 0) || 512
+const FRAMES = (process.argv[4] | 0) || 50
+const TRIANGLES = 2000
+
+const VERT_SRC = [
+  'precision mediump float;',
+  'attribute vec2 position;',
+  'void main() {',
+  '  gl_Position = vec4(position, 0, 1);',
+  '}'
+].join('\n')
+
+const FRAG_SRC = [
+  'precision mediump float;',
+  'void main() {',
+  '  gl_FragColor = vec4(1, 1, 1, 1);',
+  '}'
+].join('\n')
+
+function setup (gl) {
+  function shader (type, src) {
+    const s = gl.createShader(type)
+    gl.shaderSource(s, src)
+    gl.compileShader(s)
+    return s
+  }
+  const program = gl.createProgram()
+  gl.attachShader(program, shader(gl.VERTEX_SHADER, VERT_SRC))
+  gl.attachShader(program, shader(gl.FRAGMENT_SHADER, FRAG_SRC))
+  gl.bindAttribLocation(program, 0, 'position')
+  gl.linkProgram(program)
+  gl.useProgram(program)
+
+  // Thin slivers give lots of edges
+  const data = new Float32Array(TRIANGLES * 6)
+  let seed = 1
+  function random () {
+    seed = (seed * 16807) % 2147483647
+    return seed / 2147483647 * 2 - 1
+  }
+  for (let i = 0; i < TRIANGLES; ++i) {
+    const x = random()
+    const y = random()
+    data.set([x, y, x + 0.3 * random(), y + 0.3 * random(), x + 0.01, y], i * 6)
+  }
+  gl.bindBuffer(gl.ARRAY_BUFFER, gl.createBuffer())
+  gl.bufferData(gl.ARRAY_BUFFER, data, gl.STATIC_DRAW)
+  gl.enableVertexAttribArray(0)
+  gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0)
+}
+
+function drawFrame (gl) {
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  gl.drawArrays(gl.TRIANGLES, 0, TRIANGLES * 3)
+}
+
+// Box filter from a (scale * width) x (scale * height) image
+function downsample (src, dst, width, height, scale) {
+  const srcWidth = width * scale
+  const area = scale * scale
+  for (let y = 0; y < height; ++y) {
+    for (let x = 0; x < width; ++x) {
+      for (let c = 0; c < 4; ++c) {
+        let sum = 0
+        for (let j = 0; j < scale; ++j) {
+          let ptr = 4 * ((y * scale + j) * srcWidth + x * scale) + c
+          for (let i = 0; i < scale; ++i, ptr += 4) {
+            sum += src[ptr]
+          }
+        }
+        dst[4 * (y * width + x) + c] = (sum / area + 0.5) | 0
+      }
+    }
+  }
+}
+
+function run (name, gl, width, height, readFrame, gpuBytes) {
+  setup(gl)
+  readFrame() // warm up
+  const start = process.hrtime.bigint()
+  for (let i = 0; i < FRAMES; ++i) {
+    drawFrame(gl)
+    readFrame()
+  }
+  const ms = Number(process.hrtime.bigint() - start) / 1e6 / FRAMES
+  console.log(
+    name.padEnd(16),
+    (ms.toFixed(2) + ' ms/frame').padStart(16),
+    ((gpuBytes / (1 << 20)).toFixed(1) + ' MiB drawing buffer').padStart(26),
+    ((process.memoryUsage().rss / (1 << 20)).toFixed(0) + ' MiB rss').padStart(14))
+  gl.getExtension('STACKGL_destroy_context').destroy()
+}
+
+const out = new Uint8Array(WIDTH * HEIGHT * 4)
+console.log('antialias ' + WIDTH + 'x' + HEIGHT + ', ' + FRAMES + ' frames')
+
+{
+  const gl = createContext(WIDTH, HEIGHT)
+  run('aliased', gl, WIDTH, HEIGHT, function () {
+    gl.readPixels(0, 0, WIDTH, HEIGHT, gl.RGBA, gl.UNSIGNED_BYTE, out)
+  }, WIDTH * HEIGHT * 8)
+}
+
+{
+  const gl = createContext(WIDTH, HEIGHT, { antialias: true })
+  if (gl.getContextAttributes().antialias) {
+    const samples = gl.getParameter(gl.SAMPLES)
+    // Multisampled color + depth, plus the single sampled resolve target
+    run('msaa ' + samples + 'x', gl, WIDTH, HEIGHT, function () {
+      gl.readPixels(0, 0, WIDTH, HEIGHT, gl.RGBA, gl.UNSIGNED_BYTE, out)
+    }, WIDTH * HEIGHT * (8 * samples + 4))
+  } else {
+    console.log('msaa not supported')
+    gl.getExtension('STACKGL_destroy_context').destroy()
+  }
+}
+
+for (const scale of [2, 4]) {
+  const width = WIDTH * scale
+  const height = HEIGHT * scale
+  const gl = createContext(width, height)
+  const big = new Uint8Array(width * height * 4)
+  run('supersample ' + scale + 'x', gl, width, height, function () {
+    gl.readPixels(0, 0, width, height, gl.RGBA, gl.UNSIGNED_BYTE, big)
+    downsample(big, out, WIDTH, HEIGHT, scale)
+  }, width * height * 8)
+}
@@ -0,0 +1,57 @@
+'use strict'
+
+// Measures what a pool of contexts costs: creation time and heap per
+// context, and the overhead of a cheap call through the public wrapper.
+//
+//   node --expose-gc bench/context-pool.js [contexts] [calls]
+
+const createContext = require('../index')
+
+const CONTEXTS = (process.argv[2] | 0) || 200
+const CALLS = (process.argv[3] | 0) || 1000000
+
+function collect () {
+  if (global.gc) {
+    global.gc()
+  }
+  return process.memoryUsage()
+}
+
+console.log('context pool ' + CONTEXTS + ' contexts, ' + CALLS + ' calls')
+
+const before = collect()
+const pool = new Array(CONTEXTS)
+let start = process.hrtime.bigint()
+for (let i = 0; i < CONTEXTS; ++i) {
+  pool[i] = createContext(16, 16)
+}
+const createMs = Number(process.hrtime.bigint() - start) / 1e6
+const after = collect()
+
+console.log(
+  'create'.padEnd(10),
+  ((createMs / CONTEXTS).toFixed(3) + ' ms/context').padStart(18),
+  (((after.heapUsed - before.heapUsed) / CONTEXTS / 1024).toFixed(1) + ' KiB heap/context').padStart(24),
+  (((after.rss - before.rss) / CONTEXTS / 1024).toFixed(1) + ' KiB rss/context').padStart(24))
+
+const gl = pool[0]
+for (let i = 0; i < 1000; ++i) {
+  gl.depthMask(true)
+}
+start = process.hrtime.bigint()
+for (let i = 0; i < CALLS; ++i) {
+  gl.depthMask(i & 1)
+}
+const callNs = Number(process.hrtime.bigint() - start) / CALLS
+console.log(
+  'call'.padEnd(10),
+  (callNs.toFixed(1) + ' ns/call').padStart(18))
+
+start = process.hrtime.bigint()
+for (let i = 0; i < CONTEXTS; ++i) {
+  pool[i].getExtension('STACKGL_destroy_context').destroy()
+}
+const destroyMs = Number(process.hrtime.bigint() - start) / 1e6
+console.log(
+  'destroy'.padEnd(10),
+  ((destroyMs / CONTEXTS).toFixed(3) + ' ms/context').padStart(18))
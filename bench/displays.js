@@ -0,0 +1,101 @@
+'use strict'
+
+// Measures how rendering on several threads scales when their contexts
+// share one display, and when each thread's context has its own display.
+//
+//   node bench/displays.js [threads] [draws] [frames]
+
+const os = require('os')
+const { Worker, isMainThread, parentPort, workerData } = require('worker_threads')
+const createContext = require('../index')
+
+const THREADS = (process.argv[2] | 0) || Math.min(os.cpus().length, 8)
+const DRAWS = (process.argv[3] | 0) || 2000
+const FRAMES = (process.argv[4] | 0) || 20
+const SIZE = 128
+
+const VERT_SRC = [
+  'attribute vec2 position;',
+  'uniform vec2 offset;',
+  'void main() {',
+  '  gl_Position = vec4(position + offset, 0, 1);',
+  '}'
+].join('\n')
+
+const FRAG_SRC = [
+  'precision mediump float;',
+  'uniform vec4 color;',
+  'void main() {',
+  '  gl_FragColor = color;',
+  '}'
+].join('\n')
+
+function render (display) {
+  const gl = createContext(SIZE, SIZE, { display })
+  function shader (type, src) {
+    const s = gl.createShader(type)
+    gl.shaderSource(s, src)
+    gl.compileShader(s)
+    return s
+  }
+  const program = gl.createProgram()
+  gl.attachShader(program, shader(gl.VERTEX_SHADER, VERT_SRC))
+  gl.attachShader(program, shader(gl.FRAGMENT_SHADER, FRAG_SRC))
+  gl.bindAttribLocation(program, 0, 'position')
+  gl.linkProgram(program)
+  gl.useProgram(program)
+  gl.bindBuffer(gl.ARRAY_BUFFER, gl.createBuffer())
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([
+    -0.1, -0.1, 0.1, -0.1, 0, 0.1
+  ]), gl.STATIC_DRAW)
+  gl.enableVertexAttribArray(0)
+  gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0)
+  const offset = gl.getUniformLocation(program, 'offset')
+  const color = gl.getUniformLocation(program, 'color')
+  const pixels = new Uint8Array(SIZE * SIZE * 4)
+
+  const start = process.hrtime.bigint()
+  for (let f = 0; f < FRAMES; ++f) {
+    gl.clear(gl.COLOR_BUFFER_BIT)
+    for (let i = 0; i < DRAWS; ++i) {
+      const t = i / DRAWS
+      gl.uniform2f(offset, t * 2 - 1, Math.sin(t * 20))
+      gl.uniform4f(color, t, 1 - t, 0.5, 1)
+      gl.drawArrays(gl.TRIANGLES, 0, 3)
+    }
+    gl.readPixels(0, 0, SIZE, SIZE, gl.RGBA, gl.UNSIGNED_BYTE, pixels)
+  }
+  const ms = Number(process.hrtime.bigint() - start) / 1e6
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  return ms
+}
+
+function run (displays) {
+  const start = process.hrtime.bigint()
+  const workers = []
+  for (let i = 0; i < THREADS; ++i) {
+    workers.push(new Promise((resolve, reject) => {
+      const worker = new Worker(__filename, {
+        argv: process.argv.slice(2),
+        workerData: { display: i % displays }
+      })
+      worker.once('message', resolve)
+      worker.once('error', reject)
+    }))
+  }
+  return Promise.all(workers).then((times) => {
+    const ms = Number(process.hrtime.bigint() - start) / 1e6
+    const draws = THREADS * FRAMES * DRAWS
+    console.log(
+      ('displays ' + displays).padEnd(12),
+      ((draws / ms / 1000).toFixed(2) + ' M draws/s').padStart(16),
+      ((Math.max(...times) / FRAMES).toFixed(2) + ' ms/frame').padStart(16))
+  })
+}
+
+if (!isMainThread) {
+  parentPort.postMessage(render(workerData.display))
+} else {
+  console.log('displays ' + THREADS + ' threads, ' + DRAWS + ' draws, ' + FRAMES + ' frames')
+  run(1).then(() => run(THREADS))
+}
@@ -0,0 +1,50 @@
+'use strict'
+
+// Creates and deletes large numbers of buffers and textures, and times
+// destroying a context that still owns them.
+//
+//   node bench/object-registry.js [objects] [rounds]
+
+const createContext = require('../index')
+
+const OBJECTS = (process.argv[2] | 0) || 100000
+const ROUNDS = (process.argv[3] | 0) || 3
+
+function time (fn) {
+  const start = process.hrtime.bigint()
+  fn()
+  return Number(process.hrtime.bigint() - start) / 1e6
+}
+
+function report (name, ms) {
+  console.log(
+    name.padEnd(10),
+    (ms.toFixed(1) + ' ms').padStart(12),
+    ((ms * 1e6 / OBJECTS).toFixed(0) + ' ns/object').padStart(16))
+}
+
+console.log('object-registry ' + OBJECTS + ' buffers and textures, ' + ROUNDS + ' rounds')
+
+for (let round = 0; round < ROUNDS; ++round) {
+  const gl = createContext(1, 1)
+  const buffers = new Array(OBJECTS)
+  const textures = new Array(OBJECTS)
+
+  report('create', time(() => {
+    for (let i = 0; i < OBJECTS; ++i) {
+      buffers[i] = gl.createBuffer()
+      textures[i] = gl.createTexture()
+    }
+  }))
+
+  // Delete half, then leave the rest to destroy
+  report('delete', time(() => {
+    for (let i = 0; i < OBJECTS; i += 2) {
+      gl.deleteBuffer(buffers[i])
+      gl.deleteTexture(textures[i])
+    }
+  }))
+
+  const { destroy } = gl.getExtension('STACKGL_destroy_context')
+  report('destroy', time(destroy))
+}
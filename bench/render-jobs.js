@@ -0,0 +1,120 @@
+'use strict'
+
+// Renders a batch of thumbnails one after another on the main thread, then
+// as render jobs on the pool, and reports throughput and per-job timing.
+//
+//   node bench/render-jobs.js [jobs] [size] [threads]
+
+const os = require('os')
+const createContext = require('../index')
+
+const JOBS = (process.argv[2] | 0) || 64
+const SIZE = (process.argv[3] | 0) || 256
+const THREADS = (process.argv[4] | 0) || os.cpus().length
+
+const VERT_SRC = [
+  'attribute vec2 position;',
+  'varying vec2 vPosition;',
+  'void main() {',
+  '  vPosition = position;',
+  '  gl_Position = vec4(position, 0, 1);',
+  '}'
+].join('\n')
+
+// Enough work per fragment that rendering dominates the copies
+const FRAG_SRC = [
+  'precision mediump float;',
+  'uniform float seed;',
+  'varying vec2 vPosition;',
+  'void main() {',
+  '  vec2 z = vPosition;',
+  '  float n = 0.0;',
+  '  for (int i = 0; i < 64; ++i) {',
+  '    z = vec2(z.x * z.x - z.y * z.y, 2.0 * z.x * z.y) + vec2(seed, 0.3);',
+  '    n += step(dot(z, z), 4.0);',
+  '  }',
+  '  gl_FragColor = vec4(n / 64.0, seed, 0.5, 1);',
+  '}'
+].join('\n')
+
+const QUAD = [-1, -1, 1, -1, -1, 1, 1, 1]
+
+function job (i) {
+  return {
+    width: SIZE,
+    height: SIZE,
+    vertexShader: VERT_SRC,
+    fragmentShader: FRAG_SRC,
+    attributes: { position: QUAD },
+    uniforms: { seed: -0.8 + i / JOBS },
+    draws: [{ mode: 5, first: 0, count: 4 }]
+  }
+}
+
+function serial () {
+  const gl = createContext(SIZE, SIZE)
+  function shader (type, src) {
+    const s = gl.createShader(type)
+    gl.shaderSource(s, src)
+    gl.compileShader(s)
+    return s
+  }
+  const program = gl.createProgram()
+  gl.attachShader(program, shader(gl.VERTEX_SHADER, VERT_SRC))
+  gl.attachShader(program, shader(gl.FRAGMENT_SHADER, FRAG_SRC))
+  gl.bindAttribLocation(program, 0, 'position')
+  gl.linkProgram(program)
+  gl.useProgram(program)
+  gl.bindBuffer(gl.ARRAY_BUFFER, gl.createBuffer())
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array(QUAD), gl.STATIC_DRAW)
+  gl.enableVertexAttribArray(0)
+  gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0)
+  const seed = gl.getUniformLocation(program, 'seed')
+  const pixels = new Uint8Array(SIZE * SIZE * 4)
+
+  const start = process.hrtime.bigint()
+  for (let i = 0; i < JOBS; ++i) {
+    gl.uniform1f(seed, -0.8 + i / JOBS)
+    gl.drawArrays(gl.TRIANGLE_STRIP, 0, 4)
+    gl.readPixels(0, 0, SIZE, SIZE, gl.RGBA, gl.UNSIGNED_BYTE, pixels)
+  }
+  const ms = Number(process.hrtime.bigint() - start) / 1e6
+  gl.getExtension('STACKGL_destroy_context').destroy()
+
+  console.log(
+    'serial'.padEnd(10),
+    ((JOBS / ms * 1000).toFixed(1) + ' jobs/s').padStart(16),
+    ((ms / JOBS).toFixed(2) + ' ms/job').padStart(16))
+}
+
+async function pool () {
+  const gl = createContext(1, 1, { renderThreads: THREADS })
+
+  // Starts the threads and warms up their program caches
+  await Promise.all(Array.from({ length: THREADS }, (_, i) => gl.submit(job(i))))
+
+  let blocked = 0
+  const start = process.hrtime.bigint()
+  const tick = setInterval(() => { blocked++ }, 1)
+  const results = await Promise.all(Array.from({ length: JOBS }, (_, i) => gl.submit(job(i))))
+  const ms = Number(process.hrtime.bigint() - start) / 1e6
+  clearInterval(tick)
+  gl.getExtension('STACKGL_destroy_context').destroy()
+
+  let renderMs = 0
+  let queueMs = 0
+  for (const { timing } of results) {
+    renderMs += timing.renderMs
+    queueMs += timing.queueMs
+  }
+  console.log(
+    ('pool x' + THREADS).padEnd(10),
+    ((JOBS / ms * 1000).toFixed(1) + ' jobs/s').padStart(16),
+    ((renderMs / JOBS).toFixed(2) + ' ms/job').padStart(16),
+    ((queueMs / JOBS).toFixed(2) + ' ms queued').padStart(16),
+    (blocked + ' timer ticks').padStart(16))
+}
+
+console.log('render jobs ' + JOBS + ' jobs, ' + SIZE + 'x' + SIZE)
+serial()
+pool()
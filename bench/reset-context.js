@@ -0,0 +1,92 @@
+'use strict'
+
+// Serves a series of requests that each build a small scene and read it
+// back, first with a new context per request, then with one context that
+// is recycled with STACKGL_reset_context between requests.
+//
+//   node bench/reset-context.js [requests] [size] [textures]
+
+const createContext = require('../index')
+
+const REQUESTS = (process.argv[2] | 0) || 200
+const SIZE = (process.argv[3] | 0) || 256
+const TEXTURES = (process.argv[4] | 0) || 8
+
+const VERT_SRC = [
+  'attribute vec2 position;',
+  'varying vec2 uv;',
+  'void main() {',
+  '  uv = position * 0.5 + 0.5;',
+  '  gl_Position = vec4(position, 0, 1);',
+  '}'
+].join('\n')
+
+const FRAG_SRC = [
+  'precision mediump float;',
+  'uniform sampler2D image;',
+  'varying vec2 uv;',
+  'void main() {',
+  '  gl_FragColor = texture2D(image, uv);',
+  '}'
+].join('\n')
+
+const image = new Uint8Array(64 * 64 * 4).fill(0x80)
+const pixels = new Uint8Array(SIZE * SIZE * 4)
+
+function request (gl) {
+  function shader (type, src) {
+    const s = gl.createShader(type)
+    gl.shaderSource(s, src)
+    gl.compileShader(s)
+    return s
+  }
+  const program = gl.createProgram()
+  gl.attachShader(program, shader(gl.VERTEX_SHADER, VERT_SRC))
+  gl.attachShader(program, shader(gl.FRAGMENT_SHADER, FRAG_SRC))
+  gl.bindAttribLocation(program, 0, 'position')
+  gl.linkProgram(program)
+  gl.useProgram(program)
+
+  gl.bindBuffer(gl.ARRAY_BUFFER, gl.createBuffer())
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([-1, -1, 1, -1, -1, 1, 1, 1]), gl.STATIC_DRAW)
+  gl.enableVertexAttribArray(0)
+  gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0)
+  gl.enable(gl.BLEND)
+  gl.blendFunc(gl.SRC_ALPHA, gl.ONE_MINUS_SRC_ALPHA)
+
+  for (let i = 0; i < TEXTURES; ++i) {
+    gl.bindTexture(gl.TEXTURE_2D, gl.createTexture())
+    gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 64, 64, 0, gl.RGBA, gl.UNSIGNED_BYTE, image)
+    gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MIN_FILTER, gl.LINEAR)
+    gl.drawArrays(gl.TRIANGLE_STRIP, 0, 4)
+  }
+  gl.readPixels(0, 0, SIZE, SIZE, gl.RGBA, gl.UNSIGNED_BYTE, pixels)
+}
+
+function report (name, start) {
+  const ms = Number(process.hrtime.bigint() - start) / 1e6
+  console.log(
+    name.padEnd(10),
+    ((ms / REQUESTS).toFixed(3) + ' ms/request').padStart(20),
+    ((REQUESTS * 1000 / ms).toFixed(1) + ' requests/s').padStart(20))
+}
+
+console.log('reset-context ' + REQUESTS + ' requests, ' + SIZE + 'x' + SIZE + ', ' + TEXTURES + ' textures')
+
+let start = process.hrtime.bigint()
+for (let i = 0; i < REQUESTS; ++i) {
+  const gl = createContext(SIZE, SIZE)
+  request(gl)
+  gl.getExtension('STACKGL_destroy_context').destroy()
+}
+report('recreate', start)
+
+const gl = createContext(SIZE, SIZE)
+const ext = gl.getExtension('STACKGL_reset_context')
+start = process.hrtime.bigint()
+for (let i = 0; i < REQUESTS; ++i) {
+  request(gl)
+  ext.reset()
+}
+report('reset', start)
+gl.getExtension('STACKGL_destroy_context').destroy()
@@ -0,0 +1,135 @@
+'use strict'
+
+// Uploads a large flipped tile per frame while rendering with the previous
+// one, first with texImage2D on the main thread, then with texImage2DAsync
+// so the upload of the next tile overlaps the current frame.
+//
+//   node bench/texture-upload.js [frames] [tile size] [draws]
+
+const createContext = require('../index')
+
+const FRAMES = (process.argv[2] | 0) || 30
+const TILE = (process.argv[3] | 0) || 2048
+const DRAWS = (process.argv[4] | 0) || 500
+const SIZE = 256
+
+const VERT_SRC = [
+  'attribute vec2 position;',
+  'uniform vec2 offset;',
+  'varying vec2 uv;',
+  'void main() {',
+  '  uv = position * 0.5 + 0.5;',
+  '  gl_Position = vec4(position * 0.25 + offset, 0, 1);',
+  '}'
+].join('\n')
+
+const FRAG_SRC = [
+  'precision mediump float;',
+  'uniform sampler2D tile;',
+  'varying vec2 uv;',
+  'void main() {',
+  '  gl_FragColor = texture2D(tile, uv);',
+  '}'
+].join('\n')
+
+function setup () {
+  const gl = createContext(SIZE, SIZE)
+  function shader (type, src) {
+    const s = gl.createShader(type)
+    gl.shaderSource(s, src)
+    gl.compileShader(s)
+    return s
+  }
+  const program = gl.createProgram()
+  gl.attachShader(program, shader(gl.VERTEX_SHADER, VERT_SRC))
+  gl.attachShader(program, shader(gl.FRAGMENT_SHADER, FRAG_SRC))
+  gl.bindAttribLocation(program, 0, 'position')
+  gl.linkProgram(program)
+  gl.useProgram(program)
+  gl.bindBuffer(gl.ARRAY_BUFFER, gl.createBuffer())
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([-1, -1, 1, -1, -1, 1, 1, 1]), gl.STATIC_DRAW)
+  gl.enableVertexAttribArray(0)
+  gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0)
+  gl.pixelStorei(gl.UNPACK_FLIP_Y_WEBGL, true)
+
+  const textures = [gl.createTexture(), gl.createTexture()]
+  for (const texture of textures) {
+    gl.bindTexture(gl.TEXTURE_2D, texture)
+    gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MIN_FILTER, gl.LINEAR)
+    gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_WRAP_S, gl.CLAMP_TO_EDGE)
+    gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_WRAP_T, gl.CLAMP_TO_EDGE)
+  }
+  return { gl, textures, offset: gl.getUniformLocation(program, 'offset') }
+}
+
+const tiles = [new Uint8Array(TILE * TILE * 4), new Uint8Array(TILE * TILE * 4)]
+tiles[0].fill(0x40)
+tiles[1].fill(0xc0)
+const pixels = new Uint8Array(SIZE * SIZE * 4)
+
+function render ({ gl, textures, offset }, frame) {
+  gl.bindTexture(gl.TEXTURE_2D, textures[frame & 1])
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  for (let i = 0; i < DRAWS; ++i) {
+    const t = i / DRAWS
+    gl.uniform2f(offset, t * 1.5 - 0.75, Math.sin(t * 20) * 0.75)
+    gl.drawArrays(gl.TRIANGLE_STRIP, 0, 4)
+  }
+  gl.readPixels(0, 0, SIZE, SIZE, gl.RGBA, gl.UNSIGNED_BYTE, pixels)
+}
+
+function report (name, start, blocked) {
+  const ms = Number(process.hrtime.bigint() - start) / 1e6
+  console.log(
+    name.padEnd(8),
+    ((FRAMES * 1000 / ms).toFixed(1) + ' frames/s').padStart(16),
+    ((blocked / FRAMES).toFixed(2) + ' ms upload call').padStart(20))
+}
+
+function sync () {
+  const ctx = setup()
+  const gl = ctx.gl
+  let blocked = 0
+  const start = process.hrtime.bigint()
+  for (let frame = 0; frame < FRAMES; ++frame) {
+    const t0 = process.hrtime.bigint()
+    gl.bindTexture(gl.TEXTURE_2D, ctx.textures[frame & 1])
+    gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, TILE, TILE, 0, gl.RGBA, gl.UNSIGNED_BYTE, tiles[frame & 1])
+    blocked += Number(process.hrtime.bigint() - t0) / 1e6
+    render(ctx, frame)
+  }
+  report('sync', start, blocked)
+  gl.getExtension('STACKGL_destroy_context').destroy()
+}
+
+function async () {
+  const ctx = setup()
+  const gl = ctx.gl
+  let blocked = 0
+  function next (frame) {
+    gl.bindTexture(gl.TEXTURE_2D, ctx.textures[frame & 1])
+    const t0 = process.hrtime.bigint()
+    const done = gl.texImage2DAsync(gl.TEXTURE_2D, 0, gl.RGBA, TILE, TILE, 0, gl.RGBA, gl.UNSIGNED_BYTE, tiles[frame & 1])
+    blocked += Number(process.hrtime.bigint() - t0) / 1e6
+    return done
+  }
+
+  const start = process.hrtime.bigint()
+  let frame = 0
+  function step () {
+    if (frame === FRAMES) {
+      report('async', start, blocked)
+      gl.getExtension('STACKGL_destroy_context').destroy()
+      return
+    }
+    // Start uploading the next tile, then render with this one
+    const upload = frame + 1 < FRAMES ? next(frame + 1) : Promise.resolve()
+    render(ctx, frame++)
+    return upload.then(step)
+  }
+  return next(0).then(step)
+}
+
+console.log('texture-upload ' + TILE + 'x' + TILE + ' tiles, ' + DRAWS + ' draws, ' + FRAMES + ' frames')
+sync()
+async()
@@ -0,0 +1,107 @@
+'use strict'
+
+// Compares the per call overhead of the three validation modes on a frame
+// made of many small draws, each with its own uniform and state changes.
+//
+//   node bench/validation.js [draws] [frames]
+
+const createContext = require('../index')
+
+const DRAWS = (process.argv[2] | 0) || 5000
+const FRAMES = (process.argv[3] | 0) || 20
+const SIZE = 64
+
+const VERT_SRC = [
+  'precision mediump float;',
+  'attribute vec2 position;',
+  'uniform vec2 offset;',
+  'uniform mat2 rotation;',
+  'void main() {',
+  '  gl_Position = vec4(rotation * position + offset, 0, 1);',
+  '}'
+].join('\n')
+
+const FRAG_SRC = [
+  'precision mediump float;',
+  'uniform vec4 color;',
+  'void main() {',
+  '  gl_FragColor = color;',
+  '}'
+].join('\n')
+
+function setup (gl) {
+  function shader (type, src) {
+    const s = gl.createShader(type)
+    gl.shaderSource(s, src)
+    gl.compileShader(s)
+    return s
+  }
+  const program = gl.createProgram()
+  gl.attachShader(program, shader(gl.VERTEX_SHADER, VERT_SRC))
+  gl.attachShader(program, shader(gl.FRAGMENT_SHADER, FRAG_SRC))
+  gl.bindAttribLocation(program, 0, 'position')
+  gl.linkProgram(program)
+  gl.useProgram(program)
+
+  gl.bindBuffer(gl.ARRAY_BUFFER, gl.createBuffer())
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([
+    -0.05, -0.05, 0.05, -0.05, 0, 0.05
+  ]), gl.STATIC_DRAW)
+  gl.enableVertexAttribArray(0)
+  gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0)
+
+  return {
+    offset: gl.getUniformLocation(program, 'offset'),
+    rotation: gl.getUniformLocation(program, 'rotation'),
+    color: gl.getUniformLocation(program, 'color')
+  }
+}
+
+function drawFrame (gl, uniforms, rotation) {
+  gl.clearColor(0, 0, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  for (let i = 0; i < DRAWS; ++i) {
+    const t = i / DRAWS
+    gl.blendFunc(i & 1 ? gl.ONE : gl.SRC_ALPHA, gl.ONE_MINUS_SRC_ALPHA)
+    gl.uniform2f(uniforms.offset, t * 2 - 1, Math.sin(t * 20))
+    gl.uniformMatrix2fv(uniforms.rotation, false, rotation)
+    gl.uniform4f(uniforms.color, t, 1 - t, 0.5, 1)
+    gl.drawArrays(gl.TRIANGLES, 0, 3)
+  }
+}
+
+function run (mode) {
+  const gl = createContext(SIZE, SIZE, { validation: mode })
+  const uniforms = setup(gl)
+  const rotation = new Float32Array([1, 0, 0, 1])
+  const pixels = new Uint8Array(SIZE * SIZE * 4)
+  gl.enable(gl.BLEND)
+
+  drawFrame(gl, uniforms, rotation) // warm up
+  gl.finish()
+  const start = process.hrtime.bigint()
+  for (let i = 0; i < FRAMES; ++i) {
+    drawFrame(gl, uniforms, rotation)
+  }
+  gl.readPixels(0, 0, SIZE, SIZE, gl.RGBA, gl.UNSIGNED_BYTE, pixels)
+  const ns = Number(process.hrtime.bigint() - start) / FRAMES / DRAWS
+
+  // Every mode must produce the same image
+  let checksum = 0
+  for (let i = 0; i < pixels.length; ++i) {
+    checksum = (checksum * 31 + pixels[i]) >>> 0
+  }
+
+  console.log(
+    mode.padEnd(10),
+    (ns.toFixed(0) + ' ns/draw').padStart(14),
+    (((1e9 / ns) / 1e6).toFixed(2) + ' M draws/s').padStart(16),
+    ('checksum ' + checksum.toString(16)).padStart(20),
+    ('error ' + gl.getError()).padStart(10))
+  gl.getExtension('STACKGL_destroy_context').destroy()
+}
+
+console.log('validation ' + DRAWS + ' draws, ' + FRAMES + ' frames')
+for (const mode of ['full', 'minimal', 'none']) {
+  run(mode)
+}
@@ -16,7 +16,14 @@
       'sources': [
           'src/native/bindings.cc',
           'src/native/webgl.cc',
-          'src/native/procs.cc'
+          'src/native/procs.cc',
+          'src/native/yuv.cc',
+          'src/native/frame-sink.cc',
+          'src/native/frame-ring-writer.cc',
+          'src/native/tile-hash.cc',
+          'src/native/readback-worker.cc',
+          'src/native/render-pool.cc',
+          'src/native/texture-uploader.cc'
       ],
       'include_dirs': [
         "<!(node -e \"require('nan')\")",
@@ -51,6 +58,9 @@
             [
               'angle/src/angle.gyp:libEGL',
               'angle/src/angle.gyp:libGLESv2'
+            ],
+            'libraries': [
+                '-lrt'
             ]
         }],
         ['OS=="win"', {
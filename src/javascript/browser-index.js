@@ -18,7 +18,7 @@ function createContext (width, height, options) {
   canvas.height = height
 
   try {
-    gl = canvas.getContext('webgl', options)
+    gl = canvas.getContext(options && options.version === 2 ? 'webgl2' : 'webgl', options)
   } catch (e) {
     try {
       gl = canvas.getContext('experimental-webgl', options)
@@ -0,0 +1,69 @@
+const { gl } = require('../native-gl')
+const { finishBoundTextureUploads } = require('../webgl-texture-uploads')
+
+class ANGLEFramebufferBlit {
+  constructor (ctx) {
+    this.READ_FRAMEBUFFER_ANGLE = 0x8CA8
+    this.DRAW_FRAMEBUFFER_ANGLE = 0x8CA9
+    this.DRAW_FRAMEBUFFER_BINDING_ANGLE = 0x8CA6
+    this.READ_FRAMEBUFFER_BINDING_ANGLE = 0x8CAA
+    this.ctx = ctx
+  }
+
+  blitFramebufferANGLE (
+    srcX0, srcY0, srcX1, srcY1,
+    dstX0, dstY0, dstX1, dstY1,
+    mask, filter) {
+    const { ctx } = this
+    mask |= 0
+    filter |= 0
+
+    const allBits =
+      gl.COLOR_BUFFER_BIT |
+      gl.DEPTH_BUFFER_BIT |
+      gl.STENCIL_BUFFER_BIT
+    if (mask & ~allBits) {
+      ctx.setError(gl.INVALID_VALUE)
+      return
+    }
+    if (filter !== gl.NEAREST && filter !== gl.LINEAR) {
+      ctx.setError(gl.INVALID_ENUM)
+      return
+    }
+    if ((mask & (gl.DEPTH_BUFFER_BIT | gl.STENCIL_BUFFER_BIT)) &&
+      filter !== gl.NEAREST) {
+      ctx.setError(gl.INVALID_OPERATION)
+      return
+    }
+    if (!ctx._framebufferOk(ctx._activeReadFramebuffer) ||
+      !ctx._framebufferOk()) {
+      return
+    }
+    finishBoundTextureUploads(ctx)
+
+    gl._blitFramebuffer.call(
+      ctx,
+      srcX0 | 0,
+      srcY0 | 0,
+      srcX1 | 0,
+      srcY1 | 0,
+      dstX0 | 0,
+      dstY0 | 0,
+      dstX1 | 0,
+      dstY1 | 0,
+      mask,
+      filter)
+  }
+}
+
+function getANGLEFramebufferBlit (ctx) {
+  const exts = ctx.getSupportedExtensions()
+
+  if (exts && exts.indexOf('ANGLE_framebuffer_blit') >= 0) {
+    return new ANGLEFramebufferBlit(ctx)
+  } else {
+    return null
+  }
+}
+
+module.exports = { ANGLEFramebufferBlit, getANGLEFramebufferBlit }
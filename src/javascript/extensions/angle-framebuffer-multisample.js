@@ -0,0 +1,42 @@
+const { gl } = require('../native-gl')
+
+class ANGLEFramebufferMultisample {
+  constructor (ctx) {
+    this.RENDERBUFFER_SAMPLES_ANGLE = 0x8CAB
+    this.FRAMEBUFFER_INCOMPLETE_MULTISAMPLE_ANGLE = 0x8D56
+    this.MAX_SAMPLES_ANGLE = 0x8D57
+    this.ctx = ctx
+  }
+
+  renderbufferStorageMultisampleANGLE (
+    target,
+    samples,
+    internalFormat,
+    width,
+    height) {
+    const { ctx } = this
+    samples |= 0
+    if (samples < 0) {
+      ctx.setError(gl.INVALID_VALUE)
+      return
+    }
+    ctx._renderbufferStorage(
+      target | 0,
+      samples,
+      internalFormat | 0,
+      width | 0,
+      height | 0)
+  }
+}
+
+function getANGLEFramebufferMultisample (ctx) {
+  const exts = ctx.getSupportedExtensions()
+
+  if (exts && exts.indexOf('ANGLE_framebuffer_multisample') >= 0) {
+    return new ANGLEFramebufferMultisample(ctx)
+  } else {
+    return null
+  }
+}
+
+module.exports = { ANGLEFramebufferMultisample, getANGLEFramebufferMultisample }
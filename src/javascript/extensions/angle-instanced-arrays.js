@@ -1,5 +1,6 @@
 const { gl } = require('../native-gl')
 const { vertexCount } = require('../utils')
+const { finishBoundTextureUploads } = require('../webgl-texture-uploads')
 
 class ANGLEInstancedArrays {
   constructor (ctx) {
@@ -32,6 +33,7 @@ class ANGLEInstancedArrays {
     if (!ctx._framebufferOk()) {
       return
     }
+    finishBoundTextureUploads(ctx)
     if (count === 0 || primCount === 0) {
       return
     }
@@ -67,26 +69,17 @@ class ANGLEInstancedArrays {
       return
     }
 
-    // Unpack element data
-    let elementData = null
-    let offset = ioffset
     if (type === gl.UNSIGNED_SHORT) {
-      if (offset % 2) {
+      if (ioffset % 2) {
         ctx.setError(gl.INVALID_OPERATION)
         return
       }
-      offset >>= 1
-      elementData = new Uint16Array(elementBuffer._elements.buffer)
     } else if (ctx._extensions.oes_element_index_uint && type === gl.UNSIGNED_INT) {
-      if (offset % 4) {
+      if (ioffset % 4) {
         ctx.setError(gl.INVALID_OPERATION)
         return
       }
-      offset >>= 2
-      elementData = new Uint32Array(elementBuffer._elements.buffer)
-    } else if (type === gl.UNSIGNED_BYTE) {
-      elementData = elementBuffer._elements
-    } else {
+    } else if (type !== gl.UNSIGNED_BYTE) {
       ctx.setError(gl.INVALID_ENUM)
       return
     }
@@ -127,25 +120,15 @@ class ANGLEInstancedArrays {
     if (!ctx._framebufferOk()) {
       return
     }
+    finishBoundTextureUploads(ctx)
 
     if (count === 0 || primCount === 0) {
       this.checkInstancedVertexAttribState(0, 0)
       return
     }
 
-    if ((count + offset) >>> 0 > elementData.length) {
-      ctx.setError(gl.INVALID_OPERATION)
-      return
-    }
-
-    // Compute max index
-    let maxIndex = -1
-    for (let i = offset; i < offset + count; ++i) {
-      maxIndex = Math.max(maxIndex, elementData[i])
-    }
-
+    const maxIndex = ctx._maxElementIndex(elementBuffer, type, ioffset, count)
     if (maxIndex < 0) {
-      this.checkInstancedVertexAttribState(0, 0)
       return
     }
 
@@ -167,6 +150,7 @@ class ANGLEInstancedArrays {
     }
     const attrib = ctx._vertexObjectState._attribs[index]
     attrib._divisor = divisor
+    ctx._vertexObjectState._version += 1
     this._vertexAttribDivisor(index, divisor)
   }
 
@@ -0,0 +1,60 @@
+const { gl } = require('../native-gl')
+
+class EXTDiscardFramebuffer {
+  constructor (ctx) {
+    this.COLOR_EXT = 0x1800
+    this.DEPTH_EXT = 0x1801
+    this.STENCIL_EXT = 0x1802
+    this.ctx = ctx
+  }
+
+  discardFramebufferEXT (target, attachments) {
+    const { ctx } = this
+    if (!attachments || typeof attachments.length !== 'number') {
+      throw new TypeError('discardFramebufferEXT(GLenum, sequence<GLenum>)')
+    }
+    target |= 0
+    if (target !== gl.FRAMEBUFFER) {
+      ctx.setError(gl.INVALID_ENUM)
+      return
+    }
+
+    // The default framebuffer is named by COLOR_EXT, DEPTH_EXT and
+    // STENCIL_EXT, but is really a framebuffer object in headless-gl.
+    const framebuffer = ctx._activeFramebuffer
+    const validAttachments = framebuffer
+      ? ctx._getAttachments()
+      : [this.COLOR_EXT, this.DEPTH_EXT, this.STENCIL_EXT]
+    const names = []
+    for (let i = 0; i < attachments.length; ++i) {
+      const attachment = attachments[i] | 0
+      if (validAttachments.indexOf(attachment) < 0) {
+        ctx.setError(gl.INVALID_ENUM)
+        return
+      }
+      if (framebuffer) {
+        names.push(attachment)
+      } else if (attachment === this.COLOR_EXT) {
+        names.push(gl.COLOR_ATTACHMENT0)
+      } else if (attachment === this.DEPTH_EXT) {
+        names.push(gl.DEPTH_ATTACHMENT)
+      } else {
+        names.push(gl.STENCIL_ATTACHMENT)
+      }
+    }
+
+    gl._discardFramebuffer.call(ctx, target, names)
+  }
+}
+
+function getEXTDiscardFramebuffer (ctx) {
+  const exts = ctx.getSupportedExtensions()
+
+  if (exts && exts.indexOf('EXT_discard_framebuffer') >= 0) {
+    return new EXTDiscardFramebuffer(ctx)
+  } else {
+    return null
+  }
+}
+
+module.exports = { getEXTDiscardFramebuffer, EXTDiscardFramebuffer }
@@ -0,0 +1,561 @@
+const { gl } = require('../native-gl')
+const { vertexCount } = require('../utils')
+const { WebGLBuffer } = require('../webgl-buffer')
+const { WebGLProgram } = require('../webgl-program')
+const { WebGLTexture } = require('../webgl-texture')
+const { finishBoundTextureUploads } = require('../webgl-texture-uploads')
+
+// Must match CommandBundleOp in webgl.cc
+const BUNDLE_USE_PROGRAM = 1
+const BUNDLE_BIND_VERTEX_ARRAY = 2
+const BUNDLE_ACTIVE_TEXTURE = 3
+const BUNDLE_BIND_TEXTURE = 4
+const BUNDLE_UNIFORM = 5
+const BUNDLE_UNIFORM_OVERRIDE = 6
+const BUNDLE_DRAW_ARRAYS = 7
+const BUNDLE_DRAW_ELEMENTS = 8
+const BUNDLE_DRAW_ARRAYS_INSTANCED = 9
+const BUNDLE_DRAW_ELEMENTS_INSTANCED = 10
+
+const TEXTURE_3D = 0x806F
+const TEXTURE_2D_ARRAY = 0x8C1A
+
+const EMPTY_OVERRIDES = new Float32Array(0)
+
+// Scratch views used to store float operands as 32-bit words
+const FLOAT_WORD = new Float32Array(1)
+const INT_WORD = new Int32Array(FLOAT_WORD.buffer)
+
+function uniformWords (type) {
+  switch (type) {
+    case gl.FLOAT_MAT4:
+      return 16
+    case gl.FLOAT_MAT3:
+      return 9
+    case gl.FLOAT_MAT2:
+    case gl.FLOAT_VEC4:
+    case gl.INT_VEC4:
+    case gl.BOOL_VEC4:
+      return 4
+    case gl.FLOAT_VEC3:
+    case gl.INT_VEC3:
+    case gl.BOOL_VEC3:
+      return 3
+    case gl.FLOAT_VEC2:
+    case gl.INT_VEC2:
+    case gl.BOOL_VEC2:
+      return 2
+  }
+  return 1
+}
+
+function isFloatUniform (type) {
+  return type === gl.FLOAT ||
+    type === gl.FLOAT_VEC2 ||
+    type === gl.FLOAT_VEC3 ||
+    type === gl.FLOAT_VEC4 ||
+    type === gl.FLOAT_MAT2 ||
+    type === gl.FLOAT_MAT3 ||
+    type === gl.FLOAT_MAT4
+}
+
+// The state of an object that a bundle's validation depends on, or -1 once
+// the object has been deleted
+function objectVersion (object) {
+  if (object._pendingDelete || object._ === 0) {
+    return -1
+  }
+  if (object instanceof WebGLProgram) {
+    return object._linkCount
+  } else if (object instanceof WebGLTexture) {
+    return object._complete ? 1 : 0
+  } else if (object instanceof WebGLBuffer) {
+    return object._version
+  }
+  // Vertex array objects
+  return object._vertexState._version
+}
+
+function unitTexture (unit, target) {
+  switch (target) {
+    case gl.TEXTURE_2D:
+      return unit._bind2D
+    case gl.TEXTURE_CUBE_MAP:
+      return unit._bindCube
+    case TEXTURE_3D:
+      return unit._bind3D
+    case TEXTURE_2D_ARRAY:
+      return unit._bind2DArray
+  }
+  return null
+}
+
+function reducedElementCount (mode, count) {
+  if (mode === gl.TRIANGLES) {
+    return count - (count % 3)
+  } else if (mode === gl.LINES) {
+    return count - (count % 2)
+  }
+  return count
+}
+
+class WebGLCommandBundleSTACKGL {
+  constructor (ctx, id, dependencies, versions, textureTargets, overrideSize, draws, program) {
+    this._ctx = ctx
+    this._ = id
+    this._dependencies = dependencies
+    this._versions = versions
+    // The program the bundle's first uniforms and draws were checked
+    // against, if it did not set one itself
+    this._program = program
+    this._textureTargets = textureTargets
+    this._restore = new Int32Array(3 + textureTargets.length * 3)
+    this._draws = draws
+    this.overrideSize = overrideSize
+  }
+}
+
+class WebGLBundleRecorderSTACKGL {
+  constructor (ctx) {
+    this._ctx = ctx
+    this._commands = []
+    this._dependencies = new Map()
+    this._failed = false
+    this._finished = false
+    this._overrideSize = 0
+    this._draws = false
+    this._setsProgram = false
+    this._inheritsProgram = false
+
+    // Bindings when recording started, restored by finish()
+    const vaoExt = ctx._extensions.oes_vertex_array_object
+    this._savedProgram = ctx._activeProgram
+    this._savedVertexArray = vaoExt ? vaoExt._activeVertexArrayObject : null
+    this._savedTextureUnit = ctx._activeTextureUnit
+    this._savedTextures = new Map()
+    this._vertexArray = null
+  }
+
+  _run (fn) {
+    const ctx = this._ctx
+    if (this._finished) {
+      ctx.setError(gl.INVALID_OPERATION)
+      return false
+    }
+    ctx._saveError()
+    fn()
+    const error = ctx.getError()
+    ctx._restoreError(error)
+    if (error !== gl.NO_ERROR) {
+      this._failed = true
+      return false
+    }
+    return true
+  }
+
+  _fail (error) {
+    this._ctx.setError(error)
+    this._failed = true
+  }
+
+  _depend (object) {
+    if (object && !this._dependencies.has(object)) {
+      this._dependencies.set(object, objectVersion(object))
+    }
+  }
+
+  // Uniforms and draws recorded before useProgram were checked against the
+  // program that was current when recording started, so the bundle can only
+  // run while that program is current
+  _dependOnProgram () {
+    if (!this._setsProgram && !this._inheritsProgram) {
+      this._inheritsProgram = true
+      this._depend(this._savedProgram)
+    }
+  }
+
+  // Draws depend on the bound vertex array, its buffers and the program
+  _dependOnDrawState () {
+    const ctx = this._ctx
+    const vao = this._vertexArray
+    if (!vao) {
+      this._fail(gl.INVALID_OPERATION)
+      return false
+    }
+    this._dependOnProgram()
+    const state = ctx._vertexObjectState
+    this._depend(vao)
+    this._depend(state._elementArrayBufferBinding)
+    for (let i = 0; i < state._attribs.length; ++i) {
+      this._depend(state._attribs[i]._pointerBuffer)
+    }
+    this._draws = true
+    return true
+  }
+
+  _pushUniform (type, location, values) {
+    const words = uniformWords(type)
+    const count = Math.floor(values.length / words)
+    if (count === 0) {
+      return
+    }
+    this._commands.push(BUNDLE_UNIFORM, type, location._ | 0, count)
+    const float = isFloatUniform(type)
+    for (let i = 0; i < count * words; ++i) {
+      if (float) {
+        FLOAT_WORD[0] = values[i]
+        this._commands.push(INT_WORD[0])
+      } else {
+        this._commands.push(values[i] | 0)
+      }
+    }
+  }
+
+  _uniform (name, type, location, values, args) {
+    const ctx = this._ctx
+    if (!this._run(() => ctx[name](...args)) || !location) {
+      return
+    }
+    this._dependOnProgram()
+    this._pushUniform(type, location, values)
+  }
+
+  useProgram (program) {
+    const ctx = this._ctx
+    if (!this._run(() => ctx.useProgram(program))) {
+      return
+    }
+    this._setsProgram = true
+    this._depend(ctx._activeProgram)
+    this._commands.push(BUNDLE_USE_PROGRAM, program ? program._ | 0 : 0)
+  }
+
+  bindVertexArray (array) {
+    const ctx = this._ctx
+    const vaoExt = ctx._extensions.oes_vertex_array_object
+    if (!vaoExt) {
+      this._fail(gl.INVALID_OPERATION)
+      return
+    }
+    if (!this._run(() => vaoExt.bindVertexArrayOES(array))) {
+      return
+    }
+    this._vertexArray = vaoExt._activeVertexArrayObject
+    this._depend(this._vertexArray)
+    this._commands.push(BUNDLE_BIND_VERTEX_ARRAY, array ? array._ | 0 : 0)
+  }
+
+  activeTexture (texture) {
+    const ctx = this._ctx
+    if (!this._run(() => ctx.activeTexture(texture))) {
+      return
+    }
+    this._commands.push(BUNDLE_ACTIVE_TEXTURE, texture | 0)
+  }
+
+  bindTexture (target, texture) {
+    const ctx = this._ctx
+    target |= 0
+    const unit = ctx._activeTextureUnit
+    const key = unit + ':' + target
+    const previous = ctx._getActiveTexture(target)
+    if (!this._run(() => ctx.bindTexture(target, texture))) {
+      return
+    }
+    if (!this._savedTextures.has(key)) {
+      this._savedTextures.set(key, { unit, target, texture: previous })
+    }
+    this._depend(texture)
+    this._commands.push(
+      BUNDLE_BIND_TEXTURE,
+      target,
+      texture && texture._complete ? texture._ | 0 : 0)
+  }
+
+  uniform1f (location, x) { this._uniform('uniform1f', gl.FLOAT, location, [x], arguments) }
+  uniform2f (location, x, y) { this._uniform('uniform2f', gl.FLOAT_VEC2, location, [x, y], arguments) }
+  uniform3f (location, x, y, z) { this._uniform('uniform3f', gl.FLOAT_VEC3, location, [x, y, z], arguments) }
+  uniform4f (location, x, y, z, w) { this._uniform('uniform4f', gl.FLOAT_VEC4, location, [x, y, z, w], arguments) }
+  uniform1i (location, x) { this._uniform('uniform1i', gl.INT, location, [x], arguments) }
+  uniform2i (location, x, y) { this._uniform('uniform2i', gl.INT_VEC2, location, [x, y], arguments) }
+  uniform3i (location, x, y, z) { this._uniform('uniform3i', gl.INT_VEC3, location, [x, y, z], arguments) }
+  uniform4i (location, x, y, z, w) { this._uniform('uniform4i', gl.INT_VEC4, location, [x, y, z, w], arguments) }
+  uniform1fv (location, v) { this._uniform('uniform1fv', gl.FLOAT, location, v, arguments) }
+  uniform2fv (location, v) { this._uniform('uniform2fv', gl.FLOAT_VEC2, location, v, arguments) }
+  uniform3fv (location, v) { this._uniform('uniform3fv', gl.FLOAT_VEC3, location, v, arguments) }
+  uniform4fv (location, v) { this._uniform('uniform4fv', gl.FLOAT_VEC4, location, v, arguments) }
+  uniform1iv (location, v) { this._uniform('uniform1iv', gl.INT, location, v, arguments) }
+  uniform2iv (location, v) { this._uniform('uniform2iv', gl.INT_VEC2, location, v, arguments) }
+  uniform3iv (location, v) { this._uniform('uniform3iv', gl.INT_VEC3, location, v, arguments) }
+  uniform4iv (location, v) { this._uniform('uniform4iv', gl.INT_VEC4, location, v, arguments) }
+  uniformMatrix2fv (location, transpose, v) { this._uniform('uniformMatrix2fv', gl.FLOAT_MAT2, location, v, arguments) }
+  uniformMatrix3fv (location, transpose, v) { this._uniform('uniformMatrix3fv', gl.FLOAT_MAT3, location, v, arguments) }
+  uniformMatrix4fv (location, transpose, v) { this._uniform('uniformMatrix4fv', gl.FLOAT_MAT4, location, v, arguments) }
+
+  // Reads the uniform from the overrides passed to executeBundle, starting
+  // at the given word offset
+  uniformOverride (location, offset, count = 1) {
+    const ctx = this._ctx
+    offset |= 0
+    count |= 0
+    if (this._finished) {
+      ctx.setError(gl.INVALID_OPERATION)
+      return
+    }
+    if (!location) {
+      return
+    }
+    ctx._saveError()
+    const active = ctx._checkLocationActive(location)
+    const error = ctx.getError()
+    ctx._restoreError(error)
+    if (!active) {
+      this._failed = true
+      return
+    }
+    const type = location._activeInfo.type
+    if (type === gl.SAMPLER_2D || type === gl.SAMPLER_CUBE) {
+      // Texture units are only validated when recording
+      this._fail(gl.INVALID_OPERATION)
+      return
+    }
+    if (offset < 0 || count <= 0 ||
+      count > (location._array ? location._array.length : 1)) {
+      this._fail(gl.INVALID_VALUE)
+      return
+    }
+    this._dependOnProgram()
+    this._commands.push(BUNDLE_UNIFORM_OVERRIDE, type, location._ | 0, count, offset)
+    this._overrideSize = Math.max(
+      this._overrideSize,
+      offset + uniformWords(type) * count)
+  }
+
+  drawArrays (mode, first, count) {
+    const ctx = this._ctx
+    if (this._vertexArray && !ctx._vertexObjectState._attribs[0]._isPointer) {
+      // Attribute 0 emulation is not recorded
+      this._fail(gl.INVALID_OPERATION)
+      return
+    }
+    if (!this._dependOnDrawState() ||
+      !this._run(() => ctx.drawArrays(mode, first, count))) {
+      return
+    }
+    if ((count | 0) > 0) {
+      this._commands.push(
+        BUNDLE_DRAW_ARRAYS, mode | 0, first | 0, vertexCount(mode | 0, count | 0))
+    }
+  }
+
+  drawElements (mode, count, type, offset) {
+    const ctx = this._ctx
+    if (this._vertexArray && !ctx._vertexObjectState._attribs[0]._isPointer) {
+      this._fail(gl.INVALID_OPERATION)
+      return
+    }
+    if (!this._dependOnDrawState() ||
+      !this._run(() => ctx.drawElements(mode, count, type, offset))) {
+      return
+    }
+    const reducedCount = reducedElementCount(mode | 0, count | 0)
+    if (reducedCount > 0) {
+      this._commands.push(
+        BUNDLE_DRAW_ELEMENTS, mode | 0, reducedCount, type | 0, offset | 0)
+    }
+  }
+
+  drawArraysInstanced (mode, first, count, instanceCount) {
+    const ext = this._ctx._extensions.angle_instanced_arrays
+    if (!ext) {
+      this._fail(gl.INVALID_OPERATION)
+      return
+    }
+    if (!this._dependOnDrawState() ||
+      !this._run(() => ext.drawArraysInstancedANGLE(mode, first, count, instanceCount))) {
+      return
+    }
+    if ((count | 0) > 0 && (instanceCount | 0) > 0) {
+      this._commands.push(
+        BUNDLE_DRAW_ARRAYS_INSTANCED,
+        mode | 0,
+        first | 0,
+        vertexCount(mode | 0, count | 0),
+        instanceCount | 0)
+    }
+  }
+
+  drawElementsInstanced (mode, count, type, offset, instanceCount) {
+    const ext = this._ctx._extensions.angle_instanced_arrays
+    if (!ext) {
+      this._fail(gl.INVALID_OPERATION)
+      return
+    }
+    if (!this._dependOnDrawState() ||
+      !this._run(() => ext.drawElementsInstancedANGLE(mode, count, type, offset, instanceCount))) {
+      return
+    }
+    const reducedCount = reducedElementCount(mode | 0, count | 0)
+    if (reducedCount > 0 && (instanceCount | 0) > 0) {
+      this._commands.push(
+        BUNDLE_DRAW_ELEMENTS_INSTANCED,
+        mode | 0,
+        reducedCount,
+        type | 0,
+        offset | 0,
+        instanceCount | 0)
+    }
+  }
+
+  finish () {
+    const ctx = this._ctx
+    if (this._finished) {
+      ctx.setError(gl.INVALID_OPERATION)
+      return null
+    }
+    this._finished = true
+
+    // Put back the bindings that were current when recording started
+    const textureTargets = []
+    for (const { unit, target, texture } of this._savedTextures.values()) {
+      ctx.activeTexture(gl.TEXTURE0 + unit)
+      ctx.bindTexture(target, texture)
+      textureTargets.push(unit, target)
+    }
+    ctx.activeTexture(gl.TEXTURE0 + this._savedTextureUnit)
+    ctx.useProgram(this._savedProgram)
+    const vaoExt = ctx._extensions.oes_vertex_array_object
+    if (vaoExt) {
+      vaoExt.bindVertexArrayOES(this._savedVertexArray)
+    }
+
+    // Objects changed while recording invalidate the recorded validation
+    const dependencies = []
+    const versions = []
+    for (const [object, version] of this._dependencies) {
+      if (version < 0 || objectVersion(object) !== version) {
+        this._failed = true
+      }
+      dependencies.push(object)
+      versions.push(version)
+    }
+
+    if (this._failed) {
+      ctx.setError(gl.INVALID_OPERATION)
+      return null
+    }
+
+    const id = gl._createCommandBundle.call(ctx, new Int32Array(this._commands))
+    return new WebGLCommandBundleSTACKGL(
+      ctx,
+      id,
+      dependencies,
+      versions,
+      textureTargets,
+      this._overrideSize,
+      this._draws,
+      this._inheritsProgram ? this._savedProgram : undefined)
+  }
+}
+
+class STACKGLCommandBundle {
+  constructor (ctx) {
+    this._ctx = ctx
+  }
+
+  createBundleRecorder () {
+    return new WebGLBundleRecorderSTACKGL(this._ctx)
+  }
+
+  isBundleValid (bundle) {
+    if (!(bundle instanceof WebGLCommandBundleSTACKGL) ||
+      bundle._ctx !== this._ctx ||
+      bundle._ === 0) {
+      return false
+    }
+    if (bundle._program !== undefined &&
+      bundle._program !== this._ctx._activeProgram) {
+      return false
+    }
+    const { _dependencies: dependencies, _versions: versions } = bundle
+    for (let i = 0; i < dependencies.length; ++i) {
+      if (objectVersion(dependencies[i]) !== versions[i]) {
+        return false
+      }
+    }
+    return true
+  }
+
+  executeBundle (bundle, overrides) {
+    const ctx = this._ctx
+    if (!(bundle instanceof WebGLCommandBundleSTACKGL)) {
+      throw new TypeError('executeBundle(WebGLCommandBundleSTACKGL, Float32Array)')
+    }
+    if (!this.isBundleValid(bundle)) {
+      ctx.setError(gl.INVALID_OPERATION)
+      return false
+    }
+
+    if (bundle.overrideSize > 0) {
+      if (!(overrides instanceof Float32Array ||
+        overrides instanceof Int32Array ||
+        overrides instanceof Uint32Array) ||
+        overrides.length < bundle.overrideSize) {
+        ctx.setError(gl.INVALID_VALUE)
+        return false
+      }
+    } else {
+      overrides = EMPTY_OVERRIDES
+    }
+
+    if (bundle._draws &&
+      (!ctx._checkStencilState() || !ctx._framebufferOk())) {
+      return false
+    }
+    finishBoundTextureUploads(ctx)
+
+    // The native side puts these bindings back after replaying the bundle
+    const restore = bundle._restore
+    const vaoExt = ctx._extensions.oes_vertex_array_object
+    const activeVertexArray = vaoExt ? vaoExt._activeVertexArrayObject : null
+    restore[0] = ctx._activeProgram ? ctx._activeProgram._ | 0 : 0
+    restore[1] = activeVertexArray ? activeVertexArray._ | 0 : 0
+    restore[2] = gl.TEXTURE0 + ctx._activeTextureUnit
+    const textureTargets = bundle._textureTargets
+    for (let i = 0, j = 3; i < textureTargets.length; i += 2, j += 3) {
+      const unit = ctx._textureUnits[textureTargets[i]]
+      const target = textureTargets[i + 1]
+      const texture = unitTexture(unit, target)
+      restore[j] = gl.TEXTURE0 + textureTargets[i]
+      restore[j + 1] = target
+      restore[j + 2] = texture && texture._complete ? texture._ | 0 : 0
+    }
+
+    gl._executeCommandBundle.call(ctx, bundle._, overrides, restore)
+    return true
+  }
+
+  deleteBundle (bundle) {
+    if (!(bundle instanceof WebGLCommandBundleSTACKGL)) {
+      throw new TypeError('deleteBundle(WebGLCommandBundleSTACKGL)')
+    }
+    if (bundle._ctx !== this._ctx || bundle._ === 0) {
+      return
+    }
+    gl._deleteCommandBundle.call(this._ctx, bundle._)
+    bundle._ = 0
+    bundle._dependencies = []
+    bundle._versions = []
+  }
+}
+
+function getSTACKGLCommandBundle (ctx) {
+  return new STACKGLCommandBundle(ctx)
+}
+
+module.exports = {
+  getSTACKGLCommandBundle,
+  STACKGLCommandBundle,
+  WebGLBundleRecorderSTACKGL,
+  WebGLCommandBundleSTACKGL
+}
@@ -0,0 +1,63 @@
+const { gl } = require('../native-gl')
+
+// Counts the time spent inside this context's calls, and the draws and
+// uploads it makes, so a host running many contexts can defer the ones
+// that have used up their share. Counting starts when the extension is
+// first requested.
+class STACKGLCpuBudget {
+  constructor (ctx) {
+    this._ctx = ctx
+    this._stats = new Float64Array(6)
+    this._budget = 0
+    gl._setCallAccounting.call(ctx, true)
+  }
+
+  _read (reset) {
+    gl._getCallStats.call(this._ctx, this._stats, reset)
+    return this._stats
+  }
+
+  // cpuMs includes making the context current and finishMs, which only
+  // breaks out the part of it spent waiting in finish
+  getStats () {
+    const stats = this._read(false)
+    return {
+      cpuMs: stats[0],
+      finishMs: stats[1],
+      calls: stats[2],
+      draws: stats[3],
+      uploads: stats[4],
+      uploadBytes: stats[5]
+    }
+  }
+
+  resetStats () {
+    this._read(true)
+  }
+
+  setBudget (ms) {
+    ms = +ms
+    this._budget = ms > 0 ? ms : 0
+  }
+
+  getBudget () {
+    return this._budget
+  }
+
+  remainingBudget () {
+    if (!this._budget) {
+      return Infinity
+    }
+    return this._budget - this._read(false)[0]
+  }
+
+  overBudget () {
+    return this.remainingBudget() < 0
+  }
+}
+
+function getSTACKGLCpuBudget (ctx) {
+  return new STACKGLCpuBudget(ctx)
+}
+
+module.exports = { getSTACKGLCpuBudget, STACKGLCpuBudget }
@@ -0,0 +1,81 @@
+const { gl } = require('../native-gl')
+
+// Remembers a hash per tile of a drawing buffer region, so that each read
+// only returns the tiles that changed since the previous one.
+class TileTracker {
+  constructor (ctx, x, y, width, height, tileSize) {
+    this._ctx = ctx
+    this.x = x
+    this.y = y
+    this.width = width
+    this.height = height
+    this.tileSize = tileSize
+
+    const tiles = Math.ceil(width / tileSize) * Math.ceil(height / tileSize)
+    this._hashes = new Uint32Array(2 * tiles)
+    this._out = Buffer.allocUnsafe(4 + 16 * tiles + 4 * width * height)
+    this._force = true
+  }
+
+  read () {
+    const ctx = this._ctx
+    if (this.x + this.width > ctx.drawingBufferWidth ||
+      this.y + this.height > ctx.drawingBufferHeight) {
+      throw new RangeError('TileTracker: region is outside the drawing buffer')
+    }
+
+    ctx._bindDrawingBufferForRead()
+    let size
+    try {
+      size = gl._readDirtyTiles.call(
+        ctx,
+        this.x,
+        this.y,
+        this.width,
+        this.height,
+        this.tileSize,
+        this._force,
+        this._hashes,
+        this._out)
+    } finally {
+      ctx._restoreFramebuffer()
+    }
+    this._force = false
+
+    const data = this._out.subarray(0, size)
+    return {
+      count: data.readUInt32LE(0),
+      data
+    }
+  }
+
+  reset () {
+    this._force = true
+  }
+}
+
+class STACKGLDirtyTiles {
+  constructor (ctx) {
+    this._ctx = ctx
+  }
+
+  createTileTracker (options) {
+    const ctx = this._ctx
+    options = options || {}
+    const x = Math.max(options.x | 0, 0)
+    const y = Math.max(options.y | 0, 0)
+    const width = 'width' in options ? options.width | 0 : ctx.drawingBufferWidth - x
+    const height = 'height' in options ? options.height | 0 : ctx.drawingBufferHeight - y
+    const tileSize = 'tileSize' in options ? options.tileSize | 0 : 64
+    if (width <= 0 || height <= 0 || tileSize <= 0) {
+      throw new RangeError('createTileTracker: empty region or tile size')
+    }
+    return new TileTracker(ctx, x, y, width, height, tileSize)
+  }
+}
+
+function getSTACKGLDirtyTiles (ctx) {
+  return new STACKGLDirtyTiles(ctx)
+}
+
+module.exports = { getSTACKGLDirtyTiles, STACKGLDirtyTiles, TileTracker }
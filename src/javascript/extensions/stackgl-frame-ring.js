@@ -0,0 +1,113 @@
+const { gl } = require('../native-gl')
+const { finishBoundTextureUploads } = require('../webgl-texture-uploads')
+
+class FrameRing {
+  constructor (ctx, name, slots, width, height) {
+    this._ctx = ctx
+    this.name = name
+    this.slots = slots
+    this.width = width
+    this.height = height
+    gl._openFrameRing.call(ctx, name, slots, width, height)
+    ctx._frameRing = this
+  }
+
+  // Reads the drawing buffer into the next slot and publishes it. Returns the
+  // frame number, or -1 if the ring has been closed. present() calls this
+  // while a ring is open.
+  write () {
+    const ctx = this._ctx
+    if (ctx._frameRing !== this) {
+      return -1
+    }
+    const width = Math.min(this.width, ctx.drawingBufferWidth)
+    const height = Math.min(this.height, ctx.drawingBufferHeight)
+    return this._publish(0, 0, width, height, true)
+  }
+
+  // Like readPixels with RGBA and UNSIGNED_BYTE, but the rectangle of the
+  // current read framebuffer goes straight into the next slot. Returns the
+  // frame number, or -1 if nothing was published.
+  readPixels (x, y, width, height) {
+    const ctx = this._ctx
+    if (ctx._frameRing !== this) {
+      return -1
+    }
+    x |= 0
+    y |= 0
+    width |= 0
+    height |= 0
+
+    const framebuffer = ctx._activeReadFramebuffer
+    if (!ctx._framebufferOk(framebuffer)) {
+      return -1
+    }
+    const framebufferWidth = framebuffer ? framebuffer._width : ctx.drawingBufferWidth
+    const framebufferHeight = framebuffer ? framebuffer._height : ctx.drawingBufferHeight
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 ||
+      x + width > framebufferWidth || y + height > framebufferHeight ||
+      width > this.width || height > this.height) {
+      ctx.setError(gl.INVALID_VALUE)
+      return -1
+    }
+    finishBoundTextureUploads(ctx)
+    return this._publish(x, y, width, height, !framebuffer)
+  }
+
+  _publish (x, y, width, height, drawingBuffer) {
+    const ctx = this._ctx
+    if (!drawingBuffer) {
+      return gl._writeFrameRing.call(ctx, x, y, width, height)
+    }
+    ctx._bindDrawingBufferForRead()
+    try {
+      return gl._writeFrameRing.call(ctx, x, y, width, height)
+    } finally {
+      ctx._restoreFramebuffer()
+    }
+  }
+
+  close () {
+    const ctx = this._ctx
+    if (ctx._frameRing === this) {
+      gl._closeFrameRing.call(ctx)
+      ctx._frameRing = null
+    }
+  }
+}
+
+class STACKGLFrameRing {
+  constructor (ctx) {
+    this._ctx = ctx
+  }
+
+  createFrameRing (name, options) {
+    const ctx = this._ctx
+    options = options || {}
+    if (typeof name !== 'string' || name.length === 0) {
+      throw new TypeError('createFrameRing(String, options)')
+    }
+    if (name[0] !== '/') {
+      name = '/' + name
+    }
+    const slots = 'slots' in options ? options.slots | 0 : 3
+    const width = 'width' in options ? options.width | 0 : ctx.drawingBufferWidth
+    const height = 'height' in options ? options.height | 0 : ctx.drawingBufferHeight
+    if (slots <= 0 || width <= 0 || height <= 0) {
+      throw new RangeError('createFrameRing: slots and frame size must be positive')
+    }
+    if (ctx._frameRing) {
+      throw new Error('createFrameRing: context already has an open frame ring')
+    }
+    return new FrameRing(ctx, name, slots, width, height)
+  }
+}
+
+function getSTACKGLFrameRing (ctx) {
+  if (process.platform === 'win32') {
+    return null
+  }
+  return new STACKGLFrameRing(ctx)
+}
+
+module.exports = { getSTACKGLFrameRing, STACKGLFrameRing, FrameRing }
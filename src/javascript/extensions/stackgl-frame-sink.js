@@ -0,0 +1,156 @@
+const { gl } = require('../native-gl')
+
+const MATRICES = ['bt601', 'bt709']
+const RANGES = ['limited', 'full']
+
+function y4mHeader (width, height, fps, fullRange) {
+  return Buffer.from(
+    'YUV4MPEG2 W' + width + ' H' + height +
+    ' F' + fps[0] + ':' + fps[1] +
+    ' Ip A1:1 C420jpeg XYSCSS=420JPEG XCOLORRANGE=' +
+    (fullRange ? 'FULL' : 'LIMITED') + '\n')
+}
+
+const FRAME_HEADER = Buffer.from('FRAME\n')
+
+function yuv420Size (width, height) {
+  return width * height + 2 * ((width + 1) >> 1) * ((height + 1) >> 1)
+}
+
+// Frames written to a file descriptor are converted and written by a native
+// background thread with a bounded queue.
+class NativeFrameSink {
+  constructor (ctx, fd, config) {
+    this._ctx = ctx
+    gl._openFrameSink.call(
+      ctx,
+      fd,
+      config.width,
+      config.height,
+      config.fps[0],
+      config.fps[1],
+      config.nv12,
+      config.y4m,
+      config.bt709,
+      config.fullRange,
+      config.queueLength)
+  }
+
+  writeFrame () {
+    const ctx = this._ctx
+    ctx._bindDrawingBufferForRead()
+    try {
+      return gl._writeFrameSink.call(ctx)
+    } finally {
+      ctx._restoreFramebuffer()
+    }
+  }
+
+  close () {
+    if (!gl._closeFrameSink.call(this._ctx)) {
+      throw new Error('frame sink: write failed')
+    }
+  }
+}
+
+// Frames written to a Node.js stream are converted on the calling thread;
+// writeFrame() returns the stream's backpressure signal.
+class StreamFrameSink {
+  constructor (ctx, stream, config) {
+    this._ctx = ctx
+    this._stream = stream
+    this._config = config
+    if (config.y4m) {
+      stream.write(y4mHeader(config.width, config.height, config.fps, config.fullRange))
+    }
+  }
+
+  writeFrame () {
+    const ctx = this._ctx
+    const config = this._config
+    const frame = Buffer.allocUnsafe(yuv420Size(config.width, config.height))
+    ctx._bindDrawingBufferForRead()
+    try {
+      gl._readPixelsYUV.call(
+        ctx,
+        0,
+        0,
+        config.width,
+        config.height,
+        config.nv12,
+        config.bt709,
+        config.fullRange,
+        frame)
+    } finally {
+      ctx._restoreFramebuffer()
+    }
+    if (config.y4m) {
+      this._stream.write(FRAME_HEADER)
+    }
+    return this._stream.write(frame)
+  }
+
+  close () {}
+}
+
+class STACKGLFrameSink {
+  constructor (ctx) {
+    this._ctx = ctx
+  }
+
+  createFrameSink (target, options) {
+    const ctx = this._ctx
+    options = options || {}
+
+    const format = options.format || 'i420'
+    const container = options.container || (format === 'i420' ? 'y4m' : 'raw')
+    const matrix = options.matrix || 'bt601'
+    const range = options.range || 'limited'
+    let fps = options.fps || 30
+    if (!Array.isArray(fps)) {
+      fps = [Math.round(fps * 1000), 1000]
+    }
+
+    if (format !== 'i420' && format !== 'nv12') {
+      throw new TypeError('createFrameSink: unknown format ' + format)
+    }
+    if (container !== 'y4m' && container !== 'raw') {
+      throw new TypeError('createFrameSink: unknown container ' + container)
+    }
+    if (container === 'y4m' && format !== 'i420') {
+      throw new TypeError('createFrameSink: y4m only supports i420')
+    }
+    if (MATRICES.indexOf(matrix) < 0 || RANGES.indexOf(range) < 0) {
+      throw new TypeError('createFrameSink: unknown colour matrix or range')
+    }
+
+    const config = {
+      width: 'width' in options ? options.width | 0 : ctx.drawingBufferWidth,
+      height: 'height' in options ? options.height | 0 : ctx.drawingBufferHeight,
+      fps: [fps[0] | 0, fps[1] | 0],
+      nv12: format === 'nv12',
+      y4m: container === 'y4m',
+      bt709: matrix === 'bt709',
+      fullRange: range === 'full',
+      queueLength: 'queueLength' in options ? options.queueLength | 0 : 4
+    }
+    if (config.width <= 0 || config.height <= 0 ||
+      config.width > ctx.drawingBufferWidth ||
+      config.height > ctx.drawingBufferHeight) {
+      throw new RangeError('createFrameSink: frame size exceeds the drawing buffer')
+    }
+
+    if (typeof target === 'number') {
+      return new NativeFrameSink(ctx, target, config)
+    } else if (target && typeof target.write === 'function') {
+      return new StreamFrameSink(ctx, target, config)
+    }
+    throw new TypeError('createFrameSink(fd | Writable, options)')
+  }
+}
+
+function getSTACKGLFrameSink (ctx) {
+  return new STACKGLFrameSink(ctx)
+}
+
+module.exports = { getSTACKGLFrameSink, STACKGLFrameSink }
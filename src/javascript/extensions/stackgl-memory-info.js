@@ -0,0 +1,39 @@
+const { gl } = require('../native-gl')
+
+// Reports the bytes this context holds in textures, renderbuffers and
+// buffers, and caps them with a budget. Allocations that would go over
+// the budget fail with OUT_OF_MEMORY instead of reaching the driver.
+class STACKGLMemoryInfo {
+  constructor (ctx) {
+    this._ctx = ctx
+    this._info = new Float64Array(4)
+  }
+
+  getMemoryInfo () {
+    const info = this._info
+    gl._getMemoryInfo.call(this._ctx, info)
+    return {
+      textures: info[0],
+      renderbuffers: info[1],
+      buffers: info[2],
+      total: info[0] + info[1] + info[2],
+      budget: info[3]
+    }
+  }
+
+  setBudget (bytes) {
+    bytes = +bytes
+    gl._setMemoryBudget.call(this._ctx, bytes > 0 ? bytes : 0)
+  }
+
+  getBudget () {
+    gl._getMemoryInfo.call(this._ctx, this._info)
+    return this._info[3]
+  }
+}
+
+function getSTACKGLMemoryInfo (ctx) {
+  return new STACKGLMemoryInfo(ctx)
+}
+
+module.exports = { getSTACKGLMemoryInfo, STACKGLMemoryInfo }
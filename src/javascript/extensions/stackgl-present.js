@@ -0,0 +1,11 @@
+class STACKGLPresent {
+  constructor (ctx) {
+    this.present = ctx.present.bind(ctx)
+  }
+}
+
+function getSTACKGLPresent (ctx) {
+  return new STACKGLPresent(ctx)
+}
+
+module.exports = { getSTACKGLPresent, STACKGLPresent }
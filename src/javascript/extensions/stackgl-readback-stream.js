@@ -0,0 +1,118 @@
+const { Readable } = require('stream')
+const { gl } = require('../native-gl')
+const { PNGBandEncoder } = require('../png-band-encoder')
+
+const DEFAULT_BAND_HEIGHT = 64
+
+// Reads a rectangle of the framebuffer that was bound when the stream was
+// created, top row first, in bands of at most bandHeight rows. A new band is
+// only read back when the consumer asks for more data.
+class PixelBandStream extends Readable {
+  constructor (ctx, x, y, width, height, bandHeight) {
+    super({ highWaterMark: 4 * width * bandHeight })
+    this._ctx = ctx
+    this._framebuffer = ctx._activeFramebuffer
+    this._x = x
+    this._y = y
+    this._width = width
+    this._height = height
+    this._bandHeight = bandHeight
+    this._row = 0
+  }
+
+  _read () {
+    const ctx = this._ctx
+    const rows = Math.min(this._bandHeight, this._height - this._row)
+    if (rows <= 0) {
+      this.push(null)
+      return
+    }
+
+    const framebuffer = this._framebuffer
+    if (framebuffer && framebuffer._pendingDelete) {
+      this.destroy(new Error('framebuffer was deleted during readback'))
+      return
+    }
+
+    const band = Buffer.allocUnsafe(4 * this._width * rows)
+    try {
+      if (framebuffer) {
+        gl.bindFramebuffer.call(ctx, gl.FRAMEBUFFER, framebuffer._ | 0)
+      } else {
+        ctx._bindDrawingBufferForRead()
+      }
+      try {
+        gl._readPixelsRows.call(
+          ctx,
+          this._x,
+          this._y + this._height - this._row - rows,
+          this._width,
+          rows,
+          band)
+      } finally {
+        ctx._restoreFramebuffer()
+      }
+    } catch (err) {
+      this.destroy(err)
+      return
+    }
+
+    this._row += rows
+    this.push(band)
+  }
+}
+
+class STACKGLReadbackStream {
+  constructor (ctx) {
+    this._ctx = ctx
+  }
+
+  createReadStream (options) {
+    const ctx = this._ctx
+    options = options || {}
+
+    const framebuffer = ctx._activeFramebuffer
+    const viewWidth = framebuffer ? framebuffer._width : ctx.drawingBufferWidth
+    const viewHeight = framebuffer ? framebuffer._height : ctx.drawingBufferHeight
+
+    const x = Math.max(options.x | 0, 0)
+    const y = Math.max(options.y | 0, 0)
+    const width = Math.min(
+      'width' in options ? options.width | 0 : viewWidth,
+      viewWidth - x)
+    const height = Math.min(
+      'height' in options ? options.height | 0 : viewHeight,
+      viewHeight - y)
+    const bandHeight = 'bandHeight' in options
+      ? options.bandHeight | 0
+      : DEFAULT_BAND_HEIGHT
+
+    if (width <= 0 || height <= 0 || bandHeight <= 0) {
+      throw new RangeError('createReadStream: empty readback region')
+    }
+    if (!ctx._framebufferOk()) {
+      throw new Error('createReadStream: framebuffer is incomplete')
+    }
+
+    const stream = new PixelBandStream(ctx, x, y, width, height, bandHeight)
+    const encoding = options.encoding || 'raw'
+    if (encoding === 'raw') {
+      return stream
+    } else if (encoding === 'png') {
+      const encoder = new PNGBandEncoder(width, height)
+      stream.on('error', (err) => encoder.destroy(err))
+      return stream.pipe(encoder)
+    }
+    throw new TypeError('createReadStream: unknown encoding ' + encoding)
+  }
+}
+
+function getSTACKGLReadbackStream (ctx) {
+  return new STACKGLReadbackStream(ctx)
+}
+
+module.exports = {
+  getSTACKGLReadbackStream,
+  STACKGLReadbackStream,
+  PixelBandStream
+}
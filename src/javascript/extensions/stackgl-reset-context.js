@@ -0,0 +1,15 @@
+class STACKGLResetContext {
+  constructor (ctx) {
+    this._ctx = ctx
+  }
+
+  reset (width, height) {
+    this._ctx._resetContext(width, height)
+  }
+}
+
+function getSTACKGLResetContext (ctx) {
+  return new STACKGLResetContext(ctx)
+}
+
+module.exports = { getSTACKGLResetContext, STACKGLResetContext }
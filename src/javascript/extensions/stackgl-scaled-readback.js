@@ -0,0 +1,56 @@
+const { gl } = require('../native-gl')
+
+class STACKGLScaledReadback {
+  constructor (ctx) {
+    this._ctx = ctx
+  }
+
+  readPixelsScaled (dstWidth, dstHeight, filter, pixels) {
+    const ctx = this._ctx
+    dstWidth |= 0
+    dstHeight |= 0
+    filter = filter === undefined ? gl.LINEAR : filter | 0
+
+    if (filter !== gl.LINEAR && filter !== gl.NEAREST) {
+      ctx.setError(gl.INVALID_ENUM)
+      return null
+    }
+    if (dstWidth <= 0 || dstHeight <= 0) {
+      ctx.setError(gl.INVALID_VALUE)
+      return null
+    }
+
+    const size = 4 * dstWidth * dstHeight
+    if (!pixels) {
+      pixels = new Uint8Array(size)
+    } else if (!(pixels instanceof Uint8Array) || pixels.length < size) {
+      ctx.setError(gl.INVALID_VALUE)
+      return null
+    }
+
+    const drawingBuffer = ctx._drawingBuffer
+    if (drawingBuffer._samples) {
+      // The color texture is sampled directly, so it has to be resolved
+      ctx._bindDrawingBufferForRead()
+      ctx._restoreFramebuffer()
+    }
+    gl._readPixelsScaled.call(
+      ctx,
+      drawingBuffer._color,
+      ctx.drawingBufferWidth,
+      ctx.drawingBufferHeight,
+      drawingBuffer._width,
+      drawingBuffer._height,
+      dstWidth,
+      dstHeight,
+      filter,
+      pixels)
+    return pixels
+  }
+}
+
+function getSTACKGLScaledReadback (ctx) {
+  return new STACKGLScaledReadback(ctx)
+}
+
+module.exports = { getSTACKGLScaledReadback, STACKGLScaledReadback }
@@ -0,0 +1,18 @@
+const { gl } = require('../native-gl')
+
+class STACKGLSwapChain {
+  constructor (ctx) {
+    const drawingBuffer = ctx._drawingBuffer
+    this.length = drawingBuffer._colors.length
+    if (this.length > 1) {
+      drawingBuffer._asyncReadback = gl._openReadbackWorker.call(ctx)
+    }
+    this.readFrame = ctx._readPresentedFrame.bind(ctx)
+  }
+}
+
+function getSTACKGLSwapChain (ctx) {
+  return new STACKGLSwapChain(ctx)
+}
+
+module.exports = { getSTACKGLSwapChain, STACKGLSwapChain }
@@ -0,0 +1,172 @@
+const { gl } = require('../native-gl')
+const { checkObject } = require('../utils')
+const { WebGLProgram } = require('../webgl-program')
+
+// Number of 32-bit words in one element of a uniform of the given type
+function uniformWords (type) {
+  switch (type) {
+    case gl.FLOAT_MAT4:
+      return 16
+    case gl.FLOAT_MAT3:
+      return 9
+    case gl.FLOAT_MAT2:
+    case gl.FLOAT_VEC4:
+    case gl.INT_VEC4:
+    case gl.BOOL_VEC4:
+      return 4
+    case gl.FLOAT_VEC3:
+    case gl.INT_VEC3:
+    case gl.BOOL_VEC3:
+      return 3
+    case gl.FLOAT_VEC2:
+    case gl.INT_VEC2:
+    case gl.BOOL_VEC2:
+      return 2
+    case gl.FLOAT:
+    case gl.INT:
+    case gl.BOOL:
+    case gl.SAMPLER_2D:
+    case gl.SAMPLER_CUBE:
+      return 1
+  }
+  return 0
+}
+
+class WebGLUniformLayoutSTACKGL {
+  constructor (ctx, program, table, size, samplers, diff) {
+    this._ctx = ctx
+    this._program = program
+    this._linkCount = program._linkCount
+    this._table = table
+    this._samplers = samplers
+    this._shadow = diff ? new Int32Array(size) : null
+    this._shadowValid = false
+    this.size = size
+  }
+}
+
+class STACKGLUniformBlock {
+  constructor (ctx) {
+    this._ctx = ctx
+  }
+
+  createUniformLayout (program, entries, options) {
+    const ctx = this._ctx
+    if (!checkObject(program) || !Array.isArray(entries)) {
+      throw new TypeError('createUniformLayout(WebGLProgram, Array)')
+    }
+    if (!ctx._checkWrapper(program, WebGLProgram)) {
+      return null
+    }
+    if (!program._linkStatus) {
+      ctx.setError(gl.INVALID_OPERATION)
+      return null
+    }
+
+    const table = []
+    const samplers = []
+    let size = 0
+    for (let i = 0; i < entries.length; ++i) {
+      const entry = entries[i]
+      const name = entry.name + ''
+      const offset = entry.offset | 0
+
+      let info = null
+      for (let j = 0; j < program._uniforms.length; ++j) {
+        const uniform = program._uniforms[j]
+        if (uniform.name === name || uniform.name === name + '[0]') {
+          info = uniform
+          break
+        }
+      }
+
+      // Uniforms that were optimized away are dropped from the layout
+      if (!info) {
+        continue
+      }
+
+      const count = 'count' in entry ? entry.count | 0 : info.size
+      if (offset < 0 || count <= 0 || count > info.size) {
+        ctx.setError(gl.INVALID_VALUE)
+        return null
+      }
+      if ('type' in entry && (entry.type | 0) !== info.type) {
+        ctx.setError(gl.INVALID_OPERATION)
+        return null
+      }
+
+      const words = uniformWords(info.type)
+      const location = gl.getUniformLocation.call(ctx, program._ | 0, info.name)
+      if (words === 0 || location < 0) {
+        continue
+      }
+
+      table.push(location, info.type, offset, count)
+      if (info.type === gl.SAMPLER_2D || info.type === gl.SAMPLER_CUBE) {
+        for (let j = 0; j < count; ++j) {
+          samplers.push(offset + j)
+        }
+      }
+      size = Math.max(size, offset + words * count)
+    }
+
+    return new WebGLUniformLayoutSTACKGL(
+      ctx,
+      program,
+      new Int32Array(table),
+      size,
+      samplers,
+      !!(options && options.diff))
+  }
+
+  uniformBlock (layout, data) {
+    const ctx = this._ctx
+    if (!(layout instanceof WebGLUniformLayoutSTACKGL) ||
+      !(data instanceof Float32Array ||
+        data instanceof Int32Array ||
+        data instanceof Uint32Array)) {
+      throw new TypeError('uniformBlock(WebGLUniformLayoutSTACKGL, Float32Array)')
+    }
+    if (layout._ctx !== ctx ||
+      layout._program !== ctx._activeProgram ||
+      layout._linkCount !== layout._program._linkCount) {
+      ctx.setError(gl.INVALID_OPERATION)
+      return 0
+    }
+    if (data.length < layout.size) {
+      ctx.setError(gl.INVALID_VALUE)
+      return 0
+    }
+
+    const samplers = layout._samplers
+    if (samplers.length > 0) {
+      const ints = data instanceof Float32Array
+        ? new Int32Array(data.buffer, data.byteOffset, layout.size)
+        : data
+      for (let i = 0; i < samplers.length; ++i) {
+        const unit = ints[samplers[i]]
+        if (unit < 0 || unit >= ctx._textureUnits.length) {
+          ctx.setError(gl.INVALID_VALUE)
+          return 0
+        }
+      }
+    }
+
+    // The first upload of a diffing layout fills the shadow copy instead of
+    // comparing against it, so uniforms set before are always overwritten
+    const uploaded = gl._uniformBlock.call(
+      ctx, layout._table, data, layout._shadow, layout._shadowValid)
+    layout._shadowValid = layout._shadow !== null
+    return uploaded
+  }
+}
+
+function getSTACKGLUniformBlock (ctx) {
+  return new STACKGLUniformBlock(ctx)
+}
+
+module.exports = {
+  getSTACKGLUniformBlock,
+  STACKGLUniformBlock,
+  WebGLUniformLayoutSTACKGL
+}
@@ -1,11 +1,27 @@
 const bits = require('bit-twiddle')
 const { WebGLContextAttributes } = require('./webgl-context-attributes')
 const { WebGLRenderingContext, wrapContext } = require('./webgl-rendering-context')
+const { WebGL2RenderingContext } = require('./webgl2-rendering-context')
+const { validationLevel } = require('./webgl-trusted-methods')
+const { renderThreads, renderQueueDepth } = require('./webgl-render-jobs')
 const { WebGLTextureUnit } = require('./webgl-texture-unit')
 const { WebGLVertexArrayObjectState, WebGLVertexArrayGlobalState } = require('./webgl-vertex-attribute')
+const { ObjectReleases } = require('./webgl-object-release')
 
 let CONTEXT_COUNTER = 0
 
+// In the order of GLBackend in webgl.h
+const BACKENDS = [
+  'default',
+  'swiftshader',
+  'vulkan',
+  'gl',
+  'gles',
+  'metal',
+  'd3d11',
+  'null'
+]
+
 function flag (options, name, dflt) {
   if (!options || !(typeof options === 'object') || !(name in options)) {
     return dflt
@@ -13,6 +29,66 @@ function flag (options, name, dflt) {
   return !!options[name]
 }
 
+function swapChainLength (options) {
+  if (!options || !(typeof options === 'object') || !('swapChainLength' in options)) {
+    return 1
+  }
+  return Math.max(1, Math.min(3, options.swapChainLength | 0))
+}
+
+function contextVersion (options) {
+  if (!options || !(typeof options === 'object') || !('version' in options)) {
+    return 1
+  }
+  return (options.version | 0) === 2 ? 2 : 1
+}
+
+function displayCount (options) {
+  if (!options || !(typeof options === 'object') || !('displays' in options)) {
+    return 1
+  }
+  return Math.max(1, Math.min(16, options.displays | 0))
+}
+
+function displayIndex (options) {
+  if (!options || !(typeof options === 'object') || !('display' in options)) {
+    return -1
+  }
+  return Math.max(0, Math.min(15, options.display | 0))
+}
+
+// HEADLESS_GL_BACKEND and HEADLESS_GL_ANGLE_THREADS set the defaults for
+// the whole process. Unknown backend names throw instead of silently
+// rendering with the default backend.
+function backendName (options) {
+  let name = process.env.HEADLESS_GL_BACKEND || 'default'
+  if (options && typeof options === 'object' && 'backend' in options) {
+    name = options.backend + ''
+  }
+  if (BACKENDS.indexOf(name) < 0) {
+    throw new TypeError('Unknown headless-gl backend: ' + JSON.stringify(name))
+  }
+  return name
+}
+
+function angleThreads (options) {
+  if (!options || !(typeof options === 'object') || !('angleThreads' in options)) {
+    return Math.max(0, process.env.HEADLESS_GL_ANGLE_THREADS | 0)
+  }
+  return Math.max(0, options.angleThreads | 0)
+}
+
+function validationMode (options) {
+  if (!options || !(typeof options === 'object') || !('validation' in options)) {
+    return 'full'
+  }
+  const mode = options.validation + ''
+  if (mode !== 'full' && mode !== 'minimal' && mode !== 'none') {
+    throw new TypeError('Unknown headless-gl validation mode: ' + JSON.stringify(mode))
+  }
+  return mode
+}
+
 function createContext (width, height, options) {
   width = width | 0
   height = height | 0
@@ -24,19 +100,24 @@ function createContext (width, height, options) {
     flag(options, 'alpha', true),
     flag(options, 'depth', true),
     flag(options, 'stencil', false),
-    false, // flag(options, 'antialias', true),
+    flag(options, 'antialias', false),
     flag(options, 'premultipliedAlpha', true),
     flag(options, 'preserveDrawingBuffer', false),
     flag(options, 'preferLowPowerToHighPerformance', false),
-    flag(options, 'failIfMajorPerformanceCaveat', false))
+    flag(options, 'failIfMajorPerformanceCaveat', false),
+    validationMode(options),
+    backendName(options))
 
   // Can only use premultipliedAlpha if alpha is set
   contextAttributes.premultipliedAlpha =
     contextAttributes.premultipliedAlpha && contextAttributes.alpha
 
+  const version = contextVersion(options)
+  const ContextType = version === 2 ? WebGL2RenderingContext : WebGLRenderingContext
+
   let ctx
   try {
-    ctx = new WebGLRenderingContext(
+    ctx = new ContextType(
       1,
       1,
       contextAttributes.alpha,
@@ -46,7 +127,12 @@ function createContext (width, height, options) {
       contextAttributes.premultipliedAlpha,
       contextAttributes.preserveDrawingBuffer,
       contextAttributes.preferLowPowerToHighPerformance,
-      contextAttributes.failIfMajorPerformanceCaveat)
+      contextAttributes.failIfMajorPerformanceCaveat,
+      version,
+      displayCount(options),
+      displayIndex(options),
+      BACKENDS.indexOf(contextAttributes.backend),
+      angleThreads(options))
   } catch (e) {}
   if (!ctx) {
     return null
@@ -58,6 +144,7 @@ function createContext (width, height, options) {
   ctx._ = CONTEXT_COUNTER++
 
   ctx._contextAttributes = contextAttributes
+  ctx._validation = validationLevel(contextAttributes.validation)
 
   ctx._extensions = {}
   ctx._programs = {}
@@ -66,10 +153,21 @@ function createContext (width, height, options) {
   ctx._textures = {}
   ctx._framebuffers = {}
   ctx._renderbuffers = {}
+  ctx._objectReleases = flag(options, 'releaseUnreachable', false)
+    ? new ObjectReleases(ctx)
+    : null
 
   ctx._activeProgram = null
   ctx._activeFramebuffer = null
+  ctx._activeReadFramebuffer = null
   ctx._activeRenderbuffer = null
+  ctx._frameRing = null
+  ctx._renderJobs = null
+  ctx._textureUploads = null
+  ctx._pendingTextureUploads = new Set()
+  ctx._displays = displayCount(options)
+  ctx._renderThreads = renderThreads(options)
+  ctx._renderQueueDepth = renderQueueDepth(options, ctx._renderThreads)
   ctx._checkStencil = false
   ctx._stencilState = true
 
@@ -97,12 +195,16 @@ function createContext (width, height, options) {
   ctx._maxCubeMapSize = ctx.getParameter(ctx.MAX_CUBE_MAP_TEXTURE_SIZE)
   ctx._maxCubeMapLevel = bits.log2(bits.nextPow2(ctx._maxCubeMapSize))
 
+  if (version === 2) {
+    ctx._initWebGL2()
+  }
+
   // Unpack alignment
   ctx._unpackAlignment = 4
   ctx._packAlignment = 4
 
   // Allocate framebuffer
-  ctx._allocateDrawingBuffer(width, height)
+  ctx._allocateDrawingBuffer(width, height, swapChainLength(options))
 
   const attrib0Buffer = ctx.createBuffer()
   ctx._attrib0Buffer = attrib0Buffer
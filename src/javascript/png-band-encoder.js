@@ -0,0 +1,96 @@
+const { Transform } = require('stream')
+const zlib = require('zlib')
+
+const PNG_SIGNATURE = Buffer.from([137, 80, 78, 71, 13, 10, 26, 10])
+
+const CRC_TABLE = new Int32Array(256)
+for (let n = 0; n < 256; ++n) {
+  let c = n
+  for (let k = 0; k < 8; ++k) {
+    c = (c & 1) ? (0xedb88320 ^ (c >>> 1)) : (c >>> 1)
+  }
+  CRC_TABLE[n] = c
+}
+
+function crc32 (crc, data) {
+  for (let i = 0; i < data.length; ++i) {
+    crc = CRC_TABLE[(crc ^ data[i]) & 0xff] ^ (crc >>> 8)
+  }
+  return crc
+}
+
+function pngChunk (type, data) {
+  const header = Buffer.alloc(8)
+  header.writeUInt32BE(data.length, 0)
+  header.write(type, 4, 'ascii')
+  const crc = Buffer.alloc(4)
+  crc.writeUInt32BE((crc32(crc32(-1, header.subarray(4)), data) ^ -1) >>> 0, 0)
+  return Buffer.concat([header, data, crc])
+}
+
+// Encodes a stream of top-down RGBA rows into a PNG image, one band at a
+// time. Only the current partial row and zlib's window are kept in memory.
+class PNGBandEncoder extends Transform {
+  constructor (width, height, options) {
+    super(options)
+    this._width = width | 0
+    this._height = height | 0
+    this._stride = 4 * this._width
+    this._rowsLeft = this._height
+    this._partial = null
+    this._deflate = zlib.createDeflate(options && options.zlib)
+    this._deflate.on('data', (data) => this.push(pngChunk('IDAT', data)))
+    this._deflate.on('error', (err) => this.destroy(err))
+
+    const ihdr = Buffer.alloc(13)
+    ihdr.writeUInt32BE(this._width, 0)
+    ihdr.writeUInt32BE(this._height, 4)
+    ihdr[8] = 8 // bit depth
+    ihdr[9] = 6 // color type: RGBA
+    ihdr[10] = 0 // compression
+    ihdr[11] = 0 // filter
+    ihdr[12] = 0 // interlace
+    this.push(PNG_SIGNATURE)
+    this.push(pngChunk('IHDR', ihdr))
+  }
+
+  _transform (band, encoding, callback) {
+    if (this._partial) {
+      band = Buffer.concat([this._partial, band])
+      this._partial = null
+    }
+
+    const stride = this._stride
+    const rows = Math.min(Math.floor(band.length / stride), this._rowsLeft)
+    const remainder = band.length - rows * stride
+    if (remainder > 0 && rows < this._rowsLeft) {
+      this._partial = band.subarray(rows * stride)
+    }
+    if (rows === 0) {
+      callback()
+      return
+    }
+
+    const filtered = Buffer.allocUnsafe(rows * (stride + 1))
+    for (let i = 0; i < rows; ++i) {
+      filtered[i * (stride + 1)] = 0
+      band.copy(filtered, i * (stride + 1) + 1, i * stride, (i + 1) * stride)
+    }
+    this._rowsLeft -= rows
+    this._deflate.write(filtered, () => callback())
+  }
+
+  _flush (callback) {
+    if (this._rowsLeft !== 0) {
+      callback(new Error('PNGBandEncoder: expected ' + this._rowsLeft + ' more rows'))
+      return
+    }
+    this._deflate.once('end', () => {
+      this.push(pngChunk('IEND', Buffer.alloc(0)))
+      callback()
+    })
+    this._deflate.end()
+  }
+}
+
+module.exports = { PNGBandEncoder }
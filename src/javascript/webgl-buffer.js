@@ -1,5 +1,6 @@
 const { Linkable } = require('./linkable')
 const { gl } = require('./native-gl')
+const { untrackObject } = require('./webgl-object-release')
 
 class WebGLBuffer extends Linkable {
   constructor (_, ctx) {
@@ -7,11 +8,22 @@ class WebGLBuffer extends Linkable {
     this._ctx = ctx
     this._size = 0
     this._elements = new Uint8Array(0)
+
+    // Bumped when the size or the element data changes
+    this._version = 0
+
+    // Last range scanned for its largest index
+    this._scanVersion = -1
+    this._scanType = 0
+    this._scanOffset = 0
+    this._scanCount = 0
+    this._scanMax = 0
   }
 
   _performDelete () {
     const ctx = this._ctx
     delete ctx._buffers[this._ | 0]
+    untrackObject(ctx, this)
     gl.deleteBuffer.call(ctx, this._ | 0)
   }
 }
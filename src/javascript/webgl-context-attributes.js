@@ -7,7 +7,9 @@ class WebGLContextAttributes {
     premultipliedAlpha,
     preserveDrawingBuffer,
     preferLowPowerToHighPerformance,
-    failIfMajorPerformanceCaveat) {
+    failIfMajorPerformanceCaveat,
+    validation,
+    backend) {
     this.alpha = alpha
     this.depth = depth
     this.stencil = stencil
@@ -16,6 +18,8 @@ class WebGLContextAttributes {
     this.preserveDrawingBuffer = preserveDrawingBuffer
     this.preferLowPowerToHighPerformance = preferLowPowerToHighPerformance
     this.failIfMajorPerformanceCaveat = failIfMajorPerformanceCaveat
+    this.validation = validation
+    this.backend = backend
   }
 }
 
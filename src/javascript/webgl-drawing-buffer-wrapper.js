@@ -3,6 +3,20 @@ class WebGLDrawingBufferWrapper {
     this._framebuffer = framebuffer
     this._color = color
     this._depthStencil = depthStencil
+    // Framebuffer that rendering goes to. This is _framebuffer unless the
+    // drawing buffer is multisampled, in which case it has its own color
+    // renderbuffer which is resolved into _color before reads.
+    this._renderFramebuffer = framebuffer
+    this._multisampleColor = 0
+    this._samples = 0
+    this._canDiscard = false
+    // Color buffers of the swap chain, _color is the one being rendered to
+    this._colors = [color]
+    this._colorIndex = 0
+    this._pendingFrames = []
+    this._asyncReadback = false
+    this._width = 0
+    this._height = 0
   }
 }
 
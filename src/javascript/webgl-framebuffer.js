@@ -1,5 +1,6 @@
 const { Linkable } = require('./linkable')
 const { gl } = require('./native-gl')
+const { untrackObject } = require('./webgl-object-release')
 
 class WebGLFramebuffer extends Linkable {
   constructor (_, ctx) {
@@ -115,6 +116,7 @@ class WebGLFramebuffer extends Linkable {
   _performDelete () {
     const ctx = this._ctx
     delete ctx._framebuffers[this._ | 0]
+    untrackObject(ctx, this)
     gl.deleteFramebuffer.call(ctx, this._ | 0)
   }
 }
@@ -0,0 +1,109 @@
+const { gl } = require('./native-gl')
+
+// The context table each kind of released object lives in
+const TABLES = {
+  [gl.ARRAY_BUFFER]: '_buffers',
+  [gl.TEXTURE_2D]: '_textures',
+  [gl.FRAMEBUFFER]: '_framebuffers',
+  [gl.RENDERBUFFER]: '_renderbuffers'
+}
+
+// With the releaseUnreachable option, the context tables only hold weak
+// references to buffers, textures, framebuffers and renderbuffers. Objects
+// that are bound or attached stay reachable through the context state, so
+// anything that is collected is also unbound. The names of collected
+// objects are queued and deleted together, one native call per kind, from
+// an immediate once the current call stack has unwound.
+class ObjectReleases {
+  constructor (ctx) {
+    this._ctx = ctx
+    this._queue = new Map()
+    this._scheduled = false
+    this._registry = new FinalizationRegistry(([target, id]) => {
+      this._collected(target, id)
+    })
+  }
+
+  _collected (target, id) {
+    const ctx = this._ctx
+    if (ctx._objectReleases !== this) {
+      // Deleted by a reset or destroy in the meantime
+      return
+    }
+    const table = ctx[TABLES[target]]
+    const ref = table[id]
+    if (ref && !ref.deref()) {
+      delete table[id]
+    }
+
+    let names = this._queue.get(target)
+    if (!names) {
+      names = []
+      this._queue.set(target, names)
+    }
+    names.push(id)
+    if (!this._scheduled) {
+      this._scheduled = true
+      setImmediate(() => this.flush()).unref()
+    }
+  }
+
+  flush () {
+    this._scheduled = false
+    if (this._ctx._objectReleases !== this) {
+      return
+    }
+    for (const [target, names] of this._queue) {
+      if (names.length > 0) {
+        gl._releaseObjects.call(this._ctx, target, new Int32Array(names))
+      }
+    }
+    this._queue.clear()
+  }
+}
+
+// Adds a new object to its context table, weakly if unreachable objects
+// are released
+function trackObject (ctx, target, object) {
+  const table = ctx[TABLES[target]]
+  const releases = ctx._objectReleases
+  if (releases) {
+    table[object._] = new WeakRef(object)
+    releases._registry.register(object, [target, object._], object)
+  } else {
+    table[object._] = object
+  }
+}
+
+// Called when an object is deleted, so its name is not released again
+function untrackObject (ctx, object) {
+  if (ctx._objectReleases) {
+    ctx._objectReleases._registry.unregister(object)
+  }
+}
+
+// Returns the object a table entry refers to, or null once collected
+function trackedObject (entry) {
+  return entry instanceof WeakRef ? entry.deref() || null : entry
+}
+
+// Objects that were not collected yet are deleted by resetContext or
+// destroy, so the pending names are dropped
+function resetObjectReleases (ctx) {
+  if (ctx._objectReleases) {
+    ctx._objectReleases = new ObjectReleases(ctx)
+  }
+}
+
+function closeObjectReleases (ctx) {
+  ctx._objectReleases = null
+}
+
+module.exports = {
+  ObjectReleases,
+  trackObject,
+  untrackObject,
+  trackedObject,
+  resetObjectReleases,
+  closeObjectReleases
+}
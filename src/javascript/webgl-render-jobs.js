@@ -0,0 +1,242 @@
+const os = require('os')
+const { gl } = require('./native-gl')
+
+const DRAW_MODES = [
+  gl.POINTS,
+  gl.LINES,
+  gl.LINE_LOOP,
+  gl.LINE_STRIP,
+  gl.TRIANGLES,
+  gl.TRIANGLE_STRIP,
+  gl.TRIANGLE_FAN
+]
+
+const FILTERS = {
+  nearest: gl.NEAREST,
+  linear: gl.LINEAR
+}
+
+function renderThreads (options) {
+  if (!options || !(typeof options === 'object') || !('renderThreads' in options)) {
+    return os.availableParallelism ? os.availableParallelism() : os.cpus().length
+  }
+  return Math.max(1, options.renderThreads | 0)
+}
+
+function renderQueueDepth (options, threads) {
+  if (!options || !(typeof options === 'object') || !('renderQueueDepth' in options)) {
+    return 2 * threads
+  }
+  return Math.max(1, options.renderQueueDepth | 0)
+}
+
+function floatArray (value, what) {
+  if (typeof value === 'number') {
+    return new Float32Array([value])
+  }
+  if (value instanceof Float32Array) {
+    return value
+  }
+  if (Array.isArray(value) || ArrayBuffer.isView(value)) {
+    return new Float32Array(value)
+  }
+  throw new TypeError('submit: ' + what + ' must be a number or an array')
+}
+
+function elementArray (value) {
+  if (value instanceof Uint8Array) {
+    return { type: gl.UNSIGNED_BYTE, data: value }
+  } else if (value instanceof Uint16Array) {
+    return { type: gl.UNSIGNED_SHORT, data: value }
+  } else if (value instanceof Uint32Array) {
+    return { type: gl.UNSIGNED_INT, data: value }
+  } else if (Array.isArray(value)) {
+    let max = 0
+    for (let i = 0; i < value.length; ++i) {
+      if (value[i] > max) {
+        max = value[i]
+      }
+    }
+    return elementArray(max < 65536
+      ? new Uint16Array(value)
+      : new Uint32Array(value))
+  }
+  throw new TypeError('submit: elements must be an array or an unsigned typed array')
+}
+
+// Checks a job and copies it into the fixed shape _submitRenderJob reads.
+// Vertex ranges and indices are checked here, since nothing validates the
+// draws once they run on the pool.
+function normalizeJob (job) {
+  if (!job || typeof job !== 'object') {
+    throw new TypeError('submit(job)')
+  }
+  const width = job.width | 0
+  const height = job.height | 0
+  if (width <= 0 || height <= 0) {
+    throw new RangeError('submit: job size must be positive')
+  }
+  if (typeof job.vertexShader !== 'string' ||
+    typeof job.fragmentShader !== 'string') {
+    throw new TypeError('submit: job needs vertexShader and fragmentShader sources')
+  }
+
+  let vertices = Infinity
+  const attributes = Object.keys(job.attributes || {}).map((name) => {
+    const attribute = job.attributes[name]
+    const isArray = Array.isArray(attribute) || ArrayBuffer.isView(attribute)
+    const size = isArray ? 2 : attribute.size | 0
+    if (size < 1 || size > 4) {
+      throw new RangeError('submit: attribute ' + name + ' size must be 1 to 4')
+    }
+    const data = floatArray(isArray ? attribute : attribute.data, 'attribute ' + name)
+    vertices = Math.min(vertices, Math.floor(data.length / size))
+    return { name, size, data }
+  })
+  if (vertices === Infinity) {
+    vertices = 0
+  }
+
+  const textures = Object.keys(job.textures || {}).map((name) => {
+    const texture = job.textures[name]
+    const width = texture.width | 0
+    const height = texture.height | 0
+    const data = texture.data
+    if (!(data instanceof Uint8Array) || width <= 0 || height <= 0 ||
+      data.length < 4 * width * height) {
+      throw new TypeError('submit: texture ' + name + ' needs width, height and RGBA data')
+    }
+    const filter = FILTERS[texture.filter || 'linear']
+    if (!filter) {
+      throw new TypeError('submit: unknown filter ' + texture.filter)
+    }
+    return { name, width, height, filter, data }
+  })
+
+  const uniforms = Object.keys(job.uniforms || {}).map((name) => ({
+    name,
+    values: floatArray(job.uniforms[name], 'uniform ' + name)
+  }))
+
+  let elements = null
+  let elementType = 0
+  if (job.elements) {
+    const indices = elementArray(job.elements)
+    for (let i = 0; i < indices.data.length; ++i) {
+      if (indices.data[i] >= vertices) {
+        throw new RangeError('submit: element ' + i + ' is out of range')
+      }
+    }
+    elements = indices.data
+    elementType = indices.type
+  }
+
+  const drawList = job.draws || []
+  const draws = new Int32Array(3 * drawList.length)
+  const limit = elements ? elements.length : vertices
+  for (let i = 0; i < drawList.length; ++i) {
+    const draw = drawList[i]
+    const mode = draw.mode === undefined ? gl.TRIANGLES : draw.mode | 0
+    const first = draw.first | 0
+    const count = draw.count === undefined ? limit - first : draw.count | 0
+    if (DRAW_MODES.indexOf(mode) < 0) {
+      throw new TypeError('submit: invalid draw mode ' + draw.mode)
+    }
+    if (first < 0 || count < 0 || first + count > limit) {
+      throw new RangeError('submit: draw ' + i + ' is out of range')
+    }
+    draws[3 * i] = mode
+    draws[3 * i + 1] = first
+    draws[3 * i + 2] = count
+  }
+
+  return {
+    width,
+    height,
+    vertexShader: job.vertexShader,
+    fragmentShader: job.fragmentShader,
+    depthTest: !!job.depthTest,
+    clearColor: floatArray(job.clearColor || [0, 0, 0, 0], 'clearColor'),
+    attributes,
+    textures,
+    uniforms,
+    elementType,
+    elements,
+    draws
+  }
+}
+
+// Jobs waiting for a free slot in the pool, and jobs handed to it
+class RenderJobQueue {
+  constructor (ctx) {
+    this.ctx = ctx
+    this.waiting = []
+    this.running = new Set()
+  }
+
+  push (entry) {
+    this.waiting.push(entry)
+    this.pump()
+  }
+
+  pump () {
+    const ctx = this.ctx
+    while (this.waiting.length > 0) {
+      const entry = this.waiting[0]
+      const queued = gl._submitRenderJob.call(ctx, entry.job, (err, pixels, timing) => {
+        this.running.delete(entry)
+        if (err) {
+          entry.reject(err)
+        } else {
+          entry.resolve({ pixels: new Uint8Array(pixels.buffer, pixels.byteOffset, pixels.length), timing })
+        }
+        this.pump()
+      })
+      if (!queued) {
+        return
+      }
+      this.waiting.shift()
+      this.running.add(entry)
+    }
+  }
+
+  close () {
+    const err = new Error('submit: context was destroyed')
+    for (const entry of this.waiting) {
+      entry.reject(err)
+    }
+    for (const entry of this.running) {
+      entry.reject(err)
+    }
+    this.waiting = []
+    this.running.clear()
+  }
+}
+
+function submitRenderJob (ctx, job) {
+  return new Promise((resolve, reject) => {
+    job = normalizeJob(job)
+    if (!ctx._renderJobs) {
+      const threads = ctx._renderThreads
+      if (!gl._openRenderPool.call(ctx, threads, ctx._renderQueueDepth, ctx._displays)) {
+        throw new Error('submit: could not start render threads')
+      }
+      ctx._renderJobs = new RenderJobQueue(ctx)
+    }
+    ctx._renderJobs.push({ job, resolve, reject })
+  })
+}
+
+function closeRenderJobs (ctx) {
+  if (ctx._renderJobs) {
+    ctx._renderJobs.close()
+    ctx._renderJobs = null
+  }
+}
+
+module.exports = {
+  renderThreads,
+  renderQueueDepth,
+  submitRenderJob,
+  closeRenderJobs
+}
@@ -1,5 +1,6 @@
 const { Linkable } = require('./linkable')
 const { gl } = require('./native-gl')
+const { untrackObject } = require('./webgl-object-release')
 
 class WebGLRenderbuffer extends Linkable {
   constructor (_, ctx) {
@@ -9,11 +10,13 @@ class WebGLRenderbuffer extends Linkable {
     this._width = 0
     this._height = 0
     this._format = 0
+    this._samples = 0
   }
 
   _performDelete () {
     const ctx = this._ctx
     delete ctx._renderbuffers[this._ | 0]
+    untrackObject(ctx, this)
     gl.deleteRenderbuffer.call(ctx, this._ | 0)
   }
 }
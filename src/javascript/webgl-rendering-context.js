@@ -3,19 +3,33 @@ const tokenize = require('glsl-tokenizer/string')
 const HEADLESS_VERSION = require('../../package.json').version
 const { gl, NativeWebGLRenderingContext, NativeWebGL } = require('./native-gl')
 const { getANGLEInstancedArrays } = require('./extensions/angle-instanced-arrays')
+const { getANGLEFramebufferBlit } = require('./extensions/angle-framebuffer-blit')
+const { getANGLEFramebufferMultisample } = require('./extensions/angle-framebuffer-multisample')
 const { getOESElementIndexUint } = require('./extensions/oes-element-index-unit')
 const { getOESStandardDerivatives } = require('./extensions/oes-standard-derivatives')
 const { getOESTextureFloat } = require('./extensions/oes-texture-float')
 const { getOESTextureFloatLinear } = require('./extensions/oes-texture-float-linear')
 const { getSTACKGLDestroyContext } = require('./extensions/stackgl-destroy-context')
 const { getSTACKGLResizeDrawingBuffer } = require('./extensions/stackgl-resize-drawing-buffer')
+const { getSTACKGLPresent } = require('./extensions/stackgl-present')
+const { getSTACKGLSwapChain } = require('./extensions/stackgl-swap-chain')
+const { getSTACKGLReadbackStream } = require('./extensions/stackgl-readback-stream')
+const { getSTACKGLFrameSink } = require('./extensions/stackgl-frame-sink')
+const { getSTACKGLFrameRing } = require('./extensions/stackgl-frame-ring')
+const { getSTACKGLDirtyTiles } = require('./extensions/stackgl-dirty-tiles')
+const { getSTACKGLCommandBundle } = require('./extensions/stackgl-command-bundle')
+const { getSTACKGLScaledReadback } = require('./extensions/stackgl-scaled-readback')
+const { getSTACKGLUniformBlock } = require('./extensions/stackgl-uniform-block')
+const { getSTACKGLCpuBudget } = require('./extensions/stackgl-cpu-budget')
+const { getSTACKGLResetContext } = require('./extensions/stackgl-reset-context')
+const { getSTACKGLMemoryInfo } = require('./extensions/stackgl-memory-info')
 const { getWebGLDrawBuffers } = require('./extensions/webgl-draw-buffers')
 const { getEXTBlendMinMax } = require('./extensions/ext-blend-minmax')
+const { getEXTDiscardFramebuffer } = require('./extensions/ext-discard-framebuffer')
 const { getEXTTextureFilterAnisotropic } = require('./extensions/ext-texture-filter-anisotropic')
 const { getEXTShaderTextureLod } = require('./extensions/ext-shader-texture-lod')
 const { getOESVertexArrayObject } = require('./extensions/oes-vertex-array-object')
 const {
-  bindPublics,
   checkObject,
   checkUniform,
   formatSize,
@@ -40,7 +54,26 @@ const { WebGLRenderbuffer } = require('./webgl-renderbuffer')
 const { WebGLShader } = require('./webgl-shader')
 const { WebGLShaderPrecisionFormat } = require('./webgl-shader-precision-format')
 const { WebGLTexture } = require('./webgl-texture')
+const { WebGLTextureUnit } = require('./webgl-texture-unit')
 const { WebGLUniformLocation } = require('./webgl-uniform-location')
+const { WebGLVertexArrayObjectState, WebGLVertexArrayGlobalState } = require('./webgl-vertex-attribute')
+const { submitRenderJob, closeRenderJobs } = require('./webgl-render-jobs')
+const {
+  texImage2DAsync,
+  finishTextureUpload,
+  finishBoundTextureUploads,
+  closeTextureUploads
+} = require('./webgl-texture-uploads')
+const {
+  trackObject,
+  trackedObject,
+  resetObjectReleases,
+  closeObjectReleases
+} = require('./webgl-object-release')
+const {
+  trustedMethods,
+  VALIDATION_NONE
+} = require('./webgl-trusted-methods')
 
 // These are defined by the WebGL spec
 const MAX_UNIFORM_LENGTH = 256
@@ -55,8 +88,27 @@ const DEFAULT_ATTACHMENTS = [
 
 const DEFAULT_COLOR_ATTACHMENTS = [gl.COLOR_ATTACHMENT0]
 
+// ANGLE_framebuffer_blit and ANGLE_framebuffer_multisample
+const READ_FRAMEBUFFER_ANGLE = 0x8CA8
+const DRAW_FRAMEBUFFER_ANGLE = 0x8CA9
+const READ_FRAMEBUFFER_BINDING_ANGLE = 0x8CAA
+const RENDERBUFFER_SAMPLES_ANGLE = 0x8CAB
+const FRAMEBUFFER_INCOMPLETE_MULTISAMPLE_ANGLE = 0x8D56
+const MAX_SAMPLES_ANGLE = 0x8D57
+const RGB8_OES = 0x8051
+const RGBA8_OES = 0x8058
+
+// Number of samples used for an antialiased drawing buffer
+const DRAWING_BUFFER_SAMPLES = 4
+
+// Texture targets that can only be bound in WebGL 2 contexts
+const TEXTURE_3D = 0x806F
+const TEXTURE_2D_ARRAY = 0x8C1A
+
 const availableExtensions = {
   angle_instanced_arrays: getANGLEInstancedArrays,
+  angle_framebuffer_blit: getANGLEFramebufferBlit,
+  angle_framebuffer_multisample: getANGLEFramebufferMultisample,
   oes_element_index_uint: getOESElementIndexUint,
   oes_texture_float: getOESTextureFloat,
   oes_texture_float_linear: getOESTextureFloatLinear,
@@ -64,36 +116,128 @@ const availableExtensions = {
   oes_vertex_array_object: getOESVertexArrayObject,
   stackgl_destroy_context: getSTACKGLDestroyContext,
   stackgl_resize_drawingbuffer: getSTACKGLResizeDrawingBuffer,
+  stackgl_present: getSTACKGLPresent,
+  stackgl_swap_chain: getSTACKGLSwapChain,
+  stackgl_readback_stream: getSTACKGLReadbackStream,
+  stackgl_frame_sink: getSTACKGLFrameSink,
+  stackgl_frame_ring: getSTACKGLFrameRing,
+  stackgl_dirty_tiles: getSTACKGLDirtyTiles,
+  stackgl_command_bundle: getSTACKGLCommandBundle,
+  stackgl_scaled_readback: getSTACKGLScaledReadback,
+  stackgl_uniform_block: getSTACKGLUniformBlock,
+  stackgl_cpu_budget: getSTACKGLCpuBudget,
+  stackgl_reset_context: getSTACKGLResetContext,
+  stackgl_memory_info: getSTACKGLMemoryInfo,
   webgl_draw_buffers: getWebGLDrawBuffers,
   ext_blend_minmax: getEXTBlendMinMax,
+  ext_discard_framebuffer: getEXTDiscardFramebuffer,
   ext_texture_filter_anisotropic: getEXTTextureFilterAnisotropic,
   ext_shader_texture_lod: getEXTShaderTextureLod
 }
 
+// Reachable through the STACKGL_destroy_context and
+// STACKGL_resize_drawingbuffer extensions only
 const privateMethods = [
   'resize',
   'destroy'
 ]
 
-function wrapContext (ctx) {
-  const wrapper = new WebGLRenderingContext()
-  bindPublics(Object.keys(ctx), wrapper, ctx, privateMethods)
-  bindPublics(Object.keys(ctx.constructor.prototype), wrapper, ctx, privateMethods)
-  bindPublics(Object.getOwnPropertyNames(ctx), wrapper, ctx, privateMethods)
-  bindPublics(Object.getOwnPropertyNames(ctx.constructor.prototype), wrapper, ctx, privateMethods)
-
-  Object.defineProperties(wrapper, {
-    drawingBufferWidth: {
-      get () { return ctx.drawingBufferWidth },
-      set (value) { ctx.drawingBufferWidth = value }
-    },
-    drawingBufferHeight: {
-      get () { return ctx.drawingBufferHeight },
-      set (value) { ctx.drawingBufferHeight = value }
+// Public methods of a context class, nearest definition first. Natives that
+// no JavaScript class wraps skip the bookkeeping, so they are not public.
+function publicMethods (Type) {
+  const methods = {}
+  for (let proto = Type.prototype;
+    proto !== NativeWebGLRenderingContext.prototype;
+    proto = Object.getPrototypeOf(proto)) {
+    const names = Object.getOwnPropertyNames(proto)
+    for (let i = 0; i < names.length; ++i) {
+      const name = names[i]
+      if (name === 'constructor' || name[0] === '_' || name in methods ||
+        privateMethods.indexOf(name) >= 0) {
+        continue
+      }
+      const { value } = Object.getOwnPropertyDescriptor(proto, name)
+      if (typeof value === 'function') {
+        methods[name] = value
+      }
+    }
+  }
+  return methods
+}
+
+// The object handed to users forwards every public method to the private
+// context. The forwarding functions live on one prototype per context class
+// and validation level, so wrapping a context only allocates the wrapper.
+function createFacade (Type, level) {
+  class WebGLContextFacade {
+    #ctx
+
+    constructor (ctx) {
+      this.#ctx = ctx
+    }
+
+    get drawingBufferWidth () {
+      return this.#ctx.drawingBufferWidth
+    }
+
+    set drawingBufferWidth (value) {
+      this.#ctx.drawingBufferWidth = value
+    }
+
+    get drawingBufferHeight () {
+      return this.#ctx.drawingBufferHeight
     }
+
+    set drawingBufferHeight (value) {
+      this.#ctx.drawingBufferHeight = value
+    }
+
+    static forward (method) {
+      return function () {
+        return method.apply(this.#ctx, arguments)
+      }
+    }
+  }
+
+  // Constants and instanceof checks come from the context class
+  const proto = WebGLContextFacade.prototype
+  Object.setPrototypeOf(proto, Type.prototype)
+  Object.defineProperty(proto, 'constructor', {
+    value: Type,
+    writable: true,
+    configurable: true
   })
 
-  return wrapper
+  const methods = Object.assign(publicMethods(Type), trustedMethods(level))
+  for (const name in methods) {
+    proto[name] = WebGLContextFacade.forward(methods[name])
+  }
+
+  // Everything else the context class inherits is hidden
+  const hidden = Object.getOwnPropertyNames(NativeWebGLRenderingContext.prototype)
+    .concat(privateMethods)
+  for (const name of hidden) {
+    if (!(name in methods) && typeof Type.prototype[name] === 'function') {
+      proto[name] = undefined
+    }
+  }
+  return WebGLContextFacade
+}
+
+const facades = new Map()
+
+function wrapContext (ctx) {
+  const Type = ctx.constructor
+  let byLevel = facades.get(Type)
+  if (!byLevel) {
+    byLevel = []
+    facades.set(Type, byLevel)
+  }
+  const level = ctx._validation
+  if (!byLevel[level]) {
+    byLevel[level] = createFacade(Type, level)
+  }
+  return new byLevel[level](ctx)
 }
 
 // We need to wrap some of the native WebGL functions to handle certain error codes and check input values
@@ -304,6 +448,48 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     return true
   }
 
+  // Returns the largest index in count elements of type at byte offset in
+  // the element buffer, or -1 if the range is out of bounds. Renderers
+  // usually draw the same range again, so the last scan is remembered
+  // until the buffer contents change.
+  _maxElementIndex (buffer, type, offset, count) {
+    if (buffer._scanVersion === buffer._version &&
+      buffer._scanType === type &&
+      buffer._scanOffset === offset &&
+      buffer._scanCount === count) {
+      return buffer._scanMax
+    }
+
+    const elements = buffer._elements
+    let elementData = elements
+    let start = offset
+    if (type === gl.UNSIGNED_SHORT) {
+      start >>= 1
+      elementData = new Uint16Array(elements.buffer, 0, elements.length >> 1)
+    } else if (type === gl.UNSIGNED_INT) {
+      start >>= 2
+      elementData = new Uint32Array(elements.buffer, 0, elements.length >> 2)
+    }
+    if ((count + start) >>> 0 > elementData.length) {
+      this.setError(gl.INVALID_OPERATION)
+      return -1
+    }
+
+    let maxIndex = 0
+    for (let i = start; i < start + count; ++i) {
+      if (elementData[i] > maxIndex) {
+        maxIndex = elementData[i]
+      }
+    }
+
+    buffer._scanVersion = buffer._version
+    buffer._scanType = type
+    buffer._scanOffset = offset
+    buffer._scanCount = count
+    buffer._scanMax = maxIndex
+    return maxIndex
+  }
+
   _checkVertexIndex (index) {
     if (index < 0 || index >= this._vertexObjectState._attribs.length) {
       this.setError(gl.INVALID_VALUE)
@@ -399,8 +585,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     return true
   }
 
-  _framebufferOk () {
-    const framebuffer = this._activeFramebuffer
+  _framebufferOk (framebuffer = this._activeFramebuffer) {
     if (framebuffer &&
       this._preCheckFramebufferStatus(framebuffer) !== gl.FRAMEBUFFER_COMPLETE) {
       this.setError(gl.INVALID_FRAMEBUFFER_OPERATION)
@@ -409,6 +594,47 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     return true
   }
 
+  // Binds the single sampled drawing buffer for a readback, resolving the
+  // multisampled buffer into it first when antialiasing is enabled. Call
+  // _restoreFramebuffer() once the read is done.
+  _bindDrawingBufferForRead () {
+    const drawingBuffer = this._drawingBuffer
+    if (drawingBuffer._samples) {
+      gl._resolveDrawingBuffer.call(
+        this,
+        drawingBuffer._renderFramebuffer,
+        drawingBuffer._framebuffer,
+        this.drawingBufferWidth,
+        this.drawingBufferHeight)
+    } else {
+      super.bindFramebuffer(gl.FRAMEBUFFER, drawingBuffer._framebuffer)
+    }
+  }
+
+  _restoreFramebuffer () {
+    const drawFramebuffer = this._activeFramebuffer
+    const readFramebuffer = this._activeReadFramebuffer
+    const renderFramebuffer = this._drawingBuffer._renderFramebuffer
+    if (drawFramebuffer === readFramebuffer) {
+      super.bindFramebuffer(
+        gl.FRAMEBUFFER,
+        drawFramebuffer ? drawFramebuffer._ | 0 : renderFramebuffer)
+    } else {
+      super.bindFramebuffer(
+        READ_FRAMEBUFFER_ANGLE,
+        readFramebuffer ? readFramebuffer._ | 0 : renderFramebuffer)
+      super.bindFramebuffer(
+        DRAW_FRAMEBUFFER_ANGLE,
+        drawFramebuffer ? drawFramebuffer._ | 0 : renderFramebuffer)
+    }
+  }
+
+  // True if reads from the current read framebuffer have to go through a
+  // resolve of the multisampled drawing buffer.
+  _needsDrawingBufferResolve () {
+    return !this._activeReadFramebuffer && this._drawingBuffer._samples > 0
+  }
+
   _getActiveBuffer (target) {
     if (target === gl.ARRAY_BUFFER) {
       return this._vertexGlobalState._arrayBufferBinding
@@ -428,6 +654,10 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       return activeUnit._bind2D
     } else if (target === gl.TEXTURE_CUBE_MAP) {
       return activeUnit._bindCube
+    } else if (target === TEXTURE_3D) {
+      return activeUnit._bind3D
+    } else if (target === TEXTURE_2D_ARRAY) {
+      return activeUnit._bind2DArray
     }
     return null
   }
@@ -525,7 +755,8 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
         const format = colorAttachment._format
         if (format !== gl.RGBA4 &&
           format !== gl.RGB565 &&
-          format !== gl.RGB5_A1) {
+          format !== gl.RGB5_A1 &&
+          format !== RGBA8_OES) {
           return gl.FRAMEBUFFER_INCOMPLETE_ATTACHMENT
         }
         colorAttached = true
@@ -545,6 +776,20 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       return gl.FRAMEBUFFER_INCOMPLETE_ATTACHMENT
     }
 
+    let samples = -1
+    for (const attachmentEnum in attachments) {
+      const attachment = attachments[attachmentEnum]
+      if (!attachment) {
+        continue
+      }
+      const attachmentSamples =
+        attachment instanceof WebGLRenderbuffer ? attachment._samples : 0
+      if (samples >= 0 && samples !== attachmentSamples) {
+        return FRAMEBUFFER_INCOMPLETE_MULTISAMPLE_ANGLE
+      }
+      samples = attachmentSamples
+    }
+
     for (let i = 1; i < width.length; ++i) {
       if (width[i - 1] !== width[i] ||
         height[i - 1] !== height[i]) {
@@ -582,7 +827,6 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
   }
 
   _resizeDrawingBuffer (width, height) {
-    const prevFramebuffer = this._activeFramebuffer
     const prevTexture = this._getActiveTexture(gl.TEXTURE_2D)
     const prevRenderbuffer = this._activeRenderbuffer
 
@@ -601,21 +845,28 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
         0)
     }
 
-    // Update color attachment
-    super.bindTexture(gl.TEXTURE_2D, drawingBuffer._color)
+    // Update color attachment, and the other buffers of the swap chain once
+    // nothing is reading from them anymore
+    const pendingFrames = drawingBuffer._pendingFrames
+    for (let i = 0; i < pendingFrames.length; ++i) {
+      this._waitFrame(pendingFrames[i])
+    }
     const colorFormat = contextAttributes.alpha ? gl.RGBA : gl.RGB
-    super.texImage2D(
-      gl.TEXTURE_2D,
-      0,
-      colorFormat,
-      width,
-      height,
-      0,
-      colorFormat,
-      gl.UNSIGNED_BYTE,
-      null)
-    super.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MIN_FILTER, gl.NEAREST)
-    super.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MAG_FILTER, gl.NEAREST)
+    for (let i = 0; i < drawingBuffer._colors.length; ++i) {
+      super.bindTexture(gl.TEXTURE_2D, drawingBuffer._colors[i])
+      super.texImage2D(
+        gl.TEXTURE_2D,
+        0,
+        colorFormat,
+        width,
+        height,
+        0,
+        colorFormat,
+        gl.UNSIGNED_BYTE,
+        null)
+      super.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MIN_FILTER, gl.NEAREST)
+      super.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MAG_FILTER, gl.NEAREST)
+    }
     super.framebufferTexture2D(
       gl.FRAMEBUFFER,
       gl.COLOR_ATTACHMENT0,
@@ -623,6 +874,26 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       drawingBuffer._color,
       0)
 
+    // With antialiasing, rendering goes to multisampled renderbuffers which
+    // are resolved into the color texture above before every read.
+    const samples = drawingBuffer._samples
+    if (samples) {
+      super.bindFramebuffer(gl.FRAMEBUFFER, drawingBuffer._renderFramebuffer)
+      super.bindRenderbuffer(gl.RENDERBUFFER, drawingBuffer._multisampleColor)
+      gl._renderbufferStorageMultisample.call(
+        this,
+        gl.RENDERBUFFER,
+        samples,
+        contextAttributes.alpha ? RGBA8_OES : RGB8_OES,
+        width,
+        height)
+      super.framebufferRenderbuffer(
+        gl.FRAMEBUFFER,
+        gl.COLOR_ATTACHMENT0,
+        gl.RENDERBUFFER,
+        drawingBuffer._multisampleColor)
+    }
+
     // Update depth-stencil attachments if needed
     let storage = 0
     let attachment = 0
@@ -641,11 +912,21 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       super.bindRenderbuffer(
         gl.RENDERBUFFER,
         drawingBuffer._depthStencil)
-      super.renderbufferStorage(
-        gl.RENDERBUFFER,
-        storage,
-        width,
-        height)
+      if (samples) {
+        gl._renderbufferStorageMultisample.call(
+          this,
+          gl.RENDERBUFFER,
+          samples,
+          storage,
+          width,
+          height)
+      } else {
+        super.renderbufferStorage(
+          gl.RENDERBUFFER,
+          storage,
+          width,
+          height)
+      }
       super.framebufferRenderbuffer(
         gl.FRAMEBUFFER,
         attachment,
@@ -653,12 +934,37 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
         drawingBuffer._depthStencil)
     }
 
+    drawingBuffer._width = width
+    drawingBuffer._height = height
+
     // Restore previous binding state
-    this.bindFramebuffer(gl.FRAMEBUFFER, prevFramebuffer)
+    this._restoreFramebuffer()
     this.bindTexture(gl.TEXTURE_2D, prevTexture)
     this.bindRenderbuffer(gl.RENDERBUFFER, prevRenderbuffer)
   }
 
+  // The drawing buffer may be allocated larger than drawingBufferWidth x
+  // drawingBufferHeight (see resize), so copies from it are clipped to the
+  // visible size. Returns null when no clipping is needed.
+  _clipDrawingBufferRead (x, y, width, height) {
+    if (this._activeReadFramebuffer) {
+      return null
+    }
+    const x0 = Math.max(x, 0)
+    const y0 = Math.max(y, 0)
+    const x1 = Math.min(x + width, this.drawingBufferWidth)
+    const y1 = Math.min(y + height, this.drawingBufferHeight)
+    if (x0 === x && y0 === y && x1 === x + width && y1 === y + height) {
+      return null
+    }
+    return {
+      x: x0,
+      y: y0,
+      width: x1 - x0,
+      height: y1 - y0
+    }
+  }
+
   _restoreError (lastError) {
     const topError = this._errorStack.pop()
     if (topError === gl.NO_ERROR) {
@@ -773,6 +1079,30 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
         mode === this._extensions.ext_blend_minmax.MAX_EXT))
   }
 
+  _validBufferTarget (target) {
+    return target === gl.ARRAY_BUFFER ||
+      target === gl.ELEMENT_ARRAY_BUFFER
+  }
+
+  _validBufferUsage (usage) {
+    return usage === gl.STREAM_DRAW ||
+      usage === gl.STATIC_DRAW ||
+      usage === gl.DYNAMIC_DRAW
+  }
+
+  _validRenderbufferFormat (internalFormat) {
+    // RGBA8 storage is needed to resolve into regular RGBA textures
+    return internalFormat === gl.RGBA4 ||
+      internalFormat === gl.RGB565 ||
+      internalFormat === gl.RGB5_A1 ||
+      internalFormat === gl.DEPTH_COMPONENT16 ||
+      internalFormat === gl.STENCIL_INDEX ||
+      internalFormat === gl.STENCIL_INDEX8 ||
+      internalFormat === gl.DEPTH_STENCIL ||
+      (!!this._extensions.angle_framebuffer_multisample &&
+        internalFormat === RGBA8_OES)
+  }
+
   _validCubeTarget (target) {
     return target === gl.TEXTURE_CUBE_MAP_POSITIVE_X ||
       target === gl.TEXTURE_CUBE_MAP_NEGATIVE_X ||
@@ -848,7 +1178,8 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     super.bufferData(
       gl.ARRAY_BUFFER,
       this._vertexGlobalState._attribs[0]._data,
-      gl.STREAM_DRAW)
+      gl.STREAM_DRAW,
+      this._attrib0Buffer._)
     super.enableVertexAttribArray(0)
     super.vertexAttribPointer(0, 4, gl.FLOAT, false, 0, 0)
     super._vertexAttribDivisor(0, 1)
@@ -938,37 +1269,49 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     if (!checkObject(framebuffer)) {
       throw new TypeError('bindFramebuffer(GLenum, WebGLFramebuffer)')
     }
-    if (target !== gl.FRAMEBUFFER) {
+    if (target !== gl.FRAMEBUFFER &&
+      !(this._extensions.angle_framebuffer_blit &&
+        (target === READ_FRAMEBUFFER_ANGLE ||
+          target === DRAW_FRAMEBUFFER_ANGLE))) {
       this.setError(gl.INVALID_ENUM)
       return
     }
     if (!framebuffer) {
       super.bindFramebuffer(
-        gl.FRAMEBUFFER,
-        this._drawingBuffer._framebuffer)
+        target,
+        this._drawingBuffer._renderFramebuffer)
     } else if (framebuffer._pendingDelete) {
       return
     } else if (this._checkWrapper(framebuffer, WebGLFramebuffer)) {
       super.bindFramebuffer(
-        gl.FRAMEBUFFER,
+        target,
         framebuffer._ | 0)
     } else {
       return
     }
-    const activeFramebuffer = this._activeFramebuffer
-    if (activeFramebuffer !== framebuffer) {
-      if (activeFramebuffer) {
-        activeFramebuffer._refCount -= 1
-        activeFramebuffer._checkDelete()
+    if (target !== READ_FRAMEBUFFER_ANGLE) {
+      this._swapFramebufferRef(this._activeFramebuffer, framebuffer)
+      this._activeFramebuffer = framebuffer
+      if (framebuffer) {
+        this._updateFramebufferAttachments(framebuffer)
+      }
+    }
+    if (target !== DRAW_FRAMEBUFFER_ANGLE) {
+      this._swapFramebufferRef(this._activeReadFramebuffer, framebuffer)
+      this._activeReadFramebuffer = framebuffer
+    }
+  }
+
+  _swapFramebufferRef (prevFramebuffer, framebuffer) {
+    if (prevFramebuffer !== framebuffer) {
+      if (prevFramebuffer) {
+        prevFramebuffer._refCount -= 1
+        prevFramebuffer._checkDelete()
       }
       if (framebuffer) {
         framebuffer._refCount += 1
       }
     }
-    this._activeFramebuffer = framebuffer
-    if (framebuffer) {
-      this._updateFramebufferAttachments(framebuffer)
-    }
   }
 
   bindBuffer (target, buffer) {
@@ -976,8 +1319,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     if (!checkObject(buffer)) {
       throw new TypeError('bindBuffer(GLenum, WebGLBuffer)')
     }
-    if (target !== gl.ARRAY_BUFFER &&
-      target !== gl.ELEMENT_ARRAY_BUFFER) {
+    if (!this._validBufferTarget(target)) {
       this.setError(gl.INVALID_ENUM)
       return
     }
@@ -1108,6 +1450,10 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       activeUnit._bind2D = texture
     } else if (target === gl.TEXTURE_CUBE_MAP) {
       activeUnit._bindCube = texture
+    } else if (target === TEXTURE_3D) {
+      activeUnit._bind3D = texture
+    } else if (target === TEXTURE_2D_ARRAY) {
+      activeUnit._bind2DArray = texture
     }
   }
 
@@ -1136,7 +1482,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     const id = super.createBuffer()
     if (id <= 0) return null
     const webGLBuffer = new WebGLBuffer(id, this)
-    this._buffers[id] = webGLBuffer
+    trackObject(this, gl.ARRAY_BUFFER, webGLBuffer)
     return webGLBuffer
   }
 
@@ -1144,7 +1490,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     const id = super.createFramebuffer()
     if (id <= 0) return null
     const webGLFramebuffer = new WebGLFramebuffer(id, this)
-    this._framebuffers[id] = webGLFramebuffer
+    trackObject(this, gl.FRAMEBUFFER, webGLFramebuffer)
     return webGLFramebuffer
   }
 
@@ -1160,7 +1506,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     const id = super.createRenderbuffer()
     if (id <= 0) return null
     const webGLRenderbuffer = new WebGLRenderbuffer(id, this)
-    this._renderbuffers[id] = webGLRenderbuffer
+    trackObject(this, gl.RENDERBUFFER, webGLRenderbuffer)
     return webGLRenderbuffer
   }
 
@@ -1168,7 +1514,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     const id = super.createTexture()
     if (id <= 0) return null
     const webGlTexture = new WebGLTexture(id, this)
-    this._textures[id] = webGlTexture
+    trackObject(this, gl.TEXTURE_2D, webGlTexture)
     return webGlTexture
   }
 
@@ -1192,11 +1538,34 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     const exts = [
       'ANGLE_instanced_arrays',
       'STACKGL_resize_drawingbuffer',
-      'STACKGL_destroy_context'
+      'STACKGL_destroy_context',
+      'STACKGL_present',
+      'STACKGL_swap_chain',
+      'STACKGL_readback_stream',
+      'STACKGL_frame_sink',
+      'STACKGL_dirty_tiles',
+      'STACKGL_scaled_readback',
+      'STACKGL_uniform_block',
+      'STACKGL_command_bundle',
+      'STACKGL_cpu_budget',
+      'STACKGL_reset_context',
+      'STACKGL_memory_info'
     ]
 
+    if (process.platform !== 'win32') {
+      exts.push('STACKGL_frame_ring')
+    }
+
     const supportedExts = super.getSupportedExtensions()
 
+    if (supportedExts.indexOf('GL_ANGLE_framebuffer_blit') >= 0) {
+      exts.push('ANGLE_framebuffer_blit')
+    }
+
+    if (supportedExts.indexOf('GL_ANGLE_framebuffer_multisample') >= 0) {
+      exts.push('ANGLE_framebuffer_multisample')
+    }
+
     if (supportedExts.indexOf('GL_OES_element_index_uint') >= 0) {
       exts.push('OES_element_index_uint')
     }
@@ -1221,6 +1590,10 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       exts.push('EXT_blend_minmax')
     }
 
+    if (supportedExts.indexOf('GL_EXT_discard_framebuffer') >= 0) {
+      exts.push('EXT_discard_framebuffer')
+    }
+
     if (supportedExts.indexOf('EXT_texture_filter_anisotropic') >= 0) {
       exts.push('EXT_texture_filter_anisotropic')
     }
@@ -1289,15 +1662,12 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
   bufferData (target, data, usage) {
     target |= 0
     usage |= 0
-    if (usage !== gl.STREAM_DRAW &&
-      usage !== gl.STATIC_DRAW &&
-      usage !== gl.DYNAMIC_DRAW) {
+    if (!this._validBufferUsage(usage)) {
       this.setError(gl.INVALID_ENUM)
       return
     }
 
-    if (target !== gl.ARRAY_BUFFER &&
-      target !== gl.ELEMENT_ARRAY_BUFFER) {
+    if (!this._validBufferTarget(target)) {
       this.setError(gl.INVALID_ENUM)
       return
     }
@@ -1323,7 +1693,8 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       super.bufferData(
         target,
         u8Data,
-        usage)
+        usage,
+        active._)
       const error = this.getError()
       this._restoreError(error)
       if (error !== gl.NO_ERROR) {
@@ -1331,6 +1702,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       }
 
       active._size = u8Data.length
+      active._version += 1
       if (target === gl.ELEMENT_ARRAY_BUFFER) {
         active._elements = new Uint8Array(u8Data)
       }
@@ -1345,7 +1717,8 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       super.bufferData(
         target,
         size,
-        usage)
+        usage,
+        active._)
       const error = this.getError()
       this._restoreError(error)
       if (error !== gl.NO_ERROR) {
@@ -1353,6 +1726,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       }
 
       active._size = size
+      active._version += 1
       if (target === gl.ELEMENT_ARRAY_BUFFER) {
         active._elements = new Uint8Array(size)
       }
@@ -1365,8 +1739,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     target |= 0
     offset |= 0
 
-    if (target !== gl.ARRAY_BUFFER &&
-      target !== gl.ELEMENT_ARRAY_BUFFER) {
+    if (!this._validBufferTarget(target)) {
       this.setError(gl.INVALID_ENUM)
       return
     }
@@ -1408,6 +1781,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
 
     if (target === gl.ELEMENT_ARRAY_BUFFER) {
       active._elements.set(u8Data, offset)
+      active._version += 1
     }
 
     super.bufferSubData(
@@ -1434,6 +1808,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     if (!this._framebufferOk()) {
       return
     }
+    finishBoundTextureUploads(this)
     return super.clear(mask | 0)
   }
 
@@ -1459,7 +1834,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       throw new TypeError('compileShader(WebGLShader)')
     }
     if (this._checkWrapper(shader, WebGLShader) &&
-      this._checkShaderSource(shader)) {
+      (this._validation === VALIDATION_NONE || this._checkShaderSource(shader))) {
       const prevError = this.getError()
       super.compileShader(shader._ | 0)
       const error = this.getError()
@@ -1512,19 +1887,57 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       return
     }
 
+    finishBoundTextureUploads(this)
+    const resolve = this._needsDrawingBufferResolve()
+    if (resolve) {
+      this._bindDrawingBufferForRead()
+    }
+
     this._saveError()
-    super.copyTexImage2D(
-      target,
-      level,
-      internalFormat,
-      x,
-      y,
-      width,
-      height,
-      border)
+    const clip = this._clipDrawingBufferRead(x, y, width, height)
+    if (clip) {
+      // Texels outside the visible drawing buffer must read as zero, so
+      // allocate a zeroed level and only copy the part that is in bounds.
+      const pixelSize = this._computePixelSize(gl.UNSIGNED_BYTE, internalFormat)
+      super.texImage2D(
+        target,
+        level,
+        internalFormat,
+        width,
+        height,
+        0,
+        internalFormat,
+        gl.UNSIGNED_BYTE,
+        new Uint8Array(this._computeRowStride(width, pixelSize) * height))
+      if (clip.width > 0 && clip.height > 0) {
+        super.copyTexSubImage2D(
+          target,
+          level,
+          clip.x - x,
+          clip.y - y,
+          clip.x,
+          clip.y,
+          clip.width,
+          clip.height)
+      }
+    } else {
+      super.copyTexImage2D(
+        target,
+        level,
+        internalFormat,
+        x,
+        y,
+        width,
+        height,
+        border)
+    }
     const error = this.getError()
     this._restoreError(error)
 
+    if (resolve) {
+      this._restoreFramebuffer()
+    }
+
     if (error === gl.NO_ERROR) {
       texture._levelWidth[level] = width
       texture._levelHeight[level] = height
@@ -1558,6 +1971,25 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       return
     }
 
+    const clip = this._clipDrawingBufferRead(x, y, width, height)
+    if (clip) {
+      if (clip.width <= 0 || clip.height <= 0) {
+        return
+      }
+      xoffset += clip.x - x
+      yoffset += clip.y - y
+      x = clip.x
+      y = clip.y
+      width = clip.width
+      height = clip.height
+    }
+
+    finishBoundTextureUploads(this)
+    const resolve = this._needsDrawingBufferResolve()
+    if (resolve) {
+      this._bindDrawingBufferForRead()
+    }
+
     super.copyTexSubImage2D(
       target,
       level,
@@ -1567,6 +1999,10 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       y,
       width,
       height)
+
+    if (resolve) {
+      this._restoreFramebuffer()
+    }
   }
 
   cullFace (mode) {
@@ -1650,8 +2086,14 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       return
     }
 
-    if (this._activeFramebuffer === framebuffer) {
+    const isDraw = this._activeFramebuffer === framebuffer
+    const isRead = this._activeReadFramebuffer === framebuffer
+    if (isDraw && isRead) {
       this.bindFramebuffer(gl.FRAMEBUFFER, null)
+    } else if (isDraw) {
+      this.bindFramebuffer(DRAW_FRAMEBUFFER_ANGLE, null)
+    } else if (isRead) {
+      this.bindFramebuffer(READ_FRAMEBUFFER_ANGLE, null)
     }
 
     framebuffer._pendingDelete = true
@@ -1717,6 +2159,12 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       } else if (unit._bindCube === texture) {
         this.activeTexture(gl.TEXTURE0 + i)
         this.bindTexture(gl.TEXTURE_CUBE_MAP, null)
+      } else if (unit._bind3D === texture) {
+        this.activeTexture(gl.TEXTURE0 + i)
+        this.bindTexture(TEXTURE_3D, null)
+      } else if (unit._bind2DArray === texture) {
+        this.activeTexture(gl.TEXTURE0 + i)
+        this.bindTexture(TEXTURE_2D_ARRAY, null)
       }
     }
     this.activeTexture(gl.TEXTURE0 + curActive)
@@ -1779,6 +2227,9 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
   }
 
   destroy () {
+    closeRenderJobs(this)
+    closeTextureUploads(this)
+    closeObjectReleases(this)
     super.destroy()
   }
 
@@ -1818,6 +2269,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     }
     super.disableVertexAttribArray(index)
     this._vertexObjectState._attribs[index]._isPointer = false
+    this._vertexObjectState._version += 1
   }
 
   drawArrays (mode, first, count) {
@@ -1843,6 +2295,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     if (!this._framebufferOk()) {
       return
     }
+    finishBoundTextureUploads(this)
 
     if (count === 0) {
       return
@@ -1890,26 +2343,17 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       return
     }
 
-    // Unpack element data
-    let elementData = null
-    let offset = ioffset
     if (type === gl.UNSIGNED_SHORT) {
-      if (offset % 2) {
+      if (ioffset % 2) {
         this.setError(gl.INVALID_OPERATION)
         return
       }
-      offset >>= 1
-      elementData = new Uint16Array(elementBuffer._elements.buffer)
     } else if (this._extensions.oes_element_index_uint && type === gl.UNSIGNED_INT) {
-      if (offset % 4) {
+      if (ioffset % 4) {
         this.setError(gl.INVALID_OPERATION)
         return
       }
-      offset >>= 2
-      elementData = new Uint32Array(elementBuffer._elements.buffer)
-    } else if (type === gl.UNSIGNED_BYTE) {
-      elementData = elementBuffer._elements
-    } else {
+    } else if (type !== gl.UNSIGNED_BYTE) {
       this.setError(gl.INVALID_ENUM)
       return
     }
@@ -1950,25 +2394,15 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     if (!this._framebufferOk()) {
       return
     }
+    finishBoundTextureUploads(this)
 
     if (count === 0) {
       this._checkVertexAttribState(0)
       return
     }
 
-    if ((count + offset) >>> 0 > elementData.length) {
-      this.setError(gl.INVALID_OPERATION)
-      return
-    }
-
-    // Compute max index
-    let maxIndex = -1
-    for (let i = offset; i < offset + count; ++i) {
-      maxIndex = Math.max(maxIndex, elementData[i])
-    }
-
+    const maxIndex = this._maxElementIndex(elementBuffer, type, ioffset, count)
     if (maxIndex < 0) {
-      this._checkVertexAttribState(0)
       return
     }
 
@@ -2006,6 +2440,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     super.enableVertexAttribArray(index)
 
     this._vertexObjectState._attribs[index]._isPointer = true
+    this._vertexObjectState._version += 1
   }
 
   finish () {
@@ -2115,6 +2550,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
   }
 
   generateMipmap (target) {
+    finishTextureUpload(this, this._getActiveTexture(target | 0))
     return super.generateMipmap(target | 0) | 0
   }
 
@@ -2344,6 +2780,14 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
           return this._extensions.oes_vertex_array_object._activeVertexArrayObject
         }
 
+        if (this._extensions.angle_framebuffer_blit && pname === READ_FRAMEBUFFER_BINDING_ANGLE) {
+          return this._activeReadFramebuffer
+        }
+
+        if (this._extensions.angle_framebuffer_multisample && pname === MAX_SAMPLES_ANGLE) {
+          return super.getParameter(pname) | 0
+        }
+
         this.setError(gl.INVALID_ENUM)
         return null
     }
@@ -2378,8 +2822,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
   getBufferParameter (target, pname) {
     target |= 0
     pname |= 0
-    if (target !== gl.ARRAY_BUFFER &&
-      target !== gl.ELEMENT_ARRAY_BUFFER) {
+    if (!this._validBufferTarget(target)) {
       this.setError(gl.INVALID_ENUM)
       return null
     }
@@ -2511,6 +2954,10 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       case gl.RENDERBUFFER_STENCIL_SIZE:
         return super.getRenderbufferParameter(target, pname)
     }
+    if (this._extensions.angle_framebuffer_multisample &&
+      pname === RENDERBUFFER_SAMPLES_ANGLE) {
+      return renderbuffer._samples
+    }
     this.setError(gl.INVALID_ENUM)
     return null
   }
@@ -2911,9 +3358,11 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       }
     }
 
-    if (!this._framebufferOk()) {
+    const readFramebuffer = this._activeReadFramebuffer
+    if (!this._framebufferOk(readFramebuffer)) {
       return
     }
+    finishBoundTextureUploads(this)
 
     let rowStride = width * 4
     if (rowStride % this._packAlignment !== 0) {
@@ -2933,13 +3382,18 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     let viewWidth = this.drawingBufferWidth
     let viewHeight = this.drawingBufferHeight
 
-    if (this._activeFramebuffer) {
-      viewWidth = this._activeFramebuffer._width
-      viewHeight = this._activeFramebuffer._height
+    if (readFramebuffer) {
+      viewWidth = readFramebuffer._width
+      viewHeight = readFramebuffer._height
     }
 
     const pixelData = unpackTypedArray(pixels)
 
+    const resolve = this._needsDrawingBufferResolve()
+    if (resolve) {
+      this._bindDrawingBufferForRead()
+    }
+
     if (x >= viewWidth || x + width <= 0 ||
       y >= viewHeight || y + height <= 0) {
       for (let i = 0; i < pixelData.length; ++i) {
@@ -3006,6 +3460,10 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
         type,
         pixelData)
     }
+
+    if (resolve) {
+      this._restoreFramebuffer()
+    }
   }
 
   renderbufferStorage (
@@ -3013,11 +3471,11 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     internalFormat,
     width,
     height) {
-    target |= 0
-    internalFormat |= 0
-    width |= 0
-    height |= 0
+    this._renderbufferStorage(target | 0, 0, internalFormat | 0, width | 0, height | 0)
+  }
 
+  // Shared by renderbufferStorage and renderbufferStorageMultisampleANGLE
+  _renderbufferStorage (target, samples, internalFormat, width, height) {
     if (target !== gl.RENDERBUFFER) {
       this.setError(gl.INVALID_ENUM)
       return
@@ -3029,23 +3487,27 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       return
     }
 
-    if (internalFormat !== gl.RGBA4 &&
-      internalFormat !== gl.RGB565 &&
-      internalFormat !== gl.RGB5_A1 &&
-      internalFormat !== gl.DEPTH_COMPONENT16 &&
-      internalFormat !== gl.STENCIL_INDEX &&
-      internalFormat !== gl.STENCIL_INDEX8 &&
-      internalFormat !== gl.DEPTH_STENCIL) {
+    if (!this._validRenderbufferFormat(internalFormat)) {
       this.setError(gl.INVALID_ENUM)
       return
     }
 
     this._saveError()
-    super.renderbufferStorage(
-      target,
-      internalFormat,
-      width,
-      height)
+    if (samples) {
+      gl._renderbufferStorageMultisample.call(
+        this,
+        target,
+        samples,
+        internalFormat,
+        width,
+        height)
+    } else {
+      super.renderbufferStorage(
+        target,
+        internalFormat,
+        width,
+        height)
+    }
     const error = this.getError()
     this._restoreError(error)
     if (error !== gl.NO_ERROR) {
@@ -3055,6 +3517,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     renderbuffer._width = width
     renderbuffer._height = height
     renderbuffer._format = internalFormat
+    renderbuffer._samples = samples
 
     const activeFramebuffer = this._activeFramebuffer
     if (activeFramebuffer) {
@@ -3079,12 +3542,163 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       throw new Error('Invalid surface dimensions')
     } else if (width !== this.drawingBufferWidth ||
       height !== this.drawingBufferHeight) {
-      this._resizeDrawingBuffer(width, height)
+      // The drawing buffer is only reallocated when it is too small or more
+      // than four times larger than needed. Growth rounds up to a multiple
+      // of 64 so that a window being dragged larger does not reallocate on
+      // every frame; otherwise the existing storage is reused and cleared.
+      const drawingBuffer = this._drawingBuffer
+      const capacityWidth = drawingBuffer._width
+      const capacityHeight = drawingBuffer._height
+      if (width > capacityWidth || height > capacityHeight) {
+        this._resizeDrawingBuffer(
+          Math.max(capacityWidth, this._roundDrawingBufferSize(width)),
+          Math.max(capacityHeight, this._roundDrawingBufferSize(height)))
+      } else if (4 * this._roundDrawingBufferSize(width) *
+        this._roundDrawingBufferSize(height) < capacityWidth * capacityHeight) {
+        this._resizeDrawingBuffer(
+          this._roundDrawingBufferSize(width),
+          this._roundDrawingBufferSize(height))
+      } else {
+        gl._clearFramebuffer.call(this, drawingBuffer._framebuffer)
+        if (drawingBuffer._samples) {
+          gl._clearFramebuffer.call(this, drawingBuffer._renderFramebuffer)
+        }
+        this._restoreFramebuffer()
+      }
       this.drawingBufferWidth = width
       this.drawingBufferHeight = height
     }
   }
 
+  // Ends the current frame, publishing it to an open STACKGL_frame_ring.
+  // Unless preserveDrawingBuffer is set, the drawing buffer is invalidated
+  // and cleared, which lets the driver skip storing this frame and loading
+  // it back at the start of the next one.
+  present () {
+    if (this._frameRing) {
+      this._frameRing.write()
+    }
+    const preserve = this._contextAttributes.preserveDrawingBuffer
+    if (this._extensions.stackgl_swap_chain) {
+      this._swapDrawingBuffer(preserve)
+    }
+    if (preserve) {
+      return
+    }
+
+    const drawingBuffer = this._drawingBuffer
+    if (drawingBuffer._canDiscard) {
+      const attachments = [gl.COLOR_ATTACHMENT0]
+      if (this._contextAttributes.depth) {
+        attachments.push(gl.DEPTH_ATTACHMENT)
+      }
+      if (this._contextAttributes.stencil) {
+        attachments.push(gl.STENCIL_ATTACHMENT)
+      }
+      super.bindFramebuffer(gl.FRAMEBUFFER, drawingBuffer._renderFramebuffer)
+      gl._discardFramebuffer.call(this, gl.FRAMEBUFFER, attachments)
+      if (drawingBuffer._samples) {
+        super.bindFramebuffer(gl.FRAMEBUFFER, drawingBuffer._framebuffer)
+        gl._discardFramebuffer.call(this, gl.FRAMEBUFFER, [gl.COLOR_ATTACHMENT0])
+      }
+    }
+    gl._clearFramebuffer.call(this, drawingBuffer._renderFramebuffer)
+    this._restoreFramebuffer()
+  }
+
+  // Queues a readback of the frame that was just presented for
+  // STACKGL_swap_chain. With more than one color buffer the read happens on
+  // a background thread while the next frame renders into the next buffer.
+  _swapDrawingBuffer (preserve) {
+    const drawingBuffer = this._drawingBuffer
+    const width = this.drawingBufferWidth
+    const height = this.drawingBufferHeight
+
+    this._bindDrawingBufferForRead()
+
+    const frame = {
+      width,
+      height,
+      data: new Uint8Array(4 * width * height),
+      texture: drawingBuffer._color,
+      ticket: 0
+    }
+    if (drawingBuffer._asyncReadback) {
+      frame.ticket = gl._readTextureAsync.call(
+        this,
+        frame.texture,
+        width,
+        height,
+        frame.data)
+    } else {
+      super.pixelStorei(gl.PACK_ALIGNMENT, 1)
+      super.readPixels(0, 0, width, height, gl.RGBA, gl.UNSIGNED_BYTE, frame.data)
+      super.pixelStorei(gl.PACK_ALIGNMENT, this._packAlignment)
+    }
+
+    const pendingFrames = drawingBuffer._pendingFrames
+    pendingFrames.push(frame)
+
+    const colors = drawingBuffer._colors
+    if (colors.length > 1) {
+      drawingBuffer._colorIndex = (drawingBuffer._colorIndex + 1) % colors.length
+      const next = colors[drawingBuffer._colorIndex]
+
+      // The next buffer can only be reused once its last read is done
+      for (let i = 0; i < pendingFrames.length; ++i) {
+        if (pendingFrames[i].texture === next) {
+          this._waitFrame(pendingFrames[i])
+        }
+      }
+
+      if (preserve && !drawingBuffer._samples) {
+        const prevTexture = this._getActiveTexture(gl.TEXTURE_2D)
+        super.bindTexture(gl.TEXTURE_2D, next)
+        super.copyTexSubImage2D(gl.TEXTURE_2D, 0, 0, 0, 0, 0, width, height)
+        this.bindTexture(gl.TEXTURE_2D, prevTexture)
+      }
+      super.framebufferTexture2D(
+        gl.FRAMEBUFFER,
+        gl.COLOR_ATTACHMENT0,
+        gl.TEXTURE_2D,
+        next,
+        0)
+      drawingBuffer._color = next
+    }
+
+    // Frames nobody asked for are dropped, oldest first
+    while (pendingFrames.length > colors.length) {
+      this._waitFrame(pendingFrames.shift())
+    }
+
+    this._restoreFramebuffer()
+  }
+
+  _waitFrame (frame) {
+    if (frame.ticket) {
+      gl._waitTextureRead.call(this, frame.ticket)
+      frame.ticket = 0
+    }
+  }
+
+  // Returns the oldest presented frame that has not been read yet
+  _readPresentedFrame () {
+    const frame = this._drawingBuffer._pendingFrames.shift()
+    if (!frame) {
+      return null
+    }
+    this._waitFrame(frame)
+    return {
+      width: frame.width,
+      height: frame.height,
+      data: frame.data
+    }
+  }
+
+  _roundDrawingBufferSize (size) {
+    return Math.max(size, Math.min((size + 63) & ~63, this._maxTextureSize))
+  }
+
   sampleCoverage (value, invert) {
     return super.sampleCoverage(+value, !!invert)
   }
@@ -3140,6 +3754,12 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     return super.stencilOpSeparate(face | 0, fail | 0, zfail | 0, zpass | 0)
   }
 
+  // Renders a self-contained job on the render threads, resolving to its
+  // pixels and timing. Does not touch the state of this context.
+  submit (job) {
+    return submitRenderJob(this, job)
+  }
+
   texImage2D (
     target,
     level,
@@ -3194,6 +3814,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       this.setError(gl.INVALID_OPERATION)
       return
     }
+    finishTextureUpload(this, texture)
 
     const pixelSize = this._computePixelSize(type, format)
     if (pixelSize === 0) {
@@ -3262,6 +3883,31 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     }
   }
 
+  // Uploads pixels on a background thread, resolving once later commands
+  // on this context will see them. pixels must not change until then.
+  texImage2DAsync (
+    target,
+    level,
+    internalFormat,
+    width,
+    height,
+    border,
+    format,
+    type,
+    pixels) {
+    return texImage2DAsync(
+      this,
+      target,
+      level,
+      internalFormat,
+      width,
+      height,
+      border,
+      format,
+      type,
+      pixels)
+  }
+
   texSubImage2D (
     target,
     level,
@@ -3306,6 +3952,7 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
       this.setError(gl.INVALID_OPERATION)
       return
     }
+    finishTextureUpload(this, texture)
 
     if (type === gl.FLOAT && !this._extensions.oes_texture_float) {
       this.setError(gl.INVALID_ENUM)
@@ -3500,21 +4147,185 @@ class WebGLRenderingContext extends NativeWebGLRenderingContext {
     return super.viewport(x | 0, y | 0, width | 0, height | 0)
   }
 
-  _allocateDrawingBuffer (width, height) {
-    this._drawingBuffer = new WebGLDrawingBufferWrapper(
+  _allocateDrawingBuffer (width, height, swapChainLength) {
+    const drawingBuffer = new WebGLDrawingBufferWrapper(
       super.createFramebuffer(),
       super.createTexture(),
       super.createRenderbuffer())
+    for (let i = 1; i < swapChainLength; ++i) {
+      drawingBuffer._colors.push(super.createTexture())
+    }
 
+    const contextAttributes = this._contextAttributes
+    const supportedExts = super.getSupportedExtensions()
+    drawingBuffer._canDiscard =
+      supportedExts.indexOf('GL_EXT_discard_framebuffer') >= 0
+    if (contextAttributes.antialias) {
+      if (supportedExts.indexOf('GL_ANGLE_framebuffer_multisample') >= 0 &&
+        supportedExts.indexOf('GL_ANGLE_framebuffer_blit') >= 0) {
+        drawingBuffer._samples = Math.min(
+          DRAWING_BUFFER_SAMPLES,
+          super.getParameter(MAX_SAMPLES_ANGLE) | 0)
+      }
+      if (drawingBuffer._samples > 0) {
+        drawingBuffer._renderFramebuffer = super.createFramebuffer()
+        drawingBuffer._multisampleColor = super.createRenderbuffer()
+      } else {
+        drawingBuffer._samples = 0
+        contextAttributes.antialias = false
+      }
+    }
+
+    this._drawingBuffer = drawingBuffer
     this._resizeDrawingBuffer(width, height)
   }
 
+  // Deletes every object created through the context and returns it to the
+  // state of a new one, keeping the EGL context and the drawing buffer
+  _resetContext (width, height) {
+    const drawingBuffer = this._drawingBuffer
+    const attrib0Buffer = this._attrib0Buffer
+    const keep = [
+      gl.FRAMEBUFFER, drawingBuffer._framebuffer,
+      gl.FRAMEBUFFER, drawingBuffer._renderFramebuffer,
+      gl.RENDERBUFFER, drawingBuffer._depthStencil,
+      gl.ARRAY_BUFFER, attrib0Buffer._
+    ]
+    if (drawingBuffer._multisampleColor) {
+      keep.push(gl.RENDERBUFFER, drawingBuffer._multisampleColor)
+    }
+    for (const color of drawingBuffer._colors) {
+      keep.push(gl.TEXTURE_2D, color)
+    }
+    gl._resetContext.call(this, new Int32Array(keep))
+
+    // Wrappers that outlive the reset behave like deleted objects
+    const tables = [
+      this._programs,
+      this._shaders,
+      this._buffers,
+      this._textures,
+      this._framebuffers,
+      this._renderbuffers
+    ]
+    const vaoExt = this._extensions.oes_vertex_array_object
+    if (vaoExt) {
+      tables.push(vaoExt._vaos)
+      vaoExt._vaos = {}
+      vaoExt._activeVertexArrayObject = null
+    }
+    for (const table of tables) {
+      for (const id in table) {
+        const object = trackedObject(table[id])
+        if (object && object !== attrib0Buffer) {
+          object._ = 0
+        }
+      }
+    }
+
+    this._programs = {}
+    this._shaders = {}
+    this._buffers = {}
+    this._textures = {}
+    this._framebuffers = {}
+    this._renderbuffers = {}
+    resetObjectReleases(this)
+    this._pendingTextureUploads.clear()
+    trackObject(this, gl.ARRAY_BUFFER, attrib0Buffer)
+    this._resetState()
+
+    if (width !== undefined || height !== undefined) {
+      this.resize(
+        width === undefined ? this.drawingBufferWidth : width,
+        height === undefined ? this.drawingBufferHeight : height)
+    }
+    this.bindFramebuffer(gl.FRAMEBUFFER, null)
+    // The drawing buffer framebuffer is kept, and so are its draw buffers
+    const drawBuffersExt = this._extensions.webgl_draw_buffers
+    if (drawBuffersExt) {
+      drawBuffersExt.drawBuffersWEBGL([gl.BACK])
+    }
+    this.viewport(0, 0, this.drawingBufferWidth, this.drawingBufferHeight)
+    this.scissor(0, 0, this.drawingBufferWidth, this.drawingBufferHeight)
+    this.clear(gl.COLOR_BUFFER_BIT | gl.DEPTH_BUFFER_BIT | gl.STENCIL_BUFFER_BIT)
+
+    // Work done before the reset is not charged to the next user
+    const budgetExt = this._extensions.stackgl_cpu_budget
+    if (budgetExt) {
+      budgetExt.resetStats()
+    }
+  }
+
+  // Bookkeeping of a new context, after the native state has been reset
+  _resetState () {
+    this._activeProgram = null
+    this._activeFramebuffer = null
+    this._activeReadFramebuffer = null
+    this._activeRenderbuffer = null
+    this._checkStencil = false
+    this._stencilState = true
+
+    for (let i = 0; i < this._textureUnits.length; ++i) {
+      this._textureUnits[i] = new WebGLTextureUnit(i)
+    }
+    this._activeTextureUnit = 0
+
+    this._errorStack = []
+    this._defaultVertexObjectState = new WebGLVertexArrayObjectState(this)
+    this._vertexObjectState = this._defaultVertexObjectState
+    this._vertexGlobalState = new WebGLVertexArrayGlobalState(this)
+
+    this._unpackAlignment = 4
+    this._packAlignment = 4
+  }
+
   isContextLost () {
     return false
   }
 
-  compressedTexImage2D () {
-    // TODO not yet implemented
+  compressedTexImage2D (target, level, internalFormat, width, height, border, data) {
+    target |= 0
+    level |= 0
+    internalFormat |= 0
+    width |= 0
+    height |= 0
+    border |= 0
+
+    const pixels = convertPixels(data)
+    if (!pixels) {
+      throw new TypeError('compressedTexImage2D(GLenum, GLint, GLenum, GLint, GLint, GLint, ArrayBufferView)')
+    }
+
+    // Only the formats of enabled compression extensions are accepted
+    const formats = this.getParameter(gl.COMPRESSED_TEXTURE_FORMATS)
+    if (formats.indexOf(internalFormat) < 0) {
+      this.setError(gl.INVALID_ENUM)
+      return
+    }
+
+    const texture = this._getTexImage(target)
+    if (!texture) {
+      this.setError(gl.INVALID_OPERATION)
+      return
+    }
+    if (level < 0 || width < 0 || height < 0 || border !== 0) {
+      this.setError(gl.INVALID_VALUE)
+      return
+    }
+    finishTextureUpload(this, texture)
+
+    this._saveError()
+    super.compressedTexImage2D(target, level, internalFormat, width, height, border, pixels)
+    const error = this.getError()
+    this._restoreError(error)
+    if (error !== gl.NO_ERROR) {
+      return
+    }
+
+    texture._levelWidth[level] = width
+    texture._levelHeight[level] = height
+    texture._format = internalFormat
+    texture._type = 0
   }
 
   compressedTexSubImage2D () {
@@ -5,6 +5,8 @@ class WebGLTextureUnit {
     this._mode = 0
     this._bind2D = null
     this._bindCube = null
+    this._bind3D = null
+    this._bind2DArray = null
   }
 }
 
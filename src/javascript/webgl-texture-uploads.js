@@ -0,0 +1,166 @@
+const { gl } = require('./native-gl')
+const { convertPixels, validCubeTarget } = require('./utils')
+
+// Allocates a level with texImage2D if needed, then fills it on the
+// uploader thread. GL errors are reported like texImage2D reports them and
+// the promise still resolves; it rejects if the uploader thread fails or
+// the context is destroyed.
+function texImage2DAsync (
+  ctx,
+  target,
+  level,
+  internalFormat,
+  width,
+  height,
+  border,
+  format,
+  type,
+  pixels) {
+  const data = convertPixels(pixels)
+  if (!data) {
+    throw new TypeError('texImage2DAsync(GLenum, GLint, GLenum, GLint, GLint, GLint, GLenum, GLenum, ArrayBufferView)')
+  }
+
+  return new Promise((resolve, reject) => {
+    target |= 0
+    level |= 0
+    width |= 0
+    height |= 0
+    format |= 0
+    type |= 0
+
+    const pixelSize = ctx._computePixelSize(type, format)
+    if (pixelSize === 0) {
+      resolve()
+      return
+    }
+    if (data.length < ctx._computeRowStride(width, pixelSize) * height) {
+      ctx.setError(gl.INVALID_OPERATION)
+      resolve()
+      return
+    }
+
+    if (!ctx._textureUploads) {
+      if (!gl._openTextureUploader.call(ctx)) {
+        // No shared context, upload on this thread instead
+        ctx.texImage2D(target, level, internalFormat, width, height, border, format, type, data)
+        resolve()
+        return
+      }
+      ctx._textureUploads = new Map()
+    }
+
+    // A 2D level of the same shape is overwritten in place, anything else
+    // goes through texImage2D, which also does the checking
+    let texture = target === gl.TEXTURE_2D ? ctx._getTexImage(target) : null
+    if (!texture ||
+      (internalFormat | 0) !== format ||
+      (border | 0) !== 0 ||
+      texture._levelWidth[level] !== width ||
+      texture._levelHeight[level] !== height ||
+      texture._format !== format ||
+      texture._type !== type) {
+      ctx._saveError()
+      ctx.texImage2D(target, level, internalFormat, width, height, border, format, type, null)
+      const error = ctx.getError()
+      ctx._restoreError(error)
+      if (error !== gl.NO_ERROR) {
+        resolve()
+        return
+      }
+      texture = ctx._getTexImage(target)
+    }
+
+    const uploads = ctx._textureUploads
+    const ticket = gl._texImage2DAsync.call(
+      ctx,
+      texture._,
+      validCubeTarget(target) ? gl.TEXTURE_CUBE_MAP : gl.TEXTURE_2D,
+      target,
+      level,
+      width,
+      height,
+      format,
+      type,
+      data,
+      (ticket, err) => {
+        uploads.delete(ticket)
+        if (texture._uploadTicket === ticket) {
+          texture._uploadTicket = 0
+          ctx._pendingTextureUploads.delete(texture)
+        }
+        // Later commands on this context wait for the upload on the GPU
+        gl._finishTextureUpload.call(ctx, ticket)
+        if (err) {
+          reject(err)
+        } else {
+          resolve()
+        }
+      })
+    uploads.set(ticket, reject)
+    texture._uploadTicket = ticket
+    ctx._pendingTextureUploads.add(texture)
+  })
+}
+
+// Makes the context wait for the last upload into texture, blocking until
+// the uploader thread has submitted it
+function finishTextureUpload (ctx, texture) {
+  if (texture && texture._uploadTicket) {
+    gl._finishTextureUpload.call(ctx, texture._uploadTicket)
+    texture._uploadTicket = 0
+    ctx._pendingTextureUploads.delete(texture)
+  }
+}
+
+function textureInUse (ctx, texture) {
+  for (const unit of ctx._textureUnits) {
+    if (unit._bind2D === texture ||
+      unit._bindCube === texture ||
+      unit._bind3D === texture ||
+      unit._bind2DArray === texture) {
+      return true
+    }
+  }
+  for (const framebuffer of [ctx._activeFramebuffer, ctx._activeReadFramebuffer]) {
+    if (framebuffer) {
+      for (const attachment in framebuffer._attachments) {
+        if (framebuffer._attachments[attachment] === texture) {
+          return true
+        }
+      }
+    }
+  }
+  return false
+}
+
+// Called before commands that sample, render to or read from textures.
+// Only uploads into textures that are bound or attached are waited for.
+function finishBoundTextureUploads (ctx) {
+  if (ctx._pendingTextureUploads.size === 0) {
+    return
+  }
+  for (const texture of ctx._pendingTextureUploads) {
+    if (textureInUse(ctx, texture)) {
+      finishTextureUpload(ctx, texture)
+    }
+  }
+}
+
+function closeTextureUploads (ctx) {
+  if (ctx._textureUploads) {
+    const err = new Error('texImage2DAsync: context was destroyed')
+    for (const reject of ctx._textureUploads.values()) {
+      reject(err)
+    }
+    ctx._textureUploads = null
+  }
+  ctx._pendingTextureUploads.clear()
+}
+
+module.exports = {
+  texImage2DAsync,
+  finishTextureUpload,
+  finishBoundTextureUploads,
+  closeTextureUploads
+}
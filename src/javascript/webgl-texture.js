@@ -1,5 +1,6 @@
 const { Linkable } = require('./linkable')
 const { gl } = require('./native-gl')
+const { untrackObject } = require('./webgl-object-release')
 
 class WebGLTexture extends Linkable {
   constructor (_, ctx) {
@@ -11,11 +12,13 @@ class WebGLTexture extends Linkable {
     this._format = 0
     this._type = 0
     this._complete = true
+    this._uploadTicket = 0
   }
 
   _performDelete () {
     const ctx = this._ctx
     delete ctx._textures[this._ | 0]
+    untrackObject(ctx, this)
     gl.deleteTexture.call(ctx, this._ | 0)
   }
 }
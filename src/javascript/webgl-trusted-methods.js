@@ -0,0 +1,174 @@
+const { gl } = require('./native-gl')
+const { finishBoundTextureUploads } = require('./webgl-texture-uploads')
+
+// Levels of the `validation` context attribute
+const VALIDATION_NONE = 0
+const VALIDATION_MINIMAL = 1
+const VALIDATION_FULL = 2
+
+const VALIDATION_LEVELS = {
+  none: VALIDATION_NONE,
+  minimal: VALIDATION_MINIMAL,
+  full: VALIDATION_FULL
+}
+
+// Methods whose wrappers only coerce and validate their arguments. Reduced
+// validation calls them directly: the context is not created with WebGL
+// compatibility, so the driver only reports what OpenGL ES forbids, and
+// restrictions that only WebGL has are not enforced.
+const NATIVE_METHODS = [
+  'blendColor',
+  'blendEquation',
+  'blendEquationSeparate',
+  'blendFunc',
+  'blendFuncSeparate',
+  'clearColor',
+  'clearDepth',
+  'colorMask',
+  'cullFace',
+  'depthFunc',
+  'depthMask',
+  'depthRange',
+  'frontFace',
+  'isEnabled',
+  'lineWidth',
+  'polygonOffset',
+  'sampleCoverage',
+  'scissor',
+  'viewport'
+]
+
+const UNIFORM_METHODS = [
+  'uniform1f',
+  'uniform2f',
+  'uniform3f',
+  'uniform4f',
+  'uniform1i',
+  'uniform2i',
+  'uniform3i',
+  'uniform4i'
+]
+
+const MATRIX_METHODS = [
+  'uniformMatrix2fv',
+  'uniformMatrix3fv',
+  'uniformMatrix4fv'
+]
+
+function validationLevel (name) {
+  return name in VALIDATION_LEVELS ? VALIDATION_LEVELS[name] : VALIDATION_FULL
+}
+
+// Methods that replace the validated ones at the given level. They are
+// called with the private context as `this`, so the full versions are still
+// reachable through it.
+function createTrustedMethods (level) {
+  const methods = {}
+  if (level === VALIDATION_FULL) {
+    return methods
+  }
+
+  for (const name of NATIVE_METHODS) {
+    methods[name] = gl[name]
+  }
+
+  // Uniform locations are unwrapped without checking their type or program
+  for (const name of UNIFORM_METHODS) {
+    const native = gl[name]
+    const vname = name + 'v'
+    methods[name] = function (location, x, y, z, w) {
+      if (location) {
+        native.call(this, location._ | 0, x, y, z, w)
+      }
+    }
+    methods[vname] = function (location, value) {
+      if (!location) {
+        return
+      }
+      if (location._array) {
+        return this[vname](location, value)
+      }
+      native.call(this, location._ | 0, value[0], value[1], value[2], value[3])
+    }
+  }
+  for (const name of MATRIX_METHODS) {
+    const native = gl[name]
+    methods[name] = function (location, transpose, value) {
+      if (location) {
+        native.call(
+          this,
+          location._ | 0,
+          !!transpose,
+          value instanceof Float32Array ? value : new Float32Array(value))
+      }
+    }
+  }
+
+  // Textures that are still being uploaded are waited for before they are
+  // cleared or drawn with
+  const nativeClear = gl.clear
+  const nativeDrawArrays = gl.drawArrays
+  const nativeDrawElements = gl.drawElements
+  if (level === VALIDATION_MINIMAL) {
+    // Incomplete framebuffers, mismatched stencil state and vertex ranges
+    // are still checked, so that draws can not read past the end of a
+    // buffer. Element indices are scanned by the full method.
+    methods.clear = function (mask) {
+      if (this._framebufferOk()) {
+        finishBoundTextureUploads(this)
+        nativeClear.call(this, mask)
+      }
+    }
+    methods.drawArrays = function (mode, first, count) {
+      if (!this._vertexObjectState._attribs[0]._isPointer || count <= 0) {
+        return this.drawArrays(mode, first, count)
+      }
+      if (!this._checkStencilState() || !this._framebufferOk()) {
+        return
+      }
+      finishBoundTextureUploads(this)
+      if (this._checkVertexAttribState((first + count - 1) >>> 0)) {
+        nativeDrawArrays.call(this, mode, first, count)
+      }
+    }
+  } else {
+    methods.clear = function (mask) {
+      finishBoundTextureUploads(this)
+      nativeClear.call(this, mask)
+    }
+    // Attribute 0 must still be emulated when it is not an enabled array
+    methods.drawArrays = function (mode, first, count) {
+      if (!this._vertexObjectState._attribs[0]._isPointer) {
+        return this.drawArrays(mode, first, count)
+      }
+      finishBoundTextureUploads(this)
+      nativeDrawArrays.call(this, mode, first, count)
+    }
+    methods.drawElements = function (mode, count, type, offset) {
+      if (!this._vertexObjectState._attribs[0]._isPointer) {
+        return this.drawElements(mode, count, type, offset)
+      }
+      finishBoundTextureUploads(this)
+      nativeDrawElements.call(this, mode, count, type, offset)
+    }
+  }
+  return methods
+}
+
+const TRUSTED_METHODS = [
+  createTrustedMethods(VALIDATION_NONE),
+  createTrustedMethods(VALIDATION_MINIMAL),
+  createTrustedMethods(VALIDATION_FULL)
+]
+
+function trustedMethods (level) {
+  return TRUSTED_METHODS[level]
+}
+
+module.exports = {
+  trustedMethods,
+  validationLevel,
+  VALIDATION_NONE,
+  VALIDATION_MINIMAL,
+  VALIDATION_FULL
+}
@@ -37,6 +37,9 @@ class WebGLVertexArrayObjectState {
       this._attribs[i] = new WebGLVertexArrayObjectAttribute(ctx, i)
     }
     this._elementArrayBufferBinding = null
+
+    // Bumped whenever a pointer, divisor or binding in this state changes
+    this._version = 0
   }
 
   setElementArrayBuffer (buffer) {
@@ -53,6 +56,7 @@ class WebGLVertexArrayObjectState {
         buffer._refCount += 1
       }
       this._elementArrayBufferBinding = buffer
+      this._version += 1
     }
   }
 
@@ -72,6 +76,7 @@ class WebGLVertexArrayObjectState {
       }
       attrib._clear()
     }
+    this._version += 1
   }
 
   releaseArrayBuffer (buffer) {
@@ -84,6 +89,7 @@ class WebGLVertexArrayObjectState {
         attrib._pointerBuffer._refCount -= 1
         attrib._pointerBuffer._checkDelete()
         attrib._clear()
+        this._version += 1
       }
     }
   }
@@ -116,6 +122,7 @@ class WebGLVertexArrayObjectState {
     attrib._pointerNormal = pointerNormal
     attrib._inputStride = inputStride
     attrib._inputSize = inputSize
+    this._version += 1
   }
 }
 
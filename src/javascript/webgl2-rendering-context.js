@@ -0,0 +1,1328 @@
+const tokenize = require('glsl-tokenizer/string')
+const HEADLESS_VERSION = require('../../package.json').version
+const { gl } = require('./native-gl')
+const { WebGLRenderingContext } = require('./webgl-rendering-context')
+const { finishTextureUpload, finishBoundTextureUploads } = require('./webgl-texture-uploads')
+const { ANGLEInstancedArrays } = require('./extensions/angle-instanced-arrays')
+const { ANGLEFramebufferBlit } = require('./extensions/angle-framebuffer-blit')
+const { ANGLEFramebufferMultisample } = require('./extensions/angle-framebuffer-multisample')
+const { EXTBlendMinMax } = require('./extensions/ext-blend-minmax')
+const { EXTShaderTextureLod } = require('./extensions/ext-shader-texture-lod')
+const { OESElementIndexUint } = require('./extensions/oes-element-index-unit')
+const { OESStandardDerivatives } = require('./extensions/oes-standard-derivatives')
+const { OESTextureFloat } = require('./extensions/oes-texture-float')
+const { OESVertexArrayObject, WebGLVertexArrayObjectOES } = require('./extensions/oes-vertex-array-object')
+const { WebGLDrawBuffers } = require('./extensions/webgl-draw-buffers')
+const {
+  checkObject,
+  isTypedArray,
+  isValidString,
+  unpackTypedArray
+} = require('./utils')
+
+const { WebGLBuffer } = require('./webgl-buffer')
+const { WebGLProgram } = require('./webgl-program')
+const { WebGLTexture } = require('./webgl-texture')
+
+// The subset of the WebGL 2 constants that this context implements
+const WEBGL2_CONSTANTS = {
+  READ_BUFFER: 0x0C02,
+  TEXTURE_BINDING_3D: 0x806A,
+  TEXTURE_3D: 0x806F,
+  TEXTURE_WRAP_R: 0x8072,
+  MAX_3D_TEXTURE_SIZE: 0x8073,
+  MAX_ELEMENTS_VERTICES: 0x80E8,
+  MAX_ELEMENTS_INDICES: 0x80E9,
+  TEXTURE_MIN_LOD: 0x813A,
+  TEXTURE_MAX_LOD: 0x813B,
+  TEXTURE_BASE_LEVEL: 0x813C,
+  TEXTURE_MAX_LEVEL: 0x813D,
+  MIN: 0x8007,
+  MAX: 0x8008,
+  DEPTH_COMPONENT24: 0x81A6,
+  MAX_TEXTURE_LOD_BIAS: 0x84FD,
+  TEXTURE_COMPARE_MODE: 0x884C,
+  TEXTURE_COMPARE_FUNC: 0x884D,
+  COMPARE_REF_TO_TEXTURE: 0x884E,
+  STREAM_READ: 0x88E1,
+  STREAM_COPY: 0x88E2,
+  STATIC_READ: 0x88E5,
+  STATIC_COPY: 0x88E6,
+  DYNAMIC_READ: 0x88E9,
+  DYNAMIC_COPY: 0x88EA,
+  MAX_DRAW_BUFFERS: 0x8824,
+  DRAW_BUFFER0: 0x8825,
+  DRAW_BUFFER1: 0x8826,
+  DRAW_BUFFER2: 0x8827,
+  DRAW_BUFFER3: 0x8828,
+  DRAW_BUFFER4: 0x8829,
+  DRAW_BUFFER5: 0x882A,
+  DRAW_BUFFER6: 0x882B,
+  DRAW_BUFFER7: 0x882C,
+  DRAW_BUFFER8: 0x882D,
+  DRAW_BUFFER9: 0x882E,
+  DRAW_BUFFER10: 0x882F,
+  DRAW_BUFFER11: 0x8830,
+  DRAW_BUFFER12: 0x8831,
+  DRAW_BUFFER13: 0x8832,
+  DRAW_BUFFER14: 0x8833,
+  DRAW_BUFFER15: 0x8834,
+  SAMPLER_3D: 0x8B5F,
+  SAMPLER_2D_SHADOW: 0x8B62,
+  FRAGMENT_SHADER_DERIVATIVE_HINT: 0x8B8B,
+  PIXEL_PACK_BUFFER: 0x88EB,
+  PIXEL_UNPACK_BUFFER: 0x88EC,
+  PIXEL_PACK_BUFFER_BINDING: 0x88ED,
+  PIXEL_UNPACK_BUFFER_BINDING: 0x88EF,
+  FLOAT_MAT2x3: 0x8B65,
+  FLOAT_MAT2x4: 0x8B66,
+  FLOAT_MAT3x2: 0x8B67,
+  FLOAT_MAT3x4: 0x8B68,
+  FLOAT_MAT4x2: 0x8B69,
+  FLOAT_MAT4x3: 0x8B6A,
+  SRGB8_ALPHA8: 0x8C43,
+  RGBA32F: 0x8814,
+  RGB32F: 0x8815,
+  RGBA16F: 0x881A,
+  RGB16F: 0x881B,
+  VERTEX_ATTRIB_ARRAY_DIVISOR: 0x88FE,
+  MAX_ARRAY_TEXTURE_LAYERS: 0x88FF,
+  TEXTURE_2D_ARRAY: 0x8C1A,
+  TEXTURE_BINDING_2D_ARRAY: 0x8C1D,
+  R11F_G11F_B10F: 0x8C3A,
+  UNSIGNED_INT_10F_11F_11F_REV: 0x8C3B,
+  RGB9_E5: 0x8C3D,
+  UNSIGNED_INT_5_9_9_9_REV: 0x8C3E,
+  RASTERIZER_DISCARD: 0x8C89,
+  RGBA32UI: 0x8D70,
+  RGB32UI: 0x8D71,
+  RGBA16UI: 0x8D76,
+  RGB16UI: 0x8D77,
+  RGBA8UI: 0x8D7C,
+  RGB8UI: 0x8D7D,
+  RGBA32I: 0x8D82,
+  RGB32I: 0x8D83,
+  RGBA16I: 0x8D88,
+  RGB16I: 0x8D89,
+  RGBA8I: 0x8D8E,
+  RGB8I: 0x8D8F,
+  RED_INTEGER: 0x8D94,
+  RGB_INTEGER: 0x8D98,
+  RGBA_INTEGER: 0x8D99,
+  SAMPLER_2D_ARRAY: 0x8DC1,
+  SAMPLER_2D_ARRAY_SHADOW: 0x8DC4,
+  SAMPLER_CUBE_SHADOW: 0x8DC5,
+  UNSIGNED_INT_VEC2: 0x8DC6,
+  UNSIGNED_INT_VEC3: 0x8DC7,
+  UNSIGNED_INT_VEC4: 0x8DC8,
+  INT_SAMPLER_2D: 0x8DCA,
+  INT_SAMPLER_3D: 0x8DCB,
+  INT_SAMPLER_CUBE: 0x8DCC,
+  INT_SAMPLER_2D_ARRAY: 0x8DCF,
+  UNSIGNED_INT_SAMPLER_2D: 0x8DD2,
+  UNSIGNED_INT_SAMPLER_3D: 0x8DD3,
+  UNSIGNED_INT_SAMPLER_CUBE: 0x8DD4,
+  UNSIGNED_INT_SAMPLER_2D_ARRAY: 0x8DD7,
+  DEPTH_COMPONENT32F: 0x8CAC,
+  DEPTH32F_STENCIL8: 0x8CAD,
+  FLOAT_32_UNSIGNED_INT_24_8_REV: 0x8DAD,
+  UNSIGNED_INT_24_8: 0x84FA,
+  DEPTH24_STENCIL8: 0x88F0,
+  DRAW_FRAMEBUFFER_BINDING: 0x8CA6,
+  READ_FRAMEBUFFER: 0x8CA8,
+  DRAW_FRAMEBUFFER: 0x8CA9,
+  READ_FRAMEBUFFER_BINDING: 0x8CAA,
+  RENDERBUFFER_SAMPLES: 0x8CAB,
+  MAX_COLOR_ATTACHMENTS: 0x8CDF,
+  COLOR_ATTACHMENT1: 0x8CE1,
+  COLOR_ATTACHMENT2: 0x8CE2,
+  COLOR_ATTACHMENT3: 0x8CE3,
+  COLOR_ATTACHMENT4: 0x8CE4,
+  COLOR_ATTACHMENT5: 0x8CE5,
+  COLOR_ATTACHMENT6: 0x8CE6,
+  COLOR_ATTACHMENT7: 0x8CE7,
+  COLOR_ATTACHMENT8: 0x8CE8,
+  COLOR_ATTACHMENT9: 0x8CE9,
+  COLOR_ATTACHMENT10: 0x8CEA,
+  COLOR_ATTACHMENT11: 0x8CEB,
+  COLOR_ATTACHMENT12: 0x8CEC,
+  COLOR_ATTACHMENT13: 0x8CED,
+  COLOR_ATTACHMENT14: 0x8CEE,
+  COLOR_ATTACHMENT15: 0x8CEF,
+  FRAMEBUFFER_INCOMPLETE_MULTISAMPLE: 0x8D56,
+  MAX_SAMPLES: 0x8D57,
+  HALF_FLOAT: 0x140B,
+  RED: 0x1903,
+  RG: 0x8227,
+  RG_INTEGER: 0x8228,
+  R8: 0x8229,
+  RG8: 0x822B,
+  R16F: 0x822D,
+  R32F: 0x822E,
+  RG16F: 0x822F,
+  RG32F: 0x8230,
+  R8I: 0x8231,
+  R8UI: 0x8232,
+  R16I: 0x8233,
+  R16UI: 0x8234,
+  R32I: 0x8235,
+  R32UI: 0x8236,
+  RG8I: 0x8237,
+  RG8UI: 0x8238,
+  RG16I: 0x8239,
+  RG16UI: 0x823A,
+  RG32I: 0x823B,
+  RG32UI: 0x823C,
+  VERTEX_ARRAY_BINDING: 0x85B5,
+  R8_SNORM: 0x8F94,
+  RG8_SNORM: 0x8F95,
+  RGB8_SNORM: 0x8F96,
+  RGBA8_SNORM: 0x8F97,
+  COPY_READ_BUFFER: 0x8F36,
+  COPY_WRITE_BUFFER: 0x8F37,
+  COPY_READ_BUFFER_BINDING: 0x8F36,
+  COPY_WRITE_BUFFER_BINDING: 0x8F37,
+  UNIFORM_BUFFER: 0x8A11,
+  UNIFORM_BUFFER_BINDING: 0x8A28,
+  UNIFORM_BUFFER_START: 0x8A29,
+  UNIFORM_BUFFER_SIZE: 0x8A2A,
+  MAX_VERTEX_UNIFORM_BLOCKS: 0x8A2B,
+  MAX_FRAGMENT_UNIFORM_BLOCKS: 0x8A2D,
+  MAX_COMBINED_UNIFORM_BLOCKS: 0x8A2E,
+  MAX_UNIFORM_BUFFER_BINDINGS: 0x8A2F,
+  MAX_UNIFORM_BLOCK_SIZE: 0x8A30,
+  MAX_COMBINED_VERTEX_UNIFORM_COMPONENTS: 0x8A31,
+  MAX_COMBINED_FRAGMENT_UNIFORM_COMPONENTS: 0x8A33,
+  UNIFORM_BUFFER_OFFSET_ALIGNMENT: 0x8A34,
+  ACTIVE_UNIFORM_BLOCKS: 0x8A36,
+  UNIFORM_BLOCK_BINDING: 0x8A3F,
+  UNIFORM_BLOCK_DATA_SIZE: 0x8A40,
+  UNIFORM_BLOCK_ACTIVE_UNIFORMS: 0x8A42,
+  UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES: 0x8A43,
+  UNIFORM_BLOCK_REFERENCED_BY_VERTEX_SHADER: 0x8A44,
+  UNIFORM_BLOCK_REFERENCED_BY_FRAGMENT_SHADER: 0x8A46,
+  INVALID_INDEX: 0xFFFFFFFF,
+  MAX_VERTEX_OUTPUT_COMPONENTS: 0x9122,
+  MAX_FRAGMENT_INPUT_COMPONENTS: 0x9125,
+  RGB8: 0x8051,
+  RGBA8: 0x8058,
+  RGB10_A2: 0x8059,
+  RGB10_A2UI: 0x906F,
+  UNSIGNED_INT_2_10_10_10_REV: 0x8368
+}
+
+const {
+  PIXEL_PACK_BUFFER,
+  PIXEL_UNPACK_BUFFER,
+  PIXEL_PACK_BUFFER_BINDING,
+  PIXEL_UNPACK_BUFFER_BINDING,
+  UNIFORM_BUFFER,
+  UNIFORM_BUFFER_BINDING,
+  UNIFORM_BUFFER_START,
+  UNIFORM_BUFFER_SIZE,
+  COPY_READ_BUFFER,
+  COPY_WRITE_BUFFER,
+  TEXTURE_3D,
+  TEXTURE_2D_ARRAY,
+  TEXTURE_BINDING_3D,
+  TEXTURE_BINDING_2D_ARRAY,
+  READ_FRAMEBUFFER,
+  DRAW_FRAMEBUFFER,
+  INVALID_INDEX
+} = WEBGL2_CONSTANTS
+
+// WebGL 1 extensions that are core in WebGL 2. They are enabled when the
+// context is created and are not returned from getExtension.
+const CORE_EXTENSIONS = {
+  angle_instanced_arrays: (ctx) => new ANGLEInstancedArrays(ctx),
+  angle_framebuffer_blit: (ctx) => new ANGLEFramebufferBlit(ctx),
+  angle_framebuffer_multisample: (ctx) => new ANGLEFramebufferMultisample(ctx),
+  ext_blend_minmax: () => new EXTBlendMinMax(),
+  ext_shader_texture_lod: () => new EXTShaderTextureLod(),
+  oes_element_index_uint: () => new OESElementIndexUint(),
+  oes_standard_derivatives: () => new OESStandardDerivatives(),
+  oes_texture_float: () => new OESTextureFloat(),
+  oes_vertex_array_object: (ctx) => new WebGL2VertexArrays(ctx),
+  webgl_draw_buffers: (ctx) => new WebGLDrawBuffers(ctx)
+}
+
+// Sized formats accepted by renderbufferStorage in addition to WebGL 1's
+const RENDERBUFFER_FORMATS = [
+  WEBGL2_CONSTANTS.R8,
+  WEBGL2_CONSTANTS.RG8,
+  WEBGL2_CONSTANTS.RGB8,
+  WEBGL2_CONSTANTS.RGBA8,
+  WEBGL2_CONSTANTS.SRGB8_ALPHA8,
+  WEBGL2_CONSTANTS.RGB10_A2,
+  WEBGL2_CONSTANTS.RGB10_A2UI,
+  WEBGL2_CONSTANTS.R8I,
+  WEBGL2_CONSTANTS.R8UI,
+  WEBGL2_CONSTANTS.R16I,
+  WEBGL2_CONSTANTS.R16UI,
+  WEBGL2_CONSTANTS.R32I,
+  WEBGL2_CONSTANTS.R32UI,
+  WEBGL2_CONSTANTS.RG8I,
+  WEBGL2_CONSTANTS.RG8UI,
+  WEBGL2_CONSTANTS.RG16I,
+  WEBGL2_CONSTANTS.RG16UI,
+  WEBGL2_CONSTANTS.RG32I,
+  WEBGL2_CONSTANTS.RG32UI,
+  WEBGL2_CONSTANTS.RGBA8I,
+  WEBGL2_CONSTANTS.RGBA8UI,
+  WEBGL2_CONSTANTS.RGBA16I,
+  WEBGL2_CONSTANTS.RGBA16UI,
+  WEBGL2_CONSTANTS.RGBA32I,
+  WEBGL2_CONSTANTS.RGBA32UI,
+  WEBGL2_CONSTANTS.DEPTH_COMPONENT24,
+  WEBGL2_CONSTANTS.DEPTH_COMPONENT32F,
+  WEBGL2_CONSTANTS.DEPTH24_STENCIL8,
+  WEBGL2_CONSTANTS.DEPTH32F_STENCIL8
+]
+
+const ESSL3_VERSION = /^\s*#\s*version\s+300\s+es\b/
+
+function formatComponents (format) {
+  switch (format) {
+    case gl.ALPHA:
+    case gl.LUMINANCE:
+    case gl.DEPTH_COMPONENT:
+    case gl.DEPTH_STENCIL:
+    case WEBGL2_CONSTANTS.RED:
+    case WEBGL2_CONSTANTS.RED_INTEGER:
+      return 1
+    case gl.LUMINANCE_ALPHA:
+    case WEBGL2_CONSTANTS.RG:
+    case WEBGL2_CONSTANTS.RG_INTEGER:
+      return 2
+    case gl.RGB:
+    case WEBGL2_CONSTANTS.RGB_INTEGER:
+      return 3
+    case gl.RGBA:
+    case WEBGL2_CONSTANTS.RGBA_INTEGER:
+      return 4
+  }
+  return 0
+}
+
+// Bytes per pixel for a client format and type, or 0 if the pair is invalid
+function texelSize (format, type) {
+  const components = formatComponents(format)
+  switch (type) {
+    case gl.UNSIGNED_BYTE:
+    case gl.BYTE:
+      return components
+    case gl.UNSIGNED_SHORT:
+    case gl.SHORT:
+    case WEBGL2_CONSTANTS.HALF_FLOAT:
+      return 2 * components
+    case gl.UNSIGNED_INT:
+    case gl.INT:
+    case gl.FLOAT:
+      return 4 * components
+    case gl.UNSIGNED_SHORT_5_6_5:
+    case gl.UNSIGNED_SHORT_4_4_4_4:
+    case gl.UNSIGNED_SHORT_5_5_5_1:
+      return components > 0 ? 2 : 0
+    case WEBGL2_CONSTANTS.UNSIGNED_INT_2_10_10_10_REV:
+    case WEBGL2_CONSTANTS.UNSIGNED_INT_10F_11F_11F_REV:
+    case WEBGL2_CONSTANTS.UNSIGNED_INT_5_9_9_9_REV:
+    case WEBGL2_CONSTANTS.UNSIGNED_INT_24_8:
+      return components > 0 ? 4 : 0
+    case WEBGL2_CONSTANTS.FLOAT_32_UNSIGNED_INT_24_8_REV:
+      return components > 0 ? 8 : 0
+  }
+  return 0
+}
+
+class WebGLVertexArrayObject extends WebGLVertexArrayObjectOES {}
+
+// Core vertex array objects share the OES_vertex_array_object bookkeeping
+class WebGL2VertexArrays extends OESVertexArrayObject {
+  createVertexArrayOES () {
+    const { _ctx: ctx } = this
+    const arrayId = gl.createVertexArrayOES.call(ctx)
+    if (arrayId <= 0) return null
+    const array = new WebGLVertexArrayObject(arrayId, ctx, this)
+    this._vaos[arrayId] = array
+    return array
+  }
+}
+
+class WebGL2RenderingContext extends WebGLRenderingContext {
+  _initWebGL2 () {
+    for (const name in CORE_EXTENSIONS) {
+      this._extensions[name] = CORE_EXTENSIONS[name](this)
+    }
+
+    // Buffers bound to the targets added in WebGL 2, by target
+    this._bufferBindings = {}
+
+    // Indexed uniform buffer bindings set by bindBufferBase/Range
+    const numBindings = this._getParameterDirect(WEBGL2_CONSTANTS.MAX_UNIFORM_BUFFER_BINDINGS)
+    this._uniformBufferBindings = new Array(numBindings)
+    for (let i = 0; i < numBindings; ++i) {
+      this._uniformBufferBindings[i] = { buffer: null, offset: 0, size: 0 }
+    }
+    this._uniformBufferOffsetAlignment =
+      this._getParameterDirect(WEBGL2_CONSTANTS.UNIFORM_BUFFER_OFFSET_ALIGNMENT)
+    this._max3DTextureSize = this._getParameterDirect(WEBGL2_CONSTANTS.MAX_3D_TEXTURE_SIZE)
+    this._maxArrayTextureLayers = this._getParameterDirect(WEBGL2_CONSTANTS.MAX_ARRAY_TEXTURE_LAYERS)
+  }
+
+  _resetState () {
+    super._resetState()
+    this._bufferBindings = {}
+    for (const binding of this._uniformBufferBindings) {
+      binding.buffer = null
+      binding.offset = 0
+      binding.size = 0
+    }
+  }
+
+  _checkShaderSource (shader) {
+    if (!ESSL3_VERSION.test(shader._source)) {
+      return super._checkShaderSource(shader)
+    }
+
+    // ESSL 3.00 has do-while loops and derivatives built in, so only the
+    // WebGL identifier rules apply
+    const tokens = tokenize(shader._source, { version: '300 es' })
+    const errorLog = []
+    for (let i = 0; i < tokens.length; ++i) {
+      const tok = tokens[i]
+      if (tok.type === 'ident' && !this._validGLSLIdentifier(tok.data)) {
+        errorLog.push(tok.line + ':' + tok.column +
+          ' invalid identifier - ' + tok.data)
+      }
+    }
+
+    if (errorLog.length > 0) {
+      shader._compileInfo = errorLog.join('\n')
+      return false
+    }
+    return true
+  }
+
+  _checkTextureTarget (target) {
+    if (target !== TEXTURE_3D && target !== TEXTURE_2D_ARRAY) {
+      return super._checkTextureTarget(target)
+    }
+    if (!this._getActiveTexture(target)) {
+      this.setError(gl.INVALID_OPERATION)
+      return false
+    }
+    return true
+  }
+
+  _getActiveBuffer (target) {
+    if (target === gl.ARRAY_BUFFER || target === gl.ELEMENT_ARRAY_BUFFER) {
+      return super._getActiveBuffer(target)
+    }
+    return this._bufferBindings[target] || null
+  }
+
+  // ES 3.0 checks attachment formats itself, so only the sizes needed to
+  // clip reads and the sample counts are tracked here
+  _preCheckFramebufferStatus (framebuffer) {
+    const attachments = framebuffer._attachments
+    let width = 0
+    let height = 0
+    let samples = -1
+    for (const attachmentEnum in attachments) {
+      const attachment = attachments[attachmentEnum]
+      if (!attachment) {
+        continue
+      }
+      let attachmentWidth, attachmentHeight, attachmentSamples
+      if (attachment instanceof WebGLTexture) {
+        const level = framebuffer._attachmentLevel[attachmentEnum]
+        attachmentWidth = attachment._levelWidth[level]
+        attachmentHeight = attachment._levelHeight[level]
+        attachmentSamples = 0
+      } else {
+        attachmentWidth = attachment._width
+        attachmentHeight = attachment._height
+        attachmentSamples = attachment._samples | 0
+      }
+      if (attachmentWidth === 0 || attachmentHeight === 0) {
+        return gl.FRAMEBUFFER_INCOMPLETE_ATTACHMENT
+      }
+      if (samples >= 0 && samples !== attachmentSamples) {
+        return WEBGL2_CONSTANTS.FRAMEBUFFER_INCOMPLETE_MULTISAMPLE
+      }
+      if (samples < 0) {
+        width = attachmentWidth
+        height = attachmentHeight
+      } else {
+        width = Math.min(width, attachmentWidth)
+        height = Math.min(height, attachmentHeight)
+      }
+      samples = attachmentSamples
+    }
+
+    if (samples < 0) {
+      return gl.FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT
+    }
+
+    framebuffer._width = width
+    framebuffer._height = height
+
+    return gl.FRAMEBUFFER_COMPLETE
+  }
+
+  _setBufferBinding (target, buffer) {
+    const current = this._bufferBindings[target] || null
+    if (current !== buffer) {
+      if (current) {
+        current._refCount -= 1
+        current._checkDelete()
+      }
+      if (buffer) {
+        buffer._refCount += 1
+      }
+    }
+    this._bufferBindings[target] = buffer
+  }
+
+  _setUniformBufferBinding (index, buffer, offset, size) {
+    const binding = this._uniformBufferBindings[index]
+    if (binding.buffer !== buffer) {
+      if (binding.buffer) {
+        binding.buffer._refCount -= 1
+        binding.buffer._checkDelete()
+      }
+      if (buffer) {
+        buffer._refCount += 1
+      }
+    }
+    binding.buffer = buffer
+    binding.offset = offset
+    binding.size = size
+  }
+
+  // Shared by texImage2D and texImage3D for sized formats and unpack buffers.
+  // Returns the data to upload, or undefined after setting an error.
+  _texImageData (pixels, pixelSize, width, height, depth) {
+    const imageSize = this._computeRowStride(width, pixelSize) * height * depth
+    const unpackBuffer = this._bufferBindings[PIXEL_UNPACK_BUFFER]
+    if (unpackBuffer) {
+      if (typeof pixels !== 'number') {
+        this.setError(gl.INVALID_OPERATION)
+        return
+      }
+      const offset = pixels
+      if (offset < 0) {
+        this.setError(gl.INVALID_VALUE)
+        return
+      }
+      if (offset + imageSize > unpackBuffer._size) {
+        this.setError(gl.INVALID_OPERATION)
+        return
+      }
+      return offset
+    }
+
+    if (pixels === null || pixels === undefined) {
+      return new Uint8Array(imageSize)
+    }
+    if (!(isTypedArray(pixels) || pixels instanceof DataView)) {
+      this.setError(gl.INVALID_OPERATION)
+      return
+    }
+    const data = unpackTypedArray(pixels)
+    if (data.length < imageSize) {
+      this.setError(gl.INVALID_OPERATION)
+      return
+    }
+    return data
+  }
+
+  _validBufferTarget (target) {
+    return super._validBufferTarget(target) ||
+      target === PIXEL_PACK_BUFFER ||
+      target === PIXEL_UNPACK_BUFFER ||
+      target === UNIFORM_BUFFER ||
+      target === COPY_READ_BUFFER ||
+      target === COPY_WRITE_BUFFER
+  }
+
+  _validBufferUsage (usage) {
+    return super._validBufferUsage(usage) ||
+      usage === WEBGL2_CONSTANTS.STREAM_READ ||
+      usage === WEBGL2_CONSTANTS.STREAM_COPY ||
+      usage === WEBGL2_CONSTANTS.STATIC_READ ||
+      usage === WEBGL2_CONSTANTS.STATIC_COPY ||
+      usage === WEBGL2_CONSTANTS.DYNAMIC_READ ||
+      usage === WEBGL2_CONSTANTS.DYNAMIC_COPY
+  }
+
+  _validRenderbufferFormat (internalFormat) {
+    return super._validRenderbufferFormat(internalFormat) ||
+      RENDERBUFFER_FORMATS.indexOf(internalFormat) >= 0
+  }
+
+  _validTextureTarget (target) {
+    return super._validTextureTarget(target) ||
+      target === TEXTURE_3D ||
+      target === TEXTURE_2D_ARRAY
+  }
+
+  getExtension (name) {
+    if (name.toLowerCase() in CORE_EXTENSIONS) {
+      return null
+    }
+    return super.getExtension(name)
+  }
+
+  getSupportedExtensions () {
+    return super.getSupportedExtensions().filter(
+      (name) => !(name.toLowerCase() in CORE_EXTENSIONS))
+  }
+
+  getParameter (pname) {
+    pname |= 0
+    switch (pname) {
+      case gl.VERSION:
+        return 'WebGL 2.0 stack-gl ' + HEADLESS_VERSION
+      case gl.SHADING_LANGUAGE_VERSION:
+        return 'WebGL GLSL ES 3.00 stack-gl'
+
+      case PIXEL_PACK_BUFFER_BINDING:
+        return this._bufferBindings[PIXEL_PACK_BUFFER] || null
+      case PIXEL_UNPACK_BUFFER_BINDING:
+        return this._bufferBindings[PIXEL_UNPACK_BUFFER] || null
+      case UNIFORM_BUFFER_BINDING:
+        return this._bufferBindings[UNIFORM_BUFFER] || null
+      case COPY_READ_BUFFER:
+      case COPY_WRITE_BUFFER:
+        return this._bufferBindings[pname] || null
+
+      case TEXTURE_BINDING_3D:
+        return this._getActiveTextureUnit()._bind3D
+      case TEXTURE_BINDING_2D_ARRAY:
+        return this._getActiveTextureUnit()._bind2DArray
+
+      case WEBGL2_CONSTANTS.RASTERIZER_DISCARD:
+        return !!this._getParameterDirect(pname)
+
+      case WEBGL2_CONSTANTS.MAX_TEXTURE_LOD_BIAS:
+        return +this._getParameterDirect(pname)
+
+      case WEBGL2_CONSTANTS.READ_BUFFER:
+      case WEBGL2_CONSTANTS.MAX_3D_TEXTURE_SIZE:
+      case WEBGL2_CONSTANTS.MAX_ARRAY_TEXTURE_LAYERS:
+      case WEBGL2_CONSTANTS.MAX_ELEMENTS_VERTICES:
+      case WEBGL2_CONSTANTS.MAX_ELEMENTS_INDICES:
+      case WEBGL2_CONSTANTS.MAX_VERTEX_UNIFORM_BLOCKS:
+      case WEBGL2_CONSTANTS.MAX_FRAGMENT_UNIFORM_BLOCKS:
+      case WEBGL2_CONSTANTS.MAX_COMBINED_UNIFORM_BLOCKS:
+      case WEBGL2_CONSTANTS.MAX_UNIFORM_BUFFER_BINDINGS:
+      case WEBGL2_CONSTANTS.MAX_UNIFORM_BLOCK_SIZE:
+      case WEBGL2_CONSTANTS.MAX_COMBINED_VERTEX_UNIFORM_COMPONENTS:
+      case WEBGL2_CONSTANTS.MAX_COMBINED_FRAGMENT_UNIFORM_COMPONENTS:
+      case WEBGL2_CONSTANTS.UNIFORM_BUFFER_OFFSET_ALIGNMENT:
+      case WEBGL2_CONSTANTS.MAX_VERTEX_OUTPUT_COMPONENTS:
+      case WEBGL2_CONSTANTS.MAX_FRAGMENT_INPUT_COMPONENTS:
+        return this._getParameterDirect(pname) | 0
+    }
+    return super.getParameter(pname)
+  }
+
+  getIndexedParameter (target, index) {
+    target |= 0
+    index |= 0
+    if (target !== UNIFORM_BUFFER_BINDING &&
+      target !== UNIFORM_BUFFER_START &&
+      target !== UNIFORM_BUFFER_SIZE) {
+      this.setError(gl.INVALID_ENUM)
+      return null
+    }
+    if (index < 0 || index >= this._uniformBufferBindings.length) {
+      this.setError(gl.INVALID_VALUE)
+      return null
+    }
+    const binding = this._uniformBufferBindings[index]
+    if (target === UNIFORM_BUFFER_BINDING) {
+      return binding.buffer
+    } else if (target === UNIFORM_BUFFER_START) {
+      return binding.offset
+    }
+    return binding.size
+  }
+
+  bindBuffer (target, buffer) {
+    target |= 0
+    if (target === gl.ARRAY_BUFFER ||
+      target === gl.ELEMENT_ARRAY_BUFFER ||
+      !this._validBufferTarget(target)) {
+      return super.bindBuffer(target, buffer)
+    }
+    if (!checkObject(buffer)) {
+      throw new TypeError('bindBuffer(GLenum, WebGLBuffer)')
+    }
+
+    if (!buffer) {
+      buffer = null
+      gl.bindBuffer.call(this, target, 0)
+    } else if (buffer._pendingDelete) {
+      return
+    } else if (this._checkWrapper(buffer, WebGLBuffer)) {
+      // Element array buffers can not be bound to any other target
+      if (buffer._binding === gl.ELEMENT_ARRAY_BUFFER) {
+        this.setError(gl.INVALID_OPERATION)
+        return
+      }
+      buffer._binding = gl.ARRAY_BUFFER
+      gl.bindBuffer.call(this, target, buffer._ | 0)
+    } else {
+      return
+    }
+
+    this._setBufferBinding(target, buffer)
+  }
+
+  bindBufferBase (target, index, buffer) {
+    this._bindBufferIndexed(target | 0, index | 0, buffer, 0, 0, false)
+  }
+
+  bindBufferRange (target, index, buffer, offset, size) {
+    this._bindBufferIndexed(target | 0, index | 0, buffer, offset | 0, size | 0, true)
+  }
+
+  _bindBufferIndexed (target, index, buffer, offset, size, range) {
+    if (!checkObject(buffer)) {
+      throw new TypeError('bindBufferRange(GLenum, GLuint, WebGLBuffer, GLintptr, GLsizeiptr)')
+    }
+    if (target !== UNIFORM_BUFFER) {
+      this.setError(gl.INVALID_ENUM)
+      return
+    }
+    if (index < 0 || index >= this._uniformBufferBindings.length) {
+      this.setError(gl.INVALID_VALUE)
+      return
+    }
+
+    if (!buffer) {
+      buffer = null
+    } else if (buffer._pendingDelete) {
+      return
+    } else if (!this._checkWrapper(buffer, WebGLBuffer)) {
+      return
+    } else if (buffer._binding === gl.ELEMENT_ARRAY_BUFFER) {
+      this.setError(gl.INVALID_OPERATION)
+      return
+    }
+
+    if (range && buffer) {
+      if (offset < 0 || size <= 0 ||
+        offset % this._uniformBufferOffsetAlignment !== 0) {
+        this.setError(gl.INVALID_VALUE)
+        return
+      }
+      gl._bindBufferRange.call(this, target, index, buffer._ | 0, offset, size)
+    } else {
+      offset = 0
+      size = 0
+      gl._bindBufferBase.call(this, target, index, buffer ? buffer._ | 0 : 0)
+    }
+
+    if (buffer) {
+      buffer._binding = gl.ARRAY_BUFFER
+    }
+
+    // Indexed binds also replace the generic binding for the target
+    this._setUniformBufferBinding(index, buffer, offset, size)
+    this._setBufferBinding(target, buffer)
+  }
+
+  deleteBuffer (buffer) {
+    if (buffer instanceof WebGLBuffer && this._checkOwns(buffer)) {
+      for (const target in this._bufferBindings) {
+        if (this._bufferBindings[target] === buffer) {
+          this.bindBuffer(target | 0, null)
+        }
+      }
+      for (let i = 0; i < this._uniformBufferBindings.length; ++i) {
+        if (this._uniformBufferBindings[i].buffer === buffer) {
+          this.bindBufferBase(UNIFORM_BUFFER, i, null)
+        }
+      }
+    }
+    super.deleteBuffer(buffer)
+  }
+
+  getBufferSubData (target, srcByteOffset, dstBuffer, dstOffset = 0, length = 0) {
+    target |= 0
+    srcByteOffset |= 0
+    dstOffset |= 0
+    length |= 0
+
+    if (!(isTypedArray(dstBuffer) || dstBuffer instanceof DataView)) {
+      throw new TypeError('getBufferSubData(GLenum, GLintptr, ArrayBufferView, GLuint, GLuint)')
+    }
+    if (!this._validBufferTarget(target)) {
+      this.setError(gl.INVALID_ENUM)
+      return
+    }
+    const buffer = this._getActiveBuffer(target)
+    if (!buffer) {
+      this.setError(gl.INVALID_OPERATION)
+      return
+    }
+
+    const elementSize = dstBuffer.BYTES_PER_ELEMENT || 1
+    const numElements = dstBuffer.byteLength / elementSize
+    if (srcByteOffset < 0 || dstOffset < 0 || length < 0 ||
+      dstOffset > numElements) {
+      this.setError(gl.INVALID_VALUE)
+      return
+    }
+    const count = length || (numElements - dstOffset)
+    const byteLength = count * elementSize
+    if (dstOffset + count > numElements ||
+      srcByteOffset + byteLength > buffer._size) {
+      this.setError(gl.INVALID_VALUE)
+      return
+    }
+    if (byteLength === 0) {
+      return
+    }
+
+    const dst = unpackTypedArray(dstBuffer).subarray(
+      dstOffset * elementSize,
+      dstOffset * elementSize + byteLength)
+    gl._getBufferSubData.call(this, target, srcByteOffset, dst)
+  }
+
+  getUniformBlockIndex (program, uniformBlockName) {
+    if (!checkObject(program)) {
+      throw new TypeError('getUniformBlockIndex(WebGLProgram, String)')
+    }
+    if (!this._checkWrapper(program, WebGLProgram)) {
+      return INVALID_INDEX
+    }
+    uniformBlockName += ''
+    if (!isValidString(uniformBlockName)) {
+      this.setError(gl.INVALID_VALUE)
+      return INVALID_INDEX
+    }
+    return gl._getUniformBlockIndex.call(this, program._ | 0, uniformBlockName)
+  }
+
+  uniformBlockBinding (program, uniformBlockIndex, uniformBlockBinding) {
+    if (!checkObject(program)) {
+      throw new TypeError('uniformBlockBinding(WebGLProgram, GLuint, GLuint)')
+    }
+    if (!this._checkWrapper(program, WebGLProgram)) {
+      return
+    }
+    uniformBlockBinding |= 0
+    if (uniformBlockBinding < 0 ||
+      uniformBlockBinding >= this._uniformBufferBindings.length) {
+      this.setError(gl.INVALID_VALUE)
+      return
+    }
+    gl._uniformBlockBinding.call(
+      this,
+      program._ | 0,
+      uniformBlockIndex >>> 0,
+      uniformBlockBinding)
+  }
+
+  getActiveUniformBlockParameter (program, uniformBlockIndex, pname) {
+    if (!checkObject(program)) {
+      throw new TypeError('getActiveUniformBlockParameter(WebGLProgram, GLuint, GLenum)')
+    }
+    if (!this._checkWrapper(program, WebGLProgram)) {
+      return null
+    }
+    pname |= 0
+    switch (pname) {
+      case WEBGL2_CONSTANTS.UNIFORM_BLOCK_BINDING:
+      case WEBGL2_CONSTANTS.UNIFORM_BLOCK_DATA_SIZE:
+      case WEBGL2_CONSTANTS.UNIFORM_BLOCK_ACTIVE_UNIFORMS:
+      case WEBGL2_CONSTANTS.UNIFORM_BLOCK_REFERENCED_BY_VERTEX_SHADER:
+      case WEBGL2_CONSTANTS.UNIFORM_BLOCK_REFERENCED_BY_FRAGMENT_SHADER:
+        return gl._getActiveUniformBlockParameter.call(
+          this, program._ | 0, uniformBlockIndex >>> 0, pname)
+      case WEBGL2_CONSTANTS.UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES:
+        return new Uint32Array(gl._getActiveUniformBlockParameter.call(
+          this, program._ | 0, uniformBlockIndex >>> 0, pname))
+    }
+    this.setError(gl.INVALID_ENUM)
+    return null
+  }
+
+  getActiveUniformBlockName (program, uniformBlockIndex) {
+    if (!checkObject(program)) {
+      throw new TypeError('getActiveUniformBlockName(WebGLProgram, GLuint)')
+    }
+    if (!this._checkWrapper(program, WebGLProgram)) {
+      return null
+    }
+    return gl._getActiveUniformBlockName.call(
+      this, program._ | 0, uniformBlockIndex >>> 0)
+  }
+
+  createVertexArray () {
+    return this._extensions.oes_vertex_array_object.createVertexArrayOES()
+  }
+
+  deleteVertexArray (array) {
+    return this._extensions.oes_vertex_array_object.deleteVertexArrayOES(array)
+  }
+
+  bindVertexArray (array) {
+    return this._extensions.oes_vertex_array_object.bindVertexArrayOES(array)
+  }
+
+  isVertexArray (array) {
+    return this._extensions.oes_vertex_array_object.isVertexArrayOES(array)
+  }
+
+  drawArraysInstanced (mode, first, count, instanceCount) {
+    return this._extensions.angle_instanced_arrays.drawArraysInstancedANGLE(
+      mode, first, count, instanceCount)
+  }
+
+  drawElementsInstanced (mode, count, type, offset, instanceCount) {
+    return this._extensions.angle_instanced_arrays.drawElementsInstancedANGLE(
+      mode, count, type, offset, instanceCount)
+  }
+
+  vertexAttribDivisor (index, divisor) {
+    return this._extensions.angle_instanced_arrays.vertexAttribDivisorANGLE(
+      index, divisor)
+  }
+
+  drawBuffers (buffers) {
+    return this._extensions.webgl_draw_buffers.drawBuffersWEBGL(buffers)
+  }
+
+  blitFramebuffer (
+    srcX0, srcY0, srcX1, srcY1,
+    dstX0, dstY0, dstX1, dstY1,
+    mask, filter) {
+    return this._extensions.angle_framebuffer_blit.blitFramebufferANGLE(
+      srcX0, srcY0, srcX1, srcY1,
+      dstX0, dstY0, dstX1, dstY1,
+      mask, filter)
+  }
+
+  renderbufferStorageMultisample (target, samples, internalFormat, width, height) {
+    return this._extensions.angle_framebuffer_multisample.renderbufferStorageMultisampleANGLE(
+      target, samples, internalFormat, width, height)
+  }
+
+  checkFramebufferStatus (target) {
+    target |= 0
+    if (target === READ_FRAMEBUFFER) {
+      const framebuffer = this._activeReadFramebuffer
+      return framebuffer
+        ? this._preCheckFramebufferStatus(framebuffer)
+        : gl.FRAMEBUFFER_COMPLETE
+    }
+    return super.checkFramebufferStatus(
+      target === DRAW_FRAMEBUFFER ? gl.FRAMEBUFFER : target)
+  }
+
+  texParameteri (target, pname, param) {
+    switch (pname | 0) {
+      case WEBGL2_CONSTANTS.TEXTURE_WRAP_R:
+      case WEBGL2_CONSTANTS.TEXTURE_BASE_LEVEL:
+      case WEBGL2_CONSTANTS.TEXTURE_MAX_LEVEL:
+      case WEBGL2_CONSTANTS.TEXTURE_COMPARE_MODE:
+      case WEBGL2_CONSTANTS.TEXTURE_COMPARE_FUNC:
+        if (this._checkTextureTarget(target | 0)) {
+          gl.texParameteri.call(this, target | 0, pname | 0, param | 0)
+        }
+        return
+      case WEBGL2_CONSTANTS.TEXTURE_MIN_LOD:
+      case WEBGL2_CONSTANTS.TEXTURE_MAX_LOD:
+        return this.texParameterf(target, pname, param)
+    }
+    return super.texParameteri(target, pname, param)
+  }
+
+  texParameterf (target, pname, param) {
+    switch (pname | 0) {
+      case WEBGL2_CONSTANTS.TEXTURE_MIN_LOD:
+      case WEBGL2_CONSTANTS.TEXTURE_MAX_LOD:
+        if (this._checkTextureTarget(target | 0)) {
+          gl.texParameterf.call(this, target | 0, pname | 0, +param)
+        }
+        return
+      case WEBGL2_CONSTANTS.TEXTURE_WRAP_R:
+      case WEBGL2_CONSTANTS.TEXTURE_BASE_LEVEL:
+      case WEBGL2_CONSTANTS.TEXTURE_MAX_LEVEL:
+      case WEBGL2_CONSTANTS.TEXTURE_COMPARE_MODE:
+      case WEBGL2_CONSTANTS.TEXTURE_COMPARE_FUNC:
+        return this.texParameteri(target, pname, param)
+    }
+    return super.texParameterf(target, pname, param)
+  }
+
+  readPixels (x, y, width, height, format, type, pixels) {
+    const packBuffer = this._bufferBindings[PIXEL_PACK_BUFFER]
+    if (!packBuffer) {
+      if (typeof pixels === 'number') {
+        this.setError(gl.INVALID_OPERATION)
+        return
+      }
+      return super.readPixels(x, y, width, height, format, type, pixels)
+    }
+    if (typeof pixels !== 'number') {
+      this.setError(gl.INVALID_OPERATION)
+      return
+    }
+
+    x |= 0
+    y |= 0
+    width |= 0
+    height |= 0
+    format |= 0
+    type |= 0
+    const offset = pixels
+
+    const pixelSize = texelSize(format, type)
+    if (pixelSize === 0) {
+      this.setError(gl.INVALID_ENUM)
+      return
+    }
+    if (width < 0 || height < 0 || offset < 0) {
+      this.setError(gl.INVALID_VALUE)
+      return
+    }
+
+    if (!this._framebufferOk(this._activeReadFramebuffer)) {
+      return
+    }
+    finishBoundTextureUploads(this)
+
+    let rowStride = width * pixelSize
+    if (rowStride % this._packAlignment !== 0) {
+      rowStride += this._packAlignment - (rowStride % this._packAlignment)
+    }
+    const imageSize = rowStride * (height - 1) + width * pixelSize
+    if (imageSize <= 0) {
+      return
+    }
+    if (offset + imageSize > packBuffer._size) {
+      this.setError(gl.INVALID_OPERATION)
+      return
+    }
+
+    const resolve = this._needsDrawingBufferResolve()
+    if (resolve) {
+      this._bindDrawingBufferForRead()
+    }
+
+    // The copy into the pack buffer happens on the GPU, so the read does not
+    // stall until the buffer contents are fetched with getBufferSubData
+    gl.readPixels.call(this, x, y, width, height, format, type, offset)
+
+    if (resolve) {
+      this._restoreFramebuffer()
+    }
+  }
+
+  texImage2D (
+    target,
+    level,
+    internalFormat,
+    width,
+    height,
+    border,
+    format,
+    type,
+    pixels) {
+    // Unsized formats without an unpack buffer keep WebGL 1 validation
+    if (arguments.length !== 9 ||
+      (!this._bufferBindings[PIXEL_UNPACK_BUFFER] &&
+        typeof pixels !== 'number' &&
+        (internalFormat | 0) === (format | 0))) {
+      return super.texImage2D(...arguments)
+    }
+
+    target |= 0
+    level |= 0
+    internalFormat |= 0
+    width |= 0
+    height |= 0
+    border |= 0
+    format |= 0
+    type |= 0
+
+    const texture = this._getTexImage(target)
+    if (!texture) {
+      this.setError(gl.INVALID_OPERATION)
+      return
+    }
+    finishTextureUpload(this, texture)
+
+    const pixelSize = texelSize(format, type)
+    if (pixelSize === 0) {
+      this.setError(gl.INVALID_ENUM)
+      return
+    }
+
+    if (!this._checkDimensions(target, width, height, level)) {
+      return
+    }
+    if (border !== 0) {
+      this.setError(gl.INVALID_VALUE)
+      return
+    }
+
+    const data = this._texImageData(pixels, pixelSize, width, height, 1)
+    if (data === undefined) {
+      return
+    }
+
+    this._saveError()
+    gl.texImage2D.call(
+      this,
+      target,
+      level,
+      internalFormat,
+      width,
+      height,
+      border,
+      format,
+      type,
+      data)
+    const error = this.getError()
+    this._restoreError(error)
+    if (error !== gl.NO_ERROR) {
+      return
+    }
+
+    texture._levelWidth[level] = width
+    texture._levelHeight[level] = height
+    texture._format = format
+    texture._type = type
+
+    const activeFramebuffer = this._activeFramebuffer
+    if (activeFramebuffer && activeFramebuffer._linked(texture)) {
+      this._updateFramebufferAttachments(activeFramebuffer)
+    }
+  }
+
+  texSubImage2D (
+    target,
+    level,
+    xoffset,
+    yoffset,
+    width,
+    height,
+    format,
+    type,
+    pixels) {
+    const unpackBuffer = this._bufferBindings[PIXEL_UNPACK_BUFFER]
+    if (!unpackBuffer) {
+      if (typeof pixels === 'number') {
+        this.setError(gl.INVALID_OPERATION)
+        return
+      }
+      return super.texSubImage2D(...arguments)
+    }
+    if (typeof pixels !== 'number') {
+      this.setError(gl.INVALID_OPERATION)
+      return
+    }
+
+    target |= 0
+    level |= 0
+    xoffset |= 0
+    yoffset |= 0
+    width |= 0
+    height |= 0
+    format |= 0
+    type |= 0
+
+    const texture = this._getTexImage(target)
+    if (!texture) {
+      this.setError(gl.INVALID_OPERATION)
+      return
+    }
+    finishTextureUpload(this, texture)
+
+    const pixelSize = texelSize(format, type)
+    if (pixelSize === 0) {
+      this.setError(gl.INVALID_ENUM)
+      return
+    }
+    if (xoffset < 0 || yoffset < 0 || width < 0 || height < 0 || level < 0) {
+      this.setError(gl.INVALID_VALUE)
+      return
+    }
+
+    const offset = this._texImageData(pixels, pixelSize, width, height, 1)
+    if (offset === undefined) {
+      return
+    }
+
+    gl.texSubImage2D.call(
+      this,
+      target,
+      level,
+      xoffset,
+      yoffset,
+      width,
+      height,
+      format,
+      type,
+      offset)
+  }
+
+  texImage3D (
+    target,
+    level,
+    internalFormat,
+    width,
+    height,
+    depth,
+    border,
+    format,
+    type,
+    pixels) {
+    target |= 0
+    level |= 0
+    internalFormat |= 0
+    width |= 0
+    height |= 0
+    depth |= 0
+    border |= 0
+    format |= 0
+    type |= 0
+
+    if (target !== TEXTURE_3D && target !== TEXTURE_2D_ARRAY) {
+      this.setError(gl.INVALID_ENUM)
+      return
+    }
+
+    const texture = this._getActiveTexture(target)
+    if (!texture) {
+      this.setError(gl.INVALID_OPERATION)
+      return
+    }
+
+    const pixelSize = texelSize(format, type)
+    if (pixelSize === 0) {
+      this.setError(gl.INVALID_ENUM)
+      return
+    }
+
+    const maxSize = target === TEXTURE_3D ? this._max3DTextureSize : this._maxTextureSize
+    const maxDepth = target === TEXTURE_3D ? this._max3DTextureSize : this._maxArrayTextureLayers
+    if (level < 0 || border !== 0 ||
+      width < 0 || height < 0 || depth < 0 ||
+      width > maxSize || height > maxSize || depth > maxDepth) {
+      this.setError(gl.INVALID_VALUE)
+      return
+    }
+
+    const data = this._texImageData(pixels, pixelSize, width, height, depth)
+    if (data === undefined) {
+      return
+    }
+
+    this._saveError()
+    gl._texImage3D.call(
+      this,
+      target,
+      level,
+      internalFormat,
+      width,
+      height,
+      depth,
+      border,
+      format,
+      type,
+      data)
+    const error = this.getError()
+    this._restoreError(error)
+    if (error !== gl.NO_ERROR) {
+      return
+    }
+
+    texture._levelWidth[level] = width
+    texture._levelHeight[level] = height
+    texture._format = format
+    texture._type = type
+  }
+
+  texSubImage3D (
+    target,
+    level,
+    xoffset,
+    yoffset,
+    zoffset,
+    width,
+    height,
+    depth,
+    format,
+    type,
+    pixels) {
+    target |= 0
+    level |= 0
+    xoffset |= 0
+    yoffset |= 0
+    zoffset |= 0
+    width |= 0
+    height |= 0
+    depth |= 0
+    format |= 0
+    type |= 0
+
+    if (target !== TEXTURE_3D && target !== TEXTURE_2D_ARRAY) {
+      this.setError(gl.INVALID_ENUM)
+      return
+    }
+
+    if (!this._getActiveTexture(target)) {
+      this.setError(gl.INVALID_OPERATION)
+      return
+    }
+
+    const pixelSize = texelSize(format, type)
+    if (pixelSize === 0) {
+      this.setError(gl.INVALID_ENUM)
+      return
+    }
+
+    if (level < 0 || xoffset < 0 || yoffset < 0 || zoffset < 0 ||
+      width < 0 || height < 0 || depth < 0) {
+      this.setError(gl.INVALID_VALUE)
+      return
+    }
+
+    if (!this._bufferBindings[PIXEL_UNPACK_BUFFER] && !pixels) {
+      this.setError(gl.INVALID_VALUE)
+      return
+    }
+
+    const data = this._texImageData(pixels, pixelSize, width, height, depth)
+    if (data === undefined) {
+      return
+    }
+
+    gl._texSubImage3D.call(
+      this,
+      target,
+      level,
+      xoffset,
+      yoffset,
+      zoffset,
+      width,
+      height,
+      depth,
+      format,
+      type,
+      data)
+  }
+}
+
+Object.assign(WebGL2RenderingContext.prototype, WEBGL2_CONSTANTS)
+
+module.exports = { WebGL2RenderingContext, WebGLVertexArrayObject }
@@ -8,8 +8,6 @@
 #include <cstdlib>
 #include "webgl.h"
 
-Nan::Persistent<v8::FunctionTemplate> WEBGL_TEMPLATE;
-
 #define JS_GL_METHOD(webgl_name, method_name) \
   Nan::SetPrototypeTemplate(\
       webgl_template \
@@ -25,6 +23,10 @@ Nan::Persistent<v8::FunctionTemplate> WEBGL_TEMPLATE;
 
 #define JS_GL_CONSTANT(name) JS_CONSTANT(name, GL_ ## name)
 
+static void DisposeThreadContexts(void*) {
+  WebGLRenderingContext::disposeThreadContexts();
+}
+
 NAN_MODULE_INIT(Init) {
   v8::Local<v8::FunctionTemplate> webgl_template =
     Nan::New<v8::FunctionTemplate>(WebGLRenderingContext::New);
@@ -104,6 +106,7 @@ NAN_MODULE_INIT(Init) {
   JS_GL_METHOD("clearStencil", ClearStencil);
   JS_GL_METHOD("colorMask", ColorMask);
   JS_GL_METHOD("copyTexImage2D", CopyTexImage2D);
+  JS_GL_METHOD("compressedTexImage2D", CompressedTexImage2D);
   JS_GL_METHOD("copyTexSubImage2D", CopyTexSubImage2D);
   JS_GL_METHOD("cullFace", CullFace);
   JS_GL_METHOD("depthMask", DepthMask);
@@ -138,10 +141,39 @@ NAN_MODULE_INIT(Init) {
   JS_GL_METHOD("isShader", IsShader);
   JS_GL_METHOD("isTexture", IsTexture);
   JS_GL_METHOD("renderbufferStorage", RenderbufferStorage);
+  JS_GL_METHOD("_renderbufferStorageMultisample", RenderbufferStorageMultisample);
+  JS_GL_METHOD("_blitFramebuffer", BlitFramebuffer);
+  JS_GL_METHOD("_discardFramebuffer", DiscardFramebuffer);
   JS_GL_METHOD("getShaderSource", GetShaderSource);
   JS_GL_METHOD("validateProgram", ValidateProgram);
   JS_GL_METHOD("texSubImage2D", TexSubImage2D);
   JS_GL_METHOD("readPixels", ReadPixels);
+  JS_GL_METHOD("_readPixelsRows", ReadPixelsRows);
+  JS_GL_METHOD("_readPixelsYUV", ReadPixelsYUV);
+  JS_GL_METHOD("_readDirtyTiles", ReadDirtyTiles);
+  JS_GL_METHOD("_readPixelsScaled", ReadPixelsScaled);
+  JS_GL_METHOD("_clearFramebuffer", ClearFramebuffer);
+  JS_GL_METHOD("_resolveDrawingBuffer", ResolveDrawingBuffer);
+  JS_GL_METHOD("_openFrameSink", OpenFrameSink);
+  JS_GL_METHOD("_writeFrameSink", WriteFrameSink);
+  JS_GL_METHOD("_closeFrameSink", CloseFrameSink);
+  JS_GL_METHOD("_openFrameRing", OpenFrameRing);
+  JS_GL_METHOD("_writeFrameRing", WriteFrameRing);
+  JS_GL_METHOD("_closeFrameRing", CloseFrameRing);
+  JS_GL_METHOD("_openReadbackWorker", OpenReadbackWorker);
+  JS_GL_METHOD("_readTextureAsync", ReadTextureAsync);
+  JS_GL_METHOD("_waitTextureRead", WaitTextureRead);
+  JS_GL_METHOD("_openRenderPool", OpenRenderPool);
+  JS_GL_METHOD("_submitRenderJob", SubmitRenderJob);
+  JS_GL_METHOD("_openTextureUploader", OpenTextureUploader);
+  JS_GL_METHOD("_texImage2DAsync", TexImage2DAsync);
+  JS_GL_METHOD("_finishTextureUpload", FinishTextureUpload);
+  JS_GL_METHOD("_setCallAccounting", SetCallAccounting);
+  JS_GL_METHOD("_getCallStats", GetCallStats);
+  JS_GL_METHOD("_getMemoryInfo", GetMemoryInfo);
+  JS_GL_METHOD("_setMemoryBudget", SetMemoryBudget);
+  JS_GL_METHOD("_resetContext", ResetContext);
+  JS_GL_METHOD("_releaseObjects", ReleaseObjects);
   JS_GL_METHOD("getTexParameter", GetTexParameter);
   JS_GL_METHOD("getActiveAttrib", GetActiveAttrib);
   JS_GL_METHOD("getActiveUniform", GetActiveUniform);
@@ -165,6 +197,19 @@ NAN_MODULE_INIT(Init) {
   JS_GL_METHOD("deleteVertexArrayOES", DeleteVertexArrayOES);
   JS_GL_METHOD("isVertexArrayOES", IsVertexArrayOES);
   JS_GL_METHOD("bindVertexArrayOES", BindVertexArrayOES);
+  JS_GL_METHOD("_bindBufferBase", BindBufferBase);
+  JS_GL_METHOD("_bindBufferRange", BindBufferRange);
+  JS_GL_METHOD("_getUniformBlockIndex", GetUniformBlockIndex);
+  JS_GL_METHOD("_uniformBlockBinding", UniformBlockBinding);
+  JS_GL_METHOD("_getActiveUniformBlockParameter", GetActiveUniformBlockParameter);
+  JS_GL_METHOD("_getActiveUniformBlockName", GetActiveUniformBlockName);
+  JS_GL_METHOD("_getBufferSubData", GetBufferSubData);
+  JS_GL_METHOD("_texImage3D", TexImage3D);
+  JS_GL_METHOD("_texSubImage3D", TexSubImage3D);
+  JS_GL_METHOD("_uniformBlock", UniformBlock);
+  JS_GL_METHOD("_createCommandBundle", CreateCommandBundle);
+  JS_GL_METHOD("_deleteCommandBundle", DeleteCommandBundle);
+  JS_GL_METHOD("_executeCommandBundle", ExecuteCommandBundle);
 
   // Windows defines a macro called NO_ERROR which messes this up
   Nan::SetPrototypeTemplate(
@@ -481,7 +526,6 @@ NAN_MODULE_INIT(Init) {
   JS_CONSTANT(IMPLEMENTATION_COLOR_READ_FORMAT, 0x8B9B);
 
   //Export template
-  WEBGL_TEMPLATE.Reset(webgl_template);
   Nan::Set(
       target
     , Nan::New<v8::String>("WebGLRenderingContext").ToLocalChecked()
@@ -490,6 +534,13 @@ NAN_MODULE_INIT(Init) {
   //Export helper methods for clean up and error handling
   Nan::Export(target, "cleanup", WebGLRenderingContext::DisposeAll);
   Nan::Export(target, "setError", WebGLRenderingContext::SetError);
+
+  //Each worker thread loads its own instance, whose contexts are released
+  //when the thread's environment shuts down
+  node::AddEnvironmentCleanupHook(
+      v8::Isolate::GetCurrent()
+    , DisposeThreadContexts
+    , NULL);
 }
 
-NODE_MODULE(webgl, Init)
+NAN_MODULE_WORKER_ENABLED(webgl, Init)
@@ -0,0 +1,118 @@
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "frame-ring-writer.h"
+
+FrameRingWriter::FrameRingWriter() :
+      header_(NULL)
+    , size_(0)
+    , slot_(NULL) {
+}
+
+FrameRingWriter::~FrameRingWriter() {
+  destroy();
+}
+
+#ifdef _WIN32
+
+bool FrameRingWriter::create(const std::string&, int, int, int) {
+  return false;
+}
+
+void FrameRingWriter::destroy() {
+}
+
+unsigned char* FrameRingWriter::beginFrame(int, int) {
+  return NULL;
+}
+
+uint64_t FrameRingWriter::endFrame() {
+  return 0;
+}
+
+#else
+
+bool FrameRingWriter::create(
+    const std::string& name,
+    int slotCount,
+    int width,
+    int height) {
+  destroy();
+
+  size_t size = stackgl_frame_ring_size(slotCount, width, height);
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    return false;
+  }
+  if (ftruncate(fd, size) != 0) {
+    close(fd);
+    shm_unlink(name.c_str());
+    return false;
+  }
+  void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    return false;
+  }
+
+  name_   = name;
+  size_   = size;
+  header_ = static_cast<stackgl_frame_ring_header*>(map);
+  header_->version    = STACKGL_FRAME_RING_VERSION;
+  header_->slotCount  = slotCount;
+  header_->format     = STACKGL_FRAME_RING_FORMAT_RGBA;
+  header_->maxWidth   = width;
+  header_->maxHeight  = height;
+  header_->slotOffset = 64;
+  header_->slotStride = stackgl_frame_ring_slot_stride(width, height);
+  header_->frameCount = 0;
+
+  //Readers check the magic number last
+  STACKGL_FRAME_RING_STORE(&header_->magic, STACKGL_FRAME_RING_MAGIC);
+  return true;
+}
+
+void FrameRingWriter::destroy() {
+  if (!header_) {
+    return;
+  }
+  munmap(header_, size_);
+  shm_unlink(name_.c_str());
+  header_ = NULL;
+  slot_   = NULL;
+  size_   = 0;
+}
+
+unsigned char* FrameRingWriter::beginFrame(int width, int height) {
+  if (!header_ || slot_ ||
+      width <= 0 || height <= 0 ||
+      static_cast<uint32_t>(width) > header_->maxWidth ||
+      static_cast<uint32_t>(height) > header_->maxHeight) {
+    return NULL;
+  }
+  uint64_t frame = header_->frameCount;
+  slot_ = stackgl_frame_ring_slot(header_, frame);
+
+  //An odd sequence number tells readers the slot is being written
+  STACKGL_FRAME_RING_STORE(&slot_->sequence, slot_->sequence + 1);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  slot_->frame  = frame;
+  slot_->width  = width;
+  slot_->height = height;
+  return reinterpret_cast<unsigned char*>(slot_ + 1);
+}
+
+uint64_t FrameRingWriter::endFrame() {
+  uint64_t frame = slot_->frame;
+  STACKGL_FRAME_RING_STORE(&slot_->sequence, slot_->sequence + 1);
+  STACKGL_FRAME_RING_STORE(&header_->frameCount, frame + 1);
+  slot_ = NULL;
+  return frame;
+}
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef FRAME_RING_WRITER_H_
+#define FRAME_RING_WRITER_H_
+
+#include <string>
+
+#include "frame-ring.h"
+
+//Owns a shared memory frame ring and publishes frames into it, see
+//frame-ring.h for the layout and the reader side
+class FrameRingWriter {
+ public:
+  FrameRingWriter();
+  ~FrameRingWriter();
+
+  bool create(const std::string& name, int slotCount, int width, int height);
+  void destroy();
+
+  int maxWidth() const { return header_ ? header_->maxWidth : 0; }
+  int maxHeight() const { return header_ ? header_->maxHeight : 0; }
+
+  //Claims the next slot for a width * height frame and returns its pixels
+  unsigned char* beginFrame(int width, int height);
+  //Publishes the claimed slot, returns its frame number
+  uint64_t endFrame();
+
+ private:
+  std::string name_;
+  stackgl_frame_ring_header* header_;
+  size_t size_;
+  stackgl_frame_slot* slot_;
+};
+
+#endif
@@ -0,0 +1,204 @@
+/*
+ * frame-ring.h
+ *
+ * Layout of the shared memory frame ring written by the STACKGL_frame_ring
+ * extension, plus a small reader that other processes can include. This
+ * header is plain C and has no dependencies beyond POSIX shared memory.
+ *
+ * The ring is a header followed by slotCount slots. Each slot starts with a
+ * stackgl_frame_slot followed by the pixels, width * height RGBA bytes with
+ * the bottom row first, as returned by glReadPixels.
+ *
+ * The writer never waits for readers. It fills slots round robin, and each
+ * slot is guarded by a sequence number that is odd while the slot is being
+ * written. A reader copies a slot and then checks that the sequence number
+ * is even and has not changed; otherwise the copy was torn and is retried,
+ * up to STACKGL_FRAME_RING_MAX_RETRIES times so that a writer that died
+ * in the middle of a frame can not hang the reader.
+ */
+
+#ifndef STACKGL_FRAME_RING_H_
+#define STACKGL_FRAME_RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define STACKGL_FRAME_RING_MAGIC    0x474c5246u
+#define STACKGL_FRAME_RING_VERSION  1u
+#define STACKGL_FRAME_RING_FORMAT_RGBA 0x1908u
+
+/* Attempts a read makes before it gives up on a slot that stays busy */
+#ifndef STACKGL_FRAME_RING_MAX_RETRIES
+#define STACKGL_FRAME_RING_MAX_RETRIES 100000
+#endif
+
+#define STACKGL_FRAME_RING_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STACKGL_FRAME_RING_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct stackgl_frame_ring_header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t slotCount;
+  uint32_t format;
+  uint32_t maxWidth;
+  uint32_t maxHeight;
+  uint64_t slotOffset;
+  uint64_t slotStride;
+  /* Number of frames published so far, frame n lives in slot n % slotCount */
+  uint64_t frameCount;
+} stackgl_frame_ring_header;
+
+typedef struct stackgl_frame_slot {
+  uint64_t sequence;
+  uint64_t frame;
+  uint32_t width;
+  uint32_t height;
+  uint64_t reserved;
+} stackgl_frame_slot;
+
+static inline size_t stackgl_frame_ring_slot_stride(uint32_t width, uint32_t height) {
+  size_t size = sizeof(stackgl_frame_slot) + 4 * (size_t)width * height;
+  return (size + 63) & ~(size_t)63;
+}
+
+static inline size_t stackgl_frame_ring_size(uint32_t slotCount, uint32_t width, uint32_t height) {
+  return 64 + slotCount * stackgl_frame_ring_slot_stride(width, height);
+}
+
+static inline stackgl_frame_slot* stackgl_frame_ring_slot(
+    const stackgl_frame_ring_header* ring,
+    uint64_t frame) {
+  return (stackgl_frame_slot*)((char*)ring + ring->slotOffset +
+    (frame % ring->slotCount) * ring->slotStride);
+}
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+typedef struct stackgl_frame_ring_reader {
+  const stackgl_frame_ring_header* header;
+  size_t size;
+} stackgl_frame_ring_reader;
+
+/* Maps the ring created under name, returns 0 on success */
+static inline int stackgl_frame_ring_open(
+    stackgl_frame_ring_reader* reader,
+    const char* name) {
+  struct stat st;
+  void* map;
+  int fd = shm_open(name, O_RDONLY, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(stackgl_frame_ring_header)) {
+    close(fd);
+    return -1;
+  }
+  map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return -1;
+  }
+  reader->header = (const stackgl_frame_ring_header*)map;
+  reader->size = (size_t)st.st_size;
+  if (reader->header->magic != STACKGL_FRAME_RING_MAGIC ||
+      reader->header->version != STACKGL_FRAME_RING_VERSION) {
+    munmap(map, reader->size);
+    return -1;
+  }
+  return 0;
+}
+
+static inline void stackgl_frame_ring_close(stackgl_frame_ring_reader* reader) {
+  munmap((void*)reader->header, reader->size);
+  reader->header = NULL;
+  reader->size = 0;
+}
+
+/* Number of frames published so far */
+static inline uint64_t stackgl_frame_ring_frame_count(const stackgl_frame_ring_reader* reader) {
+  return STACKGL_FRAME_RING_LOAD(&reader->header->frameCount);
+}
+
+/*
+ * Copies frame number `frame` into dst. Returns 1 on success, 0 if the frame
+ * has not been published yet or was already overwritten, -1 if dst is too
+ * small, and -2 if the slot was still being written after
+ * STACKGL_FRAME_RING_MAX_RETRIES attempts. width and height may be NULL.
+ */
+static inline int stackgl_frame_ring_read(
+    const stackgl_frame_ring_reader* reader,
+    uint64_t frame,
+    void* dst,
+    size_t dstSize,
+    uint32_t* width,
+    uint32_t* height) {
+  const stackgl_frame_ring_header* ring = reader->header;
+  const stackgl_frame_slot* slot = stackgl_frame_ring_slot(ring, frame);
+  unsigned retries;
+  for (retries = 0; retries < STACKGL_FRAME_RING_MAX_RETRIES; ++retries) {
+    uint64_t before = STACKGL_FRAME_RING_LOAD(&slot->sequence);
+    uint32_t w, h;
+    size_t size;
+    if (before & 1) {
+      continue;
+    }
+    if (slot->frame != frame || before == 0) {
+      return 0;
+    }
+    w = slot->width;
+    h = slot->height;
+    size = 4 * (size_t)w * h;
+    if (size > dstSize) {
+      return -1;
+    }
+    memcpy(dst, slot + 1, size);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (STACKGL_FRAME_RING_LOAD(&slot->sequence) == before) {
+      if (width) *width = w;
+      if (height) *height = h;
+      return 1;
+    }
+  }
+  return -2;
+}
+
+/* Copies the most recently published frame, see stackgl_frame_ring_read */
+static inline int stackgl_frame_ring_read_latest(
+    const stackgl_frame_ring_reader* reader,
+    void* dst,
+    size_t dstSize,
+    uint32_t* width,
+    uint32_t* height,
+    uint64_t* frame) {
+  unsigned retries;
+  for (retries = 0; retries < STACKGL_FRAME_RING_MAX_RETRIES; ++retries) {
+    uint64_t count = stackgl_frame_ring_frame_count(reader);
+    int result;
+    if (count == 0) {
+      return 0;
+    }
+    result = stackgl_frame_ring_read(reader, count - 1, dst, dstSize, width, height);
+    if (result != 0) {
+      if (frame) *frame = count - 1;
+      return result;
+    }
+  }
+  return -2;
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,144 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#define write _write
+#else
+#include <unistd.h>
+#endif
+
+#include "frame-sink.h"
+
+FrameSink::FrameSink(
+    int fd
+  , int width
+  , int height
+  , int fpsNum
+  , int fpsDen
+  , FrameSinkLayout layout
+  , bool y4m
+  , const YUVConversion& conv
+  , size_t queueLength) :
+      fd_(fd)
+    , width_(width)
+    , height_(height)
+    , fpsNum_(fpsNum)
+    , fpsDen_(fpsDen)
+    , layout_(layout)
+    , y4m_(y4m)
+    , conv_(conv)
+    , slots_(queueLength < 1 ? 1 : queueLength)
+    , yuv_(yuv420FrameSize(width, height))
+    , closing_(false)
+    , error_(false) {
+  size_t frameSize = 4 * static_cast<size_t>(width) * height;
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    slots_[i].resize(frameSize);
+    free_.push_back(slots_[i].data());
+  }
+  worker_ = std::thread(&FrameSink::run, this);
+}
+
+FrameSink::~FrameSink() {
+  close();
+}
+
+unsigned char* FrameSink::acquire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this] { return !free_.empty(); });
+  unsigned char* frame = free_.front();
+  free_.pop_front();
+  return frame;
+}
+
+void FrameSink::submit(unsigned char* frame) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.push_back(frame);
+  }
+  cond_.notify_all();
+}
+
+bool FrameSink::close() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closing_ = true;
+  }
+  cond_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+  return !error_;
+}
+
+bool FrameSink::writeAll(const unsigned char* data, size_t size) {
+  while (size > 0) {
+    int chunk = size > (1 << 30) ? (1 << 30) : static_cast<int>(size);
+    int written = write(fd_, data, chunk);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= written;
+  }
+  return true;
+}
+
+void FrameSink::run() {
+  if (y4m_) {
+    char header[128];
+    int length = snprintf(
+      header,
+      sizeof(header),
+      "YUV4MPEG2 W%d H%d F%d:%d Ip A1:1 C420jpeg XYSCSS=420JPEG XCOLORRANGE=%s\n",
+      width_,
+      height_,
+      fpsNum_,
+      fpsDen_,
+      conv_.yOffset ? "LIMITED" : "FULL");
+    if (!writeAll(reinterpret_cast<unsigned char*>(header), length)) {
+      error_ = true;
+    }
+  }
+
+  static const unsigned char FRAME_HEADER[] = { 'F', 'R', 'A', 'M', 'E', '\n' };
+  ptrdiff_t stride = 4 * static_cast<ptrdiff_t>(width_);
+
+  for (;;) {
+    unsigned char* frame;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [this] { return closing_ || !pending_.empty(); });
+      if (pending_.empty()) {
+        return;
+      }
+      frame = pending_.front();
+      pending_.pop_front();
+    }
+
+    //Frames come from glReadPixels, so the top row is the last one
+    if (!error_) {
+      const unsigned char* top = frame + stride * (height_ - 1);
+      if (layout_ == FRAME_SINK_NV12) {
+        rgbaToNV12(top, -stride, width_, height_, conv_, yuv_.data());
+      } else {
+        rgbaToI420(top, -stride, width_, height_, conv_, yuv_.data());
+      }
+      if ((y4m_ && !writeAll(FRAME_HEADER, sizeof(FRAME_HEADER))) ||
+          !writeAll(yuv_.data(), yuv_.size())) {
+        error_ = true;
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      free_.push_back(frame);
+    }
+    cond_.notify_all();
+  }
+}
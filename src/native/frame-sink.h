@@ -0,0 +1,71 @@
+#ifndef FRAME_SINK_H_
+#define FRAME_SINK_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "yuv.h"
+
+enum FrameSinkLayout {
+  FRAME_SINK_I420,
+  FRAME_SINK_NV12
+};
+
+//Converts RGBA frames to 4:2:0 YUV and writes them to a file descriptor on
+//a background thread. Frames are queued in a fixed number of slots, so a
+//producer that runs ahead of the writer blocks in acquire().
+class FrameSink {
+ public:
+  FrameSink(
+    int fd,
+    int width,
+    int height,
+    int fpsNum,
+    int fpsDen,
+    FrameSinkLayout layout,
+    bool y4m,
+    const YUVConversion& conv,
+    size_t queueLength);
+  ~FrameSink();
+
+  int width() const { return width_; }
+  int height() const { return height_; }
+
+  //Returns a free slot of width * height RGBA pixels, stored bottom-up
+  unsigned char* acquire();
+  void submit(unsigned char* frame);
+
+  //Drains the queue and stops the writer, returns false on a write error
+  bool close();
+  bool failed() const { return error_; }
+
+ private:
+  void run();
+  bool writeAll(const unsigned char* data, size_t size);
+
+  int fd_;
+  int width_;
+  int height_;
+  int fpsNum_;
+  int fpsDen_;
+  FrameSinkLayout layout_;
+  bool y4m_;
+  YUVConversion conv_;
+
+  std::vector< std::vector<unsigned char> > slots_;
+  std::deque<unsigned char*> free_;
+  std::deque<unsigned char*> pending_;
+  std::vector<unsigned char> yuv_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool closing_;
+  std::atomic<bool> error_;
+  std::thread worker_;
+};
+
+#endif
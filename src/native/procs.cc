@@ -12,6 +12,14 @@ void WebGLRenderingContext::initPointers(){
 	glUniform2i=reinterpret_cast<PFNGLUNIFORM2IPROC>(eglGetProcAddress("glUniform2i"));
 	glUniform3i=reinterpret_cast<PFNGLUNIFORM3IPROC>(eglGetProcAddress("glUniform3i"));
 	glUniform4i=reinterpret_cast<PFNGLUNIFORM4IPROC>(eglGetProcAddress("glUniform4i"));
+	glUniform1fv=reinterpret_cast<PFNGLUNIFORM1FVPROC>(eglGetProcAddress("glUniform1fv"));
+	glUniform2fv=reinterpret_cast<PFNGLUNIFORM2FVPROC>(eglGetProcAddress("glUniform2fv"));
+	glUniform3fv=reinterpret_cast<PFNGLUNIFORM3FVPROC>(eglGetProcAddress("glUniform3fv"));
+	glUniform4fv=reinterpret_cast<PFNGLUNIFORM4FVPROC>(eglGetProcAddress("glUniform4fv"));
+	glUniform1iv=reinterpret_cast<PFNGLUNIFORM1IVPROC>(eglGetProcAddress("glUniform1iv"));
+	glUniform2iv=reinterpret_cast<PFNGLUNIFORM2IVPROC>(eglGetProcAddress("glUniform2iv"));
+	glUniform3iv=reinterpret_cast<PFNGLUNIFORM3IVPROC>(eglGetProcAddress("glUniform3iv"));
+	glUniform4iv=reinterpret_cast<PFNGLUNIFORM4IVPROC>(eglGetProcAddress("glUniform4iv"));
 	glPixelStorei=reinterpret_cast<PFNGLPIXELSTOREIPROC>(eglGetProcAddress("glPixelStorei"));
 	glBindAttribLocation=reinterpret_cast<PFNGLBINDATTRIBLOCATIONPROC>(eglGetProcAddress("glBindAttribLocation"));
 	glDrawArrays=reinterpret_cast<PFNGLDRAWARRAYSPROC>(eglGetProcAddress("glDrawArrays"));
@@ -66,6 +74,7 @@ void WebGLRenderingContext::initPointers(){
 	glClearStencil=reinterpret_cast<PFNGLCLEARSTENCILPROC>(eglGetProcAddress("glClearStencil"));
 	glColorMask=reinterpret_cast<PFNGLCOLORMASKPROC>(eglGetProcAddress("glColorMask"));
 	glCopyTexImage2D=reinterpret_cast<PFNGLCOPYTEXIMAGE2DPROC>(eglGetProcAddress("glCopyTexImage2D"));
+	glCompressedTexImage2D=reinterpret_cast<PFNGLCOMPRESSEDTEXIMAGE2DPROC>(eglGetProcAddress("glCompressedTexImage2D"));
 	glCopyTexSubImage2D=reinterpret_cast<PFNGLCOPYTEXSUBIMAGE2DPROC>(eglGetProcAddress("glCopyTexSubImage2D"));
 	glCullFace=reinterpret_cast<PFNGLCULLFACEPROC>(eglGetProcAddress("glCullFace"));
 	glDepthMask=reinterpret_cast<PFNGLDEPTHMASKPROC>(eglGetProcAddress("glDepthMask"));
@@ -133,4 +142,19 @@ void WebGLRenderingContext::initPointers(){
 	glDeleteVertexArraysOES=reinterpret_cast<PFNGLDELETEVERTEXARRAYSOESPROC>(eglGetProcAddress("glDeleteVertexArraysOES"));
 	glIsVertexArrayOES=reinterpret_cast<PFNGLISVERTEXARRAYOESPROC>(eglGetProcAddress("glIsVertexArrayOES"));
 	glBindVertexArrayOES=reinterpret_cast<PFNGLBINDVERTEXARRAYOESPROC>(eglGetProcAddress("glBindVertexArrayOES"));
+	glRenderbufferStorageMultisampleANGLE=reinterpret_cast<PFNGLRENDERBUFFERSTORAGEMULTISAMPLEANGLEPROC>(eglGetProcAddress("glRenderbufferStorageMultisampleANGLE"));
+	glBlitFramebufferANGLE=reinterpret_cast<PFNGLBLITFRAMEBUFFERANGLEPROC>(eglGetProcAddress("glBlitFramebufferANGLE"));
+	glDiscardFramebufferEXT=reinterpret_cast<PFNGLDISCARDFRAMEBUFFEREXTPROC>(eglGetProcAddress("glDiscardFramebufferEXT"));
+	glBindBufferBase=reinterpret_cast<PFNGLBINDBUFFERBASEPROC>(eglGetProcAddress("glBindBufferBase"));
+	glBindBufferRange=reinterpret_cast<PFNGLBINDBUFFERRANGEPROC>(eglGetProcAddress("glBindBufferRange"));
+	glGetUniformBlockIndex=reinterpret_cast<PFNGLGETUNIFORMBLOCKINDEXPROC>(eglGetProcAddress("glGetUniformBlockIndex"));
+	glUniformBlockBinding=reinterpret_cast<PFNGLUNIFORMBLOCKBINDINGPROC>(eglGetProcAddress("glUniformBlockBinding"));
+	glGetActiveUniformBlockiv=reinterpret_cast<PFNGLGETACTIVEUNIFORMBLOCKIVPROC>(eglGetProcAddress("glGetActiveUniformBlockiv"));
+	glGetActiveUniformBlockName=reinterpret_cast<PFNGLGETACTIVEUNIFORMBLOCKNAMEPROC>(eglGetProcAddress("glGetActiveUniformBlockName"));
+	glTexImage3D=reinterpret_cast<PFNGLTEXIMAGE3DPROC>(eglGetProcAddress("glTexImage3D"));
+	glTexSubImage3D=reinterpret_cast<PFNGLTEXSUBIMAGE3DPROC>(eglGetProcAddress("glTexSubImage3D"));
+	glMapBufferRange=reinterpret_cast<PFNGLMAPBUFFERRANGEPROC>(eglGetProcAddress("glMapBufferRange"));
+	glUnmapBuffer=reinterpret_cast<PFNGLUNMAPBUFFERPROC>(eglGetProcAddress("glUnmapBuffer"));
+	glBlitFramebuffer=reinterpret_cast<PFNGLBLITFRAMEBUFFERPROC>(eglGetProcAddress("glBlitFramebuffer"));
+	glMaxShaderCompilerThreadsKHR=reinterpret_cast<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>(eglGetProcAddress("glMaxShaderCompilerThreadsKHR"));
 }
@@ -9,6 +9,14 @@
 	PFNGLUNIFORM2IPROC glUniform2i;
 	PFNGLUNIFORM3IPROC glUniform3i;
 	PFNGLUNIFORM4IPROC glUniform4i;
+	PFNGLUNIFORM1FVPROC glUniform1fv;
+	PFNGLUNIFORM2FVPROC glUniform2fv;
+	PFNGLUNIFORM3FVPROC glUniform3fv;
+	PFNGLUNIFORM4FVPROC glUniform4fv;
+	PFNGLUNIFORM1IVPROC glUniform1iv;
+	PFNGLUNIFORM2IVPROC glUniform2iv;
+	PFNGLUNIFORM3IVPROC glUniform3iv;
+	PFNGLUNIFORM4IVPROC glUniform4iv;
 	PFNGLPIXELSTOREIPROC glPixelStorei;
 	PFNGLBINDATTRIBLOCATIONPROC glBindAttribLocation;
 	PFNGLDRAWARRAYSPROC glDrawArrays;
@@ -63,6 +71,7 @@
 	PFNGLCLEARSTENCILPROC glClearStencil;
 	PFNGLCOLORMASKPROC glColorMask;
 	PFNGLCOPYTEXIMAGE2DPROC glCopyTexImage2D;
+	PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2D;
 	PFNGLCOPYTEXSUBIMAGE2DPROC glCopyTexSubImage2D;
 	PFNGLCULLFACEPROC glCullFace;
 	PFNGLDEPTHMASKPROC glDepthMask;
@@ -130,3 +139,18 @@
 	PFNGLDELETEVERTEXARRAYSOESPROC glDeleteVertexArraysOES;
 	PFNGLISVERTEXARRAYOESPROC glIsVertexArrayOES;
 	PFNGLBINDVERTEXARRAYOESPROC glBindVertexArrayOES;
+	PFNGLRENDERBUFFERSTORAGEMULTISAMPLEANGLEPROC glRenderbufferStorageMultisampleANGLE;
+	PFNGLBLITFRAMEBUFFERANGLEPROC glBlitFramebufferANGLE;
+	PFNGLDISCARDFRAMEBUFFEREXTPROC glDiscardFramebufferEXT;
+	PFNGLBINDBUFFERBASEPROC glBindBufferBase;
+	PFNGLBINDBUFFERRANGEPROC glBindBufferRange;
+	PFNGLGETUNIFORMBLOCKINDEXPROC glGetUniformBlockIndex;
+	PFNGLUNIFORMBLOCKBINDINGPROC glUniformBlockBinding;
+	PFNGLGETACTIVEUNIFORMBLOCKIVPROC glGetActiveUniformBlockiv;
+	PFNGLGETACTIVEUNIFORMBLOCKNAMEPROC glGetActiveUniformBlockName;
+	PFNGLTEXIMAGE3DPROC glTexImage3D;
+	PFNGLTEXSUBIMAGE3DPROC glTexSubImage3D;
+	PFNGLMAPBUFFERRANGEPROC glMapBufferRange;
+	PFNGLUNMAPBUFFERPROC glUnmapBuffer;
+	PFNGLBLITFRAMEBUFFERPROC glBlitFramebuffer;
+	PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glMaxShaderCompilerThreadsKHR;
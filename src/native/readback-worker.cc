@@ -0,0 +1,182 @@
+#include <cstring>
+
+#include "readback-worker.h"
+
+template <typename T>
+static T loadProc(const char* name) {
+  return reinterpret_cast<T>(eglGetProcAddress(name));
+}
+
+ReadbackWorker* ReadbackWorker::create(
+    EGLDisplay display
+  , EGLConfig config
+  , EGLContext share
+  , EGLint clientVersion) {
+  //Shared contexts must use the same client version
+  EGLint contextAttribs[] = {
+    EGL_CONTEXT_CLIENT_VERSION, clientVersion,
+    EGL_NONE
+  };
+  EGLContext context = eglCreateContext(display, config, share, contextAttribs);
+  if (context == EGL_NO_CONTEXT) {
+    return NULL;
+  }
+
+  EGLint surfaceAttribs[] = {
+      EGL_WIDTH,  1
+    , EGL_HEIGHT, 1
+    , EGL_NONE
+  };
+  EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttribs);
+  if (surface == EGL_NO_SURFACE) {
+    eglDestroyContext(display, context);
+    return NULL;
+  }
+
+  return new ReadbackWorker(display, context, surface);
+}
+
+ReadbackWorker::ReadbackWorker(
+    EGLDisplay display
+  , EGLContext context
+  , EGLSurface surface) :
+      display_(display)
+    , context_(context)
+    , surface_(surface)
+    , eglCreateSyncKHR_(NULL)
+    , eglDestroySyncKHR_(NULL)
+    , eglClientWaitSyncKHR_(NULL)
+    , submitted_(0)
+    , completed_(0)
+    , closing_(false) {
+  const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+  if (extensions && strstr(extensions, "EGL_KHR_fence_sync")) {
+    eglCreateSyncKHR_ =
+      loadProc<PFNEGLCREATESYNCKHRPROC>("eglCreateSyncKHR");
+    eglDestroySyncKHR_ =
+      loadProc<PFNEGLDESTROYSYNCKHRPROC>("eglDestroySyncKHR");
+    eglClientWaitSyncKHR_ =
+      loadProc<PFNEGLCLIENTWAITSYNCKHRPROC>("eglClientWaitSyncKHR");
+  }
+
+  glGenFramebuffers_ =
+    loadProc<PFNGLGENFRAMEBUFFERSPROC>("glGenFramebuffers");
+  glDeleteFramebuffers_ =
+    loadProc<PFNGLDELETEFRAMEBUFFERSPROC>("glDeleteFramebuffers");
+  glBindFramebuffer_ =
+    loadProc<PFNGLBINDFRAMEBUFFERPROC>("glBindFramebuffer");
+  glFramebufferTexture2D_ =
+    loadProc<PFNGLFRAMEBUFFERTEXTURE2DPROC>("glFramebufferTexture2D");
+  glPixelStorei_ =
+    loadProc<PFNGLPIXELSTOREIPROC>("glPixelStorei");
+  glReadPixels_ =
+    loadProc<PFNGLREADPIXELSPROC>("glReadPixels");
+
+  worker_ = std::thread(&ReadbackWorker::run, this);
+}
+
+ReadbackWorker::~ReadbackWorker() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closing_ = true;
+  }
+  cond_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+  eglDestroySurface(display_, surface_);
+  eglDestroyContext(display_, context_);
+}
+
+EGLSyncKHR ReadbackWorker::fence() {
+  if (!eglCreateSyncKHR_) {
+    return EGL_NO_SYNC_KHR;
+  }
+  return eglCreateSyncKHR_(display_, EGL_SYNC_FENCE_KHR, NULL);
+}
+
+uint64_t ReadbackWorker::submit(
+    GLuint texture
+  , GLsizei width
+  , GLsizei height
+  , EGLSyncKHR fence
+  , unsigned char* pixels) {
+  Job job = { texture, width, height, fence, pixels };
+  uint64_t ticket;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(job);
+    ticket = ++submitted_;
+  }
+  cond_.notify_all();
+  return ticket;
+}
+
+void ReadbackWorker::wait(uint64_t ticket) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this, ticket] { return completed_ >= ticket; });
+}
+
+void ReadbackWorker::run() {
+  if (!eglMakeCurrent(display_, surface_, surface_, context_)) {
+    //Nothing can be read, but waiters must still be released
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      cond_.wait(lock, [this] { return closing_ || !jobs_.empty(); });
+      if (jobs_.empty()) {
+        return;
+      }
+      Job job = jobs_.front();
+      jobs_.pop_front();
+      memset(job.pixels, 0, 4 * static_cast<size_t>(job.width) * job.height);
+      ++completed_;
+      cond_.notify_all();
+    }
+  }
+
+  GLuint framebuffer = 0;
+  (glGenFramebuffers_)(1, &framebuffer);
+  (glBindFramebuffer_)(GL_FRAMEBUFFER, framebuffer);
+  (glPixelStorei_)(GL_PACK_ALIGNMENT, 1);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    cond_.wait(lock, [this] { return closing_ || !jobs_.empty(); });
+    if (jobs_.empty()) {
+      break;
+    }
+    Job job = jobs_.front();
+    lock.unlock();
+
+    if (job.fence != EGL_NO_SYNC_KHR) {
+      eglClientWaitSyncKHR_(display_, job.fence, 0, EGL_FOREVER_KHR);
+      eglDestroySyncKHR_(display_, job.fence);
+    }
+    (glFramebufferTexture2D_)(
+      GL_FRAMEBUFFER,
+      GL_COLOR_ATTACHMENT0,
+      GL_TEXTURE_2D,
+      job.texture,
+      0);
+    (glReadPixels_)(
+      0,
+      0,
+      job.width,
+      job.height,
+      GL_RGBA,
+      GL_UNSIGNED_BYTE,
+      job.pixels);
+
+    lock.lock();
+    jobs_.pop_front();
+    ++completed_;
+    cond_.notify_all();
+  }
+  lock.unlock();
+
+  (glFramebufferTexture2D_)(
+    GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+  (glDeleteFramebuffers_)(1, &framebuffer);
+  eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  eglReleaseThread();
+}
@@ -0,0 +1,83 @@
+#ifndef READBACK_WORKER_H_
+#define READBACK_WORKER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+
+//Reads textures back on a background thread through a context that shares
+//objects with the rendering context. The rendering context inserts a fence
+//after the frame so the worker only starts reading once it is complete,
+//and can keep rendering into a different texture in the meantime.
+class ReadbackWorker {
+ public:
+  //Returns NULL if a shared context could not be created
+  static ReadbackWorker* create(
+    EGLDisplay display,
+    EGLConfig config,
+    EGLContext share,
+    EGLint clientVersion);
+  ~ReadbackWorker();
+
+  //Inserts a fence into the context that is current on the calling thread,
+  //returns EGL_NO_SYNC_KHR if fences are not supported
+  EGLSyncKHR fence();
+
+  //Queues a read of the bottom-left width x height RGBA pixels of texture
+  //into pixels, starting once fence has signalled. The worker takes
+  //ownership of the fence. Returns a ticket for wait().
+  uint64_t submit(
+    GLuint texture,
+    GLsizei width,
+    GLsizei height,
+    EGLSyncKHR fence,
+    unsigned char* pixels);
+
+  //Blocks until the read with the given ticket has been written
+  void wait(uint64_t ticket);
+
+ private:
+  struct Job {
+    GLuint texture;
+    GLsizei width;
+    GLsizei height;
+    EGLSyncKHR fence;
+    unsigned char* pixels;
+  };
+
+  ReadbackWorker(EGLDisplay display, EGLContext context, EGLSurface surface);
+  void run();
+
+  EGLDisplay display_;
+  EGLContext context_;
+  EGLSurface surface_;
+
+  PFNEGLCREATESYNCKHRPROC eglCreateSyncKHR_;
+  PFNEGLDESTROYSYNCKHRPROC eglDestroySyncKHR_;
+  PFNEGLCLIENTWAITSYNCKHRPROC eglClientWaitSyncKHR_;
+
+  PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers_;
+  PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers_;
+  PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer_;
+  PFNGLFRAMEBUFFERTEXTURE2DPROC glFramebufferTexture2D_;
+  PFNGLPIXELSTOREIPROC glPixelStorei_;
+  PFNGLREADPIXELSPROC glReadPixels_;
+
+  std::deque<Job> jobs_;
+  uint64_t submitted_;
+  uint64_t completed_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool closing_;
+  std::thread worker_;
+};
+
+#endif
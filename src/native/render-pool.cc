@@ -0,0 +1,199 @@
+#include "render-pool.h"
+#include "webgl.h"
+
+RenderJob::RenderJob() :
+    width(0)
+  , height(0)
+  , depthTest(false)
+  , elementType(GL_UNSIGNED_SHORT)
+  , thread(-1)
+  , callback(NULL)
+  , resource(NULL) {
+  clearColor[0] = clearColor[1] = clearColor[2] = clearColor[3] = 0.f;
+}
+
+RenderJob::~RenderJob() {
+  delete callback;
+  delete resource;
+}
+
+static void closeAsync(uv_handle_t* handle) {
+  delete reinterpret_cast<uv_async_t*>(handle);
+}
+
+RenderPool* RenderPool::create(
+    int threads
+  , int queueDepth
+  , int displayCount
+  , int backend) {
+  if (threads <= 0) {
+    return NULL;
+  }
+  RenderPool* pool = new RenderPool(
+    queueDepth > 0 ? queueDepth : 2 * threads,
+    displayCount,
+    backend);
+  if (uv_async_init(
+        Nan::GetCurrentEventLoop(),
+        pool->async_,
+        &RenderPool::deliver) != 0) {
+    delete pool->async_;
+    pool->async_ = NULL;
+    delete pool;
+    return NULL;
+  }
+  pool->async_->data = pool;
+
+  //The event loop is only kept alive while jobs are in flight
+  uv_unref(reinterpret_cast<uv_handle_t*>(pool->async_));
+
+  for (int i = 0; i < threads; ++i) {
+    pool->threads_.push_back(std::thread(&RenderPool::run, pool, i));
+  }
+  return pool;
+}
+
+RenderPool::RenderPool(int queueDepth, int displayCount, int backend) :
+    queueDepth_(queueDepth)
+  , displayCount_(displayCount)
+  , backend_(backend)
+  , inFlight_(0)
+  , closing_(false)
+  , async_(new uv_async_t) {
+}
+
+RenderPool::~RenderPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closing_ = true;
+  }
+  cond_.notify_all();
+  for (size_t i = 0; i < threads_.size(); ++i) {
+    threads_[i].join();
+  }
+
+  //Jobs that were never delivered are dropped with their callbacks
+  for (size_t i = 0; i < queue_.size(); ++i) {
+    delete queue_[i];
+  }
+  for (size_t i = 0; i < done_.size(); ++i) {
+    delete done_[i];
+  }
+
+  if (async_) {
+    async_->data = NULL;
+    uv_close(reinterpret_cast<uv_handle_t*>(async_), closeAsync);
+  }
+}
+
+bool RenderPool::full() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return inFlight_ >= queueDepth_;
+}
+
+bool RenderPool::submit(RenderJob* job) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (inFlight_ >= queueDepth_) {
+      return false;
+    }
+    if (inFlight_++ == 0) {
+      uv_ref(reinterpret_cast<uv_handle_t*>(async_));
+    }
+    job->submitted = std::chrono::steady_clock::now();
+    queue_.push_back(job);
+  }
+  cond_.notify_one();
+  return true;
+}
+
+void RenderPool::run(int index) {
+  //Each thread owns a context, which is current on it from now on
+  WebGLRenderingContext* ctx = new WebGLRenderingContext(
+    1, 1, true, true, false, false, true, false, false, false, 1,
+    displayCount_, -1, backend_, 0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    cond_.wait(lock, [this] { return closing_ || !queue_.empty(); });
+    if (closing_) {
+      break;
+    }
+    RenderJob* job = queue_.front();
+    queue_.pop_front();
+    lock.unlock();
+
+    job->thread = index;
+    job->started = std::chrono::steady_clock::now();
+    if (ctx->state != GLCONTEXT_STATE_OK) {
+      job->error = "Error creating render context";
+    } else {
+      ctx->runRenderJob(*job);
+    }
+    job->finished = std::chrono::steady_clock::now();
+
+    lock.lock();
+    done_.push_back(job);
+    uv_async_send(async_);
+  }
+  lock.unlock();
+
+  delete ctx;
+  eglReleaseThread();
+}
+
+static double milliseconds(
+    std::chrono::steady_clock::time_point from
+  , std::chrono::steady_clock::time_point to) {
+  return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+void RenderPool::deliver(uv_async_t* handle) {
+  RenderPool* pool = reinterpret_cast<RenderPool*>(handle->data);
+  if (!pool) {
+    return;
+  }
+
+  std::deque<RenderJob*> done;
+  {
+    std::lock_guard<std::mutex> lock(pool->mutex_);
+    done.swap(pool->done_);
+    pool->inFlight_ -= done.size();
+    if (pool->inFlight_ == 0) {
+      uv_unref(reinterpret_cast<uv_handle_t*>(pool->async_));
+    }
+  }
+
+  Nan::HandleScope scope;
+  for (size_t i = 0; i < done.size(); ++i) {
+    RenderJob* job = done[i];
+
+    if (!job->error.empty()) {
+      v8::Local<v8::Value> argv[] = {
+        Nan::Error(job->error.c_str())
+      };
+      job->callback->Call(1, argv, job->resource);
+    } else {
+      v8::Local<v8::Object> timing = Nan::New<v8::Object>();
+      Nan::Set(timing,
+        Nan::New("queueMs").ToLocalChecked(),
+        Nan::New<v8::Number>(milliseconds(job->submitted, job->started)));
+      Nan::Set(timing,
+        Nan::New("renderMs").ToLocalChecked(),
+        Nan::New<v8::Number>(milliseconds(job->started, job->finished)));
+      Nan::Set(timing,
+        Nan::New("thread").ToLocalChecked(),
+        Nan::New<v8::Integer>(job->thread));
+
+      v8::Local<v8::Value> argv[] = {
+          Nan::Null()
+        , Nan::CopyBuffer(
+            reinterpret_cast<const char*>(job->pixels.data()),
+            job->pixels.size()).ToLocalChecked()
+        , timing
+      };
+      job->callback->Call(3, argv, job->resource);
+    }
+    delete job;
+  }
+}
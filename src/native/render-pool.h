@@ -0,0 +1,112 @@
+#ifndef RENDER_POOL_H_
+#define RENDER_POOL_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <uv.h>
+#include "nan.h"
+
+#include <GLES2/gl2.h>
+
+//A self-contained render job. Everything the job needs is copied out of
+//JavaScript when it is submitted, so it can run on any thread.
+struct RenderJob {
+  struct Attribute {
+    std::string name;
+    GLint size;
+    std::vector<GLfloat> data;
+  };
+  struct Texture {
+    std::string name;
+    GLsizei width;
+    GLsizei height;
+    GLenum filter;
+    std::vector<unsigned char> data;
+  };
+  struct Uniform {
+    std::string name;
+    std::vector<GLfloat> values;
+  };
+
+  GLsizei width;
+  GLsizei height;
+  std::string vertexShader;
+  std::string fragmentShader;
+  bool depthTest;
+  GLfloat clearColor[4];
+  std::vector<Attribute> attributes;
+  std::vector<Texture> textures;
+  std::vector<Uniform> uniforms;
+
+  //Index data, empty for drawArrays jobs
+  GLenum elementType;
+  std::vector<unsigned char> elements;
+
+  //[mode, first, count] for each draw
+  std::vector<GLint> draws;
+
+  //Results, pixels are bottom row first like readPixels
+  std::vector<unsigned char> pixels;
+  std::string error;
+  int thread;
+  std::chrono::steady_clock::time_point submitted;
+  std::chrono::steady_clock::time_point started;
+  std::chrono::steady_clock::time_point finished;
+
+  Nan::Callback* callback;
+  Nan::AsyncResource* resource;
+
+  RenderJob();
+  ~RenderJob();
+};
+
+//Runs render jobs on a pool of threads that each own a context. Finished
+//jobs are handed back to the thread that created the pool through its
+//event loop, where their callbacks are called as callback(err, pixels,
+//timing).
+class RenderPool {
+ public:
+  //Must be called on a thread with a Node event loop, returns NULL if no
+  //thread could be started. The contexts of the threads use backend and
+  //are spread over displayCount displays.
+  static RenderPool* create(
+    int threads,
+    int queueDepth,
+    int displayCount,
+    int backend);
+  ~RenderPool();
+
+  //True while queueDepth jobs are waiting, running or being delivered
+  bool full();
+
+  //Queues a job and takes ownership of it. Returns false without taking
+  //ownership if the pool is full.
+  bool submit(RenderJob* job);
+
+ private:
+  RenderPool(int queueDepth, int displayCount, int backend);
+  void run(int index);
+  static void deliver(uv_async_t* handle);
+
+  std::deque<RenderJob*> queue_;
+  std::deque<RenderJob*> done_;
+  size_t queueDepth_;
+  int displayCount_;
+  int backend_;
+  size_t inFlight_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool closing_;
+  std::vector<std::thread> threads_;
+  uv_async_t* async_;
+};
+
+#endif
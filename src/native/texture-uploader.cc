@@ -0,0 +1,313 @@
+#include <cstring>
+
+#include "texture-uploader.h"
+#include "webgl.h"
+
+template <typename T>
+static T loadProc(const char* name) {
+  return reinterpret_cast<T>(eglGetProcAddress(name));
+}
+
+TextureUploader::Upload::Upload() :
+    texture(0)
+  , bindTarget(GL_TEXTURE_2D)
+  , target(GL_TEXTURE_2D)
+  , level(0)
+  , width(0)
+  , height(0)
+  , format(GL_RGBA)
+  , type(GL_UNSIGNED_BYTE)
+  , alignment(4)
+  , flipY(false)
+  , premultiplyAlpha(false)
+  , pixels(NULL)
+  , ticket(0)
+  , callback(NULL)
+  , resource(NULL) {
+}
+
+TextureUploader::Upload::~Upload() {
+  buffer.Reset();
+  delete callback;
+  delete resource;
+}
+
+static void closeAsync(uv_handle_t* handle) {
+  delete reinterpret_cast<uv_async_t*>(handle);
+}
+
+TextureUploader* TextureUploader::create(
+    EGLDisplay display
+  , EGLConfig config
+  , EGLContext share
+  , EGLint clientVersion) {
+  //Shared contexts must use the same client version
+  EGLint contextAttribs[] = {
+    EGL_CONTEXT_CLIENT_VERSION, clientVersion,
+    EGL_NONE
+  };
+  EGLContext context = eglCreateContext(display, config, share, contextAttribs);
+  if (context == EGL_NO_CONTEXT) {
+    return NULL;
+  }
+
+  EGLint surfaceAttribs[] = {
+      EGL_WIDTH,  1
+    , EGL_HEIGHT, 1
+    , EGL_NONE
+  };
+  EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttribs);
+  if (surface == EGL_NO_SURFACE) {
+    eglDestroyContext(display, context);
+    return NULL;
+  }
+
+  TextureUploader* uploader = new TextureUploader(display, context, surface);
+  if (uv_async_init(
+        Nan::GetCurrentEventLoop(),
+        uploader->async_,
+        &TextureUploader::deliver) != 0) {
+    delete uploader->async_;
+    uploader->async_ = NULL;
+    delete uploader;
+    return NULL;
+  }
+  uploader->async_->data = uploader;
+
+  //The event loop is only kept alive while uploads are in flight
+  uv_unref(reinterpret_cast<uv_handle_t*>(uploader->async_));
+
+  uploader->worker_ = std::thread(&TextureUploader::run, uploader);
+  return uploader;
+}
+
+TextureUploader::TextureUploader(
+    EGLDisplay display
+  , EGLContext context
+  , EGLSurface surface) :
+      display_(display)
+    , context_(context)
+    , surface_(surface)
+    , eglCreateSyncKHR_(NULL)
+    , eglDestroySyncKHR_(NULL)
+    , eglClientWaitSyncKHR_(NULL)
+    , eglWaitSyncKHR_(NULL)
+    , submitted_(0)
+    , completed_(0)
+    , busy_(false)
+    , closing_(false)
+    , async_(new uv_async_t) {
+  const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+  if (extensions && strstr(extensions, "EGL_KHR_fence_sync")) {
+    eglCreateSyncKHR_ =
+      loadProc<PFNEGLCREATESYNCKHRPROC>("eglCreateSyncKHR");
+    eglDestroySyncKHR_ =
+      loadProc<PFNEGLDESTROYSYNCKHRPROC>("eglDestroySyncKHR");
+    eglClientWaitSyncKHR_ =
+      loadProc<PFNEGLCLIENTWAITSYNCKHRPROC>("eglClientWaitSyncKHR");
+  }
+  if (extensions && strstr(extensions, "EGL_KHR_wait_sync")) {
+    eglWaitSyncKHR_ =
+      loadProc<PFNEGLWAITSYNCKHRPROC>("eglWaitSyncKHR");
+  }
+
+  glBindTexture_ =
+    loadProc<PFNGLBINDTEXTUREPROC>("glBindTexture");
+  glPixelStorei_ =
+    loadProc<PFNGLPIXELSTOREIPROC>("glPixelStorei");
+  glTexSubImage2D_ =
+    loadProc<PFNGLTEXSUBIMAGE2DPROC>("glTexSubImage2D");
+  glFlush_ =
+    loadProc<PFNGLFLUSHPROC>("glFlush");
+  glFinish_ =
+    loadProc<PFNGLFINISHPROC>("glFinish");
+}
+
+TextureUploader::~TextureUploader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closing_ = true;
+  }
+  cond_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+
+  //Uploads that were never delivered are dropped with their callbacks
+  for (size_t i = 0; i < queue_.size(); ++i) {
+    delete queue_[i];
+  }
+  for (size_t i = 0; i < done_.size(); ++i) {
+    delete done_[i];
+  }
+  std::map<uint64_t, EGLSyncKHR>::iterator it;
+  for (it = fences_.begin(); it != fences_.end(); ++it) {
+    eglDestroySyncKHR_(display_, it->second);
+  }
+
+  if (async_) {
+    async_->data = NULL;
+    uv_close(reinterpret_cast<uv_handle_t*>(async_), closeAsync);
+  }
+  eglDestroySurface(display_, surface_);
+  eglDestroyContext(display_, context_);
+}
+
+uint64_t TextureUploader::submit(Upload* upload) {
+  uint64_t ticket;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.empty() && done_.empty() && !busy_) {
+      uv_ref(reinterpret_cast<uv_handle_t*>(async_));
+    }
+    ticket = upload->ticket = ++submitted_;
+    queue_.push_back(upload);
+  }
+  cond_.notify_all();
+  return ticket;
+}
+
+void TextureUploader::finish(uint64_t ticket) {
+  EGLSyncKHR fence;
+  {
+    //Uploads run in ticket order
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this, ticket] { return closing_ || completed_ >= ticket; });
+    std::map<uint64_t, EGLSyncKHR>::iterator it = fences_.find(ticket);
+    if (it == fences_.end()) {
+      return;
+    }
+    fence = it->second;
+    fences_.erase(it);
+  }
+  if (eglWaitSyncKHR_) {
+    eglWaitSyncKHR_(display_, fence, 0);
+  } else {
+    eglClientWaitSyncKHR_(display_, fence, 0, EGL_FOREVER_KHR);
+  }
+  eglDestroySyncKHR_(display_, fence);
+}
+
+void TextureUploader::drain() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this] { return queue_.empty() && !busy_; });
+}
+
+void TextureUploader::run() {
+  bool current = eglMakeCurrent(display_, surface_, surface_, context_);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    cond_.wait(lock, [this] { return closing_ || !queue_.empty(); });
+    if (closing_) {
+      break;
+    }
+    Upload* upload = queue_.front();
+    queue_.pop_front();
+    busy_ = true;
+    lock.unlock();
+
+    EGLSyncKHR fence = EGL_NO_SYNC_KHR;
+    if (current) {
+      //Flipping and premultiplying run here too, off the JavaScript thread
+      unsigned char* unpacked = NULL;
+      if (upload->flipY || upload->premultiplyAlpha) {
+        unpacked = WebGLRenderingContext::unpackPixels(
+          upload->type,
+          upload->format,
+          upload->width,
+          upload->height,
+          upload->pixels,
+          upload->flipY,
+          upload->premultiplyAlpha,
+          upload->alignment);
+      }
+
+      (glBindTexture_)(upload->bindTarget, upload->texture);
+      (glPixelStorei_)(GL_UNPACK_ALIGNMENT, upload->alignment);
+      (glTexSubImage2D_)(
+        upload->target,
+        upload->level,
+        0,
+        0,
+        upload->width,
+        upload->height,
+        upload->format,
+        upload->type,
+        unpacked ? unpacked : upload->pixels);
+      (glBindTexture_)(upload->bindTarget, 0);
+      delete[] unpacked;
+
+      if (eglCreateSyncKHR_) {
+        fence = eglCreateSyncKHR_(display_, EGL_SYNC_FENCE_KHR, NULL);
+      }
+      if (fence != EGL_NO_SYNC_KHR) {
+        (glFlush_)();
+      } else {
+        (glFinish_)();
+      }
+    } else {
+      upload->error = "texImage2DAsync: could not make the upload context current";
+    }
+
+    lock.lock();
+    if (fence != EGL_NO_SYNC_KHR) {
+      fences_[upload->ticket] = fence;
+    }
+    completed_ = upload->ticket;
+    busy_ = false;
+    done_.push_back(upload);
+    cond_.notify_all();
+    uv_async_send(async_);
+  }
+  lock.unlock();
+
+  if (current) {
+    eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  }
+  eglReleaseThread();
+}
+
+void TextureUploader::deliver(uv_async_t* handle) {
+  TextureUploader* uploader = reinterpret_cast<TextureUploader*>(handle->data);
+  if (!uploader) {
+    return;
+  }
+
+  std::deque<Upload*> done;
+  {
+    std::lock_guard<std::mutex> lock(uploader->mutex_);
+    done.swap(uploader->done_);
+    if (uploader->queue_.empty() && !uploader->busy_) {
+      uv_unref(reinterpret_cast<uv_handle_t*>(uploader->async_));
+    }
+  }
+
+  Nan::HandleScope scope;
+  for (size_t i = 0; i < done.size(); ++i) {
+    Upload* upload = done[i];
+    v8::Local<v8::Value> argv[] = {
+        Nan::New<v8::Number>(static_cast<double>(upload->ticket))
+      , upload->error.empty()
+        ? Nan::Undefined().As<v8::Value>()
+        : Nan::Error(upload->error.c_str())
+    };
+    Nan::Callback* callback = upload->callback;
+    Nan::AsyncResource* resource = upload->resource;
+    upload->callback = NULL;
+    upload->resource = NULL;
+    delete upload;
+
+    //The callback may destroy the context, and this uploader with it
+    callback->Call(2, argv, resource);
+    delete callback;
+    delete resource;
+    if (!handle->data) {
+      //Remaining uploads were never delivered
+      for (size_t j = i + 1; j < done.size(); ++j) {
+        delete done[j];
+      }
+      return;
+    }
+  }
+}
@@ -0,0 +1,109 @@
+#ifndef TEXTURE_UPLOADER_H_
+#define TEXTURE_UPLOADER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <uv.h>
+#include "nan.h"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+
+//Uploads texture images on a background thread through a context that
+//shares objects with the rendering context. The rendering context allocates
+//the level first, the worker fills it with glTexSubImage2D, and a fence
+//inserted after the upload lets the rendering context wait for it without
+//blocking the JavaScript thread.
+class TextureUploader {
+ public:
+  struct Upload {
+    GLuint  texture;
+    GLenum  bindTarget;
+    GLenum  target;
+    GLint   level;
+    GLsizei width;
+    GLsizei height;
+    GLenum  format;
+    GLenum  type;
+    GLint   alignment;
+    bool    flipY;
+    bool    premultiplyAlpha;
+
+    //Kept alive until the upload is delivered, must not change until then
+    unsigned char* pixels;
+    Nan::Persistent<v8::Object> buffer;
+
+    uint64_t ticket;
+    std::string error;
+    Nan::Callback* callback;
+    Nan::AsyncResource* resource;
+
+    Upload();
+    ~Upload();
+  };
+
+  //Must be called on a thread with a Node event loop, returns NULL if a
+  //shared context could not be created
+  static TextureUploader* create(
+    EGLDisplay display,
+    EGLConfig config,
+    EGLContext share,
+    EGLint clientVersion);
+  ~TextureUploader();
+
+  //Queues an upload and takes ownership of it. Its callback is called as
+  //callback(ticket) once the upload has been submitted to the GPU, or as
+  //callback(ticket, error) if it could not be made.
+  uint64_t submit(Upload* upload);
+
+  //Makes the context that is current on the calling thread wait for the
+  //upload with the given ticket before running later commands. If the
+  //worker has not submitted the upload yet, blocks until it has.
+  void finish(uint64_t ticket);
+
+  //Blocks until every queued upload has been submitted
+  void drain();
+
+ private:
+  TextureUploader(EGLDisplay display, EGLContext context, EGLSurface surface);
+  void run();
+  static void deliver(uv_async_t* handle);
+
+  EGLDisplay display_;
+  EGLContext context_;
+  EGLSurface surface_;
+
+  PFNEGLCREATESYNCKHRPROC eglCreateSyncKHR_;
+  PFNEGLDESTROYSYNCKHRPROC eglDestroySyncKHR_;
+  PFNEGLCLIENTWAITSYNCKHRPROC eglClientWaitSyncKHR_;
+  PFNEGLWAITSYNCKHRPROC eglWaitSyncKHR_;
+
+  PFNGLBINDTEXTUREPROC glBindTexture_;
+  PFNGLPIXELSTOREIPROC glPixelStorei_;
+  PFNGLTEXSUBIMAGE2DPROC glTexSubImage2D_;
+  PFNGLFLUSHPROC glFlush_;
+  PFNGLFINISHPROC glFinish_;
+
+  std::deque<Upload*> queue_;
+  std::deque<Upload*> done_;
+  std::map<uint64_t, EGLSyncKHR> fences_;
+  uint64_t submitted_;
+  uint64_t completed_;
+  bool busy_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool closing_;
+  std::thread worker_;
+  uv_async_t* async_;
+};
+
+#endif
@@ -0,0 +1,100 @@
+#include <cstring>
+
+#include "tile-hash.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TILE_HASH_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+//Four independent 32 bit lanes in the style of xxHash32. Word k of each
+//row goes to lane k % 4, so the SSE2 and scalar paths agree.
+static const uint32_t PRIME1 = 2654435761u;
+static const uint32_t PRIME2 = 2246822519u;
+static const uint32_t PRIME3 = 3266489917u;
+static const uint32_t PRIME4 = 668265263u;
+
+static inline uint32_t rotl(uint32_t x, int r) {
+  return (x << r) | (x >> (32 - r));
+}
+
+static inline uint32_t round32(uint32_t acc, uint32_t word) {
+  return rotl(acc + word * PRIME2, 13) * PRIME1;
+}
+
+static inline uint32_t avalanche(uint32_t h) {
+  h ^= h >> 15;
+  h *= PRIME2;
+  h ^= h >> 13;
+  h *= PRIME3;
+  h ^= h >> 16;
+  return h;
+}
+
+#ifdef TILE_HASH_USE_SSE2
+static inline __m128i mullo32(__m128i a, __m128i b) {
+  __m128i even = _mm_mul_epu32(a, b);
+  __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+  return _mm_unpacklo_epi32(
+    _mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+    _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+#endif
+
+TileHash hashTile(
+    const unsigned char* pixels,
+    ptrdiff_t stride,
+    int width,
+    int height) {
+  uint32_t lanes[4] = {
+    PRIME1 + PRIME2,
+    PRIME2,
+    0,
+    0u - PRIME1
+  };
+  int blocks = width / 4;
+
+#ifdef TILE_HASH_USE_SSE2
+  __m128i acc    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes));
+  const __m128i p1 = _mm_set1_epi32(static_cast<int>(PRIME1));
+  const __m128i p2 = _mm_set1_epi32(static_cast<int>(PRIME2));
+  for (int j = 0; j < height; ++j) {
+    const unsigned char* row = pixels + j * stride;
+    for (int i = 0; i < blocks; ++i) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 16 * i));
+      acc = _mm_add_epi32(acc, mullo32(v, p2));
+      acc = _mm_or_si128(_mm_slli_epi32(acc, 13), _mm_srli_epi32(acc, 19));
+      acc = mullo32(acc, p1);
+    }
+    if (blocks * 4 < width) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+      for (int k = blocks * 4; k < width; ++k) {
+        uint32_t word;
+        std::memcpy(&word, row + 4 * k, 4);
+        lanes[k & 3] = round32(lanes[k & 3], word);
+      }
+      acc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes));
+    }
+  }
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+#else
+  for (int j = 0; j < height; ++j) {
+    const unsigned char* row = pixels + j * stride;
+    for (int k = 0; k < width; ++k) {
+      uint32_t word;
+      std::memcpy(&word, row + 4 * k, 4);
+      lanes[k & 3] = round32(lanes[k & 3], word);
+    }
+  }
+#endif
+
+  uint32_t size = static_cast<uint32_t>(width) * static_cast<uint32_t>(height);
+  TileHash result;
+  result.lo = avalanche(
+    rotl(lanes[0], 1) + rotl(lanes[1], 7) +
+    rotl(lanes[2], 12) + rotl(lanes[3], 18) + size);
+  result.hi = avalanche(
+    (lanes[0] * PRIME4) ^ rotl(lanes[1], 11) ^
+    (lanes[2] * PRIME3) ^ rotl(lanes[3], 23) ^ (size * PRIME1));
+  return result;
+}
@@ -0,0 +1,20 @@
+#ifndef TILE_HASH_H_
+#define TILE_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+
+struct TileHash {
+  uint32_t lo;
+  uint32_t hi;
+};
+
+//Hashes a width * height block of RGBA pixels whose rows are stride bytes
+//apart. Not cryptographic, only meant to detect changed tiles.
+TileHash hashTile(
+  const unsigned char* pixels,
+  ptrdiff_t stride,
+  int width,
+  int height);
+
+#endif
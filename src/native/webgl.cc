@@ -1,13 +1,15 @@
+#include <cstdio>
 #include <cstring>
 #include <vector>
 #include <iostream>
 
 #include "webgl.h"
 
-bool                   WebGLRenderingContext::HAS_DISPLAY = false;
-EGLDisplay             WebGLRenderingContext::DISPLAY;
-WebGLRenderingContext* WebGLRenderingContext::ACTIVE = NULL;
-WebGLRenderingContext* WebGLRenderingContext::CONTEXT_LIST_HEAD = NULL;
+std::vector<WebGLRenderingContext::DisplaySlot> WebGLRenderingContext::DISPLAYS;
+std::mutex             WebGLRenderingContext::DISPLAY_MUTEX;
+unsigned               WebGLRenderingContext::NEXT_DISPLAY = 0;
+thread_local WebGLRenderingContext* WebGLRenderingContext::ACTIVE = NULL;
+thread_local WebGLRenderingContext* WebGLRenderingContext::CONTEXT_LIST_HEAD = NULL;
 
 const char* REQUIRED_EXTENSIONS[] = {
   "GL_OES_packed_depth_stencil",
@@ -24,6 +26,8 @@ const char* REQUIRED_EXTENSIONS[] = {
   } \
   WebGLRenderingContext* inst = \
     node::ObjectWrap::Unwrap<WebGLRenderingContext>(info.This()); \
+  WebGLRenderingContext::CallTimer callTimer( \
+    inst, &WebGLRenderingContext::CallStats::callNs); \
   if (!(inst && inst->setActive())) { \
     return Nan::ThrowError("Invalid GL context"); \
   }
@@ -38,36 +42,50 @@ WebGLRenderingContext::WebGLRenderingContext(
   , bool premultipliedAlpha
   , bool preserveDrawingBuffer
   , bool preferLowPowerToHighPerformance
-  , bool failIfMajorPerformanceCaveat) :
-      state(GLCONTEXT_STATE_INIT)
+  , bool failIfMajorPerformanceCaveat
+  , int version
+  , int displayCount
+  , int displayIndex
+  , int backend
+  , int threads) :
+      display(EGL_NO_DISPLAY)
+    , displaySlot(-1)
+    , backend(backend)
+    , state(GLCONTEXT_STATE_INIT)
+    , clientVersion(version == 2 ? 3 : 2)
     , unpack_flip_y(false)
     , unpack_premultiply_alpha(false)
     , unpack_colorspace_conversion(0x9244)
     , unpack_alignment(4)
     , next(NULL)
     , prev(NULL)
-    , lastError(GL_NO_ERROR) {
+    , accounting(false)
+    , callStats()
+    , memory()
+    , lastError(GL_NO_ERROR)
+    , frameSink(NULL)
+    , frameRing(NULL)
+    , readbackWorker(NULL)
+    , renderPool(NULL)
+    , textureUploader(NULL)
+    , scaledReadback()
+    , nextCommandBundle(1) {
+  forgetTextureBindings();
 
   //Get display
-  if (!HAS_DISPLAY) {
-    DISPLAY = eglGetDisplay(EGL_DEFAULT_DISPLAY);
-    if (DISPLAY == EGL_NO_DISPLAY) {
-      state = GLCONTEXT_STATE_ERROR;
-      return;
-    }
-
-    //Initialize EGL
-    if (!eglInitialize(DISPLAY, NULL, NULL)) {
-      state = GLCONTEXT_STATE_ERROR;
-      return;
-    }
-
-    //Save display
-    HAS_DISPLAY = true;
+  displaySlot = acquireDisplay(
+    backend,
+    preferLowPowerToHighPerformance,
+    displayCount,
+    displayIndex,
+    &display);
+  if (displaySlot < 0) {
+    state = GLCONTEXT_STATE_ERROR;
+    return;
   }
 
   //Set up configuration
-  EGLint attrib_list[] = {
+  std::vector<EGLint> attrib_list = {
       EGL_SURFACE_TYPE, EGL_PBUFFER_BIT
     , EGL_RED_SIZE,     8
     , EGL_GREEN_SIZE,   8
@@ -75,12 +93,17 @@ WebGLRenderingContext::WebGLRenderingContext(
     , EGL_ALPHA_SIZE,   8
     , EGL_DEPTH_SIZE,   24
     , EGL_STENCIL_SIZE, 8
-    , EGL_NONE
   };
+  //WebGL2 needs a config that can back an ES3 context
+  if (clientVersion >= 3) {
+    attrib_list.push_back(EGL_RENDERABLE_TYPE);
+    attrib_list.push_back(EGL_OPENGL_ES3_BIT_KHR);
+  }
+  attrib_list.push_back(EGL_NONE);
   EGLint num_config;
   if (!eglChooseConfig(
-      DISPLAY,
-      attrib_list,
+      display,
+      attrib_list.data(),
       &config,
       1,
       &num_config) ||
@@ -91,10 +114,10 @@ WebGLRenderingContext::WebGLRenderingContext(
 
   //Create context
   EGLint contextAttribs[] = {
-    EGL_CONTEXT_CLIENT_VERSION, 2,
+    EGL_CONTEXT_CLIENT_VERSION, clientVersion,
     EGL_NONE
   };
-  context = eglCreateContext(DISPLAY, config, EGL_NO_CONTEXT, contextAttribs);
+  context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
   if (context == EGL_NO_CONTEXT) {
     state = GLCONTEXT_STATE_ERROR;
     return;
@@ -105,14 +128,14 @@ WebGLRenderingContext::WebGLRenderingContext(
       , EGL_HEIGHT, (EGLint)height
       , EGL_NONE
   };
-  surface = eglCreatePbufferSurface(DISPLAY, config, surfaceAttribs);
+  surface = eglCreatePbufferSurface(display, config, surfaceAttribs);
   if (surface == EGL_NO_SURFACE) {
     state = GLCONTEXT_STATE_ERROR;
     return;
   }
 
   //Set active
-  if (!eglMakeCurrent(DISPLAY, surface, surface, context)) {
+  if (!eglMakeCurrent(display, surface, surface, context)) {
     state = GLCONTEXT_STATE_ERROR;
     return;
   }
@@ -137,6 +160,13 @@ WebGLRenderingContext::WebGLRenderingContext(
     }
   }
 
+  //Limit the threads ANGLE uses for compiling and linking
+  if (threads > 0 &&
+      strstr(extensionString, "GL_KHR_parallel_shader_compile") &&
+      glMaxShaderCompilerThreadsKHR) {
+    (glMaxShaderCompilerThreadsKHR)(threads);
+  }
+
   //Select best preferred depth
   preferredDepth = GL_DEPTH_COMPONENT16;
   if(strstr(extensionString, "GL_OES_depth32")) {
@@ -153,7 +183,7 @@ bool WebGLRenderingContext::setActive() {
   if (this == ACTIVE) {
     return true;
   }
-  if (!eglMakeCurrent(DISPLAY, surface, surface, context)) {
+  if (!eglMakeCurrent(display, surface, surface, context)) {
     state = GLCONTEXT_STATE_ERROR;
     return false;
   }
@@ -175,8 +205,37 @@ void WebGLRenderingContext::dispose() {
   //Unregister context
   unregisterContext();
 
+  //Flush pending frames before the context goes away
+  if (frameSink) {
+    delete frameSink;
+    frameSink = NULL;
+  }
+  if (frameRing) {
+    delete frameRing;
+    frameRing = NULL;
+  }
+  if (readbackWorker) {
+    delete readbackWorker;
+    readbackWorker = NULL;
+  }
+  if (renderPool) {
+    delete renderPool;
+    renderPool = NULL;
+  }
+  if (textureUploader) {
+    delete textureUploader;
+    textureUploader = NULL;
+  }
+  renderJobPrograms.clear();
+  commandBundles.clear();
+  bufferBytes.clear();
+  textureImages.clear();
+  renderbufferBytes.clear();
+  memory.textures = memory.renderbuffers = memory.buffers = 0;
+
   if (!setActive()) {
     state = GLCONTEXT_STATE_ERROR;
+    releaseDisplay();
     return;
   }
 
@@ -187,50 +246,484 @@ void WebGLRenderingContext::dispose() {
   WebGLRenderingContext* inst = this;
 
   //Destroy all object references
-  for (
-    std::map< std::pair<GLuint, GLObjectType>, bool >::iterator
-     iter = objects.begin();
-     iter != objects.end();
-     ++iter) {
-
-    GLuint obj = iter->first.first;
-
-    switch(iter->first.second) {
-      case GLOBJECT_TYPE_PROGRAM:
-        (inst->glDeleteProgram)(obj);
-        break;
-      case GLOBJECT_TYPE_BUFFER:
-        (inst->glDeleteBuffers)(1,&obj);
-        break;
-      case GLOBJECT_TYPE_FRAMEBUFFER:
-        (inst->glDeleteFramebuffers)(1,&obj);
-        break;
-      case GLOBJECT_TYPE_RENDERBUFFER:
-        (inst->glDeleteRenderbuffers)(1,&obj);
-        break;
-      case GLOBJECT_TYPE_SHADER:
-        (inst->glDeleteShader)(obj);
-        break;
-      case GLOBJECT_TYPE_TEXTURE:
-        (inst->glDeleteTextures)(1,&obj);
-        break;
-      case GLOBJECT_TYPE_VERTEX_ARRAY:
-        (inst->glDeleteVertexArraysOES)(1,&obj);
-        break;
-      default:
-        break;
-    }
-  }
+  inst->deleteGLObjs();
 
   //Deactivate context
-  eglMakeCurrent(DISPLAY, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+  eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
   ACTIVE = NULL;
 
   //Destroy surface and context
 
   //FIXME:  This shouldn't be commented out
-  //eglDestroySurface(DISPLAY, surface);
-  eglDestroyContext(DISPLAY, context);
+  //eglDestroySurface(display, surface);
+  eglDestroyContext(display, context);
+  releaseDisplay();
+}
+
+//Deletes every registered object, with one call per type where GL takes
+//a list of names
+void WebGLRenderingContext::deleteGLObjs() {
+  GLObjectSet& bufferNames = objects[GLOBJECT_TYPE_BUFFER];
+  if (!bufferNames.empty()) {
+    (glDeleteBuffers)(bufferNames.size(), bufferNames.data());
+  }
+  GLObjectSet& textureNames = objects[GLOBJECT_TYPE_TEXTURE];
+  if (!textureNames.empty()) {
+    (glDeleteTextures)(textureNames.size(), textureNames.data());
+  }
+  GLObjectSet& framebufferNames = objects[GLOBJECT_TYPE_FRAMEBUFFER];
+  if (!framebufferNames.empty()) {
+    (glDeleteFramebuffers)(framebufferNames.size(), framebufferNames.data());
+  }
+  GLObjectSet& renderbufferNames = objects[GLOBJECT_TYPE_RENDERBUFFER];
+  if (!renderbufferNames.empty()) {
+    (glDeleteRenderbuffers)(renderbufferNames.size(), renderbufferNames.data());
+  }
+  GLObjectSet& vertexArrayNames = objects[GLOBJECT_TYPE_VERTEX_ARRAY];
+  if (!vertexArrayNames.empty()) {
+    (glDeleteVertexArraysOES)(vertexArrayNames.size(), vertexArrayNames.data());
+  }
+  GLObjectSet& programNames = objects[GLOBJECT_TYPE_PROGRAM];
+  for (GLsizei i = 0; i < programNames.size(); ++i) {
+    (glDeleteProgram)(programNames.data()[i]);
+  }
+  GLObjectSet& shaderNames = objects[GLOBJECT_TYPE_SHADER];
+  for (GLsizei i = 0; i < shaderNames.size(); ++i) {
+    (glDeleteShader)(shaderNames.data()[i]);
+  }
+  for (int type = 0; type < GLOBJECT_TYPE_COUNT; ++type) {
+    objects[type].clear();
+  }
+}
+
+static uint64_t typeBytes(GLenum type) {
+  switch (type) {
+    case GL_UNSIGNED_BYTE:
+    case GL_BYTE:
+      return 1;
+    case GL_UNSIGNED_SHORT:
+    case GL_SHORT:
+    case GL_HALF_FLOAT:
+    case GL_HALF_FLOAT_OES:
+      return 2;
+    default:
+      return 4;
+  }
+}
+
+//Bytes per pixel of an image, from its internal format and, for unsized
+//formats, the type it was specified with
+static uint64_t pixelBytes(GLenum internalformat, GLenum type) {
+  switch (type) {
+    case GL_UNSIGNED_SHORT_5_6_5:
+    case GL_UNSIGNED_SHORT_4_4_4_4:
+    case GL_UNSIGNED_SHORT_5_5_5_1:
+      return 2;
+    case GL_UNSIGNED_INT_2_10_10_10_REV:
+    case GL_UNSIGNED_INT_24_8:
+    case GL_UNSIGNED_INT_10F_11F_11F_REV:
+    case GL_UNSIGNED_INT_5_9_9_9_REV:
+      return 4;
+    case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+      return 8;
+    default:
+      break;
+  }
+
+  switch (internalformat) {
+    case GL_ALPHA:
+    case GL_LUMINANCE:
+    case GL_DEPTH_COMPONENT:
+    case GL_RED:
+    case GL_RED_INTEGER:
+      return typeBytes(type);
+    case GL_LUMINANCE_ALPHA:
+    case GL_RG:
+    case GL_RG_INTEGER:
+      return 2 * typeBytes(type);
+    case GL_RGB:
+    case GL_RGB_INTEGER:
+      return 3 * typeBytes(type);
+    case GL_RGBA:
+    case GL_RGBA_INTEGER:
+    case GL_BGRA_EXT:
+      return 4 * typeBytes(type);
+
+    case GL_R8:
+    case GL_R8I:
+    case GL_R8UI:
+    case GL_R8_SNORM:
+    case GL_STENCIL_INDEX8:
+      return 1;
+    case GL_RGB565:
+    case GL_RGBA4:
+    case GL_RGB5_A1:
+    case GL_DEPTH_COMPONENT16:
+    case GL_R16F:
+    case GL_R16I:
+    case GL_R16UI:
+    case GL_RG8:
+    case GL_RG8I:
+    case GL_RG8UI:
+    case GL_RG8_SNORM:
+      return 2;
+    case GL_RGB8:
+    case GL_SRGB8:
+    case GL_RGB8I:
+    case GL_RGB8UI:
+    case GL_RGB8_SNORM:
+      return 3;
+    case GL_RGB16F:
+    case GL_RGB16I:
+    case GL_RGB16UI:
+      return 6;
+    case GL_RGBA16F:
+    case GL_RGBA16I:
+    case GL_RGBA16UI:
+    case GL_RG32F:
+    case GL_RG32I:
+    case GL_RG32UI:
+    case GL_DEPTH32F_STENCIL8:
+      return 8;
+    case GL_RGB32F:
+    case GL_RGB32I:
+    case GL_RGB32UI:
+      return 12;
+    case GL_RGBA32F:
+    case GL_RGBA32I:
+    case GL_RGBA32UI:
+      return 16;
+    default:
+      //RGBA8, 24 bit depth, packed formats and the other 32 bit formats
+      return 4;
+  }
+}
+
+//Index into textureBindings for a bind or image target
+static int textureBindingSlot(GLenum target) {
+  switch (target) {
+    case GL_TEXTURE_2D:
+      return 0;
+    case GL_TEXTURE_3D:
+      return 2;
+    case GL_TEXTURE_2D_ARRAY:
+      return 3;
+    default:
+      return 1;
+  }
+}
+
+static GLObjectType objectType(GLenum target) {
+  switch (target) {
+    case GL_ARRAY_BUFFER:
+    case GL_ELEMENT_ARRAY_BUFFER:
+      return GLOBJECT_TYPE_BUFFER;
+    case GL_FRAMEBUFFER:
+      return GLOBJECT_TYPE_FRAMEBUFFER;
+    case GL_RENDERBUFFER:
+      return GLOBJECT_TYPE_RENDERBUFFER;
+    case GL_VERTEX_ARRAY_BINDING_OES:
+      return GLOBJECT_TYPE_VERTEX_ARRAY;
+    default:
+      return GLOBJECT_TYPE_TEXTURE;
+  }
+}
+
+void WebGLRenderingContext::reset(const GLint* keep, size_t keepCount) {
+  //The uploader may still be writing into textures that go away
+  if (textureUploader) {
+    textureUploader->drain();
+  }
+
+  //Take the kept objects out of the registry, delete everything left in
+  //it and put them back
+  std::vector<GLObjectReference> kept;
+  for (size_t i = 0; i + 1 < keepCount; i += 2) {
+    kept.push_back(std::make_pair(
+      static_cast<GLuint>(keep[i + 1]), objectType(keep[i])));
+  }
+  //Resources of the scaled readback belong to the context, not the page
+  ScaledReadback& res = scaledReadback;
+  if (res.program) {
+    kept.push_back(std::make_pair(res.program, GLOBJECT_TYPE_PROGRAM));
+    kept.push_back(std::make_pair(res.buffer, GLOBJECT_TYPE_BUFFER));
+    kept.push_back(std::make_pair(res.framebuffer, GLOBJECT_TYPE_FRAMEBUFFER));
+    kept.push_back(std::make_pair(res.textures[0], GLOBJECT_TYPE_TEXTURE));
+    kept.push_back(std::make_pair(res.textures[1], GLOBJECT_TYPE_TEXTURE));
+  }
+  std::vector<GLObjectReference> registered;
+  for (size_t i = 0; i < kept.size(); ++i) {
+    if (objects[kept[i].second].erase(kept[i].first)) {
+      registered.push_back(kept[i]);
+    }
+  }
+
+  //Memory held by the deleted objects is given back
+  static const GLObjectType sized[] = {
+    GLOBJECT_TYPE_BUFFER,
+    GLOBJECT_TYPE_TEXTURE,
+    GLOBJECT_TYPE_RENDERBUFFER
+  };
+  for (size_t i = 0; i < sizeof(sized) / sizeof(sized[0]); ++i) {
+    GLObjectSet& dead = objects[sized[i]];
+    for (GLsizei j = 0; j < dead.size(); ++j) {
+      forgetObject(sized[i], dead.data()[j]);
+    }
+  }
+  deleteGLObjs();
+  for (size_t i = 0; i < registered.size(); ++i) {
+    registerGLObj(registered[i].second, registered[i].first);
+  }
+
+  commandBundles.clear();
+
+  unpack_flip_y = false;
+  unpack_premultiply_alpha = false;
+  unpack_colorspace_conversion = 0x9244;
+  unpack_alignment = 4;
+
+  //Fixed function state
+  static const GLenum capabilities[] = {
+    GL_BLEND,
+    GL_CULL_FACE,
+    GL_DEPTH_TEST,
+    GL_POLYGON_OFFSET_FILL,
+    GL_SAMPLE_ALPHA_TO_COVERAGE,
+    GL_SAMPLE_COVERAGE,
+    GL_SCISSOR_TEST,
+    GL_STENCIL_TEST
+  };
+  for (size_t i = 0; i < sizeof(capabilities) / sizeof(capabilities[0]); ++i) {
+    (glDisable)(capabilities[i]);
+  }
+  (glEnable)(GL_DITHER);
+  (glBlendColor)(0, 0, 0, 0);
+  (glBlendEquation)(GL_FUNC_ADD);
+  (glBlendFunc)(GL_ONE, GL_ZERO);
+  (glClearColor)(0, 0, 0, 0);
+  (glClearDepthf)(1);
+  (glClearStencil)(0);
+  (glColorMask)(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+  (glCullFace)(GL_BACK);
+  (glDepthFunc)(GL_LESS);
+  (glDepthMask)(GL_TRUE);
+  (glDepthRangef)(0, 1);
+  (glFrontFace)(GL_CCW);
+  (glHint)(GL_GENERATE_MIPMAP_HINT, GL_DONT_CARE);
+  //Without OES_standard_derivatives this fails, and the error is dropped
+  (glHint)(GL_FRAGMENT_SHADER_DERIVATIVE_HINT_OES, GL_DONT_CARE);
+  (glLineWidth)(1);
+  (glPixelStorei)(GL_PACK_ALIGNMENT, 4);
+  (glPixelStorei)(GL_UNPACK_ALIGNMENT, 4);
+  (glPolygonOffset)(0, 0);
+  (glSampleCoverage)(1, GL_FALSE);
+  (glStencilFunc)(GL_ALWAYS, 0, ~0u);
+  (glStencilMask)(~0u);
+  (glStencilOp)(GL_KEEP, GL_KEEP, GL_KEEP);
+  if (clientVersion >= 3) {
+    static const GLenum pixelStore[] = {
+      GL_UNPACK_ROW_LENGTH,
+      GL_UNPACK_IMAGE_HEIGHT,
+      GL_UNPACK_SKIP_PIXELS,
+      GL_UNPACK_SKIP_ROWS,
+      GL_UNPACK_SKIP_IMAGES,
+      GL_PACK_ROW_LENGTH,
+      GL_PACK_SKIP_PIXELS,
+      GL_PACK_SKIP_ROWS
+    };
+    for (size_t i = 0; i < sizeof(pixelStore) / sizeof(pixelStore[0]); ++i) {
+      (glPixelStorei)(pixelStore[i], 0);
+    }
+    (glDisable)(GL_RASTERIZER_DISCARD);
+  }
+
+  //Bindings to kept objects; deleted ones were unbound by the deletes
+  (glUseProgram)(0);
+  (glBindVertexArrayOES)(0);
+  (glBindBuffer)(GL_ARRAY_BUFFER, 0);
+  (glBindBuffer)(GL_ELEMENT_ARRAY_BUFFER, 0);
+  (glBindRenderbuffer)(GL_RENDERBUFFER, 0);
+
+  GLint units = 0;
+  (glGetIntegerv)(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &units);
+  for (GLint i = 0; i < units; ++i) {
+    (glActiveTexture)(GL_TEXTURE0 + i);
+    (glBindTexture)(GL_TEXTURE_2D, 0);
+    (glBindTexture)(GL_TEXTURE_CUBE_MAP, 0);
+  }
+  (glActiveTexture)(GL_TEXTURE0);
+  forgetTextureBindings();
+
+  GLint attribs = 0;
+  (glGetIntegerv)(GL_MAX_VERTEX_ATTRIBS, &attribs);
+  for (GLint i = 0; i < attribs; ++i) {
+    (glDisableVertexAttribArray)(i);
+    (glVertexAttrib4f)(i, 0, 0, 0, 1);
+    (glVertexAttribDivisor)(i, 0);
+  }
+
+  while ((glGetError)() != GL_NO_ERROR) {}
+  lastError = GL_NO_ERROR;
+}
+
+#ifdef EGL_PLATFORM_ANGLE_ANGLE
+//Adds the platform attributes selecting an ANGLE backend, returns false if
+//these headers do not know the backend
+static bool backendAttribs(int backend, std::vector<EGLint>& attribs) {
+  EGLint type = 0;
+  switch (backend) {
+    case GLBACKEND_DEFAULT:
+      return true;
+#ifdef EGL_PLATFORM_ANGLE_DEVICE_TYPE_SWIFTSHADER_ANGLE
+    case GLBACKEND_SWIFTSHADER:
+      attribs.push_back(EGL_PLATFORM_ANGLE_DEVICE_TYPE_ANGLE);
+      attribs.push_back(EGL_PLATFORM_ANGLE_DEVICE_TYPE_SWIFTSHADER_ANGLE);
+      type = EGL_PLATFORM_ANGLE_TYPE_VULKAN_ANGLE;
+      break;
+#endif
+#ifdef EGL_PLATFORM_ANGLE_TYPE_VULKAN_ANGLE
+    case GLBACKEND_VULKAN:
+      type = EGL_PLATFORM_ANGLE_TYPE_VULKAN_ANGLE;
+      break;
+#endif
+    case GLBACKEND_GL:
+      type = EGL_PLATFORM_ANGLE_TYPE_OPENGL_ANGLE;
+      break;
+    case GLBACKEND_GLES:
+      type = EGL_PLATFORM_ANGLE_TYPE_OPENGLES_ANGLE;
+      break;
+#ifdef EGL_PLATFORM_ANGLE_TYPE_METAL_ANGLE
+    case GLBACKEND_METAL:
+      type = EGL_PLATFORM_ANGLE_TYPE_METAL_ANGLE;
+      break;
+#endif
+    case GLBACKEND_D3D11:
+      type = EGL_PLATFORM_ANGLE_TYPE_D3D11_ANGLE;
+      break;
+#ifdef EGL_PLATFORM_ANGLE_TYPE_NULL_ANGLE
+    case GLBACKEND_NULL:
+      type = EGL_PLATFORM_ANGLE_TYPE_NULL_ANGLE;
+      break;
+#endif
+    default:
+      return false;
+  }
+  attribs.push_back(EGL_PLATFORM_ANGLE_TYPE_ANGLE);
+  attribs.push_back(type);
+  return true;
+}
+#endif
+
+//Opens a display for a slot. Power preference and slots past the first of
+//a backend need a platform that can create independent displays, without
+//one they share the backend's first display.
+static EGLDisplay openDisplay(int backend, bool lowPower, int index) {
+#ifdef EGL_PLATFORM_ANGLE_ANGLE
+  std::vector<EGLint> attribs;
+  if (!backendAttribs(backend, attribs)) {
+    return EGL_NO_DISPLAY;
+  }
+#ifdef EGL_POWER_PREFERENCE_ANGLE
+  if (lowPower) {
+    attribs.push_back(EGL_POWER_PREFERENCE_ANGLE);
+    attribs.push_back(EGL_LOW_POWER_ANGLE);
+  }
+#endif
+#ifdef EGL_PLATFORM_ANGLE_DISPLAY_KEY_ANGLE
+  if (index > 0) {
+    attribs.push_back(EGL_PLATFORM_ANGLE_DISPLAY_KEY_ANGLE);
+    attribs.push_back(index);
+  }
+#endif
+  if (!attribs.empty()) {
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+      reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (!getPlatformDisplay) {
+      return backend == GLBACKEND_DEFAULT
+        ? eglGetDisplay(EGL_DEFAULT_DISPLAY)
+        : EGL_NO_DISPLAY;
+    }
+    attribs.push_back(EGL_NONE);
+    return getPlatformDisplay(
+      EGL_PLATFORM_ANGLE_ANGLE,
+      reinterpret_cast<void*>(EGL_DEFAULT_DISPLAY),
+      attribs.data());
+  }
+#endif
+  //Without ANGLE only the default display can be opened
+  return backend == GLBACKEND_DEFAULT
+    ? eglGetDisplay(EGL_DEFAULT_DISPLAY)
+    : EGL_NO_DISPLAY;
+}
+
+//Picks the display slot for a new context, explicitly by displayIndex or
+//round robin over the first displayCount slots of its backend, and opens
+//it if needed. Returns -1 if no display could be initialized.
+int WebGLRenderingContext::acquireDisplay(
+    int backend
+  , bool lowPower
+  , int displayCount
+  , int displayIndex
+  , EGLDisplay* display) {
+  std::lock_guard<std::mutex> lock(DISPLAY_MUTEX);
+
+  int index;
+  if (displayIndex >= 0) {
+    index = displayIndex % MAX_DISPLAYS;
+  } else {
+    displayCount = std::max(1, std::min(displayCount, MAX_DISPLAYS));
+    index = NEXT_DISPLAY++ % displayCount;
+  }
+
+  int slot = -1;
+  for (size_t i = 0; i < DISPLAYS.size(); ++i) {
+    if (DISPLAYS[i].backend == backend &&
+        DISPLAYS[i].lowPower == lowPower &&
+        DISPLAYS[i].index == index) {
+      slot = i;
+      break;
+    }
+  }
+
+  if (slot < 0 || DISPLAYS[slot].display == EGL_NO_DISPLAY) {
+    EGLDisplay opened = openDisplay(backend, lowPower, index);
+    if (opened == EGL_NO_DISPLAY) {
+      return -1;
+    }
+
+    //Share the slot that already has this display, so that it is not
+    //terminated while contexts of another slot still use it
+    for (size_t i = 0; i < DISPLAYS.size(); ++i) {
+      if (DISPLAYS[i].display == opened) {
+        DISPLAYS[i].users += 1;
+        *display = opened;
+        return i;
+      }
+    }
+
+    if (!eglInitialize(opened, NULL, NULL)) {
+      return -1;
+    }
+    if (slot < 0) {
+      DisplaySlot empty = { backend, lowPower, index, EGL_NO_DISPLAY, 0 };
+      DISPLAYS.push_back(empty);
+      slot = DISPLAYS.size() - 1;
+    }
+    DISPLAYS[slot].display = opened;
+  }
+
+  DISPLAYS[slot].users += 1;
+  *display = DISPLAYS[slot].display;
+  return slot;
+}
+
+void WebGLRenderingContext::releaseDisplay() {
+  if (displaySlot >= 0) {
+    std::lock_guard<std::mutex> lock(DISPLAY_MUTEX);
+    DISPLAYS[displaySlot].users -= 1;
+    displaySlot = -1;
+  }
 }
 
 WebGLRenderingContext::~WebGLRenderingContext() {
@@ -242,19 +735,27 @@ GL_METHOD(SetError) {
   inst->setError((GLenum)(Nan::To<int32_t>(info[0]).ToChecked()));
 }
 
-GL_METHOD(DisposeAll) {
-  Nan::HandleScope();
-
+void WebGLRenderingContext::disposeThreadContexts() {
   while(CONTEXT_LIST_HEAD) {
     CONTEXT_LIST_HEAD->dispose();
   }
 
-  if(WebGLRenderingContext::HAS_DISPLAY) {
-    eglTerminate(WebGLRenderingContext::DISPLAY);
-    WebGLRenderingContext::HAS_DISPLAY = false;
+  //Contexts on other threads keep their displays alive
+  std::lock_guard<std::mutex> lock(DISPLAY_MUTEX);
+  for (size_t i = 0; i < DISPLAYS.size(); ++i) {
+    if (DISPLAYS[i].display != EGL_NO_DISPLAY && DISPLAYS[i].users == 0) {
+      eglTerminate(DISPLAYS[i].display);
+      DISPLAYS[i].display = EGL_NO_DISPLAY;
+    }
   }
 }
 
+GL_METHOD(DisposeAll) {
+  Nan::HandleScope();
+
+  disposeThreadContexts();
+}
+
 GL_METHOD(New) {
   Nan::HandleScope();
 
@@ -269,9 +770,15 @@ GL_METHOD(New) {
     , (Nan::To<bool>(info[7]).ToChecked()) //preserve drawing buffer
     , (Nan::To<bool>(info[8]).ToChecked()) //low power
     , (Nan::To<bool>(info[9]).ToChecked()) //fail if crap
+    , Nan::To<int32_t>(info[10]).FromMaybe(1) //WebGL version
+    , Nan::To<int32_t>(info[11]).FromMaybe(1) //Displays to spread over
+    , Nan::To<int32_t>(info[12]).FromMaybe(-1) //Explicit display
+    , Nan::To<int32_t>(info[13]).FromMaybe(0) //ANGLE backend
+    , Nan::To<int32_t>(info[14]).FromMaybe(0) //ANGLE worker threads
   );
 
   if(instance->state != GLCONTEXT_STATE_OK){
+    delete instance;
     return Nan::ThrowError("Error creating WebGLContext");
   }
 
@@ -448,6 +955,7 @@ GL_METHOD(DrawArraysInstanced) {
   GLuint  icount = Nan::To<uint32_t>(info[3]).ToChecked();
 
   (inst->glDrawArraysInstanced)(mode, first, count, icount);
+  inst->countDraws(1);
 }
 
 GL_METHOD(DrawElementsInstanced) {
@@ -465,6 +973,7 @@ GL_METHOD(DrawElementsInstanced) {
     type,
     reinterpret_cast<GLvoid*>(offset),
     icount);
+  inst->countDraws(1);
 }
 
 GL_METHOD(DrawArrays) {
@@ -475,6 +984,7 @@ GL_METHOD(DrawArrays) {
   GLint  count = Nan::To<int32_t>(info[2]).ToChecked();
 
   (inst->glDrawArrays)(mode, first, count);
+  inst->countDraws(1);
 }
 
 GL_METHOD(UniformMatrix2fv) {
@@ -511,7 +1021,11 @@ GL_METHOD(GenerateMipmap) {
   GL_BOILERPLATE;
 
   GLint target = Nan::To<int32_t>(info[0]).ToChecked();
+  if (!inst->allocMipmaps(target)) {
+    return;
+  }
   (inst->glGenerateMipmap)(target);
+  inst->commitMipmaps(target);
 }
 
 GL_METHOD(GetAttribLocation) {
@@ -717,6 +1231,7 @@ GL_METHOD(BindTexture) {
   GLint texture = Nan::To<int32_t>(info[1]).ToChecked();
 
   (inst->glBindTexture)(target, texture);
+  inst->textureBindings[textureBindingSlot(target)] = texture;
 }
 
 unsigned char* WebGLRenderingContext::unpackPixels(
@@ -725,6 +1240,26 @@ unsigned char* WebGLRenderingContext::unpackPixels(
   GLint width,
   GLint height,
   unsigned char* pixels) {
+  return unpackPixels(
+    type,
+    format,
+    width,
+    height,
+    pixels,
+    unpack_flip_y,
+    unpack_premultiply_alpha,
+    unpack_alignment);
+}
+
+unsigned char* WebGLRenderingContext::unpackPixels(
+  GLenum type,
+  GLenum format,
+  GLint width,
+  GLint height,
+  unsigned char* pixels,
+  bool flipY,
+  bool premultiplyAlpha,
+  GLint alignment) {
 
   //Compute pixel size
   GLint pixelSize = 1;
@@ -752,14 +1287,14 @@ unsigned char* WebGLRenderingContext::unpackPixels(
 
   //Compute row stride
   GLint rowStride = pixelSize * width;
-  if((rowStride % unpack_alignment) != 0) {
-    rowStride += unpack_alignment - (rowStride % unpack_alignment);
+  if((rowStride % alignment) != 0) {
+    rowStride += alignment - (rowStride % alignment);
   }
 
   GLint imageSize = rowStride * height;
   unsigned char* unpacked = new unsigned char[imageSize];
 
-  if(unpack_flip_y) {
+  if(flipY) {
     for(int i=0,j=height-1; j>=0; ++i, --j) {
       memcpy(
           reinterpret_cast<void*>(unpacked + j*rowStride)
@@ -774,7 +1309,7 @@ unsigned char* WebGLRenderingContext::unpackPixels(
   }
 
   //Premultiply alpha unpacking
-  if(unpack_premultiply_alpha &&
+  if(premultiplyAlpha &&
      (format == GL_LUMINANCE_ALPHA ||
       format == GL_RGBA)) {
 
@@ -825,7 +1360,32 @@ GL_METHOD(TexImage2D) {
   GLint border          = Nan::To<int32_t>(info[5]).ToChecked();
   GLenum format         = Nan::To<int32_t>(info[6]).ToChecked();
   GLint type            = Nan::To<int32_t>(info[7]).ToChecked();
+
+  WebGLRenderingContext::ImageMemory image =
+    { width, height, 1, pixelBytes(internalformat, type) };
+  if (!inst->allocTextureImage(target, level, image)) {
+    return;
+  }
+
+  //Offset into the bound PIXEL_UNPACK_BUFFER
+  if(info[8]->IsNumber()) {
+    (inst->glTexImage2D)(
+        target
+      , level
+      , internalformat
+      , width
+      , height
+      , border
+      , format
+      , type
+      , reinterpret_cast<void*>(static_cast<intptr_t>(
+          Nan::To<int64_t>(info[8]).ToChecked())));
+    inst->commitTextureImage(target, level, image);
+    return;
+  }
+
   Nan::TypedArrayContents<unsigned char> pixels(info[8]);
+  inst->countUpload(pixels.length());
 
   if(*pixels) {
     if(inst->unpack_flip_y || inst->unpack_premultiply_alpha) {
@@ -877,6 +1437,7 @@ GL_METHOD(TexImage2D) {
       , data);
     delete[] data;
   }
+  inst->commitTextureImage(target, level, image);
 }
 
 GL_METHOD(TexSubImage2D) {
@@ -890,7 +1451,25 @@ GL_METHOD(TexSubImage2D) {
   GLsizei height  = Nan::To<int32_t>(info[5]).ToChecked();
   GLenum format   = Nan::To<int32_t>(info[6]).ToChecked();
   GLenum type     = Nan::To<int32_t>(info[7]).ToChecked();
+
+  //Offset into the bound PIXEL_UNPACK_BUFFER
+  if(info[8]->IsNumber()) {
+    (inst->glTexSubImage2D)(
+        target
+      , level
+      , xoffset
+      , yoffset
+      , width
+      , height
+      , format
+      , type
+      , reinterpret_cast<void*>(static_cast<intptr_t>(
+          Nan::To<int64_t>(info[8]).ToChecked())));
+    return;
+  }
+
   Nan::TypedArrayContents<unsigned char> pixels(info[8]);
+  inst->countUpload(pixels.length());
 
   if(inst->unpack_flip_y ||
      inst->unpack_premultiply_alpha) {
@@ -1041,12 +1620,38 @@ GL_METHOD(BufferData) {
 
   GLint target = Nan::To<int32_t>(info[0]).ToChecked();
   GLenum usage = Nan::To<int32_t>(info[2]).ToChecked();
+  //The bound buffer is passed in by the caller, so that its size can be
+  //charged without tracking buffer bindings here
+  GLuint buffer = Nan::To<uint32_t>(info[3]).ToChecked();
+  uint64_t* bytes = buffer ? &inst->bufferBytes[buffer] : NULL;
 
   if(info[1]->IsObject()) {
     Nan::TypedArrayContents<char> array(info[1]);
+    if (bytes) {
+      inst->holdErrors();
+      if (!inst->checkBudget(*bytes, array.length())) {
+        return;
+      }
+    }
     (inst->glBufferData)(target, array.length(), static_cast<void*>(*array), usage);
+    inst->countUpload(array.length());
+    if (bytes && !inst->callFailed()) {
+      inst->memory.buffers += array.length() - *bytes;
+      *bytes = array.length();
+    }
   } else if(info[1]->IsNumber()) {
-    (inst->glBufferData)(target, Nan::To<int32_t>(info[1]).ToChecked(), NULL, usage);
+    GLsizeiptr size = Nan::To<int32_t>(info[1]).ToChecked();
+    if (bytes) {
+      inst->holdErrors();
+      if (!inst->checkBudget(*bytes, size)) {
+        return;
+      }
+    }
+    (inst->glBufferData)(target, size, NULL, usage);
+    if (bytes && !inst->callFailed()) {
+      inst->memory.buffers += size - *bytes;
+      *bytes = size;
+    }
   }
 }
 
@@ -1059,6 +1664,7 @@ GL_METHOD(BufferSubData) {
   Nan::TypedArrayContents<char> array(info[2]);
 
   (inst->glBufferSubData)(target, offset, array.length(), *array);
+  inst->countUpload(array.length());
 }
 
 
@@ -1111,6 +1717,7 @@ GL_METHOD(ActiveTexture) {
   GL_BOILERPLATE;
 
   (inst->glActiveTexture)(Nan::To<int32_t>(info[0]).ToChecked());
+  inst->forgetTextureBindings();
 }
 
 
@@ -1123,6 +1730,7 @@ GL_METHOD(DrawElements) {
   size_t offset = Nan::To<uint32_t>(info[3]).ToChecked();
 
   (inst->glDrawElements)(mode, count, type, reinterpret_cast<GLvoid*>(offset));
+  inst->countDraws(1);
 }
 
 
@@ -1135,6 +1743,7 @@ GL_METHOD(Flush) {
 GL_METHOD(Finish) {
   GL_BOILERPLATE;
 
+  CallTimer finishTimer(inst, &CallStats::finishNs);
   (inst->glFinish)();
 }
 
@@ -1242,7 +1851,39 @@ GL_METHOD(CopyTexImage2D) {
   GLsizei height        = Nan::To<int32_t>(info[6]).ToChecked();
   GLint border          = Nan::To<int32_t>(info[7]).ToChecked();
 
+  //The drawing buffer and renderable textures have 8 bit channels
+  WebGLRenderingContext::ImageMemory image =
+    { width, height, 1, pixelBytes(internalformat, GL_UNSIGNED_BYTE) };
+  if (!inst->allocTextureImage(target, level, image)) {
+    return;
+  }
+
   (inst->glCopyTexImage2D)(target, level, internalformat, x, y, width, height, border);
+  inst->commitTextureImage(target, level, image);
+}
+
+GL_METHOD(CompressedTexImage2D) {
+  GL_BOILERPLATE;
+
+  GLenum target         = Nan::To<int32_t>(info[0]).ToChecked();
+  GLint level           = Nan::To<int32_t>(info[1]).ToChecked();
+  GLenum internalformat = Nan::To<int32_t>(info[2]).ToChecked();
+  GLsizei width         = Nan::To<int32_t>(info[3]).ToChecked();
+  GLsizei height        = Nan::To<int32_t>(info[4]).ToChecked();
+  GLint border          = Nan::To<int32_t>(info[5]).ToChecked();
+  Nan::TypedArrayContents<unsigned char> data(info[6]);
+
+  //Compressed levels take as many bytes as their data
+  WebGLRenderingContext::ImageMemory image =
+    { static_cast<GLsizei>(data.length()), 1, 1, 1 };
+  if (!inst->allocTextureImage(target, level, image)) {
+    return;
+  }
+
+  inst->countUpload(data.length());
+  (inst->glCompressedTexImage2D)(
+    target, level, internalformat, width, height, border, data.length(), *data);
+  inst->commitTextureImage(target, level, image);
 }
 
 GL_METHOD(CopyTexSubImage2D) {
@@ -1435,6 +2076,7 @@ GL_METHOD(DeleteBuffer) {
   inst->unregisterGLObj(GLOBJECT_TYPE_BUFFER, buffer);
 
   (inst->glDeleteBuffers)(1, &buffer);
+  inst->forgetObject(GLOBJECT_TYPE_BUFFER, buffer);
 }
 
 GL_METHOD(DeleteFramebuffer) {
@@ -1463,6 +2105,7 @@ GL_METHOD(DeleteRenderbuffer) {
   GLuint renderbuffer = Nan::To<uint32_t>(info[0]).ToChecked();
 
   inst->unregisterGLObj(GLOBJECT_TYPE_RENDERBUFFER, renderbuffer);
+  inst->forgetObject(GLOBJECT_TYPE_RENDERBUFFER, renderbuffer);
 
   (inst->glDeleteRenderbuffers)(1, &renderbuffer);
 }
@@ -1483,8 +2126,14 @@ GL_METHOD(DeleteTexture) {
   GLuint texture = Nan::To<uint32_t>(info[0]).ToChecked();
 
   inst->unregisterGLObj(GLOBJECT_TYPE_TEXTURE, texture);
+  inst->forgetObject(GLOBJECT_TYPE_TEXTURE, texture);
 
+  //The uploader may still be writing into it
+  if (inst->textureUploader) {
+    inst->textureUploader->drain();
+  }
   (inst->glDeleteTextures)(1, &texture);
+  inst->forgetTextureBindings();
 }
 
 GL_METHOD(DetachShader) {
@@ -1601,7 +2250,101 @@ GL_METHOD(RenderbufferStorage) {
     internalformat = inst->preferredDepth;
   }
 
+  uint64_t bytes =
+    static_cast<uint64_t>(width) * height * pixelBytes(internalformat, GL_NONE);
+  if (!inst->allocRenderbuffer(bytes)) {
+    return;
+  }
+
   (inst->glRenderbufferStorage)(target, internalformat, width, height);
+  inst->commitRenderbuffer(bytes);
+}
+
+GL_METHOD(RenderbufferStorageMultisample) {
+  GL_BOILERPLATE;
+
+  GLenum target         = Nan::To<int32_t>(info[0]).ToChecked();
+  GLsizei samples       = Nan::To<int32_t>(info[1]).ToChecked();
+  GLenum internalformat = Nan::To<int32_t>(info[2]).ToChecked();
+  GLsizei width         = Nan::To<int32_t>(info[3]).ToChecked();
+  GLsizei height        = Nan::To<int32_t>(info[4]).ToChecked();
+
+  if (internalformat == GL_DEPTH_STENCIL_OES) {
+    internalformat = GL_DEPTH24_STENCIL8_OES;
+  } else if (internalformat == GL_DEPTH_COMPONENT32_OES) {
+    internalformat = inst->preferredDepth;
+  }
+
+  uint64_t bytes =
+    static_cast<uint64_t>(width) * height * std::max(samples, 1) *
+    pixelBytes(internalformat, GL_NONE);
+  if (!inst->allocRenderbuffer(bytes)) {
+    return;
+  }
+
+  (inst->glRenderbufferStorageMultisampleANGLE)(
+    target, samples, internalformat, width, height);
+  inst->commitRenderbuffer(bytes);
+}
+
+GL_METHOD(BlitFramebuffer) {
+  GL_BOILERPLATE;
+
+  GLint srcX0     = Nan::To<int32_t>(info[0]).ToChecked();
+  GLint srcY0     = Nan::To<int32_t>(info[1]).ToChecked();
+  GLint srcX1     = Nan::To<int32_t>(info[2]).ToChecked();
+  GLint srcY1     = Nan::To<int32_t>(info[3]).ToChecked();
+  GLint dstX0     = Nan::To<int32_t>(info[4]).ToChecked();
+  GLint dstY0     = Nan::To<int32_t>(info[5]).ToChecked();
+  GLint dstX1     = Nan::To<int32_t>(info[6]).ToChecked();
+  GLint dstY1     = Nan::To<int32_t>(info[7]).ToChecked();
+  GLbitfield mask = Nan::To<uint32_t>(info[8]).ToChecked();
+  GLenum filter   = Nan::To<int32_t>(info[9]).ToChecked();
+
+  //ES 3.0 blits may scale and flip, the ANGLE extension may not
+  if (inst->clientVersion >= 3) {
+    (inst->glBlitFramebuffer)(
+      srcX0, srcY0, srcX1, srcY1,
+      dstX0, dstY0, dstX1, dstY1,
+      mask, filter);
+    return;
+  }
+
+  (inst->glBlitFramebufferANGLE)(
+    srcX0, srcY0, srcX1, srcY1,
+    dstX0, dstY0, dstX1, dstY1,
+    mask, filter);
+}
+
+GL_METHOD(DiscardFramebuffer) {
+  GL_BOILERPLATE;
+
+  GLenum target = Nan::To<int32_t>(info[0]).ToChecked();
+  v8::Local<v8::Array> attachmentsArray = v8::Local<v8::Array>::Cast(info[1]);
+  GLuint numAttachments = attachmentsArray->Length();
+
+  std::vector<GLenum> attachments;
+  attachments.reserve(numAttachments + 1);
+  for (GLuint i = 0; i < numAttachments; i++) {
+    GLenum attachment = Nan::To<uint32_t>(
+      Nan::Get(attachmentsArray, i).ToLocalChecked()).ToChecked();
+    // WebGL's DEPTH_STENCIL_ATTACHMENT is bound to both points in ES2
+    if (attachment == 0x821A) {
+      attachments.push_back(GL_DEPTH_ATTACHMENT);
+      attachments.push_back(GL_STENCIL_ATTACHMENT);
+    } else {
+      attachments.push_back(attachment);
+    }
+  }
+
+  if (attachments.empty()) {
+    return;
+  }
+
+  (inst->glDiscardFramebufferEXT)(
+    target,
+    static_cast<GLsizei>(attachments.size()),
+    attachments.data());
 }
 
 GL_METHOD(GetShaderSource) {
@@ -1629,541 +2372,2420 @@ GL_METHOD(ReadPixels) {
   GLsizei height = Nan::To<int32_t>(info[3]).ToChecked();
   GLenum format  = Nan::To<int32_t>(info[4]).ToChecked();
   GLenum type    = Nan::To<int32_t>(info[5]).ToChecked();
+
+  //Offset into the bound PIXEL_PACK_BUFFER
+  if(info[6]->IsNumber()) {
+    (inst->glReadPixels)(x, y, width, height, format, type,
+      reinterpret_cast<void*>(static_cast<intptr_t>(
+        Nan::To<int64_t>(info[6]).ToChecked())));
+    return;
+  }
+
   Nan::TypedArrayContents<char> pixels(info[6]);
 
   (inst->glReadPixels)(x, y, width, height, format, type, *pixels);
 }
 
-GL_METHOD(GetTexParameter) {
+// Reads a band of RGBA rows tightly packed and flipped top-down, so that
+// consecutive bands can be concatenated into an image without a full copy.
+GL_METHOD(ReadPixelsRows) {
   GL_BOILERPLATE;
 
-  GLenum target     = Nan::To<int32_t>(info[0]).ToChecked();
-  GLenum pname      = Nan::To<int32_t>(info[1]).ToChecked();
-  
-  if (pname == GL_TEXTURE_MAX_ANISOTROPY_EXT) {
-    GLfloat param_value = 0;
-    (inst->glGetTexParameterfv)(target, pname, &param_value);
-    info.GetReturnValue().Set(Nan::New<v8::Number>(param_value));
-  } else {
-    GLint param_value = 0;
-    (inst->glGetTexParameteriv)(target, pname, &param_value);
-    info.GetReturnValue().Set(Nan::New<v8::Integer>(param_value));
-  }
-}
-
-GL_METHOD(GetActiveAttrib) {
+  GLint x        = Nan::To<int32_t>(info[0]).ToChecked();
+  GLint y        = Nan::To<int32_t>(info[1]).ToChecked();
+  GLsizei width  = Nan::To<int32_t>(info[2]).ToChecked();
+  GLsizei height = Nan::To<int32_t>(info[3]).ToChecked();
+  Nan::TypedArrayContents<unsigned char> pixels(info[4]);
+
+  size_t stride = 4 * static_cast<size_t>(width);
+  if (width <= 0 || height <= 0 ||
+      pixels.length() < stride * static_cast<size_t>(height)) {
+    inst->setError(GL_INVALID_VALUE);
+    return;
+  }
+
+  GLint packAlignment = 4;
+  (inst->glGetIntegerv)(GL_PACK_ALIGNMENT, &packAlignment);
+  (inst->glPixelStorei)(GL_PACK_ALIGNMENT, 1);
+  (inst->glReadPixels)(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, *pixels);
+  (inst->glPixelStorei)(GL_PACK_ALIGNMENT, packAlignment);
+
+  unsigned char* top    = *pixels;
+  unsigned char* bottom = *pixels + stride * (height - 1);
+  while (top < bottom) {
+    std::swap_ranges(top, top + stride, bottom);
+    top    += stride;
+    bottom -= stride;
+  }
+}
+
+// Reads RGBA pixels and converts them to 4:2:0 YUV, top row first.
+GL_METHOD(ReadPixelsYUV) {
   GL_BOILERPLATE;
 
-  GLuint program = Nan::To<int32_t>(info[0]).ToChecked();
-  GLuint index   = Nan::To<int32_t>(info[1]).ToChecked();
+  GLint x        = Nan::To<int32_t>(info[0]).ToChecked();
+  GLint y        = Nan::To<int32_t>(info[1]).ToChecked();
+  GLsizei width  = Nan::To<int32_t>(info[2]).ToChecked();
+  GLsizei height = Nan::To<int32_t>(info[3]).ToChecked();
+  bool nv12      = Nan::To<bool>(info[4]).ToChecked();
+  bool bt709     = Nan::To<bool>(info[5]).ToChecked();
+  bool fullRange = Nan::To<bool>(info[6]).ToChecked();
+  Nan::TypedArrayContents<unsigned char> pixels(info[7]);
+
+  if (width <= 0 || height <= 0 ||
+      pixels.length() < yuv420FrameSize(width, height)) {
+    inst->setError(GL_INVALID_VALUE);
+    return;
+  }
 
-  GLint maxLength;
-  (inst->glGetProgramiv)(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+  YUVConversion conv;
+  initYUVConversion(conv, bt709 ? YUV_MATRIX_BT709 : YUV_MATRIX_BT601, fullRange);
 
-  char* name = new char[maxLength];
-  GLsizei length = 0;
-  GLenum  type;
-  GLsizei size;
-  (inst->glGetActiveAttrib)(program, index, maxLength, &length, &size, &type, name);
+  ptrdiff_t stride = 4 * static_cast<ptrdiff_t>(width);
+  inst->readbackBuffer.resize(stride * height);
+  unsigned char* rgba = inst->readbackBuffer.data();
 
-  if (length > 0) {
-    v8::Local<v8::Object> activeInfo = Nan::New<v8::Object>();
-    Nan::Set(activeInfo
-      , Nan::New<v8::String>("size").ToLocalChecked()
-      , Nan::New<v8::Integer>(size));
-    Nan::Set(activeInfo
-      , Nan::New<v8::String>("type").ToLocalChecked()
-      , Nan::New<v8::Integer>(type));
-    Nan::Set(activeInfo
-      , Nan::New<v8::String>("name").ToLocalChecked()
-      , Nan::New<v8::String>(name).ToLocalChecked());
-    info.GetReturnValue().Set(activeInfo);
+  GLint packAlignment = 4;
+  (inst->glGetIntegerv)(GL_PACK_ALIGNMENT, &packAlignment);
+  (inst->glPixelStorei)(GL_PACK_ALIGNMENT, 1);
+  (inst->glReadPixels)(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+  (inst->glPixelStorei)(GL_PACK_ALIGNMENT, packAlignment);
+
+  const unsigned char* top = rgba + stride * (height - 1);
+  if (nv12) {
+    rgbaToNV12(top, -stride, width, height, conv, *pixels);
   } else {
-    info.GetReturnValue().SetNull();
+    rgbaToI420(top, -stride, width, height, conv, *pixels);
   }
+}
 
-  delete[] name;
+// Reads a region, splits it into tiles and hashes each one. Tiles whose
+// hash differs from the one stored in hashes (two words per tile) are
+// packed into out as a count followed by (x, y, width, height) and the
+// tile's RGBA rows, all top-down. Returns the number of bytes written.
+GL_METHOD(ReadDirtyTiles) {
+  GL_BOILERPLATE;
+
+  GLint x        = Nan::To<int32_t>(info[0]).ToChecked();
+  GLint y        = Nan::To<int32_t>(info[1]).ToChecked();
+  GLsizei width  = Nan::To<int32_t>(info[2]).ToChecked();
+  GLsizei height = Nan::To<int32_t>(info[3]).ToChecked();
+  int tileSize   = Nan::To<int32_t>(info[4]).ToChecked();
+  bool force     = Nan::To<bool>(info[5]).ToChecked();
+  Nan::TypedArrayContents<uint32_t> hashes(info[6]);
+  Nan::TypedArrayContents<unsigned char> out(info[7]);
+
+  if (width <= 0 || height <= 0 || tileSize <= 0) {
+    inst->setError(GL_INVALID_VALUE);
+    return;
+  }
+  size_t tilesX = (width + tileSize - 1) / tileSize;
+  size_t tilesY = (height + tileSize - 1) / tileSize;
+  size_t stride = 4 * static_cast<size_t>(width);
+  if (hashes.length() < 2 * tilesX * tilesY ||
+      out.length() < 4 + 16 * tilesX * tilesY + stride * height) {
+    inst->setError(GL_INVALID_VALUE);
+    return;
+  }
+
+  inst->readbackBuffer.resize(stride * height);
+  unsigned char* rgba = inst->readbackBuffer.data();
+
+  GLint packAlignment = 4;
+  (inst->glGetIntegerv)(GL_PACK_ALIGNMENT, &packAlignment);
+  (inst->glPixelStorei)(GL_PACK_ALIGNMENT, 1);
+  (inst->glReadPixels)(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+  (inst->glPixelStorei)(GL_PACK_ALIGNMENT, packAlignment);
+
+  //Walk the image top-down, row i of the image is row height - 1 - i of
+  //the readback
+  const unsigned char* top = rgba + stride * (height - 1);
+  unsigned char* ptr = *out + 4;
+  uint32_t count = 0;
+  for (size_t ty = 0; ty < tilesY; ++ty) {
+    int tileY = static_cast<int>(ty) * tileSize;
+    int tileH = std::min(tileSize, height - tileY);
+    for (size_t tx = 0; tx < tilesX; ++tx) {
+      int tileX = static_cast<int>(tx) * tileSize;
+      int tileW = std::min(tileSize, width - tileX);
+      const unsigned char* src = top - stride * tileY + 4 * tileX;
+
+      TileHash hash = hashTile(src, -static_cast<ptrdiff_t>(stride), tileW, tileH);
+      uint32_t* prev = *hashes + 2 * (ty * tilesX + tx);
+      if (!force && prev[0] == hash.lo && prev[1] == hash.hi) {
+        continue;
+      }
+      prev[0] = hash.lo;
+      prev[1] = hash.hi;
+
+      uint32_t rect[4] = {
+        static_cast<uint32_t>(tileX),
+        static_cast<uint32_t>(tileY),
+        static_cast<uint32_t>(tileW),
+        static_cast<uint32_t>(tileH)
+      };
+      memcpy(ptr, rect, sizeof(rect));
+      ptr += sizeof(rect);
+      for (int j = 0; j < tileH; ++j) {
+        memcpy(ptr, src - stride * j, 4 * tileW);
+        ptr += 4 * tileW;
+      }
+      ++count;
+    }
+  }
+  memcpy(*out, &count, sizeof(count));
+
+  info.GetReturnValue().Set(
+    Nan::New<v8::Number>(static_cast<double>(ptr - *out)));
+}
+
+static const char* SCALED_READBACK_VERTEX_SHADER =
+  "attribute vec2 position;\n"
+  "uniform vec2 scale;\n"
+  "varying vec2 uv;\n"
+  "void main() {\n"
+  "  uv = (0.5 * position + 0.5) * scale;\n"
+  "  gl_Position = vec4(position, 0.0, 1.0);\n"
+  "}\n";
+
+static const char* SCALED_READBACK_FRAGMENT_SHADER =
+  "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
+  "precision highp float;\n"
+  "#else\n"
+  "precision mediump float;\n"
+  "#endif\n"
+  "uniform sampler2D source;\n"
+  "varying vec2 uv;\n"
+  "void main() {\n"
+  "  gl_FragColor = texture2D(source, uv);\n"
+  "}\n";
+
+bool WebGLRenderingContext::initScaledReadback() {
+  ScaledReadback& res = scaledReadback;
+  if (res.program) {
+    return true;
+  }
+
+  GLuint shaders[2] = {
+    (this->glCreateShader)(GL_VERTEX_SHADER),
+    (this->glCreateShader)(GL_FRAGMENT_SHADER)
+  };
+  (this->glShaderSource)(shaders[0], 1, &SCALED_READBACK_VERTEX_SHADER, NULL);
+  (this->glShaderSource)(shaders[1], 1, &SCALED_READBACK_FRAGMENT_SHADER, NULL);
+
+  GLuint program = (this->glCreateProgram)();
+  for (int i = 0; i < 2; ++i) {
+    (this->glCompileShader)(shaders[i]);
+    (this->glAttachShader)(program, shaders[i]);
+  }
+  (this->glBindAttribLocation)(program, 0, "position");
+  (this->glLinkProgram)(program);
+  for (int i = 0; i < 2; ++i) {
+    (this->glDeleteShader)(shaders[i]);
+  }
+
+  GLint linked = GL_FALSE;
+  (this->glGetProgramiv)(program, GL_LINK_STATUS, &linked);
+  if (!linked) {
+    (this->glDeleteProgram)(program);
+    return false;
+  }
+
+  GLint prevProgram = 0;
+  (this->glGetIntegerv)(GL_CURRENT_PROGRAM, &prevProgram);
+  (this->glUseProgram)(program);
+  (this->glUniform1i)((this->glGetUniformLocation)(program, "source"), 0);
+  (this->glUseProgram)(prevProgram);
+
+  res.program       = program;
+  res.scaleLocation = (this->glGetUniformLocation)(program, "scale");
+  registerGLObj(GLOBJECT_TYPE_PROGRAM, program);
+
+  //One triangle covering the viewport
+  static const GLfloat TRIANGLE[] = { -1, -1, 3, -1, -1, 3 };
+  GLint prevBuffer = 0;
+  (this->glGetIntegerv)(GL_ARRAY_BUFFER_BINDING, &prevBuffer);
+  (this->glGenBuffers)(1, &res.buffer);
+  (this->glBindBuffer)(GL_ARRAY_BUFFER, res.buffer);
+  (this->glBufferData)(GL_ARRAY_BUFFER, sizeof(TRIANGLE), TRIANGLE, GL_STATIC_DRAW);
+  (this->glBindBuffer)(GL_ARRAY_BUFFER, prevBuffer);
+  registerGLObj(GLOBJECT_TYPE_BUFFER, res.buffer);
+
+  (this->glGenFramebuffers)(1, &res.framebuffer);
+  registerGLObj(GLOBJECT_TYPE_FRAMEBUFFER, res.framebuffer);
+  (this->glGenTextures)(2, res.textures);
+  registerGLObj(GLOBJECT_TYPE_TEXTURE, res.textures[0]);
+  registerGLObj(GLOBJECT_TYPE_TEXTURE, res.textures[1]);
+  return true;
 }
 
-GL_METHOD(GetActiveUniform) {
+// Downsamples a region of a texture on the GPU and reads back the result.
+// With GL_LINEAR the image is halved repeatedly with bilinear taps, so
+// every pass averages 2x2 blocks; GL_NEAREST takes a single point sample.
+// All state touched here is restored before returning.
+GL_METHOD(ReadPixelsScaled) {
   GL_BOILERPLATE;
 
-  GLuint program = Nan::To<int32_t>(info[0]).ToChecked();
-  GLuint index   = Nan::To<int32_t>(info[1]).ToChecked();
+  GLuint source     = Nan::To<uint32_t>(info[0]).ToChecked();
+  GLsizei srcWidth  = Nan::To<int32_t>(info[1]).ToChecked();
+  GLsizei srcHeight = Nan::To<int32_t>(info[2]).ToChecked();
+  GLsizei texWidth  = Nan::To<int32_t>(info[3]).ToChecked();
+  GLsizei texHeight = Nan::To<int32_t>(info[4]).ToChecked();
+  GLsizei dstWidth  = Nan::To<int32_t>(info[5]).ToChecked();
+  GLsizei dstHeight = Nan::To<int32_t>(info[6]).ToChecked();
+  GLenum filter     = Nan::To<int32_t>(info[7]).ToChecked();
+  Nan::TypedArrayContents<unsigned char> pixels(info[8]);
 
-  GLint maxLength;
-  (inst->glGetProgramiv)(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+  if (srcWidth <= 0 || srcHeight <= 0 ||
+      dstWidth <= 0 || dstHeight <= 0 ||
+      srcWidth > texWidth || srcHeight > texHeight ||
+      pixels.length() < 4 * static_cast<size_t>(dstWidth) * dstHeight) {
+    inst->setError(GL_INVALID_VALUE);
+    return;
+  }
+  if (!inst->initScaledReadback()) {
+    inst->setError(GL_INVALID_OPERATION);
+    return;
+  }
+  ScaledReadback& res = inst->scaledReadback;
+
+  //Save state. Binding GL_FRAMEBUFFER sets the read and draw bindings,
+  //which ANGLE_framebuffer_blit lets differ, so both are saved
+  GLint prevProgram, prevFramebuffer, prevReadFramebuffer, prevArrayBuffer;
+  GLint prevActiveTexture, prevTexture, prevVertexArray = 0, prevPackAlignment;
+  GLint viewport[4];
+  GLboolean colorMask[4];
+  (inst->glGetIntegerv)(GL_CURRENT_PROGRAM, &prevProgram);
+  (inst->glGetIntegerv)(GL_FRAMEBUFFER_BINDING, &prevFramebuffer);
+  (inst->glGetIntegerv)(GL_READ_FRAMEBUFFER_BINDING_ANGLE, &prevReadFramebuffer);
+  (inst->glGetIntegerv)(GL_ARRAY_BUFFER_BINDING, &prevArrayBuffer);
+  (inst->glGetIntegerv)(GL_ACTIVE_TEXTURE, &prevActiveTexture);
+  (inst->glGetIntegerv)(GL_VERTEX_ARRAY_BINDING_OES, &prevVertexArray);
+  (inst->glGetIntegerv)(GL_PACK_ALIGNMENT, &prevPackAlignment);
+  (inst->glGetIntegerv)(GL_VIEWPORT, viewport);
+  (inst->glGetBooleanv)(GL_COLOR_WRITEMASK, colorMask);
+  (inst->glActiveTexture)(GL_TEXTURE0);
+  (inst->glGetIntegerv)(GL_TEXTURE_BINDING_2D, &prevTexture);
+
+  //GL_RASTERIZER_DISCARD comes last, it only exists in OpenGL ES 3
+  static const GLenum CAPS[] = {
+    GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST, GL_DITHER, GL_POLYGON_OFFSET_FILL,
+    GL_SAMPLE_ALPHA_TO_COVERAGE, GL_SAMPLE_COVERAGE, GL_SCISSOR_TEST,
+    GL_STENCIL_TEST, GL_RASTERIZER_DISCARD
+  };
+  const size_t allCaps = sizeof(CAPS) / sizeof(CAPS[0]);
+  const size_t numCaps = inst->clientVersion >= 3 ? allCaps : allCaps - 1;
+  GLboolean capEnabled[allCaps];
+  for (size_t i = 0; i < numCaps; ++i) {
+    capEnabled[i] = (inst->glIsEnabled)(CAPS[i]);
+    (inst->glDisable)(CAPS[i]);
+  }
 
+  if (prevVertexArray) {
+    (inst->glBindVertexArrayOES)(0);
+  }
+  GLint attribEnabled, attribSize, attribType, attribNormalized;
+  GLint attribStride, attribBuffer, attribDivisor;
+  GLvoid* attribPointer = NULL;
+  (inst->glGetVertexAttribiv)(0, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &attribEnabled);
+  (inst->glGetVertexAttribiv)(0, GL_VERTEX_ATTRIB_ARRAY_SIZE, &attribSize);
+  (inst->glGetVertexAttribiv)(0, GL_VERTEX_ATTRIB_ARRAY_TYPE, &attribType);
+  (inst->glGetVertexAttribiv)(0, GL_VERTEX_ATTRIB_ARRAY_NORMALIZED, &attribNormalized);
+  (inst->glGetVertexAttribiv)(0, GL_VERTEX_ATTRIB_ARRAY_STRIDE, &attribStride);
+  (inst->glGetVertexAttribiv)(0, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &attribBuffer);
+  (inst->glGetVertexAttribPointerv)(0, GL_VERTEX_ATTRIB_ARRAY_POINTER, &attribPointer);
+  (inst->glGetVertexAttribiv)(0, GL_VERTEX_ATTRIB_ARRAY_DIVISOR_ANGLE, &attribDivisor);
+
+  //Draw passes
+  (inst->glUseProgram)(res.program);
+  (inst->glColorMask)(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+  (inst->glBindBuffer)(GL_ARRAY_BUFFER, res.buffer);
+  (inst->glEnableVertexAttribArray)(0);
+  (inst->glVertexAttribPointer)(0, 2, GL_FLOAT, GL_FALSE, 0, NULL);
+  if (attribDivisor) {
+    (inst->glVertexAttribDivisor)(0, 0);
+  }
+  (inst->glBindFramebuffer)(GL_FRAMEBUFFER, res.framebuffer);
+
+  GLuint input = source;
+  GLsizei inWidth = srcWidth, inHeight = srcHeight;
+  GLsizei inTexWidth = texWidth, inTexHeight = texHeight;
+  bool linear = filter == GL_LINEAR;
+  int target = 0;
+  for (;;) {
+    GLsizei outWidth = dstWidth, outHeight = dstHeight;
+    if (linear) {
+      outWidth  = std::max(dstWidth,  std::min(inWidth,  (inWidth  + 1) / 2));
+      outHeight = std::max(dstHeight, std::min(inHeight, (inHeight + 1) / 2));
+      if (outWidth < 2 * dstWidth && outHeight < 2 * dstHeight) {
+        outWidth  = dstWidth;
+        outHeight = dstHeight;
+      }
+    }
 
-  char* name = new char[maxLength];
-  GLsizei length = 0;
-  GLenum  type;
-  GLsizei size;
-  (inst->glGetActiveUniform)(program, index, maxLength, &length, &size, &type, name);
+    GLuint output = res.textures[target];
+    (inst->glBindTexture)(GL_TEXTURE_2D, output);
+    if (res.widths[target] < outWidth || res.heights[target] < outHeight) {
+      res.widths[target]  = std::max(res.widths[target], outWidth);
+      res.heights[target] = std::max(res.heights[target], outHeight);
+      (inst->glTexImage2D)(
+        GL_TEXTURE_2D, 0, GL_RGBA,
+        res.widths[target], res.heights[target], 0,
+        GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+      (inst->glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      (inst->glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    (inst->glFramebufferTexture2D)(
+      GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, output, 0);
+
+    (inst->glBindTexture)(GL_TEXTURE_2D, input);
+    (inst->glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, linear ? GL_LINEAR : GL_NEAREST);
+    (inst->glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, linear ? GL_LINEAR : GL_NEAREST);
+    (inst->glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    (inst->glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    (inst->glUniform2f)(
+      res.scaleLocation,
+      static_cast<GLfloat>(inWidth) / inTexWidth,
+      static_cast<GLfloat>(inHeight) / inTexHeight);
+    (inst->glViewport)(0, 0, outWidth, outHeight);
+    (inst->glDrawArrays)(GL_TRIANGLES, 0, 3);
+
+    //The drawing buffer texture is only ever point sampled elsewhere
+    if (input == source) {
+      (inst->glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+      (inst->glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
 
-  if (length > 0) {
-    v8::Local<v8::Object> activeInfo = Nan::New<v8::Object>();
-    Nan::Set(activeInfo
-      , Nan::New<v8::String>("size").ToLocalChecked()
-      , Nan::New<v8::Integer>(size));
-    Nan::Set(activeInfo
-      , Nan::New<v8::String>("type").ToLocalChecked()
-      , Nan::New<v8::Integer>(type));
-    Nan::Set(activeInfo
-      , Nan::New<v8::String>("name").ToLocalChecked()
-      , Nan::New<v8::String>(name).ToLocalChecked());
-    info.GetReturnValue().Set(activeInfo);
+    if (outWidth == dstWidth && outHeight == dstHeight) {
+      break;
+    }
+    input       = output;
+    inWidth     = outWidth;
+    inHeight    = outHeight;
+    inTexWidth  = res.widths[target];
+    inTexHeight = res.heights[target];
+    target      = 1 - target;
+  }
+
+  (inst->glPixelStorei)(GL_PACK_ALIGNMENT, 1);
+  (inst->glReadPixels)(
+    0, 0, dstWidth, dstHeight, GL_RGBA, GL_UNSIGNED_BYTE, *pixels);
+
+  //Restore state
+  (inst->glPixelStorei)(GL_PACK_ALIGNMENT, prevPackAlignment);
+  (inst->glBindBuffer)(GL_ARRAY_BUFFER, attribBuffer);
+  (inst->glVertexAttribPointer)(
+    0, attribSize, attribType, attribNormalized, attribStride, attribPointer);
+  if (attribDivisor) {
+    (inst->glVertexAttribDivisor)(0, attribDivisor);
+  }
+  if (!attribEnabled) {
+    (inst->glDisableVertexAttribArray)(0);
+  }
+  if (prevVertexArray) {
+    (inst->glBindVertexArrayOES)(prevVertexArray);
+  }
+  (inst->glBindBuffer)(GL_ARRAY_BUFFER, prevArrayBuffer);
+  (inst->glBindFramebuffer)(GL_DRAW_FRAMEBUFFER_ANGLE, prevFramebuffer);
+  (inst->glBindFramebuffer)(GL_READ_FRAMEBUFFER_ANGLE, prevReadFramebuffer);
+  (inst->glBindTexture)(GL_TEXTURE_2D, prevTexture);
+  (inst->glActiveTexture)(prevActiveTexture);
+  inst->forgetTextureBindings();
+  (inst->glUseProgram)(prevProgram);
+  (inst->glViewport)(viewport[0], viewport[1], viewport[2], viewport[3]);
+  (inst->glColorMask)(colorMask[0], colorMask[1], colorMask[2], colorMask[3]);
+  for (size_t i = 0; i < numCaps; ++i) {
+    if (capEnabled[i]) {
+      (inst->glEnable)(CAPS[i]);
+    }
+  }
+}
+
+// Clears every attachment of a framebuffer to zero without disturbing the
+// clear values, write masks, scissor test or framebuffer bindings.
+GL_METHOD(ClearFramebuffer) {
+  GL_BOILERPLATE;
+
+  GLuint framebuffer = Nan::To<uint32_t>(info[0]).ToChecked();
+
+  GLint prevFramebuffer, prevReadFramebuffer;
+  GLint stencilClear, stencilMask, stencilBackMask;
+  GLfloat colorClear[4], depthClear;
+  GLboolean colorMask[4], depthMask;
+  (inst->glGetIntegerv)(GL_FRAMEBUFFER_BINDING, &prevFramebuffer);
+  (inst->glGetIntegerv)(GL_READ_FRAMEBUFFER_BINDING_ANGLE, &prevReadFramebuffer);
+  (inst->glGetFloatv)(GL_COLOR_CLEAR_VALUE, colorClear);
+  (inst->glGetFloatv)(GL_DEPTH_CLEAR_VALUE, &depthClear);
+  (inst->glGetIntegerv)(GL_STENCIL_CLEAR_VALUE, &stencilClear);
+  (inst->glGetBooleanv)(GL_COLOR_WRITEMASK, colorMask);
+  (inst->glGetBooleanv)(GL_DEPTH_WRITEMASK, &depthMask);
+  (inst->glGetIntegerv)(GL_STENCIL_WRITEMASK, &stencilMask);
+  (inst->glGetIntegerv)(GL_STENCIL_BACK_WRITEMASK, &stencilBackMask);
+  GLboolean scissorTest = (inst->glIsEnabled)(GL_SCISSOR_TEST);
+
+  (inst->glBindFramebuffer)(GL_FRAMEBUFFER, framebuffer);
+  (inst->glDisable)(GL_SCISSOR_TEST);
+  (inst->glClearColor)(0, 0, 0, 0);
+  (inst->glClearDepthf)(1);
+  (inst->glClearStencil)(0);
+  (inst->glColorMask)(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+  (inst->glDepthMask)(GL_TRUE);
+  (inst->glStencilMask)(~0u);
+  (inst->glClear)(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+  (inst->glClearColor)(colorClear[0], colorClear[1], colorClear[2], colorClear[3]);
+  (inst->glClearDepthf)(depthClear);
+  (inst->glClearStencil)(stencilClear);
+  (inst->glColorMask)(colorMask[0], colorMask[1], colorMask[2], colorMask[3]);
+  (inst->glDepthMask)(depthMask);
+  (inst->glStencilMaskSeparate)(GL_FRONT, stencilMask);
+  (inst->glStencilMaskSeparate)(GL_BACK, stencilBackMask);
+  if (scissorTest) {
+    (inst->glEnable)(GL_SCISSOR_TEST);
+  }
+  (inst->glBindFramebuffer)(GL_DRAW_FRAMEBUFFER_ANGLE, prevFramebuffer);
+  (inst->glBindFramebuffer)(GL_READ_FRAMEBUFFER_ANGLE, prevReadFramebuffer);
+}
+
+// Resolves the color buffer of the multisampled drawing buffer into its
+// single sampled counterpart, which is left bound to GL_FRAMEBUFFER for
+// the read that follows.
+GL_METHOD(ResolveDrawingBuffer) {
+  GL_BOILERPLATE;
+
+  GLuint src    = Nan::To<uint32_t>(info[0]).ToChecked();
+  GLuint dst    = Nan::To<uint32_t>(info[1]).ToChecked();
+  GLint width   = Nan::To<int32_t>(info[2]).ToChecked();
+  GLint height  = Nan::To<int32_t>(info[3]).ToChecked();
+
+  // Blits are clipped by the scissor test
+  GLboolean scissorTest = (inst->glIsEnabled)(GL_SCISSOR_TEST);
+  if (scissorTest) {
+    (inst->glDisable)(GL_SCISSOR_TEST);
+  }
+
+  (inst->glBindFramebuffer)(GL_READ_FRAMEBUFFER_ANGLE, src);
+  (inst->glBindFramebuffer)(GL_DRAW_FRAMEBUFFER_ANGLE, dst);
+  (inst->glBlitFramebufferANGLE)(
+    0, 0, width, height,
+    0, 0, width, height,
+    GL_COLOR_BUFFER_BIT, GL_NEAREST);
+  (inst->glBindFramebuffer)(GL_FRAMEBUFFER, dst);
+
+  if (scissorTest) {
+    (inst->glEnable)(GL_SCISSOR_TEST);
+  }
+}
+
+GL_METHOD(OpenFrameSink) {
+  GL_BOILERPLATE;
+
+  int fd          = Nan::To<int32_t>(info[0]).ToChecked();
+  int width       = Nan::To<int32_t>(info[1]).ToChecked();
+  int height      = Nan::To<int32_t>(info[2]).ToChecked();
+  int fpsNum      = Nan::To<int32_t>(info[3]).ToChecked();
+  int fpsDen      = Nan::To<int32_t>(info[4]).ToChecked();
+  bool nv12       = Nan::To<bool>(info[5]).ToChecked();
+  bool y4m        = Nan::To<bool>(info[6]).ToChecked();
+  bool bt709      = Nan::To<bool>(info[7]).ToChecked();
+  bool fullRange  = Nan::To<bool>(info[8]).ToChecked();
+  int queueLength = Nan::To<int32_t>(info[9]).ToChecked();
+
+  if (inst->frameSink) {
+    return Nan::ThrowError("A frame sink is already open");
+  }
+  if (width <= 0 || height <= 0 || queueLength <= 0) {
+    inst->setError(GL_INVALID_VALUE);
+    return;
+  }
+
+  YUVConversion conv;
+  initYUVConversion(conv, bt709 ? YUV_MATRIX_BT709 : YUV_MATRIX_BT601, fullRange);
+  inst->frameSink = new FrameSink(
+    fd,
+    width,
+    height,
+    fpsNum,
+    fpsDen,
+    nv12 ? FRAME_SINK_NV12 : FRAME_SINK_I420,
+    y4m,
+    conv,
+    queueLength);
+}
+
+// Reads the bound framebuffer into the next free frame slot. Blocks while
+// the writer thread is behind by a full queue.
+GL_METHOD(WriteFrameSink) {
+  GL_BOILERPLATE;
+
+  FrameSink* sink = inst->frameSink;
+  if (!sink) {
+    return Nan::ThrowError("No frame sink is open");
+  }
+  if (sink->failed()) {
+    info.GetReturnValue().Set(Nan::False());
+    return;
+  }
+
+  unsigned char* frame = sink->acquire();
+  GLint packAlignment = 4;
+  (inst->glGetIntegerv)(GL_PACK_ALIGNMENT, &packAlignment);
+  (inst->glPixelStorei)(GL_PACK_ALIGNMENT, 1);
+  (inst->glReadPixels)(
+    0, 0, sink->width(), sink->height(), GL_RGBA, GL_UNSIGNED_BYTE, frame);
+  (inst->glPixelStorei)(GL_PACK_ALIGNMENT, packAlignment);
+  sink->submit(frame);
+
+  info.GetReturnValue().Set(Nan::True());
+}
+
+GL_METHOD(CloseFrameSink) {
+  GL_BOILERPLATE;
+
+  FrameSink* sink = inst->frameSink;
+  if (!sink) {
+    return;
+  }
+  inst->frameSink = NULL;
+  bool ok = sink->close();
+  delete sink;
+
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(ok));
+}
+
+GL_METHOD(OpenFrameRing) {
+  GL_BOILERPLATE;
+
+  Nan::Utf8String name(info[0]);
+  int slotCount = Nan::To<int32_t>(info[1]).ToChecked();
+  int width     = Nan::To<int32_t>(info[2]).ToChecked();
+  int height    = Nan::To<int32_t>(info[3]).ToChecked();
+
+  if (inst->frameRing) {
+    return Nan::ThrowError("A frame ring is already open");
+  }
+  if (slotCount <= 0 || width <= 0 || height <= 0) {
+    inst->setError(GL_INVALID_VALUE);
+    return;
+  }
+
+  FrameRingWriter* ring = new FrameRingWriter();
+  if (!ring->create(*name, slotCount, width, height)) {
+    delete ring;
+    return Nan::ThrowError("Could not create shared memory frame ring");
+  }
+  inst->frameRing = ring;
+}
+
+// Reads a rectangle of the bound framebuffer straight into the next slot of
+// the ring and returns the frame number it was published as.
+GL_METHOD(WriteFrameRing) {
+  GL_BOILERPLATE;
+
+  GLint x        = Nan::To<int32_t>(info[0]).ToChecked();
+  GLint y        = Nan::To<int32_t>(info[1]).ToChecked();
+  GLsizei width  = Nan::To<int32_t>(info[2]).ToChecked();
+  GLsizei height = Nan::To<int32_t>(info[3]).ToChecked();
+
+  FrameRingWriter* ring = inst->frameRing;
+  if (!ring) {
+    return Nan::ThrowError("No frame ring is open");
+  }
+  unsigned char* pixels = ring->beginFrame(width, height);
+  if (!pixels) {
+    inst->setError(GL_INVALID_VALUE);
+    return;
+  }
+
+  GLint packAlignment = 4;
+  (inst->glGetIntegerv)(GL_PACK_ALIGNMENT, &packAlignment);
+  (inst->glPixelStorei)(GL_PACK_ALIGNMENT, 1);
+  (inst->glReadPixels)(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+  (inst->glPixelStorei)(GL_PACK_ALIGNMENT, packAlignment);
+
+  info.GetReturnValue().Set(
+    Nan::New<v8::Number>(static_cast<double>(ring->endFrame())));
+}
+
+GL_METHOD(CloseFrameRing) {
+  GL_BOILERPLATE;
+
+  delete inst->frameRing;
+  inst->frameRing = NULL;
+}
+
+// Starts a background thread with a shared context for ReadTextureAsync,
+// returns false if the shared context could not be created.
+GL_METHOD(OpenReadbackWorker) {
+  GL_BOILERPLATE;
+
+  if (!inst->readbackWorker) {
+    inst->readbackWorker = ReadbackWorker::create(
+      inst->display, inst->config, inst->context, inst->clientVersion);
+  }
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(inst->readbackWorker != NULL));
+}
+
+// Queues a read of a texture into pixels once all commands issued so far
+// have completed, and returns a ticket for WaitTextureRead. pixels must be
+// kept alive until the read has been waited for.
+GL_METHOD(ReadTextureAsync) {
+  GL_BOILERPLATE;
+
+  GLuint texture = Nan::To<uint32_t>(info[0]).ToChecked();
+  GLsizei width  = Nan::To<int32_t>(info[1]).ToChecked();
+  GLsizei height = Nan::To<int32_t>(info[2]).ToChecked();
+  Nan::TypedArrayContents<unsigned char> pixels(info[3]);
+
+  ReadbackWorker* worker = inst->readbackWorker;
+  if (!worker) {
+    return Nan::ThrowError("No readback worker is running");
+  }
+  if (width <= 0 || height <= 0 ||
+      pixels.length() < 4 * static_cast<size_t>(width) * height) {
+    inst->setError(GL_INVALID_VALUE);
+    return;
+  }
+
+  EGLSyncKHR fence = worker->fence();
+  if (fence == EGL_NO_SYNC_KHR) {
+    (inst->glFinish)();
   } else {
-    info.GetReturnValue().SetNull();
+    (inst->glFlush)();
+  }
+
+  uint64_t ticket = worker->submit(texture, width, height, fence, *pixels);
+  info.GetReturnValue().Set(
+    Nan::New<v8::Number>(static_cast<double>(ticket)));
+}
+
+GL_METHOD(WaitTextureRead) {
+  GL_BOILERPLATE;
+
+  uint64_t ticket = static_cast<uint64_t>(
+    Nan::To<double>(info[0]).ToChecked());
+  if (inst->readbackWorker) {
+    inst->readbackWorker->wait(ticket);
+  }
+}
+
+GL_METHOD(OpenRenderPool) {
+  GL_BOILERPLATE;
+
+  if (!inst->renderPool) {
+    inst->renderPool = RenderPool::create(
+      Nan::To<int32_t>(info[0]).ToChecked(),
+      Nan::To<int32_t>(info[1]).ToChecked(),
+      Nan::To<int32_t>(info[2]).ToChecked(),
+      inst->backend);
+  }
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(inst->renderPool != NULL));
+}
+
+static v8::Local<v8::Value> jobField(v8::Local<v8::Object> obj, const char* name) {
+  return Nan::Get(obj, Nan::New(name).ToLocalChecked()).ToLocalChecked();
+}
+
+static v8::Local<v8::Object> jobObject(v8::Local<v8::Value> value) {
+  return value.As<v8::Object>();
+}
+
+template <typename T>
+static void copyTypedArray(v8::Local<v8::Value> value, std::vector<T>& out) {
+  Nan::TypedArrayContents<T> contents(value);
+  out.assign(*contents, *contents + contents.length());
+}
+
+// Copies a job that the JavaScript side has already validated and put in a
+// fixed shape, and queues it with callback. Returns false if the pool is
+// full, in which case the job should be submitted again later.
+GL_METHOD(SubmitRenderJob) {
+  GL_BOILERPLATE;
+
+  RenderPool* pool = inst->renderPool;
+  if (!pool) {
+    return Nan::ThrowError("No render pool is running");
+  }
+  if (pool->full()) {
+    info.GetReturnValue().Set(Nan::False());
+    return;
+  }
+
+  v8::Local<v8::Object> desc = jobObject(info[0]);
+  RenderJob* job = new RenderJob();
+  job->width  = Nan::To<int32_t>(jobField(desc, "width")).ToChecked();
+  job->height = Nan::To<int32_t>(jobField(desc, "height")).ToChecked();
+  job->vertexShader   = *Nan::Utf8String(jobField(desc, "vertexShader"));
+  job->fragmentShader = *Nan::Utf8String(jobField(desc, "fragmentShader"));
+  job->depthTest = Nan::To<bool>(jobField(desc, "depthTest")).ToChecked();
+
+  Nan::TypedArrayContents<GLfloat> clearColor(jobField(desc, "clearColor"));
+  for (size_t i = 0; i < 4 && i < clearColor.length(); ++i) {
+    job->clearColor[i] = (*clearColor)[i];
+  }
+
+  v8::Local<v8::Array> attributes = jobField(desc, "attributes").As<v8::Array>();
+  job->attributes.resize(attributes->Length());
+  for (uint32_t i = 0; i < attributes->Length(); ++i) {
+    v8::Local<v8::Object> attribute = jobObject(Nan::Get(attributes, i).ToLocalChecked());
+    RenderJob::Attribute& out = job->attributes[i];
+    out.name = *Nan::Utf8String(jobField(attribute, "name"));
+    out.size = Nan::To<int32_t>(jobField(attribute, "size")).ToChecked();
+    copyTypedArray(jobField(attribute, "data"), out.data);
+  }
+
+  v8::Local<v8::Array> textures = jobField(desc, "textures").As<v8::Array>();
+  job->textures.resize(textures->Length());
+  for (uint32_t i = 0; i < textures->Length(); ++i) {
+    v8::Local<v8::Object> texture = jobObject(Nan::Get(textures, i).ToLocalChecked());
+    RenderJob::Texture& out = job->textures[i];
+    out.name   = *Nan::Utf8String(jobField(texture, "name"));
+    out.width  = Nan::To<int32_t>(jobField(texture, "width")).ToChecked();
+    out.height = Nan::To<int32_t>(jobField(texture, "height")).ToChecked();
+    out.filter = Nan::To<int32_t>(jobField(texture, "filter")).ToChecked();
+    copyTypedArray(jobField(texture, "data"), out.data);
+  }
+
+  v8::Local<v8::Array> uniforms = jobField(desc, "uniforms").As<v8::Array>();
+  job->uniforms.resize(uniforms->Length());
+  for (uint32_t i = 0; i < uniforms->Length(); ++i) {
+    v8::Local<v8::Object> uniform = jobObject(Nan::Get(uniforms, i).ToLocalChecked());
+    RenderJob::Uniform& out = job->uniforms[i];
+    out.name = *Nan::Utf8String(jobField(uniform, "name"));
+    copyTypedArray(jobField(uniform, "values"), out.values);
+  }
+
+  v8::Local<v8::Value> elements = jobField(desc, "elements");
+  if (elements->IsArrayBufferView()) {
+    job->elementType = Nan::To<int32_t>(jobField(desc, "elementType")).ToChecked();
+    copyTypedArray(elements, job->elements);
+  }
+  copyTypedArray(jobField(desc, "draws"), job->draws);
+
+  job->callback = new Nan::Callback(info[1].As<v8::Function>());
+  job->resource = new Nan::AsyncResource("gl:RenderJob");
+
+  bool queued = pool->submit(job);
+  if (!queued) {
+    delete job;
   }
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(queued));
+}
+
+// Starts a background thread with a shared context for TexImage2DAsync,
+// returns false if the shared context could not be created.
+GL_METHOD(OpenTextureUploader) {
+  GL_BOILERPLATE;
+
+  if (!inst->textureUploader) {
+    inst->textureUploader = TextureUploader::create(
+      inst->display, inst->config, inst->context, inst->clientVersion);
+  }
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(inst->textureUploader != NULL));
+}
+
+// Queues an upload of pixels into a level that has already been allocated
+// with TexImage2D, using the current unpack state. callback(ticket, error)
+// is called once the upload has been submitted, with an error if the
+// uploader thread could not make it. FinishTextureUpload(ticket)
+// must be called before the texture is used, and blocks if that happens
+// before the callback. pixels is kept alive until then and must not change.
+GL_METHOD(TexImage2DAsync) {
+  GL_BOILERPLATE;
+
+  TextureUploader* uploader = inst->textureUploader;
+  if (!uploader) {
+    return Nan::ThrowError("No texture uploader is running");
+  }
+
+  Nan::TypedArrayContents<unsigned char> pixels(info[8]);
+  if (!*pixels || !info[9]->IsFunction()) {
+    return Nan::ThrowTypeError("Invalid texture upload");
+  }
+
+  TextureUploader::Upload* upload = new TextureUploader::Upload();
+  upload->texture          = Nan::To<uint32_t>(info[0]).ToChecked();
+  upload->bindTarget       = Nan::To<int32_t>(info[1]).ToChecked();
+  upload->target           = Nan::To<int32_t>(info[2]).ToChecked();
+  upload->level            = Nan::To<int32_t>(info[3]).ToChecked();
+  upload->width            = Nan::To<int32_t>(info[4]).ToChecked();
+  upload->height           = Nan::To<int32_t>(info[5]).ToChecked();
+  upload->format           = Nan::To<int32_t>(info[6]).ToChecked();
+  upload->type             = Nan::To<int32_t>(info[7]).ToChecked();
+  upload->alignment        = inst->unpack_alignment;
+  upload->flipY            = inst->unpack_flip_y;
+  upload->premultiplyAlpha = inst->unpack_premultiply_alpha;
+  upload->pixels           = *pixels;
+  upload->buffer.Reset(info[8].As<v8::Object>());
+  upload->callback = new Nan::Callback(info[9].As<v8::Function>());
+  upload->resource = new Nan::AsyncResource("gl:TextureUpload");
+  inst->countUpload(pixels.length());
+
+  //The level allocated by this context must be visible to the uploader
+  (inst->glFlush)();
+
+  uint64_t ticket = uploader->submit(upload);
+  info.GetReturnValue().Set(
+    Nan::New<v8::Number>(static_cast<double>(ticket)));
+}
+
+GL_METHOD(FinishTextureUpload) {
+  GL_BOILERPLATE;
+
+  uint64_t ticket = static_cast<uint64_t>(
+    Nan::To<double>(info[0]).ToChecked());
+  if (inst->textureUploader) {
+    inst->textureUploader->finish(ticket);
+  }
+}
+
+GL_METHOD(SetCallAccounting) {
+  GL_BOILERPLATE;
+
+  inst->accounting = Nan::To<bool>(info[0]).ToChecked();
+}
+
+// Writes [callMs, finishMs, calls, draws, uploads, uploadBytes] into a
+// Float64Array, and starts counting from zero again if asked to.
+GL_METHOD(GetCallStats) {
+  GL_BOILERPLATE;
+
+  Nan::TypedArrayContents<double> out(info[0]);
+  if (out.length() < 6) {
+    return Nan::ThrowRangeError("Call stats need 6 elements");
+  }
+
+  const CallStats& stats = inst->callStats;
+  double* values = *out;
+  values[0] = stats.callNs / 1e6;
+  values[1] = stats.finishNs / 1e6;
+  values[2] = static_cast<double>(stats.calls);
+  values[3] = static_cast<double>(stats.draws);
+  values[4] = static_cast<double>(stats.uploads);
+  values[5] = static_cast<double>(stats.uploadBytes);
+
+  if (Nan::To<bool>(info[1]).ToChecked()) {
+    inst->callStats = CallStats();
+  }
+}
+
+// Writes [textures, renderbuffers, buffers, budget] in bytes into a
+// Float64Array.
+GL_METHOD(GetMemoryInfo) {
+  GL_BOILERPLATE;
+
+  Nan::TypedArrayContents<double> out(info[0]);
+  if (out.length() < 4) {
+    return Nan::ThrowRangeError("Memory info needs 4 elements");
+  }
+
+  const MemoryStats& memory = inst->memory;
+  double* values = *out;
+  values[0] = static_cast<double>(memory.textures);
+  values[1] = static_cast<double>(memory.renderbuffers);
+  values[2] = static_cast<double>(memory.buffers);
+  values[3] = static_cast<double>(memory.budget);
+}
+
+GL_METHOD(SetMemoryBudget) {
+  GL_BOILERPLATE;
+
+  double budget = Nan::To<double>(info[0]).FromMaybe(0);
+  inst->memory.budget = budget > 0 ? static_cast<uint64_t>(budget) : 0;
+}
+
+GL_METHOD(ResetContext) {
+  GL_BOILERPLATE;
+
+  Nan::TypedArrayContents<GLint> keep(info[0]);
+  inst->reset(*keep, keep.length());
+}
+
+GL_METHOD(ReleaseObjects) {
+  GL_BOILERPLATE;
+
+  GLenum target = Nan::To<int32_t>(info[0]).ToChecked();
+  Nan::TypedArrayContents<GLint> names(info[1]);
+  GLObjectType type = objectType(target);
+
+  //Names that are no longer registered were deleted some other way
+  std::vector<GLuint> dead;
+  dead.reserve(names.length());
+  for (size_t i = 0; i < names.length(); ++i) {
+    GLuint name = static_cast<GLuint>((*names)[i]);
+    if (inst->objects[type].erase(name)) {
+      inst->forgetObject(type, name);
+      dead.push_back(name);
+    }
+  }
+  if (dead.empty()) {
+    return;
+  }
+
+  switch (type) {
+    case GLOBJECT_TYPE_BUFFER:
+      (inst->glDeleteBuffers)(dead.size(), dead.data());
+      break;
+    case GLOBJECT_TYPE_FRAMEBUFFER:
+      (inst->glDeleteFramebuffers)(dead.size(), dead.data());
+      break;
+    case GLOBJECT_TYPE_RENDERBUFFER:
+      (inst->glDeleteRenderbuffers)(dead.size(), dead.data());
+      break;
+    case GLOBJECT_TYPE_TEXTURE:
+      //The uploader may still be writing into them
+      if (inst->textureUploader) {
+        inst->textureUploader->drain();
+      }
+      (inst->glDeleteTextures)(dead.size(), dead.data());
+      break;
+    default:
+      break;
+  }
+}
+
+GL_METHOD(GetTexParameter) {
+  GL_BOILERPLATE;
+
+  GLenum target     = Nan::To<int32_t>(info[0]).ToChecked();
+  GLenum pname      = Nan::To<int32_t>(info[1]).ToChecked();
+  
+  if (pname == GL_TEXTURE_MAX_ANISOTROPY_EXT) {
+    GLfloat param_value = 0;
+    (inst->glGetTexParameterfv)(target, pname, &param_value);
+    info.GetReturnValue().Set(Nan::New<v8::Number>(param_value));
+  } else {
+    GLint param_value = 0;
+    (inst->glGetTexParameteriv)(target, pname, &param_value);
+    info.GetReturnValue().Set(Nan::New<v8::Integer>(param_value));
+  }
+}
+
+GL_METHOD(GetActiveAttrib) {
+  GL_BOILERPLATE;
+
+  GLuint program = Nan::To<int32_t>(info[0]).ToChecked();
+  GLuint index   = Nan::To<int32_t>(info[1]).ToChecked();
+
+  GLint maxLength;
+  (inst->glGetProgramiv)(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+
+  char* name = new char[maxLength];
+  GLsizei length = 0;
+  GLenum  type;
+  GLsizei size;
+  (inst->glGetActiveAttrib)(program, index, maxLength, &length, &size, &type, name);
+
+  if (length > 0) {
+    v8::Local<v8::Object> activeInfo = Nan::New<v8::Object>();
+    Nan::Set(activeInfo
+      , Nan::New<v8::String>("size").ToLocalChecked()
+      , Nan::New<v8::Integer>(size));
+    Nan::Set(activeInfo
+      , Nan::New<v8::String>("type").ToLocalChecked()
+      , Nan::New<v8::Integer>(type));
+    Nan::Set(activeInfo
+      , Nan::New<v8::String>("name").ToLocalChecked()
+      , Nan::New<v8::String>(name).ToLocalChecked());
+    info.GetReturnValue().Set(activeInfo);
+  } else {
+    info.GetReturnValue().SetNull();
+  }
+
+  delete[] name;
+}
+
+GL_METHOD(GetActiveUniform) {
+  GL_BOILERPLATE;
+
+  GLuint program = Nan::To<int32_t>(info[0]).ToChecked();
+  GLuint index   = Nan::To<int32_t>(info[1]).ToChecked();
+
+  GLint maxLength;
+  (inst->glGetProgramiv)(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+
+  char* name = new char[maxLength];
+  GLsizei length = 0;
+  GLenum  type;
+  GLsizei size;
+  (inst->glGetActiveUniform)(program, index, maxLength, &length, &size, &type, name);
+
+  if (length > 0) {
+    v8::Local<v8::Object> activeInfo = Nan::New<v8::Object>();
+    Nan::Set(activeInfo
+      , Nan::New<v8::String>("size").ToLocalChecked()
+      , Nan::New<v8::Integer>(size));
+    Nan::Set(activeInfo
+      , Nan::New<v8::String>("type").ToLocalChecked()
+      , Nan::New<v8::Integer>(type));
+    Nan::Set(activeInfo
+      , Nan::New<v8::String>("name").ToLocalChecked()
+      , Nan::New<v8::String>(name).ToLocalChecked());
+    info.GetReturnValue().Set(activeInfo);
+  } else {
+    info.GetReturnValue().SetNull();
+  }
+
+  delete[] name;
+}
+
+GL_METHOD(GetAttachedShaders) {
+  GL_BOILERPLATE;
+
+  GLuint program = Nan::To<int32_t>(info[0]).ToChecked();
+
+  GLint numAttachedShaders;
+  (inst->glGetProgramiv)(program, GL_ATTACHED_SHADERS, &numAttachedShaders);
+
+  GLuint* shaders = new GLuint[numAttachedShaders];
+  GLsizei count;
+  (inst->glGetAttachedShaders)(program, numAttachedShaders, &count, shaders);
+
+  v8::Local<v8::Array> shadersArr = Nan::New<v8::Array>(count);
+  for (int i=0; i<count; i++) {
+    Nan::Set(shadersArr, i, Nan::New<v8::Integer>((int)shaders[i]));
+  }
+
+  info.GetReturnValue().Set(shadersArr);
+
+  delete[] shaders;
+}
+
+GL_METHOD(GetParameter) {
+  GL_BOILERPLATE;
+  GLenum name = Nan::To<int32_t>(info[0]).ToChecked();
+
+  switch(name) {
+    case 0x9240 /* UNPACK_FLIP_Y_WEBGL */:
+      info.GetReturnValue().Set(
+        Nan::New<v8::Boolean>(inst->unpack_flip_y));
+    return;
+
+    case 0x9241 /* UNPACK_PREMULTIPLY_ALPHA_WEBGL*/:
+      info.GetReturnValue().Set(
+        Nan::New<v8::Boolean>(inst->unpack_premultiply_alpha));
+    return;
+
+    case 0x9243 /* UNPACK_COLORSPACE_CONVERSION_WEBGL */:
+      info.GetReturnValue().Set(
+        Nan::New<v8::Integer>(inst->unpack_colorspace_conversion));
+    return;
+
+    case GL_BLEND:
+    case GL_CULL_FACE:
+    case GL_DEPTH_TEST:
+    case GL_DEPTH_WRITEMASK:
+    case GL_DITHER:
+    case GL_POLYGON_OFFSET_FILL:
+    case GL_SAMPLE_COVERAGE_INVERT:
+    case GL_SCISSOR_TEST:
+    case GL_STENCIL_TEST:
+    {
+      GLboolean params;
+      (inst->glGetBooleanv)(name, &params);
+
+      info.GetReturnValue().Set(Nan::New<v8::Boolean>(params != 0));
+
+      return;
+    }
+
+    case GL_DEPTH_CLEAR_VALUE:
+    case GL_LINE_WIDTH:
+    case GL_POLYGON_OFFSET_FACTOR:
+    case GL_POLYGON_OFFSET_UNITS:
+    case GL_SAMPLE_COVERAGE_VALUE:
+    case GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT:
+    {
+      GLfloat params;
+      (inst->glGetFloatv)(name, &params);
+
+      info.GetReturnValue().Set(Nan::New<v8::Number>(params));
+
+      return;
+    }
+
+    case GL_RENDERER:
+    case GL_SHADING_LANGUAGE_VERSION:
+    case GL_VENDOR:
+    case GL_VERSION:
+    case GL_EXTENSIONS:
+    {
+      const char *params = reinterpret_cast<const char*>((inst->glGetString)(name));
+      if(params) {
+        info.GetReturnValue().Set(
+          Nan::New<v8::String>(params).ToLocalChecked());
+      }
+      return;
+    }
+
+    case GL_MAX_VIEWPORT_DIMS:
+    {
+      GLint params[2];
+      (inst->glGetIntegerv)(name, params);
+
+      v8::Local<v8::Array> arr = Nan::New<v8::Array>(2);
+      Nan::Set(arr, 0, Nan::New<v8::Integer>(params[0]));
+      Nan::Set(arr, 1, Nan::New<v8::Integer>(params[1]));
+      info.GetReturnValue().Set(arr);
+
+      return;
+    }
+
+    case GL_SCISSOR_BOX:
+    case GL_VIEWPORT:
+    {
+      GLint params[4];
+      (inst->glGetIntegerv)(name, params);
+
+      v8::Local<v8::Array> arr=Nan::New<v8::Array>(4);
+      Nan::Set(arr, 0, Nan::New<v8::Integer>(params[0]));
+      Nan::Set(arr, 1, Nan::New<v8::Integer>(params[1]));
+      Nan::Set(arr, 2, Nan::New<v8::Integer>(params[2]));
+      Nan::Set(arr, 3, Nan::New<v8::Integer>(params[3]));
+      info.GetReturnValue().Set(arr);
+
+      return;
+    }
+
+    case GL_ALIASED_LINE_WIDTH_RANGE:
+    case GL_ALIASED_POINT_SIZE_RANGE:
+    case GL_DEPTH_RANGE:
+    {
+      GLfloat params[2];
+      (inst->glGetFloatv)(name, params);
+
+      v8::Local<v8::Array> arr=Nan::New<v8::Array>(2);
+      Nan::Set(arr, 0, Nan::New<v8::Number>(params[0]));
+      Nan::Set(arr, 1, Nan::New<v8::Number>(params[1]));
+      info.GetReturnValue().Set(arr);
+
+      return;
+    }
+
+    case GL_BLEND_COLOR:
+    case GL_COLOR_CLEAR_VALUE:
+    {
+      GLfloat params[4];
+      (inst->glGetFloatv)(name, params);
+
+      v8::Local<v8::Array> arr = Nan::New<v8::Array>(4);
+      Nan::Set(arr, 0, Nan::New<v8::Number>(params[0]));
+      Nan::Set(arr, 1, Nan::New<v8::Number>(params[1]));
+      Nan::Set(arr, 2, Nan::New<v8::Number>(params[2]));
+      Nan::Set(arr, 3, Nan::New<v8::Number>(params[3]));
+      info.GetReturnValue().Set(arr);
+
+      return;
+    }
+
+    case GL_COLOR_WRITEMASK:
+    {
+      GLboolean params[4];
+      (inst->glGetBooleanv)(name, params);
+
+      v8::Local<v8::Array> arr = Nan::New<v8::Array>(4);
+      Nan::Set(arr, 0, Nan::New<v8::Boolean>(params[0] == GL_TRUE));
+      Nan::Set(arr, 1, Nan::New<v8::Boolean>(params[1] == GL_TRUE));
+      Nan::Set(arr, 2, Nan::New<v8::Boolean>(params[2] == GL_TRUE));
+      Nan::Set(arr, 3, Nan::New<v8::Boolean>(params[3] == GL_TRUE));
+      info.GetReturnValue().Set(arr);
+
+      return;
+    }
+
+    default:
+    {
+      GLint params;
+      (inst->glGetIntegerv)(name, &params);
+      info.GetReturnValue().Set(Nan::New<v8::Integer>(params));
+      return;
+    }
+  }
+}
+
+GL_METHOD(GetBufferParameter) {
+  GL_BOILERPLATE;
+
+  GLenum target = Nan::To<int32_t>(info[0]).ToChecked();
+  GLenum pname  = Nan::To<int32_t>(info[1]).ToChecked();
+
+  GLint params;
+  (inst->glGetBufferParameteriv)(target, pname, &params);
+
+  info.GetReturnValue().Set(Nan::New<v8::Integer>(params));
+}
+
+GL_METHOD(GetFramebufferAttachmentParameter) {
+  GL_BOILERPLATE;
+
+  GLenum target     = Nan::To<int32_t>(info[0]).ToChecked();
+  GLenum attachment = Nan::To<int32_t>(info[1]).ToChecked();
+  GLenum pname      = Nan::To<int32_t>(info[2]).ToChecked();
+
+  GLint params;
+  (inst->glGetFramebufferAttachmentParameteriv)(target, attachment, pname, &params);
+
+  info.GetReturnValue().Set(Nan::New<v8::Integer>(params));
+}
+
+GL_METHOD(GetProgramInfoLog) {
+  GL_BOILERPLATE;
+
+  GLuint program = Nan::To<int32_t>(info[0]).ToChecked();
+
+  GLint infoLogLength;
+  (inst->glGetProgramiv)(program, GL_INFO_LOG_LENGTH, &infoLogLength);
+
+  char* error = new char[infoLogLength+1];
+  (inst->glGetProgramInfoLog)(program, infoLogLength+1, &infoLogLength, error);
+
+  info.GetReturnValue().Set(
+    Nan::New<v8::String>(error).ToLocalChecked());
+
+  delete[] error;
+}
+
+GL_METHOD(GetShaderPrecisionFormat) {
+  GL_BOILERPLATE;
+
+  GLenum shaderType    = Nan::To<int32_t>(info[0]).ToChecked();
+  GLenum precisionType = Nan::To<int32_t>(info[1]).ToChecked();
+
+  GLint range[2];
+  GLint precision;
+
+  (inst->glGetShaderPrecisionFormat)(shaderType, precisionType, range, &precision);
+
+  v8::Local<v8::Object> result = Nan::New<v8::Object>();
+  Nan::Set(result
+    , Nan::New<v8::String>("rangeMin").ToLocalChecked()
+    , Nan::New<v8::Integer>(range[0]));
+  Nan::Set(result
+    , Nan::New<v8::String>("rangeMax").ToLocalChecked()
+    , Nan::New<v8::Integer>(range[1]));
+  Nan::Set(result
+    , Nan::New<v8::String>("precision").ToLocalChecked()
+    , Nan::New<v8::Integer>(precision));
+
+  info.GetReturnValue().Set(result);
+}
+
+GL_METHOD(GetRenderbufferParameter) {
+  GL_BOILERPLATE;
+
+  GLenum target = Nan::To<int32_t>(info[0]).ToChecked();
+  GLenum pname  = Nan::To<int32_t>(info[1]).ToChecked();
+
+  int value;
+  (inst->glGetRenderbufferParameteriv)(target, pname, &value);
+
+  info.GetReturnValue().Set(Nan::New<v8::Integer>(value));
+}
+
+GL_METHOD(GetUniform) {
+  GL_BOILERPLATE;
+
+  GLint program  = Nan::To<int32_t>(info[0]).ToChecked();
+  GLint location = Nan::To<int32_t>(info[1]).ToChecked();
+
+  float data[16];
+  (inst->glGetUniformfv)(program, location, data);
+
+  v8::Local<v8::Array> arr = Nan::New<v8::Array>(16);
+  for (int i=0; i<16; i++) {
+    Nan::Set(arr, i, Nan::New<v8::Number>(data[i]));
+  }
+
+  info.GetReturnValue().Set(arr);
+}
+
+GL_METHOD(GetVertexAttrib) {
+  GL_BOILERPLATE;
+
+  GLint index  = Nan::To<int32_t>(info[0]).ToChecked();
+  GLenum pname = Nan::To<int32_t>(info[1]).ToChecked();
+
+  GLint value;
+
+  switch (pname) {
+    case GL_VERTEX_ATTRIB_ARRAY_ENABLED:
+    case GL_VERTEX_ATTRIB_ARRAY_NORMALIZED:
+    {
+      (inst->glGetVertexAttribiv)(index, pname, &value);
+      info.GetReturnValue().Set(Nan::New<v8::Boolean>(value != 0));
+      return;
+    }
+
+    case GL_VERTEX_ATTRIB_ARRAY_SIZE:
+    case GL_VERTEX_ATTRIB_ARRAY_STRIDE:
+    case GL_VERTEX_ATTRIB_ARRAY_TYPE:
+    {
+      (inst->glGetVertexAttribiv)(index, pname, &value);
+      info.GetReturnValue().Set(Nan::New<v8::Integer>(value));
+      return;
+    }
+
+    case GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING:
+    {
+      (inst->glGetVertexAttribiv)(index, pname, &value);
+      info.GetReturnValue().Set(Nan::New<v8::Integer>(value));
+      return;
+    }
+
+    case GL_CURRENT_VERTEX_ATTRIB:
+    {
+      float vextex_attribs[4];
+
+      (inst->glGetVertexAttribfv)(index, pname, vextex_attribs);
+
+      v8::Local<v8::Array> arr=Nan::New<v8::Array>(4);
+      Nan::Set(arr, 0,
+        Nan::New<v8::Number>(vextex_attribs[0]));
+      Nan::Set(arr, 1,
+        Nan::New<v8::Number>(vextex_attribs[1]));
+      Nan::Set(arr, 2,
+        Nan::New<v8::Number>(vextex_attribs[2]));
+      Nan::Set(arr, 3,
+        Nan::New<v8::Number>(vextex_attribs[3]));
+      info.GetReturnValue().Set(arr);
+
+      return;
+    }
+
+    default:
+      inst->setError(GL_INVALID_ENUM);
+  }
+
+  info.GetReturnValue().SetNull();
+}
+
+GL_METHOD(GetSupportedExtensions) {
+  GL_BOILERPLATE;
+
+  const char *extensions = reinterpret_cast<const char*>(
+    (inst->glGetString)(GL_EXTENSIONS));
+
+  info.GetReturnValue().Set(
+    Nan::New<v8::String>(extensions).ToLocalChecked());
+}
+
+GL_METHOD(GetExtension) {
+  GL_BOILERPLATE;
+
+  //TODO
+}
+
+GL_METHOD(CheckFramebufferStatus) {
+  GL_BOILERPLATE;
+
+  GLenum target = Nan::To<int32_t>(info[0]).ToChecked();
+
+  info.GetReturnValue().Set(
+    Nan::New<v8::Integer>(
+      static_cast<int>((inst->glCheckFramebufferStatus)(target))));
+}
+
+GL_METHOD(DrawBuffersWEBGL) {
+  GL_BOILERPLATE;
+
+  v8::Local<v8::Array> buffersArray = v8::Local<v8::Array>::Cast(info[0]);
+  GLuint numBuffers = buffersArray->Length();
+  GLenum* buffers = new GLenum[numBuffers];
+
+  for (GLuint i = 0; i < numBuffers; i++) {
+    buffers[i] = Nan::Get(buffersArray, i).ToLocalChecked()->Uint32Value(Nan::GetCurrentContext()).ToChecked();
+  }
+
+  (inst->glDrawBuffersEXT)(numBuffers, buffers);
+
+  delete[] buffers;
+}
+
+GL_METHOD(EXTWEBGL_draw_buffers) {
+  v8::Local<v8::Object> result = Nan::New<v8::Object>();
+  Nan::Set(result, Nan::New("COLOR_ATTACHMENT0_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT0_EXT));
+  Nan::Set(result, Nan::New("COLOR_ATTACHMENT1_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT1_EXT));
+  Nan::Set(result, Nan::New("COLOR_ATTACHMENT2_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT2_EXT));
+  Nan::Set(result, Nan::New("COLOR_ATTACHMENT3_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT3_EXT));
+  Nan::Set(result, Nan::New("COLOR_ATTACHMENT4_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT4_EXT));
+  Nan::Set(result, Nan::New("COLOR_ATTACHMENT5_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT5_EXT));
+  Nan::Set(result, Nan::New("COLOR_ATTACHMENT6_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT6_EXT));
+  Nan::Set(result, Nan::New("COLOR_ATTACHMENT7_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT7_EXT));
+  Nan::Set(result, Nan::New("COLOR_ATTACHMENT8_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT8_EXT));
+  Nan::Set(result, Nan::New("COLOR_ATTACHMENT9_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT9_EXT));
+  Nan::Set(result, Nan::New("COLOR_ATTACHMENT10_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT10_EXT));
+  Nan::Set(result, Nan::New("COLOR_ATTACHMENT11_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT11_EXT));
+  Nan::Set(result, Nan::New("COLOR_ATTACHMENT12_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT12_EXT));
+  Nan::Set(result, Nan::New("COLOR_ATTACHMENT13_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT13_EXT));
+  Nan::Set(result, Nan::New("COLOR_ATTACHMENT14_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT14_EXT));
+  Nan::Set(result, Nan::New("COLOR_ATTACHMENT15_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT15_EXT));
+
+  Nan::Set(result, Nan::New("DRAW_BUFFER0_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER0_EXT));
+  Nan::Set(result, Nan::New("DRAW_BUFFER1_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER1_EXT));
+  Nan::Set(result, Nan::New("DRAW_BUFFER2_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER2_EXT));
+  Nan::Set(result, Nan::New("DRAW_BUFFER3_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER3_EXT));
+  Nan::Set(result, Nan::New("DRAW_BUFFER4_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER4_EXT));
+  Nan::Set(result, Nan::New("DRAW_BUFFER5_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER5_EXT));
+  Nan::Set(result, Nan::New("DRAW_BUFFER6_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER6_EXT));
+  Nan::Set(result, Nan::New("DRAW_BUFFER7_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER7_EXT));
+  Nan::Set(result, Nan::New("DRAW_BUFFER8_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER8_EXT));
+  Nan::Set(result, Nan::New("DRAW_BUFFER9_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER9_EXT));
+  Nan::Set(result, Nan::New("DRAW_BUFFER10_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER10_EXT));
+  Nan::Set(result, Nan::New("DRAW_BUFFER11_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER11_EXT));
+  Nan::Set(result, Nan::New("DRAW_BUFFER12_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER12_EXT));
+  Nan::Set(result, Nan::New("DRAW_BUFFER13_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER13_EXT));
+  Nan::Set(result, Nan::New("DRAW_BUFFER14_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER14_EXT));
+  Nan::Set(result, Nan::New("DRAW_BUFFER15_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER15_EXT));
 
-  delete[] name;
+  Nan::Set(result, Nan::New("MAX_COLOR_ATTACHMENTS_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_MAX_COLOR_ATTACHMENTS_EXT));
+  Nan::Set(result, Nan::New("MAX_DRAW_BUFFERS_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_MAX_DRAW_BUFFERS_EXT));
+
+  info.GetReturnValue().Set(result);
 }
 
-GL_METHOD(GetAttachedShaders) {
+GL_METHOD(BindVertexArrayOES) {
   GL_BOILERPLATE;
 
-  GLuint program = Nan::To<int32_t>(info[0]).ToChecked();
-
-  GLint numAttachedShaders;
-  (inst->glGetProgramiv)(program, GL_ATTACHED_SHADERS, &numAttachedShaders);
+  GLuint array = Nan::To<uint32_t>(info[0]).ToChecked();
 
-  GLuint* shaders = new GLuint[numAttachedShaders];
-  GLsizei count;
-  (inst->glGetAttachedShaders)(program, numAttachedShaders, &count, shaders);
+  (inst->glBindVertexArrayOES)(array);
+}
 
-  v8::Local<v8::Array> shadersArr = Nan::New<v8::Array>(count);
-  for (int i=0; i<count; i++) {
-    Nan::Set(shadersArr, i, Nan::New<v8::Integer>((int)shaders[i]));
-  }
+GL_METHOD(CreateVertexArrayOES) {
+  GL_BOILERPLATE;
 
-  info.GetReturnValue().Set(shadersArr);
+  GLuint array = 0;
+  (inst->glGenVertexArraysOES)(1, &array);
+  inst->registerGLObj(GLOBJECT_TYPE_VERTEX_ARRAY, array);
 
-  delete[] shaders;
+  info.GetReturnValue().Set(Nan::New<v8::Integer>(array));
 }
 
-GL_METHOD(GetParameter) {
+GL_METHOD(DeleteVertexArrayOES) {
   GL_BOILERPLATE;
-  GLenum name = Nan::To<int32_t>(info[0]).ToChecked();
 
-  switch(name) {
-    case 0x9240 /* UNPACK_FLIP_Y_WEBGL */:
-      info.GetReturnValue().Set(
-        Nan::New<v8::Boolean>(inst->unpack_flip_y));
-    return;
+  GLuint array = Nan::To<uint32_t>(info[0]).ToChecked();
+  inst->unregisterGLObj(GLOBJECT_TYPE_VERTEX_ARRAY, array);
 
-    case 0x9241 /* UNPACK_PREMULTIPLY_ALPHA_WEBGL*/:
-      info.GetReturnValue().Set(
-        Nan::New<v8::Boolean>(inst->unpack_premultiply_alpha));
-    return;
+  (inst->glDeleteVertexArraysOES)(1, &array);
+}
 
-    case 0x9243 /* UNPACK_COLORSPACE_CONVERSION_WEBGL */:
-      info.GetReturnValue().Set(
-        Nan::New<v8::Integer>(inst->unpack_colorspace_conversion));
-    return;
+GL_METHOD(IsVertexArrayOES) {
+  GL_BOILERPLATE;
 
-    case GL_BLEND:
-    case GL_CULL_FACE:
-    case GL_DEPTH_TEST:
-    case GL_DEPTH_WRITEMASK:
-    case GL_DITHER:
-    case GL_POLYGON_OFFSET_FILL:
-    case GL_SAMPLE_COVERAGE_INVERT:
-    case GL_SCISSOR_TEST:
-    case GL_STENCIL_TEST:
-    {
-      GLboolean params;
-      (inst->glGetBooleanv)(name, &params);
+  info.GetReturnValue().Set(Nan::New<v8::Boolean>(
+    (inst->glIsVertexArrayOES)(Nan::To<uint32_t>(info[0]).ToChecked()) != 0));
+}
 
-      info.GetReturnValue().Set(Nan::New<v8::Boolean>(params != 0));
+GL_METHOD(BindBufferBase) {
+  GL_BOILERPLATE;
 
-      return;
-    }
+  GLenum target = Nan::To<int32_t>(info[0]).ToChecked();
+  GLuint index  = Nan::To<uint32_t>(info[1]).ToChecked();
+  GLuint buffer = Nan::To<uint32_t>(info[2]).ToChecked();
 
-    case GL_DEPTH_CLEAR_VALUE:
-    case GL_LINE_WIDTH:
-    case GL_POLYGON_OFFSET_FACTOR:
-    case GL_POLYGON_OFFSET_UNITS:
-    case GL_SAMPLE_COVERAGE_VALUE:
-    case GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT:
-    {
-      GLfloat params;
-      (inst->glGetFloatv)(name, &params);
+  (inst->glBindBufferBase)(target, index, buffer);
+}
 
-      info.GetReturnValue().Set(Nan::New<v8::Number>(params));
+GL_METHOD(BindBufferRange) {
+  GL_BOILERPLATE;
 
-      return;
-    }
+  GLenum target    = Nan::To<int32_t>(info[0]).ToChecked();
+  GLuint index     = Nan::To<uint32_t>(info[1]).ToChecked();
+  GLuint buffer    = Nan::To<uint32_t>(info[2]).ToChecked();
+  GLintptr offset  = Nan::To<int64_t>(info[3]).ToChecked();
+  GLsizeiptr size  = Nan::To<int64_t>(info[4]).ToChecked();
 
-    case GL_RENDERER:
-    case GL_SHADING_LANGUAGE_VERSION:
-    case GL_VENDOR:
-    case GL_VERSION:
-    case GL_EXTENSIONS:
-    {
-      const char *params = reinterpret_cast<const char*>((inst->glGetString)(name));
-      if(params) {
-        info.GetReturnValue().Set(
-          Nan::New<v8::String>(params).ToLocalChecked());
-      }
-      return;
-    }
+  (inst->glBindBufferRange)(target, index, buffer, offset, size);
+}
 
-    case GL_MAX_VIEWPORT_DIMS:
-    {
-      GLint params[2];
-      (inst->glGetIntegerv)(name, params);
+GL_METHOD(GetUniformBlockIndex) {
+  GL_BOILERPLATE;
 
-      v8::Local<v8::Array> arr = Nan::New<v8::Array>(2);
-      Nan::Set(arr, 0, Nan::New<v8::Integer>(params[0]));
-      Nan::Set(arr, 1, Nan::New<v8::Integer>(params[1]));
-      info.GetReturnValue().Set(arr);
+  GLuint program = Nan::To<uint32_t>(info[0]).ToChecked();
+  Nan::Utf8String name(info[1]);
 
-      return;
-    }
+  GLuint index = (inst->glGetUniformBlockIndex)(program, *name);
 
-    case GL_SCISSOR_BOX:
-    case GL_VIEWPORT:
-    {
-      GLint params[4];
-      (inst->glGetIntegerv)(name, params);
+  info.GetReturnValue().Set(Nan::New<v8::Uint32>(index));
+}
 
-      v8::Local<v8::Array> arr=Nan::New<v8::Array>(4);
-      Nan::Set(arr, 0, Nan::New<v8::Integer>(params[0]));
-      Nan::Set(arr, 1, Nan::New<v8::Integer>(params[1]));
-      Nan::Set(arr, 2, Nan::New<v8::Integer>(params[2]));
-      Nan::Set(arr, 3, Nan::New<v8::Integer>(params[3]));
-      info.GetReturnValue().Set(arr);
+GL_METHOD(UniformBlockBinding) {
+  GL_BOILERPLATE;
 
-      return;
-    }
+  GLuint program = Nan::To<uint32_t>(info[0]).ToChecked();
+  GLuint index   = Nan::To<uint32_t>(info[1]).ToChecked();
+  GLuint binding = Nan::To<uint32_t>(info[2]).ToChecked();
 
-    case GL_ALIASED_LINE_WIDTH_RANGE:
-    case GL_ALIASED_POINT_SIZE_RANGE:
-    case GL_DEPTH_RANGE:
-    {
-      GLfloat params[2];
-      (inst->glGetFloatv)(name, params);
+  (inst->glUniformBlockBinding)(program, index, binding);
+}
 
-      v8::Local<v8::Array> arr=Nan::New<v8::Array>(2);
-      Nan::Set(arr, 0, Nan::New<v8::Number>(params[0]));
-      Nan::Set(arr, 1, Nan::New<v8::Number>(params[1]));
-      info.GetReturnValue().Set(arr);
+GL_METHOD(GetActiveUniformBlockParameter) {
+  GL_BOILERPLATE;
 
-      return;
-    }
+  GLuint program = Nan::To<uint32_t>(info[0]).ToChecked();
+  GLuint index   = Nan::To<uint32_t>(info[1]).ToChecked();
+  GLenum pname   = Nan::To<int32_t>(info[2]).ToChecked();
 
-    case GL_BLEND_COLOR:
-    case GL_COLOR_CLEAR_VALUE:
+  switch (pname) {
+    case GL_UNIFORM_BLOCK_REFERENCED_BY_VERTEX_SHADER:
+    case GL_UNIFORM_BLOCK_REFERENCED_BY_FRAGMENT_SHADER:
     {
-      GLfloat params[4];
-      (inst->glGetFloatv)(name, params);
-
-      v8::Local<v8::Array> arr = Nan::New<v8::Array>(4);
-      Nan::Set(arr, 0, Nan::New<v8::Number>(params[0]));
-      Nan::Set(arr, 1, Nan::New<v8::Number>(params[1]));
-      Nan::Set(arr, 2, Nan::New<v8::Number>(params[2]));
-      Nan::Set(arr, 3, Nan::New<v8::Number>(params[3]));
-      info.GetReturnValue().Set(arr);
-
+      GLint value = 0;
+      (inst->glGetActiveUniformBlockiv)(program, index, pname, &value);
+      info.GetReturnValue().Set(Nan::New<v8::Boolean>(value != 0));
       return;
     }
 
-    case GL_COLOR_WRITEMASK:
+    case GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES:
     {
-      GLboolean params[4];
-      (inst->glGetBooleanv)(name, params);
+      GLint count = 0;
+      (inst->glGetActiveUniformBlockiv)(
+        program, index, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &count);
+      std::vector<GLint> indices(std::max(count, 0));
+      if (count > 0) {
+        (inst->glGetActiveUniformBlockiv)(program, index, pname, indices.data());
+      }
 
-      v8::Local<v8::Array> arr = Nan::New<v8::Array>(4);
-      Nan::Set(arr, 0, Nan::New<v8::Boolean>(params[0] == GL_TRUE));
-      Nan::Set(arr, 1, Nan::New<v8::Boolean>(params[1] == GL_TRUE));
-      Nan::Set(arr, 2, Nan::New<v8::Boolean>(params[2] == GL_TRUE));
-      Nan::Set(arr, 3, Nan::New<v8::Boolean>(params[3] == GL_TRUE));
+      v8::Local<v8::Array> arr = Nan::New<v8::Array>(indices.size());
+      for (size_t i = 0; i < indices.size(); ++i) {
+        Nan::Set(arr, i, Nan::New<v8::Uint32>(static_cast<uint32_t>(indices[i])));
+      }
       info.GetReturnValue().Set(arr);
-
       return;
     }
 
     default:
     {
-      GLint params;
-      (inst->glGetIntegerv)(name, &params);
-      info.GetReturnValue().Set(Nan::New<v8::Integer>(params));
+      GLint value = 0;
+      (inst->glGetActiveUniformBlockiv)(program, index, pname, &value);
+      info.GetReturnValue().Set(Nan::New<v8::Integer>(value));
       return;
     }
   }
 }
 
-GL_METHOD(GetBufferParameter) {
+GL_METHOD(GetActiveUniformBlockName) {
   GL_BOILERPLATE;
 
-  GLenum target = Nan::To<int32_t>(info[0]).ToChecked();
-  GLenum pname  = Nan::To<int32_t>(info[1]).ToChecked();
+  GLuint program = Nan::To<uint32_t>(info[0]).ToChecked();
+  GLuint index   = Nan::To<uint32_t>(info[1]).ToChecked();
 
-  GLint params;
-  (inst->glGetBufferParameteriv)(target, pname, &params);
+  GLint length = 0;
+  (inst->glGetActiveUniformBlockiv)(
+    program, index, GL_UNIFORM_BLOCK_NAME_LENGTH, &length);
+  if (length <= 0) {
+    info.GetReturnValue().SetNull();
+    return;
+  }
 
-  info.GetReturnValue().Set(Nan::New<v8::Integer>(params));
+  std::vector<GLchar> name(length);
+  (inst->glGetActiveUniformBlockName)(program, index, length, NULL, name.data());
+
+  info.GetReturnValue().Set(
+    Nan::New<v8::String>(name.data()).ToLocalChecked());
 }
 
-GL_METHOD(GetFramebufferAttachmentParameter) {
+// Copies a range of the buffer bound to target into a typed array by
+// mapping it for reading.
+GL_METHOD(GetBufferSubData) {
   GL_BOILERPLATE;
 
-  GLenum target     = Nan::To<int32_t>(info[0]).ToChecked();
-  GLenum attachment = Nan::To<int32_t>(info[1]).ToChecked();
-  GLenum pname      = Nan::To<int32_t>(info[2]).ToChecked();
+  GLenum target   = Nan::To<int32_t>(info[0]).ToChecked();
+  GLintptr offset = Nan::To<int64_t>(info[1]).ToChecked();
+  Nan::TypedArrayContents<unsigned char> data(info[2]);
 
-  GLint params;
-  (inst->glGetFramebufferAttachmentParameteriv)(target, attachment, pname, &params);
+  if (data.length() == 0) {
+    return;
+  }
 
-  info.GetReturnValue().Set(Nan::New<v8::Integer>(params));
+  void* mapped = (inst->glMapBufferRange)(
+    target, offset, data.length(), GL_MAP_READ_BIT);
+  if (!mapped) {
+    return;
+  }
+  memcpy(*data, mapped, data.length());
+  (inst->glUnmapBuffer)(target);
 }
 
-GL_METHOD(GetProgramInfoLog) {
+GL_METHOD(TexImage3D) {
   GL_BOILERPLATE;
 
-  GLuint program = Nan::To<int32_t>(info[0]).ToChecked();
-
-  GLint infoLogLength;
-  (inst->glGetProgramiv)(program, GL_INFO_LOG_LENGTH, &infoLogLength);
-
-  char* error = new char[infoLogLength+1];
-  (inst->glGetProgramInfoLog)(program, infoLogLength+1, &infoLogLength, error);
-
-  info.GetReturnValue().Set(
-    Nan::New<v8::String>(error).ToLocalChecked());
+  GLenum target         = Nan::To<int32_t>(info[0]).ToChecked();
+  GLint level           = Nan::To<int32_t>(info[1]).ToChecked();
+  GLint internalformat  = Nan::To<int32_t>(info[2]).ToChecked();
+  GLsizei width         = Nan::To<int32_t>(info[3]).ToChecked();
+  GLsizei height        = Nan::To<int32_t>(info[4]).ToChecked();
+  GLsizei depth         = Nan::To<int32_t>(info[5]).ToChecked();
+  GLint border          = Nan::To<int32_t>(info[6]).ToChecked();
+  GLenum format         = Nan::To<int32_t>(info[7]).ToChecked();
+  GLenum type           = Nan::To<int32_t>(info[8]).ToChecked();
+
+  WebGLRenderingContext::ImageMemory image =
+    { width, height, depth, pixelBytes(internalformat, type) };
+  if (!inst->allocTextureImage(target, level, image)) {
+    return;
+  }
 
-  delete[] error;
+  //Offset into the bound PIXEL_UNPACK_BUFFER
+  if (info[9]->IsNumber()) {
+    (inst->glTexImage3D)(
+      target, level, internalformat, width, height, depth, border,
+      format, type,
+      reinterpret_cast<void*>(static_cast<intptr_t>(
+        Nan::To<int64_t>(info[9]).ToChecked())));
+  } else {
+    Nan::TypedArrayContents<unsigned char> pixels(info[9]);
+    inst->countUpload(pixels.length());
+    (inst->glTexImage3D)(
+      target, level, internalformat, width, height, depth, border,
+      format, type, *pixels);
+  }
+  inst->commitTextureImage(target, level, image);
 }
 
-GL_METHOD(GetShaderPrecisionFormat) {
+GL_METHOD(TexSubImage3D) {
   GL_BOILERPLATE;
 
-  GLenum shaderType    = Nan::To<int32_t>(info[0]).ToChecked();
-  GLenum precisionType = Nan::To<int32_t>(info[1]).ToChecked();
-
-  GLint range[2];
-  GLint precision;
-
-  (inst->glGetShaderPrecisionFormat)(shaderType, precisionType, range, &precision);
-
-  v8::Local<v8::Object> result = Nan::New<v8::Object>();
-  Nan::Set(result
-    , Nan::New<v8::String>("rangeMin").ToLocalChecked()
-    , Nan::New<v8::Integer>(range[0]));
-  Nan::Set(result
-    , Nan::New<v8::String>("rangeMax").ToLocalChecked()
-    , Nan::New<v8::Integer>(range[1]));
-  Nan::Set(result
-    , Nan::New<v8::String>("precision").ToLocalChecked()
-    , Nan::New<v8::Integer>(precision));
+  GLenum target   = Nan::To<int32_t>(info[0]).ToChecked();
+  GLint level     = Nan::To<int32_t>(info[1]).ToChecked();
+  GLint xoffset   = Nan::To<int32_t>(info[2]).ToChecked();
+  GLint yoffset   = Nan::To<int32_t>(info[3]).ToChecked();
+  GLint zoffset   = Nan::To<int32_t>(info[4]).ToChecked();
+  GLsizei width   = Nan::To<int32_t>(info[5]).ToChecked();
+  GLsizei height  = Nan::To<int32_t>(info[6]).ToChecked();
+  GLsizei depth   = Nan::To<int32_t>(info[7]).ToChecked();
+  GLenum format   = Nan::To<int32_t>(info[8]).ToChecked();
+  GLenum type     = Nan::To<int32_t>(info[9]).ToChecked();
+
+  //Offset into the bound PIXEL_UNPACK_BUFFER
+  if (info[10]->IsNumber()) {
+    (inst->glTexSubImage3D)(
+      target, level, xoffset, yoffset, zoffset, width, height, depth,
+      format, type,
+      reinterpret_cast<void*>(static_cast<intptr_t>(
+        Nan::To<int64_t>(info[10]).ToChecked())));
+    return;
+  }
 
-  info.GetReturnValue().Set(result);
+  Nan::TypedArrayContents<unsigned char> pixels(info[10]);
+  inst->countUpload(pixels.length());
+  (inst->glTexSubImage3D)(
+    target, level, xoffset, yoffset, zoffset, width, height, depth,
+    format, type, *pixels);
+}
+
+//Number of 32-bit words in one element of a uniform
+static size_t uniformWords(GLenum type) {
+  switch (type) {
+    case GL_FLOAT_MAT4: return 16;
+    case GL_FLOAT_MAT3: return 9;
+    case GL_FLOAT_MAT2:
+    case GL_FLOAT_VEC4:
+    case GL_INT_VEC4:
+    case GL_BOOL_VEC4: return 4;
+    case GL_FLOAT_VEC3:
+    case GL_INT_VEC3:
+    case GL_BOOL_VEC3: return 3;
+    case GL_FLOAT_VEC2:
+    case GL_INT_VEC2:
+    case GL_BOOL_VEC2: return 2;
+  }
+  return 1;
+}
+
+//Uploads count elements of a uniform, reading floats or ints from value
+static bool uploadUniform(
+    WebGLRenderingContext* inst,
+    GLenum type,
+    GLint location,
+    GLsizei count,
+    const GLint* value) {
+  const GLfloat* fvalue = reinterpret_cast<const GLfloat*>(value);
+  switch (type) {
+    case GL_FLOAT:
+      (inst->glUniform1fv)(location, count, fvalue);
+      return true;
+    case GL_FLOAT_VEC2:
+      (inst->glUniform2fv)(location, count, fvalue);
+      return true;
+    case GL_FLOAT_VEC3:
+      (inst->glUniform3fv)(location, count, fvalue);
+      return true;
+    case GL_FLOAT_VEC4:
+      (inst->glUniform4fv)(location, count, fvalue);
+      return true;
+    case GL_FLOAT_MAT2:
+      (inst->glUniformMatrix2fv)(location, count, GL_FALSE, fvalue);
+      return true;
+    case GL_FLOAT_MAT3:
+      (inst->glUniformMatrix3fv)(location, count, GL_FALSE, fvalue);
+      return true;
+    case GL_FLOAT_MAT4:
+      (inst->glUniformMatrix4fv)(location, count, GL_FALSE, fvalue);
+      return true;
+    case GL_INT:
+    case GL_BOOL:
+    case GL_SAMPLER_2D:
+    case GL_SAMPLER_CUBE:
+      (inst->glUniform1iv)(location, count, value);
+      return true;
+    case GL_INT_VEC2:
+    case GL_BOOL_VEC2:
+      (inst->glUniform2iv)(location, count, value);
+      return true;
+    case GL_INT_VEC3:
+    case GL_BOOL_VEC3:
+      (inst->glUniform3iv)(location, count, value);
+      return true;
+    case GL_INT_VEC4:
+    case GL_BOOL_VEC4:
+      (inst->glUniform4iv)(location, count, value);
+      return true;
+  }
+  return false;
 }
 
-GL_METHOD(GetRenderbufferParameter) {
+GL_METHOD(UniformBlock) {
   GL_BOILERPLATE;
 
-  GLenum target = Nan::To<int32_t>(info[0]).ToChecked();
-  GLenum pname  = Nan::To<int32_t>(info[1]).ToChecked();
-
-  int value;
-  (inst->glGetRenderbufferParameteriv)(target, pname, &value);
+  //Each entry is [location, type, offset, count], offsets in 32-bit words
+  Nan::TypedArrayContents<GLint> table(info[0]);
+  Nan::TypedArrayContents<GLint> data(info[1]);
+  GLint* values = *data;
+  GLint* shadow = NULL;
+  Nan::TypedArrayContents<GLint> shadowData(info[2]);
+  if (info[2]->IsArrayBufferView()) {
+    shadow = *shadowData;
+  }
+  //Until the shadow holds a full upload, it is only filled
+  bool compare = Nan::To<bool>(info[3]).ToChecked();
+
+  int uploaded = 0;
+  for (size_t i = 0; i + 3 < table.length(); i += 4) {
+    GLint location = (*table)[i];
+    GLenum type    = (*table)[i + 1];
+    GLint offset   = (*table)[i + 2];
+    GLsizei count  = (*table)[i + 3];
+    GLint* value   = values + offset;
+
+    //Skip uniforms whose words match the last uploaded copy
+    if (shadow) {
+      size_t size = uniformWords(type) * count * sizeof(GLint);
+      if (compare && memcmp(shadow + offset, value, size) == 0) {
+        continue;
+      }
+      memcpy(shadow + offset, value, size);
+    }
 
-  info.GetReturnValue().Set(Nan::New<v8::Integer>(value));
-}
+    if (uploadUniform(inst, type, location, count, value)) {
+      ++uploaded;
+    }
+  }
 
-GL_METHOD(GetUniform) {
-  GL_BOILERPLATE;
+  info.GetReturnValue().Set(Nan::New<v8::Integer>(uploaded));
+}
+
+//Opcodes of a recorded command bundle, see stackgl-command-bundle.js
+enum CommandBundleOp {
+  BUNDLE_USE_PROGRAM = 1,
+  BUNDLE_BIND_VERTEX_ARRAY,
+  BUNDLE_ACTIVE_TEXTURE,
+  BUNDLE_BIND_TEXTURE,
+  BUNDLE_UNIFORM,
+  BUNDLE_UNIFORM_OVERRIDE,
+  BUNDLE_DRAW_ARRAYS,
+  BUNDLE_DRAW_ELEMENTS,
+  BUNDLE_DRAW_ARRAYS_INSTANCED,
+  BUNDLE_DRAW_ELEMENTS_INSTANCED
+};
 
-  GLint program  = Nan::To<int32_t>(info[0]).ToChecked();
-  GLint location = Nan::To<int32_t>(info[1]).ToChecked();
+GL_METHOD(CreateCommandBundle) {
+  GL_BOILERPLATE;
 
-  float data[16];
-  (inst->glGetUniformfv)(program, location, data);
+  Nan::TypedArrayContents<GLint> commands(info[0]);
 
-  v8::Local<v8::Array> arr = Nan::New<v8::Array>(16);
-  for (int i=0; i<16; i++) {
-    Nan::Set(arr, i, Nan::New<v8::Number>(data[i]));
-  }
+  GLuint id = inst->nextCommandBundle++;
+  inst->commandBundles[id].assign(*commands, *commands + commands.length());
 
-  info.GetReturnValue().Set(arr);
+  info.GetReturnValue().Set(Nan::New<v8::Integer>(id));
 }
 
-GL_METHOD(GetVertexAttrib) {
+GL_METHOD(DeleteCommandBundle) {
   GL_BOILERPLATE;
 
-  GLint index  = Nan::To<int32_t>(info[0]).ToChecked();
-  GLenum pname = Nan::To<int32_t>(info[1]).ToChecked();
+  inst->commandBundles.erase(Nan::To<uint32_t>(info[0]).ToChecked());
+}
 
-  GLint value;
+GL_METHOD(ExecuteCommandBundle) {
+  GL_BOILERPLATE;
 
-  switch (pname) {
-    case GL_VERTEX_ATTRIB_ARRAY_ENABLED:
-    case GL_VERTEX_ATTRIB_ARRAY_NORMALIZED:
-    {
-      (inst->glGetVertexAttribiv)(index, pname, &value);
-      info.GetReturnValue().Set(Nan::New<v8::Boolean>(value != 0));
-      return;
-    }
+  std::map<GLuint, std::vector<GLint> >::iterator it =
+    inst->commandBundles.find(Nan::To<uint32_t>(info[0]).ToChecked());
+  if (it == inst->commandBundles.end()) {
+    inst->setError(GL_INVALID_OPERATION);
+    return;
+  }
 
-    case GL_VERTEX_ATTRIB_ARRAY_SIZE:
-    case GL_VERTEX_ATTRIB_ARRAY_STRIDE:
-    case GL_VERTEX_ATTRIB_ARRAY_TYPE:
-    {
-      (inst->glGetVertexAttribiv)(index, pname, &value);
-      info.GetReturnValue().Set(Nan::New<v8::Integer>(value));
-      return;
+  //Uniform values supplied for this execution
+  Nan::TypedArrayContents<GLint> overrides(info[1]);
+
+  //Bindings to put back afterwards: program, vertex array, active texture,
+  //then a [unit, target, texture] triple for each texture the bundle binds
+  Nan::TypedArrayContents<GLint> restore(info[2]);
+
+  const std::vector<GLint>& commands = it->second;
+  const GLint* cmd = commands.data();
+  const GLint* end = cmd + commands.size();
+  while (cmd < end) {
+    switch (*cmd++) {
+      case BUNDLE_USE_PROGRAM:
+        (inst->glUseProgram)(cmd[0]);
+        cmd += 1;
+        break;
+      case BUNDLE_BIND_VERTEX_ARRAY:
+        (inst->glBindVertexArrayOES)(cmd[0]);
+        cmd += 1;
+        break;
+      case BUNDLE_ACTIVE_TEXTURE:
+        (inst->glActiveTexture)(cmd[0]);
+        cmd += 1;
+        break;
+      case BUNDLE_BIND_TEXTURE:
+        (inst->glBindTexture)(cmd[0], cmd[1]);
+        cmd += 2;
+        break;
+      case BUNDLE_UNIFORM:
+        //[type, location, count, values...]
+        uploadUniform(inst, cmd[0], cmd[1], cmd[2], cmd + 3);
+        cmd += 3 + uniformWords(cmd[0]) * cmd[2];
+        break;
+      case BUNDLE_UNIFORM_OVERRIDE:
+        //[type, location, count, offset into overrides]
+        uploadUniform(inst, cmd[0], cmd[1], cmd[2], *overrides + cmd[3]);
+        cmd += 4;
+        break;
+      case BUNDLE_DRAW_ARRAYS:
+        (inst->glDrawArrays)(cmd[0], cmd[1], cmd[2]);
+        cmd += 3;
+        inst->countDraws(1);
+        break;
+      case BUNDLE_DRAW_ELEMENTS:
+        (inst->glDrawElements)(cmd[0], cmd[1], cmd[2],
+          reinterpret_cast<GLvoid*>(static_cast<intptr_t>(cmd[3])));
+        cmd += 4;
+        inst->countDraws(1);
+        break;
+      case BUNDLE_DRAW_ARRAYS_INSTANCED:
+        (inst->glDrawArraysInstanced)(cmd[0], cmd[1], cmd[2], cmd[3]);
+        cmd += 4;
+        inst->countDraws(1);
+        break;
+      case BUNDLE_DRAW_ELEMENTS_INSTANCED:
+        (inst->glDrawElementsInstanced)(cmd[0], cmd[1], cmd[2],
+          reinterpret_cast<GLvoid*>(static_cast<intptr_t>(cmd[3])), cmd[4]);
+        cmd += 5;
+        inst->countDraws(1);
+        break;
+      default:
+        //Bundles are encoded by the extension, so this is never reached
+        cmd = end;
+        break;
     }
+  }
 
-    case GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING:
-    {
-      (inst->glGetVertexAttribiv)(index, pname, &value);
-      info.GetReturnValue().Set(Nan::New<v8::Integer>(value));
-      return;
+  if (restore.length() >= 3) {
+    const GLint* state = *restore;
+    for (size_t i = 3; i + 2 < restore.length(); i += 3) {
+      (inst->glActiveTexture)(state[i]);
+      (inst->glBindTexture)(state[i + 1], state[i + 2]);
     }
+    (inst->glUseProgram)(state[0]);
+    (inst->glBindVertexArrayOES)(state[1]);
+    (inst->glActiveTexture)(state[2]);
+  }
+  inst->forgetTextureBindings();
+}
 
-    case GL_CURRENT_VERTEX_ATTRIB:
-    {
-      float vextex_attribs[4];
-
-      (inst->glGetVertexAttribfv)(index, pname, vextex_attribs);
 
-      v8::Local<v8::Array> arr=Nan::New<v8::Array>(4);
-      Nan::Set(arr, 0,
-        Nan::New<v8::Number>(vextex_attribs[0]));
-      Nan::Set(arr, 1,
-        Nan::New<v8::Number>(vextex_attribs[1]));
-      Nan::Set(arr, 2,
-        Nan::New<v8::Number>(vextex_attribs[2]));
-      Nan::Set(arr, 3,
-        Nan::New<v8::Number>(vextex_attribs[3]));
-      info.GetReturnValue().Set(arr);
+bool WebGLRenderingContext::checkBudget(uint64_t oldBytes, uint64_t newBytes) {
+  if (memory.budget &&
+      newBytes > oldBytes &&
+      memoryUsed() - oldBytes + newBytes > memory.budget) {
+    setError(GL_OUT_OF_MEMORY);
+    return false;
+  }
+  return true;
+}
 
-      return;
+void WebGLRenderingContext::holdErrors() {
+  for (GLenum error = (glGetError)(); error != GL_NO_ERROR; error = (glGetError)()) {
+    if (lastError == GL_NO_ERROR) {
+      lastError = error;
     }
+  }
+}
 
-    default:
-      inst->setError(GL_INVALID_ENUM);
+bool WebGLRenderingContext::callFailed() {
+  GLenum error = (glGetError)();
+  if (error == GL_NO_ERROR) {
+    return false;
+  }
+  if (lastError == GL_NO_ERROR) {
+    lastError = error;
   }
+  return true;
+}
 
-  info.GetReturnValue().SetNull();
+GLuint WebGLRenderingContext::boundTexture(GLenum target) {
+  int slot = textureBindingSlot(target);
+  if (textureBindings[slot] < 0) {
+    static const GLenum BINDINGS[] = {
+      GL_TEXTURE_BINDING_2D,
+      GL_TEXTURE_BINDING_CUBE_MAP,
+      GL_TEXTURE_BINDING_3D,
+      GL_TEXTURE_BINDING_2D_ARRAY
+    };
+    (glGetIntegerv)(BINDINGS[slot], &textureBindings[slot]);
+  }
+  return static_cast<GLuint>(textureBindings[slot]);
 }
 
-GL_METHOD(GetSupportedExtensions) {
-  GL_BOILERPLATE;
+void WebGLRenderingContext::forgetTextureBindings() {
+  for (size_t i = 0; i < sizeof(textureBindings) / sizeof(textureBindings[0]); ++i) {
+    textureBindings[i] = -1;
+  }
+}
 
-  const char *extensions = reinterpret_cast<const char*>(
-    (inst->glGetString)(GL_EXTENSIONS));
+bool WebGLRenderingContext::allocTextureImage(
+    GLenum target,
+    GLint level,
+    const ImageMemory& image) {
+  holdErrors();
+  GLuint texture = boundTexture(target);
+  if (!hasGLObj(GLOBJECT_TYPE_TEXTURE, texture)) {
+    //GL reports the error
+    return true;
+  }
 
-  info.GetReturnValue().Set(
-    Nan::New<v8::String>(extensions).ToLocalChecked());
+  std::map<GLuint, std::map<std::pair<GLenum, GLint>, ImageMemory> >::iterator
+    images = textureImages.find(texture);
+  uint64_t oldBytes = 0;
+  if (images != textureImages.end()) {
+    std::map<std::pair<GLenum, GLint>, ImageMemory>::iterator it =
+      images->second.find(std::make_pair(target, level));
+    if (it != images->second.end()) {
+      oldBytes = it->second.bytes();
+    }
+  }
+  return checkBudget(oldBytes, image.bytes());
 }
 
-GL_METHOD(GetExtension) {
-  GL_BOILERPLATE;
+void WebGLRenderingContext::commitTextureImage(
+    GLenum target,
+    GLint level,
+    const ImageMemory& image) {
+  if (callFailed()) {
+    return;
+  }
+  GLuint texture = boundTexture(target);
+  if (!hasGLObj(GLOBJECT_TYPE_TEXTURE, texture)) {
+    return;
+  }
 
-  //TODO
+  ImageMemory& stored = textureImages[texture][std::make_pair(target, level)];
+  memory.textures += image.bytes() - stored.bytes();
+  stored = image;
+}
+
+//The levels generateMipmap creates below level 0 of each face, and the
+//bytes of the levels they replace
+typedef std::map<std::pair<GLenum, GLint>, WebGLRenderingContext::ImageMemory>
+  ImageMemoryMap;
+
+static uint64_t mipmapImages(
+    const ImageMemoryMap& images,
+    GLenum target,
+    ImageMemoryMap& mipmaps,
+    uint64_t& oldBytes) {
+  uint64_t newBytes = 0;
+  oldBytes = 0;
+  ImageMemoryMap::const_iterator it;
+  for (it = images.begin(); it != images.end(); ++it) {
+    if (it->first.second != 0) {
+      oldBytes += it->second.bytes();
+      continue;
+    }
+    WebGLRenderingContext::ImageMemory image = it->second;
+    for (GLint level = 1;
+        image.width > 1 || image.height > 1 ||
+          (target == GL_TEXTURE_3D && image.depth > 1);
+        ++level) {
+      image.width = std::max(1, image.width >> 1);
+      image.height = std::max(1, image.height >> 1);
+      if (target == GL_TEXTURE_3D) {
+        image.depth = std::max(1, image.depth >> 1);
+      }
+      mipmaps[std::make_pair(it->first.first, level)] = image;
+      newBytes += image.bytes();
+    }
+  }
+  return newBytes;
 }
 
-GL_METHOD(CheckFramebufferStatus) {
-  GL_BOILERPLATE;
-
-  GLenum target = Nan::To<int32_t>(info[0]).ToChecked();
+bool WebGLRenderingContext::allocMipmaps(GLenum target) {
+  holdErrors();
+  GLuint texture = boundTexture(target);
+  std::map<GLuint, std::map<std::pair<GLenum, GLint>, ImageMemory> >::iterator
+    images = textureImages.find(texture);
+  if (!hasGLObj(GLOBJECT_TYPE_TEXTURE, texture) || images == textureImages.end()) {
+    return true;
+  }
 
-  info.GetReturnValue().Set(
-    Nan::New<v8::Integer>(
-      static_cast<int>((inst->glCheckFramebufferStatus)(target))));
+  std::map<std::pair<GLenum, GLint>, ImageMemory> mipmaps;
+  uint64_t oldBytes;
+  uint64_t newBytes = mipmapImages(images->second, target, mipmaps, oldBytes);
+  return checkBudget(oldBytes, newBytes);
 }
 
-GL_METHOD(DrawBuffersWEBGL) {
-  GL_BOILERPLATE;
-
-  v8::Local<v8::Array> buffersArray = v8::Local<v8::Array>::Cast(info[0]);
-  GLuint numBuffers = buffersArray->Length();
-  GLenum* buffers = new GLenum[numBuffers];
+void WebGLRenderingContext::commitMipmaps(GLenum target) {
+  if (callFailed()) {
+    return;
+  }
+  GLuint texture = boundTexture(target);
+  std::map<GLuint, std::map<std::pair<GLenum, GLint>, ImageMemory> >::iterator
+    images = textureImages.find(texture);
+  if (!hasGLObj(GLOBJECT_TYPE_TEXTURE, texture) || images == textureImages.end()) {
+    return;
+  }
 
-  for (GLuint i = 0; i < numBuffers; i++) {
-    buffers[i] = Nan::Get(buffersArray, i).ToLocalChecked()->Uint32Value(Nan::GetCurrentContext()).ToChecked();
+  std::map<std::pair<GLenum, GLint>, ImageMemory> mipmaps;
+  uint64_t oldBytes;
+  uint64_t newBytes = mipmapImages(images->second, target, mipmaps, oldBytes);
+  std::map<std::pair<GLenum, GLint>, ImageMemory>::iterator it;
+  for (it = images->second.begin(); it != images->second.end();) {
+    if (it->first.second != 0) {
+      images->second.erase(it++);
+    } else {
+      ++it;
+    }
   }
+  images->second.insert(mipmaps.begin(), mipmaps.end());
+  memory.textures += newBytes - oldBytes;
+}
 
-  (inst->glDrawBuffersEXT)(numBuffers, buffers);
+bool WebGLRenderingContext::allocRenderbuffer(uint64_t bytes) {
+  holdErrors();
+  GLint renderbuffer = 0;
+  (glGetIntegerv)(GL_RENDERBUFFER_BINDING, &renderbuffer);
+  if (!hasGLObj(GLOBJECT_TYPE_RENDERBUFFER, renderbuffer)) {
+    return true;
+  }
 
-  delete[] buffers;
+  std::map<GLuint, uint64_t>::iterator it = renderbufferBytes.find(renderbuffer);
+  return checkBudget(it == renderbufferBytes.end() ? 0 : it->second, bytes);
 }
 
-GL_METHOD(EXTWEBGL_draw_buffers) {
-  v8::Local<v8::Object> result = Nan::New<v8::Object>();
-  Nan::Set(result, Nan::New("COLOR_ATTACHMENT0_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT0_EXT));
-  Nan::Set(result, Nan::New("COLOR_ATTACHMENT1_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT1_EXT));
-  Nan::Set(result, Nan::New("COLOR_ATTACHMENT2_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT2_EXT));
-  Nan::Set(result, Nan::New("COLOR_ATTACHMENT3_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT3_EXT));
-  Nan::Set(result, Nan::New("COLOR_ATTACHMENT4_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT4_EXT));
-  Nan::Set(result, Nan::New("COLOR_ATTACHMENT5_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT5_EXT));
-  Nan::Set(result, Nan::New("COLOR_ATTACHMENT6_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT6_EXT));
-  Nan::Set(result, Nan::New("COLOR_ATTACHMENT7_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT7_EXT));
-  Nan::Set(result, Nan::New("COLOR_ATTACHMENT8_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT8_EXT));
-  Nan::Set(result, Nan::New("COLOR_ATTACHMENT9_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT9_EXT));
-  Nan::Set(result, Nan::New("COLOR_ATTACHMENT10_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT10_EXT));
-  Nan::Set(result, Nan::New("COLOR_ATTACHMENT11_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT11_EXT));
-  Nan::Set(result, Nan::New("COLOR_ATTACHMENT12_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT12_EXT));
-  Nan::Set(result, Nan::New("COLOR_ATTACHMENT13_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT13_EXT));
-  Nan::Set(result, Nan::New("COLOR_ATTACHMENT14_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT14_EXT));
-  Nan::Set(result, Nan::New("COLOR_ATTACHMENT15_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_COLOR_ATTACHMENT15_EXT));
-
-  Nan::Set(result, Nan::New("DRAW_BUFFER0_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER0_EXT));
-  Nan::Set(result, Nan::New("DRAW_BUFFER1_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER1_EXT));
-  Nan::Set(result, Nan::New("DRAW_BUFFER2_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER2_EXT));
-  Nan::Set(result, Nan::New("DRAW_BUFFER3_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER3_EXT));
-  Nan::Set(result, Nan::New("DRAW_BUFFER4_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER4_EXT));
-  Nan::Set(result, Nan::New("DRAW_BUFFER5_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER5_EXT));
-  Nan::Set(result, Nan::New("DRAW_BUFFER6_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER6_EXT));
-  Nan::Set(result, Nan::New("DRAW_BUFFER7_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER7_EXT));
-  Nan::Set(result, Nan::New("DRAW_BUFFER8_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER8_EXT));
-  Nan::Set(result, Nan::New("DRAW_BUFFER9_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER9_EXT));
-  Nan::Set(result, Nan::New("DRAW_BUFFER10_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER10_EXT));
-  Nan::Set(result, Nan::New("DRAW_BUFFER11_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER11_EXT));
-  Nan::Set(result, Nan::New("DRAW_BUFFER12_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER12_EXT));
-  Nan::Set(result, Nan::New("DRAW_BUFFER13_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER13_EXT));
-  Nan::Set(result, Nan::New("DRAW_BUFFER14_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER14_EXT));
-  Nan::Set(result, Nan::New("DRAW_BUFFER15_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_DRAW_BUFFER15_EXT));
+void WebGLRenderingContext::commitRenderbuffer(uint64_t bytes) {
+  if (callFailed()) {
+    return;
+  }
+  GLint renderbuffer = 0;
+  (glGetIntegerv)(GL_RENDERBUFFER_BINDING, &renderbuffer);
+  if (!hasGLObj(GLOBJECT_TYPE_RENDERBUFFER, renderbuffer)) {
+    return;
+  }
 
-  Nan::Set(result, Nan::New("MAX_COLOR_ATTACHMENTS_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_MAX_COLOR_ATTACHMENTS_EXT));
-  Nan::Set(result, Nan::New("MAX_DRAW_BUFFERS_WEBGL").ToLocalChecked(), Nan::New<v8::Number>(GL_MAX_DRAW_BUFFERS_EXT));
+  uint64_t& size = renderbufferBytes[renderbuffer];
+  memory.renderbuffers += bytes - size;
+  size = bytes;
+}
 
-  info.GetReturnValue().Set(result);
+//Drops the state and memory kept for an object that was deleted
+void WebGLRenderingContext::forgetObject(GLObjectType type, GLuint name) {
+  switch (type) {
+    case GLOBJECT_TYPE_BUFFER: {
+      std::map<GLuint, uint64_t>::iterator it = bufferBytes.find(name);
+      if (it != bufferBytes.end()) {
+        memory.buffers -= it->second;
+        bufferBytes.erase(it);
+      }
+      break;
+    }
+    case GLOBJECT_TYPE_TEXTURE: {
+      std::map<GLuint, std::map<std::pair<GLenum, GLint>, ImageMemory> >::iterator
+        it = textureImages.find(name);
+      if (it != textureImages.end()) {
+        std::map<std::pair<GLenum, GLint>, ImageMemory>::iterator image;
+        for (image = it->second.begin(); image != it->second.end(); ++image) {
+          memory.textures -= image->second.bytes();
+        }
+        textureImages.erase(it);
+      }
+      break;
+    }
+    case GLOBJECT_TYPE_RENDERBUFFER: {
+      std::map<GLuint, uint64_t>::iterator it = renderbufferBytes.find(name);
+      if (it != renderbufferBytes.end()) {
+        memory.renderbuffers -= it->second;
+        renderbufferBytes.erase(it);
+      }
+      break;
+    }
+    default:
+      break;
+  }
 }
 
-GL_METHOD(BindVertexArrayOES) {
-  GL_BOILERPLATE;
+//Render jobs keep up to this many linked programs per pool thread
+#define RENDER_JOB_PROGRAMS 16
 
-  GLuint array = Nan::To<uint32_t>(info[0]).ToChecked();
+GLuint WebGLRenderingContext::renderJobProgram(RenderJob& job) {
+  std::pair<std::string, std::string> key(job.vertexShader, job.fragmentShader);
+  std::map<std::pair<std::string, std::string>, GLuint>::iterator it =
+    renderJobPrograms.find(key);
+  if (it != renderJobPrograms.end()) {
+    return it->second;
+  }
 
-  (inst->glBindVertexArrayOES)(array);
+  const GLenum types[2] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+  const char* sources[2] = {
+    job.vertexShader.c_str(),
+    job.fragmentShader.c_str()
+  };
+  GLuint shaders[2] = { 0, 0 };
+  for (int i = 0; i < 2; ++i) {
+    shaders[i] = (glCreateShader)(types[i]);
+    (glShaderSource)(shaders[i], 1, &sources[i], NULL);
+    (glCompileShader)(shaders[i]);
+
+    GLint status = GL_FALSE;
+    (glGetShaderiv)(shaders[i], GL_COMPILE_STATUS, &status);
+    if (status != GL_TRUE) {
+      char log[1024] = "";
+      (glGetShaderInfoLog)(shaders[i], sizeof(log), NULL, log);
+      job.error = std::string(i ? "fragment" : "vertex") +
+        " shader failed to compile: " + log;
+      (glDeleteShader)(shaders[0]);
+      (glDeleteShader)(shaders[1]);
+      return 0;
+    }
+  }
+
+  GLuint program = (glCreateProgram)();
+  (glAttachShader)(program, shaders[0]);
+  (glAttachShader)(program, shaders[1]);
+  (glLinkProgram)(program);
+  (glDeleteShader)(shaders[0]);
+  (glDeleteShader)(shaders[1]);
+
+  GLint status = GL_FALSE;
+  (glGetProgramiv)(program, GL_LINK_STATUS, &status);
+  if (status != GL_TRUE) {
+    char log[1024] = "";
+    (glGetProgramInfoLog)(program, sizeof(log), NULL, log);
+    job.error = std::string("program failed to link: ") + log;
+    (glDeleteProgram)(program);
+    return 0;
+  }
+
+  if (renderJobPrograms.size() >= RENDER_JOB_PROGRAMS) {
+    for (it = renderJobPrograms.begin(); it != renderJobPrograms.end(); ++it) {
+      (glDeleteProgram)(it->second);
+      unregisterGLObj(GLOBJECT_TYPE_PROGRAM, it->second);
+    }
+    renderJobPrograms.clear();
+  }
+  registerGLObj(GLOBJECT_TYPE_PROGRAM, program);
+  renderJobPrograms[key] = program;
+  return program;
 }
 
-GL_METHOD(CreateVertexArrayOES) {
-  GL_BOILERPLATE;
+void WebGLRenderingContext::runRenderJob(RenderJob& job) {
+  GLint maxSize = 0;
+  (glGetIntegerv)(GL_MAX_RENDERBUFFER_SIZE, &maxSize);
+  if (job.width <= 0 || job.height <= 0 ||
+      job.width > maxSize || job.height > maxSize) {
+    job.error = "render job size is out of range";
+    return;
+  }
 
-  GLuint array = 0;
-  (inst->glGenVertexArraysOES)(1, &array);
-  inst->registerGLObj(GLOBJECT_TYPE_VERTEX_ARRAY, array);
+  GLuint program = renderJobProgram(job);
+  if (!program) {
+    return;
+  }
 
-  info.GetReturnValue().Set(Nan::New<v8::Integer>(array));
-}
+  //Target
+  GLuint renderbuffers[2] = { 0, 0 };
+  GLuint framebuffer = 0;
+  (glGenRenderbuffers)(2, renderbuffers);
+  (glBindRenderbuffer)(GL_RENDERBUFFER, renderbuffers[0]);
+  (glRenderbufferStorage)(GL_RENDERBUFFER, GL_RGBA8_OES, job.width, job.height);
+  (glBindRenderbuffer)(GL_RENDERBUFFER, renderbuffers[1]);
+  (glRenderbufferStorage)(GL_RENDERBUFFER, preferredDepth, job.width, job.height);
+  (glBindRenderbuffer)(GL_RENDERBUFFER, 0);
+  (glGenFramebuffers)(1, &framebuffer);
+  (glBindFramebuffer)(GL_FRAMEBUFFER, framebuffer);
+  (glFramebufferRenderbuffer)(
+    GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+  (glFramebufferRenderbuffer)(
+    GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+
+  std::vector<GLuint> buffers(job.attributes.size() + 1, 0);
+  std::vector<GLuint> textures(job.textures.size(), 0);
+  std::vector<GLint>  enabled;
+
+  if ((glCheckFramebufferStatus)(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    job.error = "render job framebuffer is incomplete";
+  } else {
+    (glUseProgram)(program);
+    (glViewport)(0, 0, job.width, job.height);
+    if (job.depthTest) {
+      (glEnable)(GL_DEPTH_TEST);
+    } else {
+      (glDisable)(GL_DEPTH_TEST);
+    }
+    (glClearColor)(
+      job.clearColor[0], job.clearColor[1], job.clearColor[2], job.clearColor[3]);
+    (glClearDepthf)(1.f);
+    (glClear)(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    //Attributes the program does not use are skipped
+    (glGenBuffers)(buffers.size(), buffers.data());
+    for (size_t i = 0; i < job.attributes.size(); ++i) {
+      RenderJob::Attribute& attribute = job.attributes[i];
+      GLint location = (glGetAttribLocation)(program, attribute.name.c_str());
+      if (location < 0) {
+        continue;
+      }
+      (glBindBuffer)(GL_ARRAY_BUFFER, buffers[i]);
+      (glBufferData)(
+        GL_ARRAY_BUFFER,
+        attribute.data.size() * sizeof(GLfloat),
+        attribute.data.data(),
+        GL_STATIC_DRAW);
+      (glEnableVertexAttribArray)(location);
+      (glVertexAttribPointer)(location, attribute.size, GL_FLOAT, GL_FALSE, 0, NULL);
+      enabled.push_back(location);
+    }
+    (glBindBuffer)(GL_ARRAY_BUFFER, 0);
+    if (!job.elements.empty()) {
+      (glBindBuffer)(GL_ELEMENT_ARRAY_BUFFER, buffers.back());
+      (glBufferData)(
+        GL_ELEMENT_ARRAY_BUFFER,
+        job.elements.size(),
+        job.elements.data(),
+        GL_STATIC_DRAW);
+    }
 
-GL_METHOD(DeleteVertexArrayOES) {
-  GL_BOILERPLATE;
+    //Each texture gets the unit matching its position in the job
+    if (!textures.empty()) {
+      (glGenTextures)(textures.size(), textures.data());
+    }
+    (glPixelStorei)(GL_UNPACK_ALIGNMENT, 1);
+    for (size_t i = 0; i < job.textures.size(); ++i) {
+      RenderJob::Texture& texture = job.textures[i];
+      (glActiveTexture)(GL_TEXTURE0 + i);
+      (glBindTexture)(GL_TEXTURE_2D, textures[i]);
+      (glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture.filter);
+      (glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texture.filter);
+      (glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      (glTexParameteri)(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      (glTexImage2D)(
+        GL_TEXTURE_2D, 0, GL_RGBA, texture.width, texture.height, 0,
+        GL_RGBA, GL_UNSIGNED_BYTE, texture.data.data());
+      GLint location = (glGetUniformLocation)(program, texture.name.c_str());
+      if (location >= 0) {
+        (glUniform1i)(location, i);
+      }
+    }
 
-  GLuint array = Nan::To<uint32_t>(info[0]).ToChecked();
-  inst->unregisterGLObj(GLOBJECT_TYPE_VERTEX_ARRAY, array);
+    //Uniform types come from the program, values are converted to match
+    GLint activeUniforms = 0;
+    (glGetProgramiv)(program, GL_ACTIVE_UNIFORMS, &activeUniforms);
+    std::vector<GLint> words;
+    for (GLint u = 0; u < activeUniforms; ++u) {
+      char name[256];
+      GLint size = 0;
+      GLenum type = 0;
+      (glGetActiveUniform)(program, u, sizeof(name), NULL, &size, &type, name);
+      std::string base(name);
+      if (base.size() > 3 && base.compare(base.size() - 3, 3, "[0]") == 0) {
+        base.resize(base.size() - 3);
+      }
+      for (size_t i = 0; i < job.uniforms.size(); ++i) {
+        RenderJob::Uniform& uniform = job.uniforms[i];
+        if (uniform.name != base) {
+          continue;
+        }
+        size_t width = uniformWords(type);
+        GLsizei count = std::min<GLsizei>(size, uniform.values.size() / width);
+        if (count <= 0) {
+          break;
+        }
+        words.resize(count * width);
+        for (size_t w = 0; w < words.size(); ++w) {
+          switch (type) {
+            case GL_FLOAT:
+            case GL_FLOAT_VEC2:
+            case GL_FLOAT_VEC3:
+            case GL_FLOAT_VEC4:
+            case GL_FLOAT_MAT2:
+            case GL_FLOAT_MAT3:
+            case GL_FLOAT_MAT4:
+              memcpy(&words[w], &uniform.values[w], sizeof(GLfloat));
+              break;
+            default:
+              words[w] = static_cast<GLint>(uniform.values[w]);
+              break;
+          }
+        }
+        uploadUniform(this, type, (glGetUniformLocation)(program, name), count, words.data());
+        break;
+      }
+    }
 
-  (inst->glDeleteVertexArraysOES)(1, &array);
-}
+    const size_t elementSize = job.elementType == GL_UNSIGNED_INT ? 4 :
+      job.elementType == GL_UNSIGNED_SHORT ? 2 : 1;
+    for (size_t i = 0; i + 2 < job.draws.size(); i += 3) {
+      if (job.elements.empty()) {
+        (glDrawArrays)(job.draws[i], job.draws[i + 1], job.draws[i + 2]);
+      } else {
+        (glDrawElements)(
+          job.draws[i],
+          job.draws[i + 2],
+          job.elementType,
+          reinterpret_cast<GLvoid*>(job.draws[i + 1] * elementSize));
+      }
+    }
 
-GL_METHOD(IsVertexArrayOES) {
-  GL_BOILERPLATE;
+    job.pixels.resize(4 * static_cast<size_t>(job.width) * job.height);
+    (glPixelStorei)(GL_PACK_ALIGNMENT, 4);
+    (glReadPixels)(
+      0, 0, job.width, job.height, GL_RGBA, GL_UNSIGNED_BYTE, job.pixels.data());
 
-  info.GetReturnValue().Set(Nan::New<v8::Boolean>(
-    (inst->glIsVertexArrayOES)(Nan::To<uint32_t>(info[0]).ToChecked()) != 0));
+    GLenum error = (glGetError)();
+    if (error != GL_NO_ERROR) {
+      char message[64];
+      snprintf(message, sizeof(message), "render job failed with GL error 0x%04x", error);
+      job.error = message;
+    }
+  }
+
+  //Leave the context as it was for the next job
+  for (size_t i = 0; i < enabled.size(); ++i) {
+    (glDisableVertexAttribArray)(enabled[i]);
+  }
+  (glBindBuffer)(GL_ELEMENT_ARRAY_BUFFER, 0);
+  (glDeleteBuffers)(buffers.size(), buffers.data());
+  if (!textures.empty()) {
+    (glDeleteTextures)(textures.size(), textures.data());
+  }
+  (glActiveTexture)(GL_TEXTURE0);
+  forgetTextureBindings();
+  (glUseProgram)(0);
+  (glBindFramebuffer)(GL_FRAMEBUFFER, 0);
+  (glDeleteFramebuffers)(1, &framebuffer);
+  (glDeleteRenderbuffers)(2, renderbuffers);
 }
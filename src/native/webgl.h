@@ -2,17 +2,32 @@
 #define WEBGL_H_
 
 #include <algorithm>
+#include <chrono>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <string>
 #include <utility>
 
 #include <node.h>
 #include "nan.h"
 #include <v8.h>
 
+#include "frame-sink.h"
+#include "frame-ring-writer.h"
+#include "tile-hash.h"
+#include "readback-worker.h"
+#include "render-pool.h"
+#include "texture-uploader.h"
+
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
+#if __has_include(<EGL/eglext_angle.h>)
+#include <EGL/eglext_angle.h>
+#endif
 #include <GLES2/gl2.h>
 #include <GLES2/gl2ext.h>
+#include <GLES3/gl3.h>
 
 enum GLObjectType {
   GLOBJECT_TYPE_BUFFER,
@@ -22,6 +37,7 @@ enum GLObjectType {
   GLOBJECT_TYPE_SHADER,
   GLOBJECT_TYPE_TEXTURE,
   GLOBJECT_TYPE_VERTEX_ARRAY,
+  GLOBJECT_TYPE_COUNT
 };
 
 enum GLContextState {
@@ -33,11 +49,95 @@ enum GLContextState {
 
 typedef std::pair<GLuint, GLObjectType> GLObjectReference;
 
+//The live names of one type of GL object. GL hands out names densely from
+//1 and reuses freed ones, so membership is an array indexed by name, and
+//the names are kept packed so they can be deleted with one glDelete* call.
+class GLObjectSet {
+ public:
+  void insert(GLuint name) {
+    if (name >= slots_.size()) {
+      slots_.resize(std::max<size_t>(name + 1, slots_.size() * 2), 0);
+    }
+    if (!slots_[name]) {
+      names_.push_back(name);
+      slots_[name] = static_cast<GLuint>(names_.size());
+    }
+  }
+
+  //Returns false if the name was not in the set
+  bool erase(GLuint name) {
+    if (name >= slots_.size() || !slots_[name]) {
+      return false;
+    }
+    GLuint last = names_.back();
+    names_[slots_[name] - 1] = last;
+    slots_[last] = slots_[name];
+    slots_[name] = 0;
+    names_.pop_back();
+    return true;
+  }
+
+  bool contains(GLuint name) const {
+    return name < slots_.size() && slots_[name] != 0;
+  }
+
+  bool empty() const { return names_.empty(); }
+  GLsizei size() const { return static_cast<GLsizei>(names_.size()); }
+  const GLuint* data() const { return names_.data(); }
+
+  void clear() {
+    names_.clear();
+    slots_.clear();
+  }
+
+ private:
+  std::vector<GLuint> names_;
+  //Index into names_ plus one, 0 if the name is not in the set
+  std::vector<GLuint> slots_;
+};
+
+#define MAX_DISPLAYS 16
+
+//ANGLE backends a display can be opened with
+enum GLBackend {
+  GLBACKEND_DEFAULT,
+  GLBACKEND_SWIFTSHADER,
+  GLBACKEND_VULKAN,
+  GLBACKEND_GL,
+  GLBACKEND_GLES,
+  GLBACKEND_METAL,
+  GLBACKEND_D3D11,
+  GLBACKEND_NULL
+};
+
 struct WebGLRenderingContext : public node::ObjectWrap {
 
-  //The underlying OpenGL context
-  static bool       HAS_DISPLAY;
-  static EGLDisplay DISPLAY;
+  //Contexts are spread over up to MAX_DISPLAYS displays per backend, since
+  //ANGLE serializes the work of each display behind its own lock. Displays
+  //are shared by the contexts of every thread and count their live
+  //contexts, so that each is only terminated after the last. Slots are
+  //only read or written while DISPLAY_MUTEX is held, since adding one may
+  //move the others.
+  struct DisplaySlot {
+    int        backend;
+    bool       lowPower;
+    int        index;
+    EGLDisplay display;
+    int        users;
+  };
+  static std::vector<DisplaySlot> DISPLAYS;
+  static std::mutex  DISPLAY_MUTEX;
+  static unsigned    NEXT_DISPLAY;
+  static int acquireDisplay(
+    int backend,
+    bool lowPower,
+    int displayCount,
+    int displayIndex,
+    EGLDisplay* display);
+  EGLDisplay display;
+  int        displaySlot;
+  int        backend;
+  void releaseDisplay();
 
 
   EGLContext context;
@@ -45,24 +145,32 @@ struct WebGLRenderingContext : public node::ObjectWrap {
   EGLSurface surface;
   GLContextState  state;
 
+  //EGL_CONTEXT_CLIENT_VERSION, 3 for WebGL 2 contexts
+  GLint clientVersion;
+
   //Pixel storage flags
   bool  unpack_flip_y;
   bool  unpack_premultiply_alpha;
   GLint unpack_colorspace_conversion;
   GLint unpack_alignment;
 
-  //A list of object references, need do destroy them at program exit
-  std::map< std::pair<GLuint, GLObjectType>, bool > objects;
+  //The live objects of each type, need do destroy them at program exit
+  GLObjectSet objects[GLOBJECT_TYPE_COUNT];
   void registerGLObj(GLObjectType type, GLuint obj) {
-    objects[std::make_pair(obj, type)] = true;
+    objects[type].insert(obj);
   }
   void unregisterGLObj(GLObjectType type, GLuint obj) {
-    objects.erase(std::make_pair(obj, type));
+    objects[type].erase(obj);
+  }
+  bool hasGLObj(GLObjectType type, GLuint obj) const {
+    return objects[type].contains(obj);
   }
+  void deleteGLObjs();
 
-  //Context list
+  //Context list, one per thread since contexts belong to the isolate
+  //that created them
   WebGLRenderingContext *next, *prev;
-  static WebGLRenderingContext* CONTEXT_LIST_HEAD;
+  static thread_local WebGLRenderingContext* CONTEXT_LIST_HEAD;
   void registerContext() {
     if(CONTEXT_LIST_HEAD) {
       CONTEXT_LIST_HEAD->prev = this;
@@ -95,11 +203,16 @@ struct WebGLRenderingContext : public node::ObjectWrap {
     bool premultipliedAlpha,
     bool preserveDrawingBuffer,
     bool preferLowPowerToHighPerformance,
-    bool failIfMajorPerformanceCaveat);
+    bool failIfMajorPerformanceCaveat,
+    int version,
+    int displayCount,
+    int displayIndex,
+    int backend,
+    int threads);
   virtual ~WebGLRenderingContext();
 
-  //Context validation
-  static WebGLRenderingContext* ACTIVE;
+  //Context validation, the current EGL context is per thread
+  static thread_local WebGLRenderingContext* ACTIVE;
   bool setActive();
 
   //Unpacks a buffer full of pixels into memory
@@ -109,6 +222,118 @@ struct WebGLRenderingContext : public node::ObjectWrap {
     GLint width,
     GLint height,
     unsigned char* pixels);
+  static unsigned char* unpackPixels(
+    GLenum type,
+    GLenum format,
+    GLint width,
+    GLint height,
+    unsigned char* pixels,
+    bool flipY,
+    bool premultiplyAlpha,
+    GLint alignment);
+
+  //Time the calling thread spent inside the methods of this context, and
+  //the work they submitted, counted while accounting is on
+  struct CallStats {
+    uint64_t calls;
+    uint64_t callNs;
+    uint64_t finishNs;
+    uint64_t draws;
+    uint64_t uploads;
+    uint64_t uploadBytes;
+  };
+  bool      accounting;
+  CallStats callStats;
+  void countDraws(uint64_t draws) {
+    if (accounting) {
+      callStats.draws += draws;
+    }
+  }
+  void countUpload(uint64_t bytes) {
+    if (accounting) {
+      ++callStats.uploads;
+      callStats.uploadBytes += bytes;
+    }
+  }
+
+  //Adds the time until it goes out of scope to a counter in callStats.
+  //Every method gets one from GL_BOILERPLATE, started before the context
+  //is made current so that context switches are counted, and Finish
+  //nests a second one for finishNs, which is also part of callNs.
+  class CallTimer {
+   public:
+    CallTimer(WebGLRenderingContext* inst, uint64_t CallStats::*counter) :
+        inst_(inst && inst->accounting ? inst : NULL)
+      , counter_(counter) {
+      if (inst_) {
+        start_ = std::chrono::steady_clock::now();
+      }
+    }
+    ~CallTimer() {
+      if (inst_) {
+        std::chrono::nanoseconds elapsed =
+          std::chrono::steady_clock::now() - start_;
+        inst_->callStats.*counter_ += elapsed.count();
+        if (counter_ == &CallStats::callNs) {
+          ++inst_->callStats.calls;
+        }
+      }
+    }
+
+   private:
+    WebGLRenderingContext* inst_;
+    uint64_t CallStats::*counter_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+  //Bytes held in textures, renderbuffers and buffers, estimated from the
+  //sizes and formats they were allocated with. An allocation that would
+  //take the total over a nonzero budget fails with GL_OUT_OF_MEMORY
+  //before it reaches the driver.
+  struct MemoryStats {
+    uint64_t textures;
+    uint64_t renderbuffers;
+    uint64_t buffers;
+    uint64_t budget;
+  };
+  struct ImageMemory {
+    GLsizei  width;
+    GLsizei  height;
+    GLsizei  depth;
+    uint64_t pixelBytes;
+    uint64_t bytes() const {
+      return static_cast<uint64_t>(width) * height * depth * pixelBytes;
+    }
+  };
+  MemoryStats memory;
+  //Images of each texture by face target and level
+  std::map<GLuint, std::map<std::pair<GLenum, GLint>, ImageMemory> > textureImages;
+  std::map<GLuint, uint64_t> renderbufferBytes;
+  std::map<GLuint, uint64_t> bufferBytes;
+  uint64_t memoryUsed() const {
+    return memory.textures + memory.renderbuffers + memory.buffers;
+  }
+  //The alloc calls check an allocation against the budget before the GL
+  //call that makes it, and the matching commit calls charge it only if that
+  //call succeeded. Errors raised before are moved to lastError first, so
+  //the commit sees the error of the call alone.
+  bool checkBudget(uint64_t oldBytes, uint64_t newBytes);
+  void holdErrors();
+  bool callFailed();
+  bool allocTextureImage(GLenum target, GLint level, const ImageMemory& image);
+  void commitTextureImage(GLenum target, GLint level, const ImageMemory& image);
+  bool allocMipmaps(GLenum target);
+  void commitMipmaps(GLenum target);
+  bool allocRenderbuffer(uint64_t bytes);
+  void commitRenderbuffer(uint64_t bytes);
+  void forgetObject(GLObjectType type, GLuint name);
+
+  //Textures bound to the 2D, cube map, 3D and 2D array targets of the
+  //active unit, -1 until queried. Native code that binds textures behind
+  //the JavaScript side's back calls forgetTextureBindings afterwards.
+  GLint textureBindings[4];
+  GLuint boundTexture(GLenum target);
+  void forgetTextureBindings();
 
   //Error handling
   GLenum lastError;
@@ -120,10 +345,53 @@ struct WebGLRenderingContext : public node::ObjectWrap {
   //Preferred depth format
   GLenum preferredDepth;
 
+  //Background YUV frame writer, if one is open
+  FrameSink* frameSink;
+
+  //Shared memory frame ring, if one is open
+  FrameRingWriter* frameRing;
+  ReadbackWorker* readbackWorker;
+
+  //Threads running submitted render jobs, started by the first submit
+  RenderPool* renderPool;
+
+  //Background texture uploads, started by the first texImage2DAsync
+  TextureUploader* textureUploader;
+
+  //Runs a render job with this context, used by the render pool threads.
+  //Linked programs are kept by source for the jobs that follow.
+  std::map<std::pair<std::string, std::string>, GLuint> renderJobPrograms;
+  GLuint renderJobProgram(RenderJob& job);
+  void runRenderJob(RenderJob& job);
+
+  //Scratch memory for readbacks that are converted before returning
+  std::vector<unsigned char> readbackBuffer;
+
+  //GPU resources kept between scaled readbacks, created on first use
+  struct ScaledReadback {
+    GLuint  program;
+    GLint   scaleLocation;
+    GLuint  buffer;
+    GLuint  framebuffer;
+    GLuint  textures[2];
+    GLsizei widths[2];
+    GLsizei heights[2];
+  } scaledReadback;
+  bool initScaledReadback();
+
+  //Recorded command bundles by id, replayed by ExecuteCommandBundle
+  std::map<GLuint, std::vector<GLint> > commandBundles;
+  GLuint nextCommandBundle;
+
   //Destructors
   void dispose();
 
+  //Deletes every registered object except the [GL target, name] pairs in
+  //keep, and puts the GL state back to the WebGL defaults
+  void reset(const GLint* keep, size_t keepCount);
+
   static NAN_METHOD(DisposeAll);
+  static void disposeThreadContexts();
 
   static NAN_METHOD(New);
   static NAN_METHOD(Destroy);
@@ -199,6 +467,7 @@ struct WebGLRenderingContext : public node::ObjectWrap {
   static NAN_METHOD(ClearStencil);
   static NAN_METHOD(ColorMask);
   static NAN_METHOD(CopyTexImage2D);
+  static NAN_METHOD(CompressedTexImage2D);
   static NAN_METHOD(CopyTexSubImage2D);
   static NAN_METHOD(CullFace);
   static NAN_METHOD(DepthMask);
@@ -242,11 +511,40 @@ struct WebGLRenderingContext : public node::ObjectWrap {
   static NAN_METHOD(IsTexture);
 
   static NAN_METHOD(RenderbufferStorage);
+  static NAN_METHOD(RenderbufferStorageMultisample);
+  static NAN_METHOD(BlitFramebuffer);
+  static NAN_METHOD(DiscardFramebuffer);
   static NAN_METHOD(GetShaderSource);
   static NAN_METHOD(ValidateProgram);
 
   static NAN_METHOD(TexSubImage2D);
   static NAN_METHOD(ReadPixels);
+  static NAN_METHOD(ReadPixelsRows);
+  static NAN_METHOD(ReadPixelsYUV);
+  static NAN_METHOD(ReadDirtyTiles);
+  static NAN_METHOD(ReadPixelsScaled);
+  static NAN_METHOD(ClearFramebuffer);
+  static NAN_METHOD(ResolveDrawingBuffer);
+  static NAN_METHOD(OpenFrameSink);
+  static NAN_METHOD(WriteFrameSink);
+  static NAN_METHOD(CloseFrameSink);
+  static NAN_METHOD(OpenFrameRing);
+  static NAN_METHOD(WriteFrameRing);
+  static NAN_METHOD(CloseFrameRing);
+  static NAN_METHOD(OpenReadbackWorker);
+  static NAN_METHOD(ReadTextureAsync);
+  static NAN_METHOD(WaitTextureRead);
+  static NAN_METHOD(OpenRenderPool);
+  static NAN_METHOD(SubmitRenderJob);
+  static NAN_METHOD(OpenTextureUploader);
+  static NAN_METHOD(TexImage2DAsync);
+  static NAN_METHOD(FinishTextureUpload);
+  static NAN_METHOD(SetCallAccounting);
+  static NAN_METHOD(GetCallStats);
+  static NAN_METHOD(GetMemoryInfo);
+  static NAN_METHOD(SetMemoryBudget);
+  static NAN_METHOD(ResetContext);
+  static NAN_METHOD(ReleaseObjects);
   static NAN_METHOD(GetTexParameter);
   static NAN_METHOD(GetActiveAttrib);
   static NAN_METHOD(GetActiveUniform);
@@ -273,6 +571,22 @@ struct WebGLRenderingContext : public node::ObjectWrap {
   static NAN_METHOD(DeleteVertexArrayOES);
   static NAN_METHOD(IsVertexArrayOES);
 
+  static NAN_METHOD(BindBufferBase);
+  static NAN_METHOD(BindBufferRange);
+  static NAN_METHOD(GetUniformBlockIndex);
+  static NAN_METHOD(UniformBlockBinding);
+  static NAN_METHOD(GetActiveUniformBlockParameter);
+  static NAN_METHOD(GetActiveUniformBlockName);
+  static NAN_METHOD(GetBufferSubData);
+  static NAN_METHOD(TexImage3D);
+  static NAN_METHOD(TexSubImage3D);
+
+  static NAN_METHOD(UniformBlock);
+  static NAN_METHOD(CreateCommandBundle);
+  static NAN_METHOD(DeleteCommandBundle);
+  static NAN_METHOD(ExecuteCommandBundle);
+
+
   void initPointers();
 
   #include "procs.h"
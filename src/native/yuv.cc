@@ -0,0 +1,238 @@
+#include <cmath>
+#include <cstring>
+
+#include "yuv.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define YUV_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+static const int YUV_SHIFT = 14;
+
+static inline unsigned char clampByte(int32_t v) {
+  return static_cast<unsigned char>(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+static inline int16_t toFixed(double v) {
+  return static_cast<int16_t>(std::lround(v * (1 << YUV_SHIFT)));
+}
+
+void initYUVConversion(YUVConversion& conv, YUVMatrix matrix, bool fullRange) {
+  double kr = 0.299;
+  double kb = 0.114;
+  if (matrix == YUV_MATRIX_BT709) {
+    kr = 0.2126;
+    kb = 0.0722;
+  }
+  double kg = 1.0 - kr - kb;
+
+  double yScale = fullRange ? 1.0 : 219.0 / 255.0;
+  double cScale = fullRange ? 1.0 : 224.0 / 255.0;
+  double cb = cScale * 0.5 / (1.0 - kb);
+  double cr = cScale * 0.5 / (1.0 - kr);
+
+  conv.y[0] = toFixed(yScale * kr);
+  conv.y[1] = toFixed(yScale * kg);
+  conv.y[2] = toFixed(yScale * kb);
+  conv.u[0] = toFixed(-cb * kr);
+  conv.u[1] = toFixed(-cb * kg);
+  conv.u[2] = toFixed(cb * (1.0 - kb));
+  conv.v[0] = toFixed(cr * (1.0 - kr));
+  conv.v[1] = toFixed(-cr * kg);
+  conv.v[2] = toFixed(-cr * kb);
+  conv.yOffset = fullRange ? 0 : 16;
+  conv.cOffset = 128;
+}
+
+size_t yuv420FrameSize(int width, int height) {
+  size_t cw = (width + 1) / 2;
+  size_t ch = (height + 1) / 2;
+  return static_cast<size_t>(width) * height + 2 * cw * ch;
+}
+
+static inline unsigned char lumaOf(const unsigned char* p, const YUVConversion& c) {
+  int32_t y = c.y[0] * p[0] + c.y[1] * p[1] + c.y[2] * p[2];
+  return clampByte(((y + (1 << (YUV_SHIFT - 1))) >> YUV_SHIFT) + c.yOffset);
+}
+
+//r, g, b are sums of four samples
+static inline void chromaOf(
+    int32_t r, int32_t g, int32_t b,
+    const YUVConversion& c,
+    unsigned char* u, unsigned char* v) {
+  const int shift = YUV_SHIFT + 2;
+  int32_t cu = c.u[0] * r + c.u[1] * g + c.u[2] * b;
+  int32_t cv = c.v[0] * r + c.v[1] * g + c.v[2] * b;
+  *u = clampByte(((cu + (1 << (shift - 1))) >> shift) + c.cOffset);
+  *v = clampByte(((cv + (1 << (shift - 1))) >> shift) + c.cOffset);
+}
+
+#ifdef YUV_USE_SSE2
+//Dot products of four RGBA pixels, held as 16 bit lanes in two registers,
+//with the coefficient vector (c0, c1, c2, 0) repeated
+static inline __m128i dot4(__m128i lo, __m128i hi, __m128i coef) {
+  __m128 a = _mm_castsi128_ps(_mm_madd_epi16(lo, coef));
+  __m128 b = _mm_castsi128_ps(_mm_madd_epi16(hi, coef));
+  __m128i even = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+  __m128i odd  = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+  return _mm_add_epi32(even, odd);
+}
+
+static inline __m128i coefVector(const int16_t* c) {
+  return _mm_set_epi16(0, c[2], c[1], c[0], 0, c[2], c[1], c[0]);
+}
+
+//Converts 8 pixels to 8 luma samples, returns the number converted
+static int lumaRow(
+    const unsigned char* src,
+    int width,
+    const YUVConversion& c,
+    unsigned char* dst) {
+  const __m128i zero  = _mm_setzero_si128();
+  const __m128i coef  = coefVector(c.y);
+  const __m128i round = _mm_set1_epi32((1 << (YUV_SHIFT - 1)) + (c.yOffset << YUV_SHIFT));
+  int x = 0;
+  for (; x + 8 <= width; x += 8) {
+    __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * x));
+    __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * x + 16));
+    __m128i y0 = dot4(_mm_unpacklo_epi8(p0, zero), _mm_unpackhi_epi8(p0, zero), coef);
+    __m128i y1 = dot4(_mm_unpacklo_epi8(p1, zero), _mm_unpackhi_epi8(p1, zero), coef);
+    y0 = _mm_srai_epi32(_mm_add_epi32(y0, round), YUV_SHIFT);
+    y1 = _mm_srai_epi32(_mm_add_epi32(y1, round), YUV_SHIFT);
+    __m128i packed = _mm_packs_epi32(y0, y1);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(packed, packed));
+  }
+  return x;
+}
+
+//Sums horizontal pixel pairs of 4 RGBA pixels (16 bit lanes) into two
+//16 bit RGBA sums
+static inline __m128i pairSums(__m128i px, __m128i zero) {
+  __m128i lo = _mm_unpacklo_epi8(px, zero);
+  __m128i hi = _mm_unpackhi_epi8(px, zero);
+  return _mm_unpacklo_epi64(
+    _mm_add_epi16(lo, _mm_srli_si128(lo, 8)),
+    _mm_add_epi16(hi, _mm_srli_si128(hi, 8)));
+}
+
+//Converts an 8 pixel wide, 2 row high block to 4 chroma pairs, returns the
+//number of chroma samples converted
+template<bool Interleaved>
+static int chromaRow(
+    const unsigned char* row0,
+    const unsigned char* row1,
+    int width,
+    const YUVConversion& c,
+    unsigned char* u,
+    unsigned char* v) {
+  const __m128i zero  = _mm_setzero_si128();
+  const __m128i coefU = coefVector(c.u);
+  const __m128i coefV = coefVector(c.v);
+  const int shift = YUV_SHIFT + 1;
+  const __m128i round = _mm_set1_epi32((1 << (shift - 1)) + (c.cOffset << shift));
+  int x = 0;
+  for (; 2 * x + 8 <= width; x += 4) {
+    const unsigned char* a = row0 + 8 * x;
+    const unsigned char* b = row1 + 8 * x;
+    __m128i p0 = _mm_avg_epu8(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(a)),
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+    __m128i p1 = _mm_avg_epu8(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + 16)),
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 16)));
+    __m128i s0 = pairSums(p0, zero);
+    __m128i s1 = pairSums(p1, zero);
+    __m128i cu = _mm_srai_epi32(_mm_add_epi32(dot4(s0, s1, coefU), round), shift);
+    __m128i cv = _mm_srai_epi32(_mm_add_epi32(dot4(s0, s1, coefV), round), shift);
+    __m128i packed = _mm_packus_epi16(_mm_packs_epi32(cu, cv), zero);
+    if (Interleaved) {
+      __m128i uv = _mm_unpacklo_epi8(packed, _mm_srli_si128(packed, 4));
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(u + 2 * x), uv);
+    } else {
+      int32_t uu = _mm_cvtsi128_si32(packed);
+      int32_t vv = _mm_cvtsi128_si32(_mm_srli_si128(packed, 4));
+      std::memcpy(u + x, &uu, 4);
+      std::memcpy(v + x, &vv, 4);
+    }
+  }
+  return x;
+}
+#endif
+
+template<bool Interleaved>
+static void rgbaToYUV420(
+    const unsigned char* rgba,
+    ptrdiff_t stride,
+    int width,
+    int height,
+    const YUVConversion& conv,
+    unsigned char* dst) {
+  int cw = (width + 1) / 2;
+  int ch = (height + 1) / 2;
+  unsigned char* yPlane = dst;
+  unsigned char* uPlane = dst + static_cast<size_t>(width) * height;
+  unsigned char* vPlane = uPlane + static_cast<size_t>(cw) * ch;
+
+  for (int j = 0; j < height; ++j) {
+    const unsigned char* src = rgba + j * stride;
+    unsigned char* out = yPlane + static_cast<size_t>(j) * width;
+    int x = 0;
+#ifdef YUV_USE_SSE2
+    x = lumaRow(src, width, conv, out);
+#endif
+    for (; x < width; ++x) {
+      out[x] = lumaOf(src + 4 * x, conv);
+    }
+  }
+
+  for (int j = 0; j < ch; ++j) {
+    const unsigned char* row0 = rgba + (2 * j) * stride;
+    const unsigned char* row1 = (2 * j + 1 < height) ? row0 + stride : row0;
+    unsigned char* u;
+    unsigned char* v;
+    if (Interleaved) {
+      u = uPlane + 2 * static_cast<size_t>(j) * cw;
+      v = u + 1;
+    } else {
+      u = uPlane + static_cast<size_t>(j) * cw;
+      v = vPlane + static_cast<size_t>(j) * cw;
+    }
+    int x = 0;
+#ifdef YUV_USE_SSE2
+    x = chromaRow<Interleaved>(row0, row1, width, conv, u, v);
+#endif
+    for (; x < cw; ++x) {
+      int x0 = 4 * (2 * x);
+      int x1 = (2 * x + 1 < width) ? x0 + 4 : x0;
+      int32_t r = row0[x0]     + row0[x1]     + row1[x0]     + row1[x1];
+      int32_t g = row0[x0 + 1] + row0[x1 + 1] + row1[x0 + 1] + row1[x1 + 1];
+      int32_t b = row0[x0 + 2] + row0[x1 + 2] + row1[x0 + 2] + row1[x1 + 2];
+      if (Interleaved) {
+        chromaOf(r, g, b, conv, u + 2 * x, v + 2 * x);
+      } else {
+        chromaOf(r, g, b, conv, u + x, v + x);
+      }
+    }
+  }
+}
+
+void rgbaToI420(
+    const unsigned char* rgba,
+    ptrdiff_t stride,
+    int width,
+    int height,
+    const YUVConversion& conv,
+    unsigned char* dst) {
+  rgbaToYUV420<false>(rgba, stride, width, height, conv, dst);
+}
+
+void rgbaToNV12(
+    const unsigned char* rgba,
+    ptrdiff_t stride,
+    int width,
+    int height,
+    const YUVConversion& conv,
+    unsigned char* dst) {
+  rgbaToYUV420<true>(rgba, stride, width, height, conv, dst);
+}
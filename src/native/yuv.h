@@ -0,0 +1,45 @@
+#ifndef YUV_H_
+#define YUV_H_
+
+#include <cstddef>
+#include <cstdint>
+
+enum YUVMatrix {
+  YUV_MATRIX_BT601,
+  YUV_MATRIX_BT709
+};
+
+//Fixed point (Q14) RGB to YCbCr coefficients for one matrix and range
+struct YUVConversion {
+  int16_t y[3];
+  int16_t u[3];
+  int16_t v[3];
+  int32_t yOffset;
+  int32_t cOffset;
+};
+
+void initYUVConversion(YUVConversion& conv, YUVMatrix matrix, bool fullRange);
+
+//Size in bytes of a 4:2:0 frame with the given dimensions
+size_t yuv420FrameSize(int width, int height);
+
+//Converts RGBA rows to planar I420 (Y, then U, then V) or semi-planar NV12
+//(Y, then interleaved UV). Rows are read starting at rgba and advance by
+//stride bytes, which may be negative to flip a bottom-up image.
+void rgbaToI420(
+  const unsigned char* rgba,
+  ptrdiff_t stride,
+  int width,
+  int height,
+  const YUVConversion& conv,
+  unsigned char* dst);
+
+void rgbaToNV12(
+  const unsigned char* rgba,
+  ptrdiff_t stride,
+  int width,
+  int height,
+  const YUVConversion& conv,
+  unsigned char* dst);
+
+#endif
@@ -0,0 +1,136 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+const makeProgram = require('./util/make-program')
+
+const VERT_SRC = [
+  'precision mediump float;',
+  'attribute vec2 position;',
+  'void main() {',
+  '  gl_Position = vec4(position, 0, 1);',
+  '}'
+].join('\n')
+
+const FRAG_SRC = [
+  'precision mediump float;',
+  'void main() {',
+  '  gl_FragColor = vec4(1, 1, 1, 1);',
+  '}'
+].join('\n')
+
+// Draws a white triangle covering the lower left half of the drawing buffer
+// and returns the distinct red values found along its diagonal edge.
+function edgeValues (gl, size) {
+  const program = makeProgram(gl, VERT_SRC, FRAG_SRC)
+  gl.bindAttribLocation(program, 0, 'position')
+  gl.linkProgram(program)
+  gl.useProgram(program)
+
+  gl.clearColor(0, 0, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+
+  const buffer = gl.createBuffer()
+  gl.bindBuffer(gl.ARRAY_BUFFER, buffer)
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([-1, -1, 1, -1, -1, 1]), gl.STATIC_DRAW)
+  gl.enableVertexAttribArray(0)
+  gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0)
+  gl.drawArrays(gl.TRIANGLES, 0, 3)
+
+  const pixels = new Uint8Array(size * size * 4)
+  gl.readPixels(0, 0, size, size, gl.RGBA, gl.UNSIGNED_BYTE, pixels)
+
+  const values = {}
+  for (let i = 0; i < size; ++i) {
+    values[pixels[4 * (i * size + (size - 1 - i))]] = true
+  }
+  return Object.keys(values).map(Number)
+}
+
+tape('antialias - multisampled drawing buffer', function (t) {
+  const size = 16
+  const gl = createContext(size, size, { antialias: true })
+  t.ok(gl, 'context created')
+
+  if (!gl.getContextAttributes().antialias) {
+    t.skip('multisampling not supported')
+    gl.getExtension('STACKGL_destroy_context').destroy()
+    t.end()
+    return
+  }
+
+  t.ok(gl.getParameter(gl.SAMPLES) > 1, 'drawing buffer is multisampled')
+
+  const values = edgeValues(gl, size)
+  t.ok(values.some(function (x) { return x > 0 && x < 255 }), 'edge is antialiased')
+  t.equals(gl.getError(), gl.NO_ERROR, 'no errors')
+
+  // Scissor must not affect the resolve
+  gl.enable(gl.SCISSOR_TEST)
+  gl.scissor(0, 0, 1, 1)
+  const pixel = new Uint8Array(4)
+  gl.readPixels(0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixel)
+  t.deepEquals(Array.from(pixel), [255, 255, 255, 255], 'resolved with scissor enabled')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
+
+tape('antialias - disabled by default', function (t) {
+  const size = 16
+  const gl = createContext(size, size)
+  t.equals(gl.getContextAttributes().antialias, false, 'antialias off')
+
+  const values = edgeValues(gl, size)
+  t.ok(values.every(function (x) { return x === 0 || x === 255 }), 'edge is aliased')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
+
+tape('antialias - ANGLE_framebuffer_multisample and blit', function (t) {
+  const size = 8
+  const gl = createContext(size, size)
+  const ms = gl.getExtension('ANGLE_framebuffer_multisample')
+  const blit = gl.getExtension('ANGLE_framebuffer_blit')
+  if (!ms || !blit) {
+    t.skip('extensions not supported')
+    gl.getExtension('STACKGL_destroy_context').destroy()
+    t.end()
+    return
+  }
+
+  const renderbuffer = gl.createRenderbuffer()
+  gl.bindRenderbuffer(gl.RENDERBUFFER, renderbuffer)
+  ms.renderbufferStorageMultisampleANGLE(gl.RENDERBUFFER, 4, 0x8058, size, size)
+  t.equals(gl.getError(), gl.NO_ERROR, 'multisample storage')
+  t.ok(gl.getRenderbufferParameter(gl.RENDERBUFFER, ms.RENDERBUFFER_SAMPLES_ANGLE) > 0, 'samples reported')
+
+  const msFramebuffer = gl.createFramebuffer()
+  gl.bindFramebuffer(gl.FRAMEBUFFER, msFramebuffer)
+  gl.framebufferRenderbuffer(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, gl.RENDERBUFFER, renderbuffer)
+  t.equals(gl.checkFramebufferStatus(gl.FRAMEBUFFER), gl.FRAMEBUFFER_COMPLETE, 'multisample framebuffer complete')
+  gl.clearColor(0, 1, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+
+  const texture = gl.createTexture()
+  gl.bindTexture(gl.TEXTURE_2D, texture)
+  gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, size, size, 0, gl.RGBA, gl.UNSIGNED_BYTE, null)
+  const framebuffer = gl.createFramebuffer()
+  gl.bindFramebuffer(gl.FRAMEBUFFER, framebuffer)
+  gl.framebufferTexture2D(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, gl.TEXTURE_2D, texture, 0)
+
+  gl.bindFramebuffer(blit.READ_FRAMEBUFFER_ANGLE, msFramebuffer)
+  t.equals(gl.getParameter(blit.READ_FRAMEBUFFER_BINDING_ANGLE), msFramebuffer, 'read binding')
+  t.equals(gl.getParameter(gl.FRAMEBUFFER_BINDING), framebuffer, 'draw binding')
+  blit.blitFramebufferANGLE(0, 0, size, size, 0, 0, size, size, gl.COLOR_BUFFER_BIT, gl.NEAREST)
+  t.equals(gl.getError(), gl.NO_ERROR, 'blit ok')
+
+  gl.bindFramebuffer(gl.FRAMEBUFFER, framebuffer)
+  const pixel = new Uint8Array(4)
+  gl.readPixels(1, 1, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixel)
+  t.deepEquals(Array.from(pixel), [0, 255, 0, 255], 'resolved color')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
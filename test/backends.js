@@ -0,0 +1,61 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+
+function render (gl) {
+  gl.clearColor(0.2, 0.4, 0.6, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  gl.enable(gl.SCISSOR_TEST)
+  gl.scissor(0, 0, 1, 1)
+  gl.clearColor(1, 0, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  gl.disable(gl.SCISSOR_TEST)
+  const pixels = new Uint8Array(2 * 2 * 4)
+  gl.readPixels(0, 0, 2, 2, gl.RGBA, gl.UNSIGNED_BYTE, pixels)
+  return Array.from(pixels)
+}
+
+tape('backends', function (t) {
+  const gl = createContext(2, 2)
+  t.equals(gl.getContextAttributes().backend, 'default', 'default backend')
+  const expected = render(gl)
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.deepEquals(expected.slice(0, 4), [255, 0, 0, 255], 'scissored clear')
+  t.deepEquals(expected.slice(4, 8), [51, 102, 153, 255], 'clear')
+
+  t.throws(function () {
+    createContext(2, 2, { backend: 'bogus' })
+  }, TypeError, 'unknown backend throws')
+
+  const saved = process.env.HEADLESS_GL_BACKEND
+  process.env.HEADLESS_GL_BACKEND = 'swiftshdaer'
+  t.throws(function () {
+    createContext(2, 2)
+  }, TypeError, 'unknown HEADLESS_GL_BACKEND throws')
+  if (saved === undefined) {
+    delete process.env.HEADLESS_GL_BACKEND
+  } else {
+    process.env.HEADLESS_GL_BACKEND = saved
+  }
+
+  // CPU only configurations, which need an ANGLE build that includes them
+  for (const options of [
+    { backend: 'swiftshader' },
+    { backend: 'swiftshader', angleThreads: 1 },
+    { backend: 'swiftshader', preferLowPowerToHighPerformance: true }
+  ]) {
+    const name = JSON.stringify(options)
+    const ctx = createContext(2, 2, options)
+    if (!ctx) {
+      t.skip(name + ' not available')
+      continue
+    }
+    t.equals(ctx.getContextAttributes().backend, 'swiftshader', name + ' attribute')
+    t.deepEquals(render(ctx), expected, name + ' renders the same image')
+    t.equals(ctx.getError(), ctx.NO_ERROR, name + ' no errors')
+    ctx.getExtension('STACKGL_destroy_context').destroy()
+  }
+
+  t.end()
+})
@@ -0,0 +1,120 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+
+function createProgram (gl) {
+  const vs = `attribute vec2 position;
+void main() {
+  gl_PointSize = 1.0;
+  gl_Position = vec4(position, 0, 1);
+}`
+  const fs = `precision mediump float;
+uniform vec4 color;
+void main() {
+  gl_FragColor = color;
+}`
+  const vertShader = gl.createShader(gl.VERTEX_SHADER)
+  gl.shaderSource(vertShader, vs)
+  gl.compileShader(vertShader)
+  const fragShader = gl.createShader(gl.FRAGMENT_SHADER)
+  gl.shaderSource(fragShader, fs)
+  gl.compileShader(fragShader)
+  const program = gl.createProgram()
+  gl.attachShader(program, vertShader)
+  gl.attachShader(program, fragShader)
+  gl.bindAttribLocation(program, 0, 'position')
+  gl.linkProgram(program)
+  return program
+}
+
+function readPixel (gl) {
+  const pixel = new Uint8Array(4)
+  gl.readPixels(0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixel)
+  return Array.from(pixel)
+}
+
+tape('command-bundle', function (t) {
+  const gl = createContext(1, 1)
+  const ext = gl.getExtension('STACKGL_command_bundle')
+  t.ok(ext, 'extension supported')
+  const vaoExt = gl.getExtension('OES_vertex_array_object')
+
+  const program = createProgram(gl)
+  const color = gl.getUniformLocation(program, 'color')
+
+  const vao = vaoExt.createVertexArrayOES()
+  vaoExt.bindVertexArrayOES(vao)
+  const buffer = gl.createBuffer()
+  gl.bindBuffer(gl.ARRAY_BUFFER, buffer)
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([0, 0]), gl.STATIC_DRAW)
+  gl.enableVertexAttribArray(0)
+  gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0)
+  vaoExt.bindVertexArrayOES(null)
+
+  const recorder = ext.createBundleRecorder()
+  recorder.useProgram(program)
+  recorder.bindVertexArray(vao)
+  recorder.uniform4f(color, 1, 0, 0, 1)
+  recorder.drawArrays(gl.POINTS, 0, 1)
+  recorder.uniformOverride(color, 0)
+  recorder.drawArrays(gl.POINTS, 0, 1)
+  const bundle = recorder.finish()
+  t.ok(bundle, 'bundle recorded')
+  t.equals(bundle.overrideSize, 4, 'override size')
+  t.equals(gl.getParameter(gl.CURRENT_PROGRAM), null, 'program restored after recording')
+
+  t.ok(ext.executeBundle(bundle, new Float32Array([0, 1, 0, 1])), 'bundle executed')
+  t.deepEquals(readPixel(gl), [0, 255, 0, 255], 'override applied')
+  t.ok(ext.executeBundle(bundle, new Float32Array([0, 0, 1, 1])), 'bundle executed again')
+  t.deepEquals(readPixel(gl), [0, 0, 255, 255], 'new override applied')
+  t.equals(gl.getParameter(gl.CURRENT_PROGRAM), null, 'program restored after execution')
+
+  ext.executeBundle(bundle, new Float32Array(2))
+  t.equals(gl.getError(), gl.INVALID_VALUE, 'overrides too short')
+
+  // Draws need a vertex array bound inside the bundle
+  const unbound = ext.createBundleRecorder()
+  unbound.useProgram(program)
+  unbound.drawArrays(gl.POINTS, 0, 1)
+  t.equals(unbound.finish(), null, 'draw without vertex array')
+  gl.getError()
+
+  // Without useProgram, the bundle only runs with the program it was
+  // recorded against
+  const other = createProgram(gl)
+  gl.useProgram(program)
+  const inherited = ext.createBundleRecorder()
+  inherited.bindVertexArray(vao)
+  inherited.uniform4f(color, 1, 1, 0, 1)
+  inherited.drawArrays(gl.POINTS, 0, 1)
+  const inheritedBundle = inherited.finish()
+  t.ok(inheritedBundle, 'bundle recorded without useProgram')
+  t.ok(ext.isBundleValid(inheritedBundle), 'valid with the recording program')
+  gl.useProgram(other)
+  t.notOk(ext.isBundleValid(inheritedBundle), 'invalid with another program')
+  t.notOk(ext.executeBundle(inheritedBundle), 'not executed with another program')
+  t.equals(gl.getError(), gl.INVALID_OPERATION, 'other program error')
+  gl.useProgram(null)
+  t.notOk(ext.executeBundle(inheritedBundle), 'not executed without a program')
+  t.equals(gl.getError(), gl.INVALID_OPERATION, 'no program error')
+  gl.useProgram(program)
+  t.ok(ext.executeBundle(inheritedBundle), 'executed with the recording program')
+  t.deepEquals(readPixel(gl), [255, 255, 0, 255], 'inherited program used')
+  gl.useProgram(null)
+  ext.deleteBundle(inheritedBundle)
+
+  // Changing a referenced buffer invalidates the bundle
+  gl.bindBuffer(gl.ARRAY_BUFFER, buffer)
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([0, 0]), gl.STATIC_DRAW)
+  t.notOk(ext.isBundleValid(bundle), 'bundle invalidated')
+  t.notOk(ext.executeBundle(bundle, new Float32Array(4)), 'invalid bundle not executed')
+  t.equals(gl.getError(), gl.INVALID_OPERATION, 'invalid bundle error')
+
+  ext.deleteBundle(bundle)
+  t.notOk(ext.isBundleValid(bundle), 'deleted bundle')
+
+  t.equals(gl.getError(), gl.NO_ERROR, 'no errors')
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
@@ -0,0 +1,73 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+
+function program (gl) {
+  function shader (type, src) {
+    const s = gl.createShader(type)
+    gl.shaderSource(s, src)
+    gl.compileShader(s)
+    return s
+  }
+  const p = gl.createProgram()
+  gl.attachShader(p, shader(gl.VERTEX_SHADER, 'attribute vec2 p; void main() { gl_Position = vec4(p, 0, 1); }'))
+  gl.attachShader(p, shader(gl.FRAGMENT_SHADER, 'void main() { gl_FragColor = vec4(1); }'))
+  gl.bindAttribLocation(p, 0, 'p')
+  gl.linkProgram(p)
+  return p
+}
+
+tape('cpu-budget', function (t) {
+  const gl = createContext(16, 16)
+  const ext = gl.getExtension('STACKGL_cpu_budget')
+  t.ok(ext, 'extension available')
+  t.ok(gl.getSupportedExtensions().indexOf('STACKGL_cpu_budget') >= 0, 'extension listed')
+
+  gl.useProgram(program(gl))
+  ext.resetStats()
+  gl.bindBuffer(gl.ARRAY_BUFFER, gl.createBuffer())
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([-1, -1, 1, -1, -1, 1]), gl.STATIC_DRAW)
+  gl.bindTexture(gl.TEXTURE_2D, gl.createTexture())
+  gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 2, 2, 0, gl.RGBA, gl.UNSIGNED_BYTE, new Uint8Array(16))
+  gl.enableVertexAttribArray(0)
+  gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0)
+  for (let i = 0; i < 10; ++i) {
+    gl.drawArrays(gl.TRIANGLES, 0, 3)
+  }
+  gl.finish()
+
+  const stats = ext.getStats()
+  t.equals(stats.draws, 10, 'draws counted')
+  t.equals(stats.uploads, 2, 'uploads counted')
+  t.equals(stats.uploadBytes, 24 + 16, 'upload bytes counted')
+  t.ok(stats.calls >= 10, 'calls counted')
+  t.ok(stats.cpuMs > 0, 'time counted')
+  t.ok(stats.finishMs >= 0 && stats.finishMs <= stats.cpuMs, 'finish is part of the call time')
+
+  ext.resetStats()
+  t.equals(ext.getStats().draws, 0, 'reset')
+
+  t.equals(ext.remainingBudget(), Infinity, 'no budget by default')
+  t.notOk(ext.overBudget(), 'not over without a budget')
+  ext.setBudget(1e-6)
+  for (let i = 0; i < 100; ++i) {
+    gl.drawArrays(gl.TRIANGLES, 0, 3)
+  }
+  t.ok(ext.overBudget(), 'over a tiny budget')
+  ext.resetStats()
+  ext.setBudget(1e6)
+  t.notOk(ext.overBudget(), 'within a large budget')
+  t.ok(ext.remainingBudget() > 0, 'remaining budget')
+
+  // Other contexts are not charged
+  const other = createContext(1, 1)
+  other.clear(other.COLOR_BUFFER_BIT)
+  other.getExtension('STACKGL_cpu_budget').resetStats()
+  t.equals(other.getExtension('STACKGL_cpu_budget').getStats().draws, 0, 'separate stats')
+  other.getExtension('STACKGL_destroy_context').destroy()
+
+  t.equals(gl.getError(), gl.NO_ERROR, 'no errors')
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
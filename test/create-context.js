@@ -2,6 +2,7 @@
 
 const tape = require('tape')
 const createContext = require('../index')
+const { WebGLRenderingContext } = require('../index')
 
 tape('create context', function (t) {
   const width = 10
@@ -9,3 +10,33 @@ tape('create context', function (t) {
   createContext(width, height)
   t.end()
 })
+
+tape('contexts share their methods', function (t) {
+  const gl1 = createContext(2, 2)
+  const gl2 = createContext(4, 4)
+
+  t.ok(gl1 instanceof WebGLRenderingContext, 'instanceof WebGLRenderingContext')
+  t.equals(gl1.constructor, WebGLRenderingContext, 'constructor')
+  t.equals(gl1.clearColor, gl2.clearColor, 'methods are shared')
+  t.equals(gl1.COLOR_BUFFER_BIT, 0x4000, 'constants are inherited')
+  t.deepEquals(Object.keys(gl1), [], 'no own properties')
+  t.equals(gl1._extensions, undefined, 'private state is hidden')
+  t.equals(gl1.destroy, undefined, 'destroy is private')
+  t.equals(gl1.resize, undefined, 'resize is private')
+  t.equals(gl1.bindVertexArrayOES, undefined, 'unwrapped natives are private')
+  t.equals(gl2.drawingBufferWidth, 4, 'drawing buffer width')
+
+  gl1.clearColor(1, 0, 0, 1)
+  gl1.clear(gl1.COLOR_BUFFER_BIT)
+  gl2.clearColor(0, 1, 0, 1)
+  gl2.clear(gl2.COLOR_BUFFER_BIT)
+  const pixel = new Uint8Array(4)
+  gl1.readPixels(0, 0, 1, 1, gl1.RGBA, gl1.UNSIGNED_BYTE, pixel)
+  t.deepEquals(Array.from(pixel), [255, 0, 0, 255], 'first context')
+  gl2.readPixels(0, 0, 1, 1, gl2.RGBA, gl2.UNSIGNED_BYTE, pixel)
+  t.deepEquals(Array.from(pixel), [0, 255, 0, 255], 'second context')
+
+  gl1.getExtension('STACKGL_destroy_context').destroy()
+  gl2.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
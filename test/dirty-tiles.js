@@ -0,0 +1,67 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+
+function readTiles (t, data) {
+  const tiles = []
+  let ptr = 4
+  for (let i = 0; i < data.readUInt32LE(0); ++i) {
+    const tile = {
+      x: data.readUInt32LE(ptr),
+      y: data.readUInt32LE(ptr + 4),
+      width: data.readUInt32LE(ptr + 8),
+      height: data.readUInt32LE(ptr + 12)
+    }
+    ptr += 16
+    tile.pixels = data.subarray(ptr, ptr + 4 * tile.width * tile.height)
+    ptr += tile.pixels.length
+    tiles.push(tile)
+  }
+  t.equals(ptr, data.length, 'packed buffer fully consumed')
+  return tiles
+}
+
+tape('dirty-tiles', function (t) {
+  const width = 20
+  const height = 12
+  const gl = createContext(width, height)
+  const ext = gl.getExtension('STACKGL_dirty_tiles')
+  t.ok(ext, 'extension supported')
+
+  const tracker = ext.createTileTracker({ tileSize: 8 })
+
+  gl.clearColor(0, 0, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  let result = tracker.read()
+  t.equals(result.count, 6, 'first read returns every tile')
+  const tiles = readTiles(t, result.data)
+  t.deepEquals(
+    tiles.map((tile) => [tile.x, tile.y, tile.width, tile.height]),
+    [[0, 0, 8, 8], [8, 0, 8, 8], [16, 0, 4, 8],
+      [0, 8, 8, 4], [8, 8, 8, 4], [16, 8, 4, 4]],
+    'tiles cover the region, edge tiles are clipped')
+
+  result = tracker.read()
+  t.equals(result.count, 0, 'unchanged frame returns no tiles')
+
+  // Paint the top-left pixel of the image, which is GL row height - 1
+  gl.enable(gl.SCISSOR_TEST)
+  gl.scissor(0, height - 1, 1, 1)
+  gl.clearColor(1, 0, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  gl.disable(gl.SCISSOR_TEST)
+
+  const changed = readTiles(t, tracker.read().data)
+  t.equals(changed.length, 1, 'one tile changed')
+  t.equals(changed[0].x, 0, 'changed tile x')
+  t.equals(changed[0].y, 0, 'changed tile y')
+  t.deepEquals(Array.from(changed[0].pixels.subarray(0, 8)), [255, 0, 0, 255, 0, 0, 0, 255],
+    'tile rows are top-down')
+
+  tracker.reset()
+  t.equals(tracker.read().count, 6, 'reset forces a full read')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
@@ -0,0 +1,47 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+
+function clearAndRead (gl, r, g, b) {
+  gl.clearColor(r / 255, g / 255, b / 255, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  const pixel = new Uint8Array(4)
+  gl.readPixels(0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixel)
+  return Array.from(pixel)
+}
+
+tape('displays', function (t) {
+  // Round robin over four displays, plus one on an explicit display
+  const contexts = []
+  for (let i = 0; i < 6; ++i) {
+    contexts.push(createContext(1, 1, { displays: 4 }))
+  }
+  contexts.push(createContext(1, 1, { display: 7 }))
+
+  contexts.forEach((gl, i) => {
+    t.ok(gl, 'context ' + i + ' created')
+    gl.bindTexture(gl.TEXTURE_2D, gl.createTexture())
+  })
+
+  // Switching between contexts on different displays keeps their state
+  for (let frame = 0; frame < 3; ++frame) {
+    contexts.forEach((gl, i) => {
+      t.deepEquals(clearAndRead(gl, 10 * i, frame, 0), [10 * i, frame, 0, 255],
+        'context ' + i + ' frame ' + frame)
+    })
+  }
+  contexts.forEach((gl, i) => {
+    t.ok(gl.isTexture(gl.getParameter(gl.TEXTURE_BINDING_2D)), 'context ' + i + ' texture')
+    t.equals(gl.getError(), gl.NO_ERROR, 'context ' + i + ' no errors')
+  })
+
+  contexts.forEach((gl) => gl.getExtension('STACKGL_destroy_context').destroy())
+
+  // Displays stay usable after all of their contexts are gone
+  const gl = createContext(1, 1, { displays: 4 })
+  t.deepEquals(clearAndRead(gl, 1, 2, 3), [1, 2, 3, 255], 'context after destroy')
+  gl.getExtension('STACKGL_destroy_context').destroy()
+
+  t.end()
+})
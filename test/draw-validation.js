@@ -0,0 +1,98 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+
+function createProgram (gl) {
+  const vs = `attribute vec2 position;
+attribute vec2 unused;
+void main() {
+  gl_PointSize = 1.0;
+  gl_Position = vec4(position, 0, 1);
+}`
+  const fs = `precision mediump float;
+void main() {
+  gl_FragColor = vec4(1, 0, 0, 1);
+}`
+  const vertShader = gl.createShader(gl.VERTEX_SHADER)
+  gl.shaderSource(vertShader, vs)
+  gl.compileShader(vertShader)
+  const fragShader = gl.createShader(gl.FRAGMENT_SHADER)
+  gl.shaderSource(fragShader, fs)
+  gl.compileShader(fragShader)
+  const program = gl.createProgram()
+  gl.attachShader(program, vertShader)
+  gl.attachShader(program, fragShader)
+  gl.bindAttribLocation(program, 0, 'position')
+  gl.linkProgram(program)
+  return program
+}
+
+tape('draw-validation', function (t) {
+  const gl = createContext(1, 1)
+
+  gl.drawArrays(gl.POINTS, 0, 1)
+  t.equals(gl.getError(), gl.INVALID_OPERATION, 'no program')
+
+  const program = createProgram(gl)
+  gl.useProgram(program)
+
+  const buffer = gl.createBuffer()
+  gl.bindBuffer(gl.ARRAY_BUFFER, buffer)
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array(8), gl.STATIC_DRAW)
+  gl.enableVertexAttribArray(0)
+  gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0)
+
+  gl.drawArrays(gl.POINTS, 0, 4)
+  t.equals(gl.getError(), gl.NO_ERROR, 'draw in range')
+  gl.drawArrays(gl.POINTS, 1, 4)
+  t.equals(gl.getError(), gl.INVALID_OPERATION, 'draw out of range')
+
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array(10), gl.STATIC_DRAW)
+  gl.drawArrays(gl.POINTS, 1, 4)
+  t.equals(gl.getError(), gl.NO_ERROR, 'buffer grown')
+
+  const elements = gl.createBuffer()
+  gl.bindBuffer(gl.ELEMENT_ARRAY_BUFFER, elements)
+  gl.bufferData(gl.ELEMENT_ARRAY_BUFFER, new Uint16Array([0, 1, 4, 2]), gl.STATIC_DRAW)
+  gl.drawElements(gl.POINTS, 4, gl.UNSIGNED_SHORT, 0)
+  t.equals(gl.getError(), gl.NO_ERROR, 'indices in range')
+  gl.drawElements(gl.POINTS, 4, gl.UNSIGNED_SHORT, 2)
+  t.equals(gl.getError(), gl.INVALID_OPERATION, 'element range past the end')
+
+  gl.bufferSubData(gl.ELEMENT_ARRAY_BUFFER, 4, new Uint16Array([5]))
+  gl.drawElements(gl.POINTS, 4, gl.UNSIGNED_SHORT, 0)
+  t.equals(gl.getError(), gl.INVALID_OPERATION, 'updated index out of range')
+  gl.bufferSubData(gl.ELEMENT_ARRAY_BUFFER, 4, new Uint16Array([3]))
+  gl.drawElements(gl.POINTS, 4, gl.UNSIGNED_SHORT, 0)
+  t.equals(gl.getError(), gl.NO_ERROR, 'index back in range')
+
+  // Enabled attributes need a buffer, even if the program does not use them
+  gl.bindBuffer(gl.ARRAY_BUFFER, null)
+  gl.enableVertexAttribArray(1)
+  gl.vertexAttribPointer(1, 2, gl.FLOAT, false, 0, 0)
+  t.equals(gl.getError(), gl.INVALID_OPERATION, 'pointer without buffer')
+  gl.drawArrays(gl.POINTS, 0, 1)
+  t.equals(gl.getError(), gl.INVALID_OPERATION, 'enabled attribute without buffer')
+  gl.disableVertexAttribArray(1)
+
+  gl.deleteBuffer(buffer)
+  gl.drawArrays(gl.POINTS, 0, 1)
+  t.equals(gl.getError(), gl.NO_ERROR, 'deleted buffer released from attribute')
+
+  const ext = gl.getExtension('ANGLE_instanced_arrays')
+  const instances = gl.createBuffer()
+  gl.bindBuffer(gl.ARRAY_BUFFER, instances)
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array(4), gl.STATIC_DRAW)
+  gl.enableVertexAttribArray(0)
+  gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0)
+  ext.vertexAttribDivisorANGLE(0, 1)
+  ext.drawArraysInstancedANGLE(gl.POINTS, 0, 1, 2)
+  t.equals(gl.getError(), gl.INVALID_OPERATION, 'instanced draw needs a divisor 0 attribute')
+  ext.vertexAttribDivisorANGLE(0, 0)
+  ext.drawArraysInstancedANGLE(gl.POINTS, 0, 2, 3)
+  t.equals(gl.getError(), gl.NO_ERROR, 'instanced draw in range')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
@@ -0,0 +1,82 @@
+'use strict'
+
+const tape = require('tape')
+const fs = require('fs')
+const createContext = require('../index')
+
+const HEADER_SIZE = 64
+const SLOT_HEADER_SIZE = 32
+
+tape('frame-ring', { skip: process.platform !== 'linux' }, function (t) {
+  const width = 4
+  const height = 2
+  const gl = createContext(width, height)
+  const ext = gl.getExtension('STACKGL_frame_ring')
+  t.ok(ext, 'extension supported')
+
+  const name = 'headless-gl-test-' + process.pid
+  const ring = ext.createFrameRing(name, { slots: 2 })
+  t.throws(function () {
+    ext.createFrameRing(name + '-other')
+  }, 'only one ring per context')
+
+  const colors = [[255, 0, 0], [0, 255, 0], [0, 0, 255]]
+  for (let i = 0; i < colors.length; ++i) {
+    const c = colors[i]
+    gl.clearColor(c[0] / 255, c[1] / 255, c[2] / 255, 1)
+    gl.clear(gl.COLOR_BUFFER_BIT)
+    t.equals(ring.write(), i, 'frame ' + i + ' published')
+  }
+
+  // Map the ring the way another process would
+  const shm = fs.readFileSync('/dev/shm/' + name)
+  t.equals(shm.readUInt32LE(0), 0x474c5246, 'magic')
+  t.equals(shm.readUInt32LE(8), 2, 'slot count')
+  t.equals(shm.readUInt32LE(16), width, 'width')
+  t.equals(shm.readUInt32LE(20), height, 'height')
+  t.equals(Number(shm.readBigUInt64LE(40)), 3, 'frame count')
+
+  const slotStride = Number(shm.readBigUInt64LE(32))
+  const latest = HEADER_SIZE + (2 % 2) * slotStride
+  t.equals(Number(shm.readBigUInt64LE(latest)) % 2, 0, 'slot is not being written')
+  t.equals(Number(shm.readBigUInt64LE(latest + 8)), 2, 'slot holds frame 2')
+  t.deepEquals(
+    Array.from(shm.subarray(latest + SLOT_HEADER_SIZE, latest + SLOT_HEADER_SIZE + 4)),
+    [0, 0, 255, 255],
+    'slot pixels')
+
+  // present() publishes the frame it ends
+  gl.clearColor(1, 1, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  gl.getExtension('STACKGL_present').present()
+
+  // A rectangle of the read framebuffer goes into the next slot
+  gl.clearColor(0, 1, 1, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  t.equals(ring.readPixels(1, 0, 2, 1), 4, 'readPixels published as frame 4')
+  t.equals(ring.readPixels(3, 0, 2, 1), -1, 'rectangle out of bounds')
+  t.equals(gl.getError(), gl.INVALID_VALUE, 'out of bounds is an error')
+
+  const after = fs.readFileSync('/dev/shm/' + name)
+  t.equals(Number(after.readBigUInt64LE(40)), 5, 'frame count after present and readPixels')
+  const presented = HEADER_SIZE + (3 % 2) * slotStride
+  t.equals(Number(after.readBigUInt64LE(presented + 8)), 3, 'slot holds presented frame')
+  t.deepEquals(
+    Array.from(after.subarray(presented + SLOT_HEADER_SIZE, presented + SLOT_HEADER_SIZE + 4)),
+    [255, 255, 0, 255],
+    'presented pixels')
+  const rect = HEADER_SIZE + (4 % 2) * slotStride
+  t.equals(after.readUInt32LE(rect + 16), 2, 'rectangle width')
+  t.equals(after.readUInt32LE(rect + 20), 1, 'rectangle height')
+  t.deepEquals(
+    Array.from(after.subarray(rect + SLOT_HEADER_SIZE, rect + SLOT_HEADER_SIZE + 8)),
+    [0, 255, 255, 255, 0, 255, 255, 255],
+    'rectangle pixels')
+
+  ring.close()
+  t.notOk(fs.existsSync('/dev/shm/' + name), 'ring unlinked on close')
+  t.equals(ring.write(), -1, 'closed ring ignores writes')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
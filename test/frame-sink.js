@@ -0,0 +1,78 @@
+'use strict'
+
+const tape = require('tape')
+const fs = require('fs')
+const os = require('os')
+const path = require('path')
+const { PassThrough } = require('stream')
+const createContext = require('../index')
+
+tape('frame-sink y4m to file descriptor', function (t) {
+  const width = 6
+  const height = 4
+  const gl = createContext(width, height)
+  const ext = gl.getExtension('STACKGL_frame_sink')
+  t.ok(ext, 'extension supported')
+
+  const file = path.join(os.tmpdir(), 'headless-gl-frame-sink-' + process.pid + '.y4m')
+  const fd = fs.openSync(file, 'w')
+  const sink = ext.createFrameSink(fd, { fps: 25, queueLength: 2 })
+
+  for (let i = 0; i < 5; ++i) {
+    gl.clearColor(1, 1, 1, 1)
+    gl.clear(gl.COLOR_BUFFER_BIT)
+    t.ok(sink.writeFrame(), 'frame ' + i + ' queued')
+  }
+  sink.close()
+  fs.closeSync(fd)
+
+  const data = fs.readFileSync(file)
+  fs.unlinkSync(file)
+
+  const header = data.toString('latin1', 0, data.indexOf(10) + 1)
+  t.equals(header.indexOf('YUV4MPEG2 W6 H4 F25000:1000'), 0, 'stream header')
+  const frameSize = 'FRAME\n'.length + width * height * 3 / 2
+  t.equals(data.length, header.length + 5 * frameSize, 'five frames written')
+
+  const y = data[header.length + 'FRAME\n'.length]
+  const u = data[header.length + 'FRAME\n'.length + width * height]
+  t.equals(y, 235, 'white is limited range peak luma')
+  t.equals(u, 128, 'white has neutral chroma')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
+
+tape('frame-sink nv12 to stream', function (t) {
+  const width = 8
+  const height = 2
+  const gl = createContext(width, height)
+  const stream = new PassThrough()
+  const chunks = []
+  stream.on('data', (chunk) => chunks.push(chunk))
+
+  const sink = gl.getExtension('STACKGL_frame_sink').createFrameSink(stream, {
+    format: 'nv12',
+    range: 'full'
+  })
+
+  gl.clearColor(1, 0, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  sink.writeFrame()
+
+  const frame = Buffer.concat(chunks)
+  t.equals(frame.length, width * height * 3 / 2, 'raw nv12 frame size')
+  t.equals(frame[0], 76, 'bt601 full range luma of red')
+  t.equals(frame[width * height], 85, 'Cb of red')
+  t.equals(frame[width * height + 1], 255, 'Cr of red')
+
+  t.throws(function () {
+    gl.getExtension('STACKGL_frame_sink').createFrameSink(stream, {
+      format: 'nv12',
+      container: 'y4m'
+    })
+  }, 'y4m requires i420')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
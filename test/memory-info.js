@@ -0,0 +1,89 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+
+tape('memory-info', function (t) {
+  const gl = createContext(16, 16)
+  const ext = gl.getExtension('STACKGL_memory_info')
+  t.ok(ext, 'extension available')
+  t.ok(gl.getSupportedExtensions().indexOf('STACKGL_memory_info') >= 0, 'extension listed')
+
+  // The drawing buffer is counted from the start
+  const base = ext.getMemoryInfo()
+  t.ok(base.textures >= 16 * 16 * 4, 'drawing buffer counted')
+  t.equals(base.total, base.textures + base.renderbuffers + base.buffers, 'total')
+  t.equals(base.budget, 0, 'no budget by default')
+
+  const texture = gl.createTexture()
+  gl.bindTexture(gl.TEXTURE_2D, texture)
+  gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 32, 32, 0, gl.RGBA, gl.UNSIGNED_BYTE, null)
+  t.equals(ext.getMemoryInfo().textures - base.textures, 32 * 32 * 4, 'texImage2D')
+
+  gl.generateMipmap(gl.TEXTURE_2D)
+  const mipmaps = (16 * 16 + 8 * 8 + 4 * 4 + 2 * 2 + 1) * 4
+  t.equals(ext.getMemoryInfo().textures - base.textures, 32 * 32 * 4 + mipmaps, 'generateMipmap')
+
+  gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 8, 8, 0, gl.RGBA, gl.UNSIGNED_BYTE, null)
+  t.equals(ext.getMemoryInfo().textures - base.textures, 8 * 8 * 4 + mipmaps, 'level replaced')
+
+  // Calls the driver rejects are not counted
+  const maxSize = gl.getParameter(gl.MAX_TEXTURE_SIZE)
+  gl.texImage2D(gl.TEXTURE_2D, 1, gl.RGBA, maxSize * 2, 1, 0, gl.RGBA, gl.UNSIGNED_BYTE, null)
+  t.equals(gl.getError(), gl.INVALID_VALUE, 'texImage2D rejected')
+  t.equals(ext.getMemoryInfo().textures - base.textures, 8 * 8 * 4 + mipmaps, 'rejected level not counted')
+
+  const copy = gl.createTexture()
+  gl.bindTexture(gl.TEXTURE_2D, copy)
+  gl.copyTexImage2D(gl.TEXTURE_2D, 0, gl.RGB, 0, 0, 4, 4, 0)
+  t.equals(ext.getMemoryInfo().textures - base.textures, 8 * 8 * 4 + mipmaps + 4 * 4 * 3, 'copyTexImage2D')
+
+  const buffer = gl.createBuffer()
+  gl.bindBuffer(gl.ARRAY_BUFFER, buffer)
+  gl.bufferData(gl.ARRAY_BUFFER, 1000, gl.STATIC_DRAW)
+  gl.bufferData(gl.ARRAY_BUFFER, new Uint8Array(600), gl.STATIC_DRAW)
+  t.equals(ext.getMemoryInfo().buffers - base.buffers, 600, 'bufferData')
+
+  const renderbuffer = gl.createRenderbuffer()
+  gl.bindRenderbuffer(gl.RENDERBUFFER, renderbuffer)
+  gl.renderbufferStorage(gl.RENDERBUFFER, gl.RGBA4, 8, 8)
+  t.equals(ext.getMemoryInfo().renderbuffers - base.renderbuffers, 8 * 8 * 2, 'renderbufferStorage')
+  t.equals(gl.getError(), gl.NO_ERROR, 'no errors allocating')
+
+  // Allocations over the budget fail, shrinking always works
+  const used = ext.getMemoryInfo().total
+  ext.setBudget(used + 100)
+  t.equals(ext.getBudget(), used + 100, 'budget set')
+
+  gl.bindTexture(gl.TEXTURE_2D, texture)
+  gl.texImage2D(gl.TEXTURE_2D, 1, gl.RGBA, 64, 64, 0, gl.RGBA, gl.UNSIGNED_BYTE, null)
+  t.equals(gl.getError(), gl.OUT_OF_MEMORY, 'texImage2D over budget')
+  gl.bufferData(gl.ARRAY_BUFFER, 1000, gl.STATIC_DRAW)
+  t.equals(gl.getError(), gl.OUT_OF_MEMORY, 'bufferData over budget')
+  t.equals(gl.getBufferParameter(gl.ARRAY_BUFFER, gl.BUFFER_SIZE), 600, 'buffer unchanged')
+  gl.renderbufferStorage(gl.RENDERBUFFER, gl.RGBA4, 64, 64)
+  t.equals(gl.getError(), gl.OUT_OF_MEMORY, 'renderbufferStorage over budget')
+  t.equals(ext.getMemoryInfo().total, used, 'nothing allocated over budget')
+
+  gl.bufferData(gl.ARRAY_BUFFER, 700, gl.STATIC_DRAW)
+  t.equals(gl.getError(), gl.NO_ERROR, 'allocation within budget')
+  ext.setBudget(1)
+  gl.bufferData(gl.ARRAY_BUFFER, 100, gl.STATIC_DRAW)
+  t.equals(gl.getError(), gl.NO_ERROR, 'shrinking over budget')
+  ext.setBudget(0)
+
+  gl.deleteTexture(texture)
+  gl.deleteTexture(copy)
+  gl.deleteBuffer(buffer)
+  gl.deleteRenderbuffer(renderbuffer)
+  t.deepEquals(ext.getMemoryInfo(), base, 'deletes give memory back')
+
+  // Objects deleted by a reset are given back too
+  gl.bindTexture(gl.TEXTURE_2D, gl.createTexture())
+  gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 8, 8, 0, gl.RGBA, gl.UNSIGNED_BYTE, null)
+  gl.getExtension('STACKGL_reset_context').reset()
+  t.deepEquals(ext.getMemoryInfo(), base, 'reset gives memory back')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
@@ -0,0 +1,60 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+const { gl: nativeGL } = require('../src/javascript/native-gl')
+
+const COUNT = 2000
+
+tape('object-registry', function (t) {
+  const gl = createContext(1, 1)
+  const ext = gl.getExtension('STACKGL_reset_context')
+
+  const buffers = []
+  const textures = []
+  for (let i = 0; i < COUNT; ++i) {
+    buffers.push(gl.createBuffer())
+    textures.push(gl.createTexture())
+  }
+
+  // Delete out of creation order, so names move around in the registry
+  for (let i = COUNT - 1; i >= 0; i -= 3) {
+    gl.deleteBuffer(buffers[i])
+    gl.deleteTexture(textures[i])
+  }
+  for (let i = 0; i < COUNT; i += 3) {
+    gl.deleteBuffer(buffers[i])
+  }
+  t.equals(gl.getError(), gl.NO_ERROR, 'no errors deleting')
+
+  // Freed names are handed out again and must be tracked again
+  const reused = []
+  for (let i = 0; i < COUNT / 2; ++i) {
+    reused.push(gl.createBuffer())
+  }
+
+  const live = buffers.concat(reused).filter((b) => gl.isBuffer(b))
+  for (const buffer of live) {
+    gl.bindBuffer(gl.ARRAY_BUFFER, buffer)
+  }
+  gl.bindBuffer(gl.ARRAY_BUFFER, null)
+  t.ok(live.length > 0, 'live buffers')
+  const names = live.map((b) => b._)
+  t.ok(names.every((name) => nativeGL.isBuffer.call(gl, name)), 'native buffers exist')
+
+  // Everything still registered is deleted by the reset. The wrappers are
+  // zeroed either way, so the raw names are checked with glIsBuffer
+  ext.reset()
+  t.notOk(names.some((name) => nativeGL.isBuffer.call(gl, name)), 'native buffers deleted by reset')
+  t.notOk(live.some((b) => gl.isBuffer(b)), 'buffer wrappers deleted by reset')
+  const buffer = gl.createBuffer()
+  gl.bindBuffer(gl.ARRAY_BUFFER, buffer)
+  t.ok(gl.isBuffer(buffer), 'buffer created after reset')
+  t.equals(gl.getError(), gl.NO_ERROR, 'no errors after reset')
+
+  for (let i = 0; i < COUNT; ++i) {
+    gl.createTexture()
+  }
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
@@ -0,0 +1,90 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+
+function readCorner (gl) {
+  const pixel = new Uint8Array(4)
+  gl.readPixels(0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixel)
+  return Array.from(pixel)
+}
+
+tape('present - preserveDrawingBuffer false', function (t) {
+  const gl = createContext(16, 16)
+  const ext = gl.getExtension('STACKGL_present')
+  t.ok(ext, 'extension supported')
+
+  gl.clearColor(1, 0, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  t.deepEquals(readCorner(gl), [255, 0, 0, 255], 'frame rendered')
+
+  ext.present()
+  t.deepEquals(readCorner(gl), [0, 0, 0, 0], 'drawing buffer cleared')
+  t.deepEquals(Array.from(gl.getParameter(gl.COLOR_CLEAR_VALUE)), [1, 0, 0, 1], 'clear color kept')
+  t.equals(gl.getError(), gl.NO_ERROR, 'no errors')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
+
+tape('present - preserveDrawingBuffer true', function (t) {
+  const gl = createContext(16, 16, { preserveDrawingBuffer: true })
+  const ext = gl.getExtension('STACKGL_present')
+
+  gl.clearColor(0, 0, 1, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  ext.present()
+  t.deepEquals(readCorner(gl), [0, 0, 255, 255], 'drawing buffer preserved')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
+
+tape('present - user framebuffer stays bound', function (t) {
+  const gl = createContext(16, 16)
+  const ext = gl.getExtension('STACKGL_present')
+  const framebuffer = gl.createFramebuffer()
+  gl.bindFramebuffer(gl.FRAMEBUFFER, framebuffer)
+  ext.present()
+  t.equals(gl.getParameter(gl.FRAMEBUFFER_BINDING), framebuffer, 'binding restored')
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
+
+tape('EXT_discard_framebuffer', function (t) {
+  const gl = createContext(16, 16)
+  const ext = gl.getExtension('EXT_discard_framebuffer')
+  if (!ext) {
+    t.skip('extension not supported')
+    gl.getExtension('STACKGL_destroy_context').destroy()
+    t.end()
+    return
+  }
+
+  ext.discardFramebufferEXT(gl.FRAMEBUFFER, [ext.COLOR_EXT, ext.DEPTH_EXT])
+  t.equals(gl.getError(), gl.NO_ERROR, 'default framebuffer attachments')
+
+  ext.discardFramebufferEXT(gl.FRAMEBUFFER, [gl.COLOR_ATTACHMENT0])
+  t.equals(gl.getError(), gl.INVALID_ENUM, 'attachment names rejected for default framebuffer')
+
+  const texture = gl.createTexture()
+  gl.bindTexture(gl.TEXTURE_2D, texture)
+  gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 16, 16, 0, gl.RGBA, gl.UNSIGNED_BYTE, null)
+  const framebuffer = gl.createFramebuffer()
+  gl.bindFramebuffer(gl.FRAMEBUFFER, framebuffer)
+  gl.framebufferTexture2D(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, gl.TEXTURE_2D, texture, 0)
+
+  ext.discardFramebufferEXT(gl.FRAMEBUFFER, [gl.COLOR_ATTACHMENT0])
+  t.equals(gl.getError(), gl.NO_ERROR, 'framebuffer object attachments')
+
+  ext.discardFramebufferEXT(gl.FRAMEBUFFER, [ext.COLOR_EXT])
+  t.equals(gl.getError(), gl.INVALID_ENUM, 'default names rejected for framebuffer object')
+
+  ext.discardFramebufferEXT(gl.RENDERBUFFER, [gl.COLOR_ATTACHMENT0])
+  t.equals(gl.getError(), gl.INVALID_ENUM, 'bad target')
+
+  t.throws(function () { ext.discardFramebufferEXT(gl.FRAMEBUFFER) }, TypeError, 'missing attachments')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
@@ -0,0 +1,88 @@
+'use strict'
+
+const tape = require('tape')
+const zlib = require('zlib')
+const createContext = require('../index')
+
+function collect (stream, cb) {
+  const chunks = []
+  stream.on('data', (chunk) => chunks.push(chunk))
+  stream.on('error', cb)
+  stream.on('end', () => cb(null, chunks))
+}
+
+function fillRows (gl, width, height) {
+  gl.enable(gl.SCISSOR_TEST)
+  for (let row = 0; row < height; ++row) {
+    gl.scissor(0, row, width, 1)
+    gl.clearColor(row / 255, 0, 1, 1)
+    gl.clear(gl.COLOR_BUFFER_BIT)
+  }
+  gl.disable(gl.SCISSOR_TEST)
+}
+
+tape('readback-stream raw bands', function (t) {
+  const width = 16
+  const height = 37
+  const gl = createContext(width, height)
+  fillRows(gl, width, height)
+
+  const ext = gl.getExtension('STACKGL_readback_stream')
+  t.ok(ext, 'extension supported')
+  t.ok(gl.getSupportedExtensions().indexOf('STACKGL_readback_stream') >= 0, 'extension listed')
+
+  collect(ext.createReadStream({ bandHeight: 8 }), function (err, bands) {
+    t.error(err, 'no stream error')
+    t.equals(bands.length, 5, 'band count')
+    t.equals(bands[4].length, 4 * width * 5, 'last band is partial')
+
+    const image = Buffer.concat(bands)
+    t.equals(image.length, 4 * width * height, 'image size')
+
+    const pixels = new Uint8Array(4 * width * height)
+    gl.readPixels(0, 0, width, height, gl.RGBA, gl.UNSIGNED_BYTE, pixels)
+    let ok = true
+    for (let row = 0; row < height; ++row) {
+      const streamed = image.subarray(4 * width * row, 4 * width * (row + 1))
+      const glRow = height - 1 - row
+      const read = pixels.subarray(4 * width * glRow, 4 * width * (glRow + 1))
+      ok = ok && Buffer.compare(streamed, Buffer.from(read)) === 0
+    }
+    t.ok(ok, 'bands are top-down rows of the framebuffer')
+
+    gl.getExtension('STACKGL_destroy_context').destroy()
+    t.end()
+  })
+})
+
+tape('readback-stream png encoding', function (t) {
+  const width = 8
+  const height = 8
+  const gl = createContext(width, height)
+  fillRows(gl, width, height)
+
+  const stream = gl.getExtension('STACKGL_readback_stream')
+    .createReadStream({ bandHeight: 3, encoding: 'png' })
+
+  collect(stream, function (err, chunks) {
+    t.error(err, 'no stream error')
+    const png = Buffer.concat(chunks)
+    t.equals(png.toString('latin1', 1, 4), 'PNG', 'png signature')
+
+    const idat = []
+    let ptr = 8
+    while (ptr < png.length) {
+      const length = png.readUInt32BE(ptr)
+      if (png.toString('ascii', ptr + 4, ptr + 8) === 'IDAT') {
+        idat.push(png.subarray(ptr + 8, ptr + 8 + length))
+      }
+      ptr += 12 + length
+    }
+    const raw = zlib.inflateSync(Buffer.concat(idat))
+    t.equals(raw.length, height * (4 * width + 1), 'filtered scanline size')
+    t.equals(raw[1], height - 1, 'first scanline is the top row')
+
+    gl.getExtension('STACKGL_destroy_context').destroy()
+    t.end()
+  })
+})
@@ -0,0 +1,87 @@
+'use strict'
+
+const tape = require('tape')
+const v8 = require('v8')
+const vm = require('vm')
+const createContext = require('../index')
+
+v8.setFlagsFromString('--expose-gc')
+const gc = vm.runInNewContext('gc')
+
+const COUNT = 100
+
+function createGarbage (gl) {
+  for (let i = 0; i < COUNT; ++i) {
+    gl.createTexture()
+    gl.createBuffer()
+    gl.createRenderbuffer()
+    gl.createFramebuffer()
+  }
+}
+
+// Finalizers run on later turns of the event loop, and the queued names
+// are released from an immediate after that
+async function collect (tables, expected) {
+  for (let i = 0; i < 50; ++i) {
+    gc()
+    await new Promise((resolve) => setImmediate(resolve))
+    await new Promise((resolve) => setImmediate(resolve))
+    if (tables.every((table, j) => Object.keys(table).length <= expected[j])) {
+      return true
+    }
+  }
+  return false
+}
+
+tape('release-unreachable', async function (t) {
+  const gl = createContext(4, 4, { releaseUnreachable: true })
+
+  // Objects that are still in use, without a reference from the test
+  const framebuffer = gl.createFramebuffer()
+  gl.bindFramebuffer(gl.FRAMEBUFFER, framebuffer)
+  gl.framebufferTexture2D(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, gl.TEXTURE_2D, (() => {
+    const texture = gl.createTexture()
+    gl.bindTexture(gl.TEXTURE_2D, texture)
+    gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 4, 4, 0, gl.RGBA, gl.UNSIGNED_BYTE, null)
+    return texture
+  })(), 0)
+  gl.bindTexture(gl.TEXTURE_2D, gl.createTexture())
+  gl.bindBuffer(gl.ARRAY_BUFFER, gl.createBuffer())
+
+  // Deleted explicitly and then dropped, which must not release it twice
+  gl.deleteTexture(gl.createTexture())
+
+  const ctx = framebuffer._ctx
+  const tables = [ctx._textures, ctx._buffers, ctx._renderbuffers, ctx._framebuffers]
+  const before = tables.map((table) => Object.keys(table).length)
+  createGarbage(gl)
+  t.ok(tables.every((table, i) => Object.keys(table).length === before[i] + COUNT), 'objects tracked')
+
+  t.ok(await collect(tables, before), 'unreachable objects released')
+  t.equals(gl.getError(), gl.NO_ERROR, 'no errors releasing')
+
+  t.equals(gl.checkFramebufferStatus(gl.FRAMEBUFFER), gl.FRAMEBUFFER_COMPLETE, 'attached texture kept')
+  t.ok(gl.isTexture(gl.getParameter(gl.TEXTURE_BINDING_2D)), 'bound texture kept')
+  t.ok(gl.isBuffer(gl.getParameter(gl.ARRAY_BUFFER_BINDING)), 'bound buffer kept')
+  gl.clearColor(1, 0, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  const pixel = new Uint8Array(4)
+  gl.readPixels(0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixel)
+  t.deepEquals(Array.from(pixel), [255, 0, 0, 255], 'render to kept framebuffer')
+
+  // Names queued when the context goes away are dropped with it
+  createGarbage(gl)
+  gc()
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  await new Promise((resolve) => setImmediate(resolve))
+  t.pass('destroy with pending releases')
+
+  // Without the option, objects live until they are deleted
+  const strong = createContext(1, 1)
+  const strongCtx = strong.createTexture()._ctx
+  const count = Object.keys(strongCtx._textures).length
+  createGarbage(strong)
+  t.notOk(await collect([strongCtx._textures], [count]), 'objects kept without the option')
+  strong.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
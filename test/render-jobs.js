@@ -0,0 +1,96 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+
+const VERTEX_SHADER = `attribute vec2 position;
+attribute vec2 uv;
+varying vec2 vUv;
+void main() {
+  vUv = uv;
+  gl_Position = vec4(position, 0, 1);
+}`
+
+const FRAGMENT_SHADER = `precision mediump float;
+uniform vec4 tint;
+uniform sampler2D image;
+varying vec2 vUv;
+void main() {
+  gl_FragColor = tint * texture2D(image, vUv);
+}`
+
+function job (index) {
+  return {
+    width: 4,
+    height: 4,
+    vertexShader: VERTEX_SHADER,
+    fragmentShader: FRAGMENT_SHADER,
+    clearColor: [0, 0, 1, 1],
+    // Left half of the target
+    attributes: {
+      position: [-1, -1, 0, -1, -1, 1, 0, 1],
+      uv: [0, 0, 1, 0, 0, 1, 1, 1]
+    },
+    elements: [0, 1, 2, 1, 3, 2],
+    textures: {
+      image: { width: 1, height: 1, data: new Uint8Array([255, 255, 255, 255]), filter: 'nearest' }
+    },
+    uniforms: {
+      tint: [index / 255, 1, 0, 1]
+    },
+    draws: [{ mode: 4, first: 0, count: 6 }]
+  }
+}
+
+tape('render-jobs', function (t) {
+  const gl = createContext(1, 1, { renderThreads: 2, renderQueueDepth: 2 })
+
+  // More jobs than the queue holds, so some wait for a free slot
+  const jobs = []
+  for (let i = 0; i < 8; ++i) {
+    jobs.push(gl.submit(job(10 * i)))
+  }
+
+  Promise.all(jobs).then((results) => {
+    results.forEach(({ pixels, timing }, i) => {
+      t.equals(pixels.length, 4 * 4 * 4, 'job ' + i + ' size')
+      t.deepEquals(Array.from(pixels.subarray(0, 4)), [10 * i, 255, 0, 255], 'job ' + i + ' draw')
+      t.deepEquals(Array.from(pixels.subarray(12, 16)), [0, 0, 255, 255], 'job ' + i + ' clear')
+      t.ok(timing.renderMs >= 0 && timing.queueMs >= 0, 'job ' + i + ' timing')
+    })
+    t.equals(gl.getError(), gl.NO_ERROR, 'context untouched')
+
+    const broken = job(0)
+    broken.fragmentShader = 'void main() { nope }'
+    return gl.submit(broken).then(
+      () => t.fail('bad shader resolved'),
+      (err) => t.ok(/compile/.test(err.message), 'bad shader rejected'))
+  }).then(() => {
+    const outOfRange = job(0)
+    outOfRange.elements = [0, 1, 4]
+    return gl.submit(outOfRange).then(
+      () => t.fail('bad index resolved'),
+      (err) => t.ok(err instanceof RangeError, 'out of range index rejected'))
+  }).then(() => {
+    // Too many indices to spread into Math.max
+    const large = job(0)
+    large.elements = []
+    for (let i = 0; i < 300000; ++i) {
+      large.elements.push(i % 4)
+    }
+    large.draws = [{ mode: 4, first: 0, count: 6 }]
+    const empty = job(0)
+    empty.elements = []
+    empty.draws = []
+    return Promise.all([gl.submit(large), gl.submit(empty)]).then(([a, b]) => {
+      t.deepEquals(Array.from(a.pixels.subarray(0, 4)), [0, 255, 0, 255], 'large index list drawn')
+      t.deepEquals(Array.from(b.pixels.subarray(0, 4)), [0, 0, 255, 255], 'empty index list only clears')
+    })
+  }).then(() => {
+    const pending = gl.submit(job(0))
+    gl.getExtension('STACKGL_destroy_context').destroy()
+    return pending.then(
+      () => t.pass('finished before destroy'),
+      (err) => t.ok(/destroyed/.test(err.message), 'pending job rejected by destroy'))
+  }).then(() => t.end(), t.end)
+})
@@ -0,0 +1,116 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+
+function dirty (gl) {
+  const texture = gl.createTexture()
+  gl.bindTexture(gl.TEXTURE_2D, texture)
+  gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 1, 1, 0, gl.RGBA, gl.UNSIGNED_BYTE, new Uint8Array(4))
+  const buffer = gl.createBuffer()
+  gl.bindBuffer(gl.ARRAY_BUFFER, buffer)
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array(6), gl.STATIC_DRAW)
+  gl.enableVertexAttribArray(1)
+  const framebuffer = gl.createFramebuffer()
+  gl.bindFramebuffer(gl.FRAMEBUFFER, framebuffer)
+  gl.framebufferTexture2D(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, gl.TEXTURE_2D, texture, 0)
+  const program = gl.createProgram()
+  const shader = gl.createShader(gl.VERTEX_SHADER)
+  const drawBuffersExt = gl.getExtension('WEBGL_draw_buffers')
+  if (drawBuffersExt) {
+    gl.bindFramebuffer(gl.FRAMEBUFFER, null)
+    drawBuffersExt.drawBuffersWEBGL([gl.NONE])
+    gl.bindFramebuffer(gl.FRAMEBUFFER, framebuffer)
+  }
+  gl.activeTexture(gl.TEXTURE3)
+  gl.enable(gl.BLEND)
+  gl.enable(gl.DEPTH_TEST)
+  gl.enable(gl.SCISSOR_TEST)
+  gl.scissor(0, 0, 1, 1)
+  gl.colorMask(true, false, true, false)
+  gl.blendFunc(gl.SRC_ALPHA, gl.ONE_MINUS_SRC_ALPHA)
+  gl.clearColor(1, 0, 0, 1)
+  gl.pixelStorei(gl.UNPACK_FLIP_Y_WEBGL, true)
+  gl.pixelStorei(gl.UNPACK_ALIGNMENT, 1)
+  const derivativesExt = gl.getExtension('OES_standard_derivatives')
+  if (derivativesExt) {
+    gl.hint(derivativesExt.FRAGMENT_SHADER_DERIVATIVE_HINT_OES, gl.NICEST)
+  }
+  const vaoExt = gl.getExtension('OES_vertex_array_object')
+  const vao = vaoExt.createVertexArrayOES()
+  vaoExt.bindVertexArrayOES(vao)
+  return { texture, buffer, framebuffer, program, shader, vao, vaoExt }
+}
+
+tape('reset-context', function (t) {
+  const gl = createContext(8, 8)
+  const ext = gl.getExtension('STACKGL_reset_context')
+  t.ok(ext, 'extension available')
+  t.ok(gl.getSupportedExtensions().indexOf('STACKGL_reset_context') >= 0, 'extension listed')
+  const budgetExt = gl.getExtension('STACKGL_cpu_budget')
+  budgetExt.setBudget(1000)
+
+  for (let round = 0; round < 3; ++round) {
+    const objects = dirty(gl)
+    gl.bindTexture(gl.TEXTURE_2D, gl.createTexture())
+    gl.getError()
+    ext.reset()
+
+    t.equals(gl.getError(), gl.NO_ERROR, round + ': no errors')
+    t.notOk(gl.isTexture(objects.texture), round + ': texture deleted')
+    t.notOk(gl.isBuffer(objects.buffer), round + ': buffer deleted')
+    t.notOk(gl.isFramebuffer(objects.framebuffer), round + ': framebuffer deleted')
+    t.notOk(gl.isProgram(objects.program), round + ': program deleted')
+    t.notOk(gl.isShader(objects.shader), round + ': shader deleted')
+    t.notOk(objects.vaoExt.isVertexArrayOES(objects.vao), round + ': vertex array deleted')
+
+    t.equals(gl.getParameter(gl.BLEND), false, round + ': blend')
+    t.equals(gl.getParameter(gl.DEPTH_TEST), false, round + ': depth test')
+    t.equals(gl.getParameter(gl.SCISSOR_TEST), false, round + ': scissor test')
+    t.deepEquals(Array.from(gl.getParameter(gl.SCISSOR_BOX)), [0, 0, 8, 8], round + ': scissor box')
+    t.deepEquals(Array.from(gl.getParameter(gl.VIEWPORT)), [0, 0, 8, 8], round + ': viewport')
+    t.deepEquals(gl.getParameter(gl.COLOR_WRITEMASK), [true, true, true, true], round + ': color mask')
+    t.equals(gl.getParameter(gl.BLEND_SRC_RGB), gl.ONE, round + ': blend func')
+    t.deepEquals(Array.from(gl.getParameter(gl.COLOR_CLEAR_VALUE)), [0, 0, 0, 0], round + ': clear color')
+    t.equals(gl.getParameter(gl.UNPACK_FLIP_Y_WEBGL), false, round + ': flip y')
+    t.equals(gl.getParameter(gl.UNPACK_ALIGNMENT), 4, round + ': unpack alignment')
+    t.equals(gl.getParameter(gl.ACTIVE_TEXTURE), gl.TEXTURE0, round + ': active texture')
+    t.equals(gl.getParameter(gl.TEXTURE_BINDING_2D), null, round + ': texture binding')
+    t.equals(gl.getParameter(gl.ARRAY_BUFFER_BINDING), null, round + ': buffer binding')
+    t.equals(gl.getParameter(gl.FRAMEBUFFER_BINDING), null, round + ': framebuffer binding')
+    t.equals(gl.getParameter(gl.CURRENT_PROGRAM), null, round + ': program binding')
+    t.equals(gl.getVertexAttrib(1, gl.VERTEX_ATTRIB_ARRAY_ENABLED), false, round + ': attribute disabled')
+    const derivativesExt = gl.getExtension('OES_standard_derivatives')
+    if (derivativesExt) {
+      t.equals(gl.getParameter(derivativesExt.FRAGMENT_SHADER_DERIVATIVE_HINT_OES), gl.DONT_CARE, round + ': derivative hint')
+    }
+    const drawBuffersExt = gl.getExtension('WEBGL_draw_buffers')
+    if (drawBuffersExt) {
+      t.equals(gl.getParameter(drawBuffersExt.DRAW_BUFFER0_WEBGL), gl.BACK, round + ': draw buffers')
+    }
+    const stats = budgetExt.getStats()
+    t.equals(stats.uploads, 0, round + ': upload count reset')
+    t.equals(stats.draws, 0, round + ': draw count reset')
+    t.equals(budgetExt.getBudget(), 1000, round + ': budget kept')
+
+    const pixel = new Uint8Array(4)
+    gl.readPixels(0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixel)
+    t.deepEquals(Array.from(pixel), [0, 0, 0, 0], round + ': drawing buffer cleared')
+  }
+
+  // Objects created after a reset work as usual
+  gl.clearColor(0, 1, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  const pixel = new Uint8Array(4)
+  gl.readPixels(0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixel)
+  t.deepEquals(Array.from(pixel), [0, 255, 0, 255], 'drawing after reset')
+
+  ext.reset(16, 4)
+  t.equals(gl.drawingBufferWidth, 16, 'resized width')
+  t.equals(gl.drawingBufferHeight, 4, 'resized height')
+  t.deepEquals(Array.from(gl.getParameter(gl.VIEWPORT)), [0, 0, 16, 4], 'resized viewport')
+  t.equals(gl.getError(), gl.NO_ERROR, 'no errors after resize')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
@@ -9,7 +9,7 @@ tape('resize', function (t) {
   const gl = createContext(width, height)
 
   function testColor (width, height, r, g, b, a) {
-    gl.resize(width, height)
+    gl.getExtension('STACKGL_resize_drawingbuffer').resize(width, height)
 
     t.equals(gl.drawingBufferWidth, width, 'width updated')
     t.equals(gl.drawingBufferHeight, height, 'height updated')
@@ -42,7 +42,77 @@ tape('resize', function (t) {
   testColor(4, 4, 255, 0, 255, 0)
   testColor(1, 1, 0, 255, 255, 255)
 
-  gl.destroy()
+  gl.getExtension('STACKGL_destroy_context').destroy()
 
   t.end()
 })
+
+tape('resize reuses drawing buffer storage', function (t) {
+  const gl = createContext(16, 16)
+  // The drawing buffer is private, reach it through an object of the context
+  const drawingBuffer = gl.createBuffer()._ctx._drawingBuffer
+
+  gl.clearColor(1, 0, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+
+  gl.getExtension('STACKGL_resize_drawingbuffer').resize(8, 8)
+  t.equals(drawingBuffer._width, 16, 'shrink keeps storage width')
+  t.equals(drawingBuffer._height, 16, 'shrink keeps storage height')
+
+  gl.getExtension('STACKGL_resize_drawingbuffer').resize(16, 16)
+  const pixels = new Uint8Array(16 * 16 * 4)
+  gl.readPixels(0, 0, 16, 16, gl.RGBA, gl.UNSIGNED_BYTE, pixels)
+  t.ok(pixels.every(function (x) { return x === 0 }), 'reused storage is cleared')
+
+  gl.getExtension('STACKGL_resize_drawingbuffer').resize(100, 20)
+  t.equals(drawingBuffer._width, 128, 'growth rounds width')
+  t.equals(drawingBuffer._height, 64, 'growth rounds height')
+
+  gl.getExtension('STACKGL_resize_drawingbuffer').resize(300, 300)
+  t.equals(drawingBuffer._width, 320, 'growth rounds width again')
+  t.equals(drawingBuffer._height, 320, 'growth rounds height again')
+
+  gl.getExtension('STACKGL_resize_drawingbuffer').resize(8, 8)
+  t.equals(drawingBuffer._width, 64, 'large shrink reallocates width')
+  t.equals(drawingBuffer._height, 64, 'large shrink reallocates height')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
+
+tape('copyTexImage2D clips to visible drawing buffer', function (t) {
+  const gl = createContext(16, 16)
+  gl.getExtension('STACKGL_resize_drawingbuffer').resize(8, 8)
+
+  // Clear writes the whole allocation, including the hidden part.
+  gl.clearColor(0, 1, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+
+  const texture = gl.createTexture()
+  gl.bindTexture(gl.TEXTURE_2D, texture)
+  gl.copyTexImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 4, 4, 8, 8, 0)
+  t.equals(gl.getError(), gl.NO_ERROR, 'copyTexImage2D ok')
+
+  const framebuffer = gl.createFramebuffer()
+  gl.bindFramebuffer(gl.FRAMEBUFFER, framebuffer)
+  gl.framebufferTexture2D(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, gl.TEXTURE_2D, texture, 0)
+
+  const pixels = new Uint8Array(8 * 8 * 4)
+  gl.readPixels(0, 0, 8, 8, gl.RGBA, gl.UNSIGNED_BYTE, pixels)
+
+  let ok = true
+  for (let i = 0; i < 8; ++i) {
+    for (let j = 0; j < 8; ++j) {
+      const inside = i < 4 && j < 4
+      const ptr = 4 * (i * 8 + j)
+      if (pixels[ptr + 1] !== (inside ? 255 : 0) ||
+        pixels[ptr + 3] !== (inside ? 255 : 0)) {
+        ok = false
+      }
+    }
+  }
+  t.ok(ok, 'pixels outside the drawing buffer are zero')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
@@ -0,0 +1,89 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+
+tape('scaled-readback', function (t) {
+  const width = 64
+  const height = 48
+  const gl = createContext(width, height)
+  const ext = gl.getExtension('STACKGL_scaled_readback')
+  t.ok(ext, 'extension supported')
+
+  // Left half red, right half blue
+  gl.enable(gl.SCISSOR_TEST)
+  gl.scissor(0, 0, width / 2, height)
+  gl.clearColor(1, 0, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  gl.scissor(width / 2, 0, width / 2, height)
+  gl.clearColor(0, 0, 1, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  gl.scissor(0, 0, 1, 1)
+
+  const small = ext.readPixelsScaled(4, 3, gl.LINEAR)
+  t.equals(small.length, 4 * 4 * 3, 'thumbnail size')
+  t.deepEquals(Array.from(small.subarray(0, 4)), [255, 0, 0, 255], 'left is red')
+  t.deepEquals(Array.from(small.subarray(12, 16)), [0, 0, 255, 255], 'right is blue')
+
+  const nearest = ext.readPixelsScaled(2, 2, gl.NEAREST)
+  t.deepEquals(Array.from(nearest.subarray(0, 4)), [255, 0, 0, 255], 'nearest left')
+  t.deepEquals(Array.from(nearest.subarray(4, 8)), [0, 0, 255, 255], 'nearest right')
+
+  t.equals(ext.readPixelsScaled(2, 2, gl.LINEAR_MIPMAP_LINEAR), null, 'bad filter')
+  t.equals(gl.getError(), gl.INVALID_ENUM, 'bad filter raises INVALID_ENUM')
+
+  // State touched by the downsampling passes is restored
+  t.ok(gl.isEnabled(gl.SCISSOR_TEST), 'scissor test still enabled')
+  t.deepEquals(Array.from(gl.getParameter(gl.VIEWPORT)), [0, 0, width, height], 'viewport restored')
+  t.deepEquals(Array.from(gl.getParameter(gl.SCISSOR_BOX)), [0, 0, 1, 1], 'scissor box untouched')
+  gl.disable(gl.SCISSOR_TEST)
+  const pixel = new Uint8Array(4)
+  gl.readPixels(0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixel)
+  t.deepEquals(Array.from(pixel), [255, 0, 0, 255], 'drawing buffer still bound')
+  t.equals(gl.getError(), gl.NO_ERROR, 'no errors')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
+
+tape('scaled-readback keeps read framebuffer and divisor', function (t) {
+  const gl = createContext(8, 8)
+  const ext = gl.getExtension('STACKGL_scaled_readback')
+  const blit = gl.getExtension('ANGLE_framebuffer_blit')
+  const instancing = gl.getExtension('ANGLE_instanced_arrays')
+  if (!blit || !instancing) {
+    t.skip('ANGLE_framebuffer_blit or ANGLE_instanced_arrays not supported')
+    gl.getExtension('STACKGL_destroy_context').destroy()
+    t.end()
+    return
+  }
+
+  gl.clearColor(1, 0, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+
+  const texture = gl.createTexture()
+  gl.bindTexture(gl.TEXTURE_2D, texture)
+  gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 8, 8, 0, gl.RGBA, gl.UNSIGNED_BYTE, null)
+  const framebuffer = gl.createFramebuffer()
+  gl.bindFramebuffer(gl.FRAMEBUFFER, framebuffer)
+  gl.framebufferTexture2D(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, gl.TEXTURE_2D, texture, 0)
+  gl.clearColor(0, 1, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  gl.bindFramebuffer(gl.FRAMEBUFFER, null)
+  gl.bindFramebuffer(blit.READ_FRAMEBUFFER_ANGLE, framebuffer)
+
+  // An instanced divisor on attribute 0 must not collapse the triangle
+  instancing.vertexAttribDivisorANGLE(0, 1)
+
+  const small = ext.readPixelsScaled(2, 2, gl.LINEAR)
+  t.deepEquals(Array.from(small.subarray(0, 4)), [255, 0, 0, 255], 'thumbnail drawn')
+
+  const pixel = new Uint8Array(4)
+  gl.readPixels(0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixel)
+  t.deepEquals(Array.from(pixel), [0, 255, 0, 255], 'read framebuffer restored')
+  t.equals(gl.getVertexAttrib(0, instancing.VERTEX_ATTRIB_ARRAY_DIVISOR_ANGLE), 1, 'divisor restored')
+  t.equals(gl.getError(), gl.NO_ERROR, 'no errors')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
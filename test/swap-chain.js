@@ -0,0 +1,78 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+
+function corner (frame) {
+  return Array.from(frame.data.subarray(0, 4))
+}
+
+function renderFrames (t, gl, ext) {
+  gl.clearColor(1, 0, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  gl.present()
+  gl.clearColor(0, 1, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  gl.present()
+
+  const first = ext.readFrame()
+  t.equals(first.width, 8, 'frame width')
+  t.equals(first.height, 4, 'frame height')
+  t.equals(first.data.length, 8 * 4 * 4, 'frame size')
+  t.deepEquals(corner(first), [255, 0, 0, 255], 'first frame')
+  t.deepEquals(corner(ext.readFrame()), [0, 255, 0, 255], 'second frame')
+  t.equals(ext.readFrame(), null, 'no more frames')
+}
+
+tape('swap-chain - single buffer', function (t) {
+  const gl = createContext(8, 4)
+  const ext = gl.getExtension('STACKGL_swap_chain')
+  t.ok(ext, 'extension supported')
+  t.equals(ext.length, 1, 'one color buffer')
+  renderFrames(t, gl, ext)
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
+
+tape('swap-chain - pipelined readback', function (t) {
+  for (const length of [2, 3]) {
+    const gl = createContext(8, 4, { swapChainLength: length })
+    const ext = gl.getExtension('STACKGL_swap_chain')
+    t.equals(ext.length, length, length + ' color buffers')
+    renderFrames(t, gl, ext)
+
+    // Unread frames are dropped once every buffer is in flight
+    for (let i = 0; i < length + 2; ++i) {
+      gl.present()
+    }
+    let count = 0
+    while (ext.readFrame()) {
+      ++count
+    }
+    t.equals(count, length, 'pending frames bounded by swap chain length')
+    t.equals(gl.getError(), gl.NO_ERROR, 'no errors')
+    gl.getExtension('STACKGL_destroy_context').destroy()
+  }
+  t.end()
+})
+
+tape('swap-chain - preserveDrawingBuffer', function (t) {
+  const gl = createContext(8, 4, { swapChainLength: 2, preserveDrawingBuffer: true })
+  const ext = gl.getExtension('STACKGL_swap_chain')
+
+  gl.clearColor(0, 0, 1, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  gl.present()
+
+  const pixel = new Uint8Array(4)
+  gl.readPixels(0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixel)
+  t.deepEquals(Array.from(pixel), [0, 0, 255, 255], 'contents carried to next buffer')
+  t.deepEquals(corner(ext.readFrame()), [0, 0, 255, 255], 'presented frame')
+
+  gl.getExtension('STACKGL_resize_drawingbuffer').resize(16, 16)
+  gl.present()
+  t.equals(ext.readFrame().width, 16, 'frames follow resize')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
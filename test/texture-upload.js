@@ -0,0 +1,133 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+const drawTriangle = require('./util/draw-triangle')
+const makeShader = require('./util/make-program')
+
+const SIZE = 64
+
+function image (seed) {
+  const pixels = new Uint8Array(SIZE * SIZE * 4)
+  for (let i = 0; i < pixels.length; ++i) {
+    pixels[i] = (i * 7 + seed * 13) & 0xff
+  }
+  return pixels
+}
+
+function readTexture (gl, texture) {
+  const framebuffer = gl.createFramebuffer()
+  gl.bindFramebuffer(gl.FRAMEBUFFER, framebuffer)
+  gl.framebufferTexture2D(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0, gl.TEXTURE_2D, texture, 0)
+  const pixels = new Uint8Array(SIZE * SIZE * 4)
+  gl.readPixels(0, 0, SIZE, SIZE, gl.RGBA, gl.UNSIGNED_BYTE, pixels)
+  gl.bindFramebuffer(gl.FRAMEBUFFER, null)
+  gl.deleteFramebuffer(framebuffer)
+  return pixels
+}
+
+function upload (gl, pixels) {
+  const texture = gl.createTexture()
+  gl.bindTexture(gl.TEXTURE_2D, texture)
+  const done = gl.texImage2DAsync(gl.TEXTURE_2D, 0, gl.RGBA, SIZE, SIZE, 0, gl.RGBA, gl.UNSIGNED_BYTE, pixels)
+  return { texture, done }
+}
+
+tape('texture-upload', function (t) {
+  const gl = createContext(1, 1)
+
+  // Several uploads in flight at once, to different textures
+  const images = [0, 1, 2, 3].map(image)
+  const uploads = images.map((pixels) => upload(gl, pixels))
+  t.equals(gl.getError(), gl.NO_ERROR, 'uploads queued')
+
+  t.throws(
+    () => gl.texImage2DAsync(gl.TEXTURE_2D, 0, gl.RGBA, SIZE, SIZE, 0, gl.RGBA, gl.UNSIGNED_BYTE, null),
+    TypeError,
+    'bad pixels throw synchronously')
+
+  Promise.all(uploads.map((u) => u.done)).then(() => {
+    uploads.forEach((u, i) => {
+      t.deepEquals(readTexture(gl, u.texture), images[i], 'upload ' + i + ' contents')
+    })
+
+    // Unpack state at the time of the call applies to the upload
+    gl.pixelStorei(gl.UNPACK_FLIP_Y_WEBGL, true)
+    const flipped = upload(gl, images[0])
+    gl.pixelStorei(gl.UNPACK_FLIP_Y_WEBGL, false)
+    return flipped.done.then(() => {
+      const pixels = readTexture(gl, flipped.texture)
+      const row = SIZE * 4
+      t.deepEquals(pixels.subarray(0, row), images[0].subarray((SIZE - 1) * row), 'flipped first row')
+      t.deepEquals(pixels.subarray((SIZE - 1) * row), images[0].subarray(0, row), 'flipped last row')
+    })
+  }).then(() => {
+    const short = upload(gl, new Uint8Array(16))
+    return short.done.then(() => {
+      t.equals(gl.getError(), gl.INVALID_OPERATION, 'short buffer is an error')
+    })
+  }).then(() => {
+    // Deleting a texture waits for its upload
+    const deleted = upload(gl, image(4))
+    gl.deleteTexture(deleted.texture)
+    t.equals(gl.getError(), gl.NO_ERROR, 'delete during upload')
+
+    const pending = upload(gl, image(5))
+    gl.getExtension('STACKGL_destroy_context').destroy()
+    return pending.done.then(
+      () => t.pass('finished before destroy'),
+      (err) => t.ok(/destroyed/.test(err.message), 'pending upload rejected by destroy'))
+  }).then(() => t.end(), t.end)
+})
+
+tape('texture-upload draw before resolve', function (t) {
+  const gl = createContext(SIZE, SIZE, { antialias: false })
+
+  const program = makeShader(gl, [
+    'precision mediump float;',
+    'attribute vec2 position;',
+    'varying vec2 texCoord;',
+    'void main() {',
+    'texCoord = 0.5*(position + 1.0);',
+    'gl_Position = vec4(position,0,1);',
+    '}'
+  ].join('\n'), [
+    'precision mediump float;',
+    'uniform sampler2D tex;',
+    'varying vec2 texCoord;',
+    'void main() {',
+    'gl_FragColor = texture2D(tex, texCoord);',
+    '}'
+  ].join('\n'))
+  gl.useProgram(program)
+  gl.uniform1i(gl.getUniformLocation(program, 'tex'), 0)
+
+  const pixels = image(6)
+  for (let i = 3; i < pixels.length; i += 4) {
+    pixels[i] = 255
+  }
+  const { texture, done } = upload(gl, pixels)
+  gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MIN_FILTER, gl.NEAREST)
+  gl.texParameteri(gl.TEXTURE_2D, gl.TEXTURE_MAG_FILTER, gl.NEAREST)
+
+  // The draw is issued before the promise resolves and waits for the upload
+  let resolved = false
+  done.then(() => { resolved = true })
+  drawTriangle(gl)
+  const drawn = new Uint8Array(SIZE * SIZE * 4)
+  gl.readPixels(0, 0, SIZE, SIZE, gl.RGBA, gl.UNSIGNED_BYTE, drawn)
+  t.notOk(resolved, 'promise not resolved yet')
+  t.equals(gl.getError(), gl.NO_ERROR, 'no error')
+  t.deepEquals(drawn, pixels, 'draw samples the uploaded image')
+
+  // Attached to a framebuffer before the promise resolves
+  const next = image(7)
+  gl.bindTexture(gl.TEXTURE_2D, texture)
+  const again = gl.texImage2DAsync(gl.TEXTURE_2D, 0, gl.RGBA, SIZE, SIZE, 0, gl.RGBA, gl.UNSIGNED_BYTE, next)
+  gl.bindTexture(gl.TEXTURE_2D, null)
+  t.deepEquals(readTexture(gl, texture), next, 'read through a framebuffer')
+
+  Promise.all([done, again]).then(() => {
+    gl.getExtension('STACKGL_destroy_context').destroy()
+  }).then(() => t.end(), t.end)
+})
@@ -0,0 +1,100 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+
+function createProgram (gl) {
+  const vs = `attribute vec2 position;
+uniform vec2 offset[2];
+void main() {
+  gl_PointSize = 1.0;
+  gl_Position = vec4(position + offset[0] + offset[1], 0, 1);
+}`
+  const fs = `precision mediump float;
+uniform vec4 color;
+uniform mat2 scale;
+uniform bool enabled;
+void main() {
+  gl_FragColor = enabled ? vec4(scale * color.xy, color.zw) : vec4(0);
+}`
+  const vertShader = gl.createShader(gl.VERTEX_SHADER)
+  gl.shaderSource(vertShader, vs)
+  gl.compileShader(vertShader)
+  const fragShader = gl.createShader(gl.FRAGMENT_SHADER)
+  gl.shaderSource(fragShader, fs)
+  gl.compileShader(fragShader)
+  const program = gl.createProgram()
+  gl.attachShader(program, vertShader)
+  gl.attachShader(program, fragShader)
+  gl.bindAttribLocation(program, 0, 'position')
+  gl.linkProgram(program)
+  return program
+}
+
+tape('uniform-block', function (t) {
+  const gl = createContext(1, 1)
+  const ext = gl.getExtension('STACKGL_uniform_block')
+  t.ok(ext, 'extension supported')
+
+  const program = createProgram(gl)
+  t.ok(gl.getProgramParameter(program, gl.LINK_STATUS), 'program linked')
+
+  const layout = ext.createUniformLayout(program, [
+    { name: 'offset', offset: 0 },
+    { name: 'color', offset: 4, type: gl.FLOAT_VEC4 },
+    { name: 'scale', offset: 8 },
+    { name: 'enabled', offset: 12 },
+    { name: 'unused', offset: 13 }
+  ], { diff: true })
+  t.ok(layout, 'layout created')
+  t.equals(layout.size, 13, 'layout size')
+
+  const data = new Float32Array(layout.size)
+  data.set([0.25, 0, -0.25, 0], 0)
+  data.set([1, 0.5, 0, 1], 4)
+  data.set([1, 0, 0, 1], 8)
+  new Int32Array(data.buffer)[12] = 1
+
+  ext.uniformBlock(layout, data)
+  t.equals(gl.getError(), gl.INVALID_OPERATION, 'program must be current')
+
+  gl.useProgram(program)
+  t.equals(ext.uniformBlock(layout, data), 4, 'all uniforms uploaded')
+  t.deepEquals(Array.from(gl.getUniform(program, gl.getUniformLocation(program, 'offset[1]'))), [-0.25, 0], 'array uniform')
+  t.deepEquals(Array.from(gl.getUniform(program, gl.getUniformLocation(program, 'color'))), [1, 0.5, 0, 1], 'vec4 uniform')
+  t.equals(gl.getUniform(program, gl.getUniformLocation(program, 'enabled')), true, 'bool uniform')
+
+  const buffer = gl.createBuffer()
+  gl.bindBuffer(gl.ARRAY_BUFFER, buffer)
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([0, 0]), gl.STATIC_DRAW)
+  gl.enableVertexAttribArray(0)
+  gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0)
+  gl.drawArrays(gl.POINTS, 0, 1)
+  const pixel = new Uint8Array(4)
+  gl.readPixels(0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixel)
+  t.ok(pixel[0] === 255 && Math.abs(pixel[1] - 128) <= 1 && pixel[2] === 0, 'rendered with uniforms')
+
+  t.equals(ext.uniformBlock(layout, data), 0, 'unchanged uniforms skipped')
+  data[5] = 0.25
+  t.equals(ext.uniformBlock(layout, data), 1, 'only changed uniform uploaded')
+
+  ext.uniformBlock(layout, new Float32Array(4))
+  t.equals(gl.getError(), gl.INVALID_VALUE, 'data too short')
+
+  const colorLocation = gl.getUniformLocation(program, 'color')
+  gl.uniform4f(colorLocation, 1, 1, 1, 1)
+  const zeroLayout = ext.createUniformLayout(program, [
+    { name: 'color', offset: 0 }
+  ], { diff: true })
+  t.equals(ext.uniformBlock(zeroLayout, new Float32Array(4)), 1, 'first upload is not diffed')
+  t.deepEquals(Array.from(gl.getUniform(program, colorLocation)), [0, 0, 0, 0], 'zero uniform uploaded')
+  t.equals(ext.uniformBlock(zeroLayout, new Float32Array(4)), 0, 'later uploads are diffed')
+
+  gl.linkProgram(program)
+  ext.uniformBlock(layout, data)
+  t.equals(gl.getError(), gl.INVALID_OPERATION, 'relinked program')
+
+  t.equals(gl.getError(), gl.NO_ERROR, 'no errors')
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
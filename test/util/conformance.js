@@ -15,10 +15,16 @@ WebGLActiveInfo = require('../../src/javascript/webgl-active-info').WebGLActiveI
 WebGLShaderPrecisionFormat = require('../../src/javascript/webgl-shader-precision-format').WebGLShaderPrecisionFormat // eslint-disable-line
 WebGLContextAttributes = require('../../src/javascript/webgl-context-attributes').WebGLContextAttributes // eslint-disable-line
 
+// GL_VALIDATION=minimal or none runs the suite with reduced validation
+const VALIDATION = process.env.GL_VALIDATION
+
 module.exports = function (filter) {
   return runConformance({
     tape,
     createContext: function (width, height, options) {
+      if (VALIDATION) {
+        options = Object.assign({ validation: VALIDATION }, options)
+      }
       const context = createContext(width, height, options)
       context.destroy = context.getExtension('STACKGL_destroy_context').destroy
       context.resize = context.getExtension('STACKGL_resize_drawingbuffer').resize
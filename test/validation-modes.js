@@ -0,0 +1,116 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+
+function createProgram (gl) {
+  const vs = `attribute vec2 position;
+uniform vec2 offset;
+uniform mat2 scale;
+void main() {
+  gl_PointSize = 1.0;
+  gl_Position = vec4(scale * position + offset, 0, 1);
+}`
+  const fs = `precision mediump float;
+uniform vec4 color;
+void main() {
+  gl_FragColor = color;
+}`
+  const vertShader = gl.createShader(gl.VERTEX_SHADER)
+  gl.shaderSource(vertShader, vs)
+  gl.compileShader(vertShader)
+  const fragShader = gl.createShader(gl.FRAGMENT_SHADER)
+  gl.shaderSource(fragShader, fs)
+  gl.compileShader(fragShader)
+  const program = gl.createProgram()
+  gl.attachShader(program, vertShader)
+  gl.attachShader(program, fragShader)
+  gl.bindAttribLocation(program, 0, 'position')
+  gl.linkProgram(program)
+  return program
+}
+
+function render (gl) {
+  const program = createProgram(gl)
+  gl.useProgram(program)
+
+  const buffer = gl.createBuffer()
+  gl.bindBuffer(gl.ARRAY_BUFFER, buffer)
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([
+    -1, -1, 1, -1, -1, 1, 1, 1
+  ]), gl.STATIC_DRAW)
+  gl.enableVertexAttribArray(0)
+  gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0)
+
+  const elements = gl.createBuffer()
+  gl.bindBuffer(gl.ELEMENT_ARRAY_BUFFER, elements)
+  gl.bufferData(gl.ELEMENT_ARRAY_BUFFER, new Uint16Array([0, 1, 2, 1, 3, 2]), gl.STATIC_DRAW)
+
+  gl.viewport(0, 0, 4, 4)
+  gl.clearColor(0, 0, 0, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+  gl.enable(gl.SCISSOR_TEST)
+  gl.scissor(0, 0, 2, 4)
+
+  const offset = gl.getUniformLocation(program, 'offset')
+  const scale = gl.getUniformLocation(program, 'scale')
+  const color = gl.getUniformLocation(program, 'color')
+  gl.uniform2f(offset, 0, 0)
+  gl.uniformMatrix2fv(scale, false, [1, 0, 0, 1])
+  gl.uniform4fv(color, [1, 0, 0, 1])
+  gl.drawArrays(gl.TRIANGLE_STRIP, 0, 4)
+
+  gl.scissor(2, 0, 2, 4)
+  gl.uniform4f(color, 0, 1, 0, 1)
+  gl.drawElements(gl.TRIANGLES, 6, gl.UNSIGNED_SHORT, 0)
+  gl.disable(gl.SCISSOR_TEST)
+
+  const pixels = new Uint8Array(4 * 4 * 4)
+  gl.readPixels(0, 0, 4, 4, gl.RGBA, gl.UNSIGNED_BYTE, pixels)
+  return Array.from(pixels)
+}
+
+tape('validation-modes', function (t) {
+  const full = createContext(4, 4)
+  const expected = render(full)
+  full.getExtension('STACKGL_destroy_context').destroy()
+  t.deepEquals(expected.slice(0, 4), [255, 0, 0, 255], 'left half red')
+  t.deepEquals(expected.slice(12, 16), [0, 255, 0, 255], 'right half green')
+
+  for (const mode of ['minimal', 'none']) {
+    const gl = createContext(4, 4, { validation: mode })
+    t.equals(gl.getContextAttributes().validation, mode, mode + ' attribute')
+    t.deepEquals(render(gl), expected, mode + ' renders the same image')
+    t.equals(gl.getError(), gl.NO_ERROR, mode + ' no errors')
+    gl.getExtension('STACKGL_destroy_context').destroy()
+  }
+
+  t.throws(function () {
+    createContext(4, 4, { validation: 'bogus' })
+  }, TypeError, 'unknown mode throws')
+
+  t.end()
+})
+
+tape('validation-modes errors', function (t) {
+  for (const mode of ['full', 'minimal']) {
+    const gl = createContext(4, 4, { validation: mode })
+    const program = createProgram(gl)
+    gl.useProgram(program)
+    gl.bindBuffer(gl.ARRAY_BUFFER, gl.createBuffer())
+    gl.bufferData(gl.ARRAY_BUFFER, new Float32Array(4), gl.STATIC_DRAW)
+    gl.enableVertexAttribArray(0)
+    gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0)
+
+    gl.drawArrays(gl.TRIANGLES, 0, 3)
+    t.equals(gl.getError(), gl.INVALID_OPERATION, mode + ' draw out of range')
+
+    gl.blendFunc(0x1234, gl.ONE)
+    t.equals(gl.getError(), gl.INVALID_ENUM, mode + ' invalid enum')
+
+    gl.uniform4f(null, 0, 0, 0, 0)
+    t.equals(gl.getError(), gl.NO_ERROR, mode + ' null location ignored')
+    gl.getExtension('STACKGL_destroy_context').destroy()
+  }
+  t.end()
+})
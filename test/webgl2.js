@@ -0,0 +1,183 @@
+'use strict'
+
+const tape = require('tape')
+const createContext = require('../index')
+const { WebGL2RenderingContext } = require('../index')
+
+function compile (t, gl, vs, fs) {
+  const vertShader = gl.createShader(gl.VERTEX_SHADER)
+  gl.shaderSource(vertShader, vs)
+  gl.compileShader(vertShader)
+  t.ok(gl.getShaderParameter(vertShader, gl.COMPILE_STATUS), gl.getShaderInfoLog(vertShader) || 'vertex shader compiled')
+
+  const fragShader = gl.createShader(gl.FRAGMENT_SHADER)
+  gl.shaderSource(fragShader, fs)
+  gl.compileShader(fragShader)
+  t.ok(gl.getShaderParameter(fragShader, gl.COMPILE_STATUS), gl.getShaderInfoLog(fragShader) || 'fragment shader compiled')
+
+  const program = gl.createProgram()
+  gl.attachShader(program, vertShader)
+  gl.attachShader(program, fragShader)
+  gl.bindAttribLocation(program, 0, 'position')
+  gl.linkProgram(program)
+  t.ok(gl.getProgramParameter(program, gl.LINK_STATUS), gl.getProgramInfoLog(program) || 'program linked')
+  return program
+}
+
+tape('webgl2 - context', function (t) {
+  const gl = createContext(4, 4, { version: 2 })
+  t.ok(gl instanceof WebGL2RenderingContext, 'WebGL2RenderingContext')
+  t.ok(/^WebGL 2\.0/.test(gl.getParameter(gl.VERSION)), 'version string')
+  t.equals(gl.getExtension('OES_vertex_array_object'), null, 'core extensions are not exposed')
+  t.ok(gl.getParameter(gl.MAX_UNIFORM_BUFFER_BINDINGS) >= 24, 'uniform buffer bindings')
+  t.ok(gl.getExtension('STACKGL_destroy_context'), 'stackgl extensions')
+
+  const gl1 = createContext(4, 4)
+  t.notOk(gl1 instanceof WebGL2RenderingContext, 'WebGL 1 by default')
+  gl1.getExtension('STACKGL_destroy_context').destroy()
+
+  t.equals(gl.getError(), gl.NO_ERROR, 'no errors')
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
+
+tape('webgl2 - uniform buffers and instancing', function (t) {
+  const gl = createContext(4, 1, { version: 2 })
+
+  const program = compile(t, gl, `#version 300 es
+in vec2 position;
+in float offset;
+void main() {
+  gl_PointSize = 1.0;
+  gl_Position = vec4(position.x + offset, position.y, 0, 1);
+}`, `#version 300 es
+precision mediump float;
+uniform Colors {
+  vec4 color;
+};
+out vec4 fragColor;
+void main() {
+  fragColor = color;
+}`)
+
+  const blockIndex = gl.getUniformBlockIndex(program, 'Colors')
+  t.notEquals(blockIndex, gl.INVALID_INDEX, 'block index')
+  t.equals(gl.getActiveUniformBlockName(program, blockIndex), 'Colors', 'block name')
+  t.ok(gl.getActiveUniformBlockParameter(program, blockIndex, gl.UNIFORM_BLOCK_DATA_SIZE) >= 16, 'block size')
+  gl.uniformBlockBinding(program, blockIndex, 1)
+
+  const ubo = gl.createBuffer()
+  gl.bindBuffer(gl.UNIFORM_BUFFER, ubo)
+  gl.bufferData(gl.UNIFORM_BUFFER, new Float32Array([0, 1, 0, 1]), gl.STATIC_DRAW)
+  gl.bindBufferBase(gl.UNIFORM_BUFFER, 1, ubo)
+  t.equals(gl.getIndexedParameter(gl.UNIFORM_BUFFER_BINDING, 1), ubo, 'indexed binding')
+
+  const vao = gl.createVertexArray()
+  gl.bindVertexArray(vao)
+  t.ok(gl.isVertexArray(vao), 'vertex array')
+
+  const positions = gl.createBuffer()
+  gl.bindBuffer(gl.ARRAY_BUFFER, positions)
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([-0.75, 0]), gl.STATIC_DRAW)
+  gl.enableVertexAttribArray(0)
+  gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0)
+
+  const offsetLocation = gl.getAttribLocation(program, 'offset')
+  const offsets = gl.createBuffer()
+  gl.bindBuffer(gl.ARRAY_BUFFER, offsets)
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([0, 0.5, 1, 1.5]), gl.STATIC_DRAW)
+  gl.enableVertexAttribArray(offsetLocation)
+  gl.vertexAttribPointer(offsetLocation, 1, gl.FLOAT, false, 0, 0)
+  gl.vertexAttribDivisor(offsetLocation, 1)
+
+  gl.useProgram(program)
+  gl.drawArraysInstanced(gl.POINTS, 0, 1, 4)
+
+  const pixels = new Uint8Array(16)
+  gl.readPixels(0, 0, 4, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixels)
+  for (let i = 0; i < 4; ++i) {
+    t.deepEquals(Array.from(pixels.subarray(4 * i, 4 * i + 4)), [0, 255, 0, 255], 'instance ' + i)
+  }
+
+  t.equals(gl.getError(), gl.NO_ERROR, 'no errors')
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
+
+tape('webgl2 - pixel buffers', function (t) {
+  const gl = createContext(2, 2, { version: 2 })
+  gl.clearColor(1, 0, 1, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+
+  const pbo = gl.createBuffer()
+  gl.bindBuffer(gl.PIXEL_PACK_BUFFER, pbo)
+  gl.bufferData(gl.PIXEL_PACK_BUFFER, 16, gl.STREAM_READ)
+  gl.readPixels(0, 0, 2, 2, gl.RGBA, gl.UNSIGNED_BYTE, 0)
+  t.equals(gl.getError(), gl.NO_ERROR, 'read into pack buffer')
+
+  gl.readPixels(0, 0, 2, 2, gl.RGBA, gl.UNSIGNED_BYTE, 4)
+  t.equals(gl.getError(), gl.INVALID_OPERATION, 'pack buffer overflow')
+
+  const pixels = new Uint8Array(16)
+  gl.getBufferSubData(gl.PIXEL_PACK_BUFFER, 0, pixels)
+  t.deepEquals(Array.from(pixels.subarray(0, 4)), [255, 0, 255, 255], 'pixels from pack buffer')
+
+  gl.bindBuffer(gl.PIXEL_PACK_BUFFER, null)
+  gl.readPixels(0, 0, 2, 2, gl.RGBA, gl.UNSIGNED_BYTE, 0)
+  t.equals(gl.getError(), gl.INVALID_OPERATION, 'offset without pack buffer')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
+
+tape('webgl2 - 3D textures', function (t) {
+  const gl = createContext(2, 2, { version: 2 })
+
+  const texture = gl.createTexture()
+  gl.bindTexture(gl.TEXTURE_3D, texture)
+  t.equals(gl.getParameter(gl.TEXTURE_BINDING_3D), texture, 'texture binding')
+  gl.texParameteri(gl.TEXTURE_3D, gl.TEXTURE_MIN_FILTER, gl.NEAREST)
+  gl.texParameteri(gl.TEXTURE_3D, gl.TEXTURE_WRAP_R, gl.CLAMP_TO_EDGE)
+  gl.texImage3D(gl.TEXTURE_3D, 0, gl.RGBA8, 2, 2, 2, 0, gl.RGBA, gl.UNSIGNED_BYTE, new Uint8Array(32))
+  gl.texSubImage3D(gl.TEXTURE_3D, 0, 0, 0, 1, 2, 2, 1, gl.RGBA, gl.UNSIGNED_BYTE, new Uint8Array(16))
+  t.equals(gl.getError(), gl.NO_ERROR, 'texImage3D')
+
+  gl.texImage3D(gl.TEXTURE_3D, 0, gl.RGBA8, 2, 2, 2, 0, gl.RGBA, gl.UNSIGNED_BYTE, new Uint8Array(8))
+  t.equals(gl.getError(), gl.INVALID_OPERATION, 'short pixel array')
+
+  const array = gl.createTexture()
+  gl.bindTexture(gl.TEXTURE_2D_ARRAY, array)
+  gl.texImage3D(gl.TEXTURE_2D_ARRAY, 0, gl.R8, 4, 4, 3, 0, gl.RED, gl.UNSIGNED_BYTE, null)
+  t.equals(gl.getError(), gl.NO_ERROR, 'texture array')
+
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
+
+tape('webgl2 - draw buffers', function (t) {
+  const gl = createContext(1, 1, { version: 2 })
+
+  const framebuffer = gl.createFramebuffer()
+  gl.bindFramebuffer(gl.FRAMEBUFFER, framebuffer)
+  const textures = []
+  for (let i = 0; i < 2; ++i) {
+    const texture = gl.createTexture()
+    gl.bindTexture(gl.TEXTURE_2D, texture)
+    gl.texImage2D(gl.TEXTURE_2D, 0, gl.RGBA, 1, 1, 0, gl.RGBA, gl.UNSIGNED_BYTE, null)
+    gl.framebufferTexture2D(gl.FRAMEBUFFER, gl.COLOR_ATTACHMENT0 + i, gl.TEXTURE_2D, texture, 0)
+    textures.push(texture)
+  }
+  t.equals(gl.checkFramebufferStatus(gl.FRAMEBUFFER), gl.FRAMEBUFFER_COMPLETE, 'framebuffer complete')
+  gl.drawBuffers([gl.COLOR_ATTACHMENT0, gl.COLOR_ATTACHMENT1])
+
+  gl.clearColor(0, 0, 1, 1)
+  gl.clear(gl.COLOR_BUFFER_BIT)
+
+  const pixel = new Uint8Array(4)
+  gl.readPixels(0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixel)
+  t.deepEquals(Array.from(pixel), [0, 0, 255, 255], 'first attachment cleared')
+
+  t.equals(gl.getError(), gl.NO_ERROR, 'no errors')
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  t.end()
+})
@@ -0,0 +1,95 @@
+'use strict'
+
+const { Worker, isMainThread, parentPort, workerData } = require('worker_threads')
+const createContext = require('../index')
+
+const WORKERS = 4
+const FRAMES = 20
+const SIZE = 16
+
+function render (index) {
+  const gl = createContext(SIZE, SIZE)
+  const vs = `attribute vec2 position;
+void main() {
+  gl_Position = vec4(position, 0, 1);
+}`
+  const fs = `precision mediump float;
+uniform vec4 color;
+void main() {
+  gl_FragColor = color;
+}`
+  const vertShader = gl.createShader(gl.VERTEX_SHADER)
+  gl.shaderSource(vertShader, vs)
+  gl.compileShader(vertShader)
+  const fragShader = gl.createShader(gl.FRAGMENT_SHADER)
+  gl.shaderSource(fragShader, fs)
+  gl.compileShader(fragShader)
+  const program = gl.createProgram()
+  gl.attachShader(program, vertShader)
+  gl.attachShader(program, fragShader)
+  gl.bindAttribLocation(program, 0, 'position')
+  gl.linkProgram(program)
+  gl.useProgram(program)
+
+  gl.bindBuffer(gl.ARRAY_BUFFER, gl.createBuffer())
+  gl.bufferData(gl.ARRAY_BUFFER, new Float32Array([
+    -1, -1, 0, -1, -1, 1, 0, 1
+  ]), gl.STATIC_DRAW)
+  gl.enableVertexAttribArray(0)
+  gl.vertexAttribPointer(0, 2, gl.FLOAT, false, 0, 0)
+  const color = gl.getUniformLocation(program, 'color')
+
+  // Render repeatedly so the workers overlap and keep switching contexts
+  const pixels = new Uint8Array(SIZE * SIZE * 4)
+  for (let i = 0; i < FRAMES; ++i) {
+    gl.clearColor(index / 255, 0, 1, 1)
+    gl.clear(gl.COLOR_BUFFER_BIT)
+    gl.uniform4f(color, 0, index / 255, 0, 1)
+    gl.drawArrays(gl.TRIANGLE_STRIP, 0, 4)
+    gl.readPixels(0, 0, SIZE, SIZE, gl.RGBA, gl.UNSIGNED_BYTE, pixels)
+  }
+  const error = gl.getError()
+  gl.getExtension('STACKGL_destroy_context').destroy()
+  return {
+    error,
+    left: Array.from(pixels.subarray(0, 4)),
+    right: Array.from(pixels.subarray((SIZE - 1) * 4, SIZE * 4))
+  }
+}
+
+if (!isMainThread) {
+  parentPort.postMessage(render(workerData.index))
+} else {
+  const tape = require('tape')
+
+  tape('workers', function (t) {
+    // The main thread keeps a context alive while the workers come and go
+    const gl = createContext(1, 1)
+    let pending = WORKERS
+
+    for (let i = 0; i < WORKERS; ++i) {
+      const index = 10 * (i + 1)
+      const worker = new Worker(__filename, { workerData: { index } })
+      worker.once('message', function (result) {
+        t.equals(result.error, 0, 'worker ' + i + ' no errors')
+        t.deepEquals(result.left, [0, index, 0, 255], 'worker ' + i + ' draw')
+        t.deepEquals(result.right, [index, 0, 255, 255], 'worker ' + i + ' clear')
+      })
+      worker.once('error', function (err) {
+        t.fail(err)
+      })
+      worker.once('exit', function (code) {
+        t.equals(code, 0, 'worker ' + i + ' exit')
+        if (--pending === 0) {
+          gl.clearColor(1, 0, 0, 1)
+          gl.clear(gl.COLOR_BUFFER_BIT)
+          const pixel = new Uint8Array(4)
+          gl.readPixels(0, 0, 1, 1, gl.RGBA, gl.UNSIGNED_BYTE, pixel)
+          t.deepEquals(Array.from(pixel), [255, 0, 0, 255], 'main thread context still works')
+          gl.getExtension('STACKGL_destroy_context').destroy()
+          t.end()
+        }
+      })
+    }
+  })
+}